@@ -7,13 +7,24 @@
 
 #ifndef INPUT_PARAMETERS_H_
 #define INPUT_PARAMETERS_H_
-#include "SimpleKalmanFilter_v2.h"
+#include "filter_bank.h"
 #include "adc.h"
 // Khai báo typedef cho các struct
 
+// Thứ tự kênh trong bộ lọc = thứ tự rank của ADC1
+typedef enum {
+    SENSOR_CH_VREF = 0,
+    SENSOR_CH_HOI_VE,
+    SENSOR_CH_DAU_DAY,
+    SENSOR_CH_LOW_PRESSURE,
+    SENSOR_CH_HIGH_PRESSURE,
+    SENSOR_CH_COUNT
+} Sensor_Channel;
+
+// Giá trị ADC đã lọc (LSB), giữ phần lẻ dưới 1 LSB có được từ oversampling và trung bình khối
 typedef struct {
-    uint16_t ADC_hoi_ve;
-    uint16_t ADC_dau_day;
+    float ADC_hoi_ve;
+    float ADC_dau_day;
 } ADC_Temperature_Sensors;
 
 typedef struct {
@@ -24,8 +35,8 @@ typedef struct {
 
 ////////////////////////////////////////////////////////////////////////////////
 typedef struct {
-    uint16_t ADC_high_pressure;
-    uint16_t ADC_low_pressure;
+    float ADC_high_pressure;
+    float ADC_low_pressure;
 } ADC_Pressure_Sensors;
 
 typedef struct {
@@ -34,33 +45,32 @@ typedef struct {
 } Pressure_Sensors;
 
 
-//////////////////////////////////////////////////////////////////////////////////
-typedef struct{
-	SimpleKalmanFilter filter_temperature_sensor_hoi_ve;
-	SimpleKalmanFilter filter_temperature_sensor_dau_day;
-}Filter_Temperature_Sensors;
-////////////////////////////////////////////////////////////////////////////////
-typedef struct{
-	SimpleKalmanFilter filter_high_pressure_sensor;
-	SimpleKalmanFilter filter_low_pressure_sensor;
-}Filter_Pressure_Sensors;
 
 
 
 
+// Đường nhanh (sensor_pipeline.h): cập nhật mỗi khối ADC, chỉ dùng cho bảo vệ
+typedef struct {
+    float dau_day;
+    float high_pressure_sensor;
+} Fast_Sensors;
+
 extern Temperature_Sensors temperature_sensors;
 extern Pressure_Sensors pressure_sensors;
+extern Fast_Sensors fast_sensors;
 
 extern ADC_Temperature_Sensors adc_temperature_sensors;
 extern ADC_Pressure_Sensors adc_pressure_sensors;
 
-extern Filter_Temperature_Sensors filter_temperature_sensors;
-extern Filter_Pressure_Sensors filter_pressure_sensors;
+extern FilterBank sensor_filters;
 
-extern uint16_t adc_vref;
+extern float adc_vref;
 extern float vref;
 
 
 void Filter_Input_Init(void);
-void Calcular_Input(ADC_HandleTypeDef* hadc1);
+// scan: một lượt quét ADC (LSB) theo thứ tự Sensor_Channel
+void Calcular_Input(const float* scan);
+// Đổi giá trị đường nhanh sang đơn vị kỹ thuật, gọi sau mỗi khối ADC
+void Calcular_Fast_Input(void);
 #endif /* INC_INPUT_PARAMETERS_H_ */
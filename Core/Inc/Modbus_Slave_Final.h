@@ -19,8 +19,10 @@
  *        - Đặt là 1: Xử lý trong hàm Modbus_Poll() được gọi từ vòng lặp chính.
  *                     Ưu điểm: Giảm tải xử lý trong ngắt, phù hợp nếu việc xử lý Modbus phức tạp hoặc có nhiều tác vụ khác.
  *                     Nhược điểm: Độ trễ phản hồi phụ thuộc vào tần suất gọi Modbus_Poll().
+ *                     Ngắt chỉ chụp frame vào bộ đệm đôi và gọi Modbus_FrameReadyCallback()
+ *                     để ứng dụng đánh thức tác vụ gọi Modbus_Poll() ngay.
  */
-#define MODBUS_PROCESS_IN_MAIN_LOOP   0 // <-- CHỌN 0 hoặc 1 TẠI ĐÂY
+#define MODBUS_PROCESS_IN_MAIN_LOOP   1 // <-- CHỌN 0 hoặc 1 TẠI ĐÂY
 /**
  * @brief Bật/Tắt cơ chế Critical Section tự động của thư viện Modbus.
  *        - Đặt là 1: BẬT. Các hàm Modbus_Enter/ExitCriticalSection sẽ
@@ -31,6 +33,21 @@
  *          Người dùng tự quản lý critical section nếu cần. Không cần cung cấp IRQn.
  */
 #define MODBUS_USE_CRITICAL_SECTION 1 // <-- Đặt là 1 hoặc 0 TẠI ĐÂY
+/**
+ * @brief Cách xác định kết thúc frame RTU.
+ *        - Đặt là 0: Theo Idle Line của UART (im lặng 1 ký tự). Đơn giản nhưng frame bị tách
+ *                     nếu Master ngừng giữa frame, và phản hồi có thể bắt đầu trước t3.5.
+ *        - Đặt là 1: Theo chuẩn Modbus RTU. Receiver timeout (RTOR) của USART báo im lặng t1.5,
+ *                     timer MODBUS_T35_TIM đếm nốt tới t3.5 rồi mới kết thúc frame và cho phép phản hồi.
+ *                     Ngưỡng t1.5/t3.5 theo từng baud nằm trong bảng modbus_rtu_timing_table.
+ */
+#define MODBUS_RTU_TIMING             1
+/**
+ * @brief Xử lý khoảng lặng giữa 2 ký tự trong frame lớn hơn t1.5 (chỉ khi MODBUS_RTU_TIMING = 1).
+ *        - Đặt là 1: Bỏ frame như chuẩn quy định.
+ *        - Đặt là 0: Chấp nhận (chỉ đếm vào stats.t15_gaps), phù hợp với Master ngừng giữa frame.
+ */
+#define MODBUS_T15_STRICT             0
 /* Includes ------------------------------------------------------------------*/
 #include "stm32h5xx_hal.h" // Thay stm32f3xx bằng dòng chip STM32 bạn đang dùng (vd: stm32f1xx, stm32f4xx)
 #include <stdint.h>        // Định nghĩa các kiểu số nguyên chuẩn (uint8_t, uint16_t, ...)
@@ -41,7 +58,7 @@
 /* Configuration Defines ---------------------------------------------------*/
 /** @defgroup Modbus_Config Cấu hình Modbus - Các giá trị người dùng cần tùy chỉnh */
 /** @{ */
-#define SLAVE_ADDRESS         0x04  /*!< Địa chỉ (ID) của thiết bị Slave này trên mạng Modbus. */
+#define SLAVE_ADDRESS         0x04  /*!< Địa chỉ (ID) mặc định của Slave, dùng khi EEPROM chưa có cấu hình truyền thông. */
 #define MODBUS_RX_BUFFER_SIZE 256   /*!< Kích thước bộ đệm nhận dữ liệu Modbus (byte). Nên đủ lớn cho frame dài nhất (FC 0F/10). */
 #define MODBUS_TX_BUFFER_SIZE 256   /*!< Kích thước bộ đệm truyền dữ liệu Modbus (byte). Nên đủ lớn cho phản hồi dài nhất (FC 01/02/03/04). */
 
@@ -50,8 +67,16 @@
 // Ví dụ: Coil 1 tương ứng với modbus->coils bit 0, Holding Register 40001 tương ứng với modbus->holdingRegs[0].
 #define MAX_COILS             128   /*!< Số lượng Coils tối đa (00001 - 00128). Kích thước mảng coils sẽ là MAX_COILS/8. */
 #define MAX_DISCRETE          128   /*!< Số lượng Discrete Inputs tối đa (10001 - 10128). Kích thước mảng discreteInputs sẽ là MAX_DISCRETE/8. */
-#define MAX_HOLDING_REGS      100   /*!< Số lượng Holding Registers tối đa (40001 - 40100). Kích thước mảng holdingRegs sẽ là MAX_HOLDING_REGS. */
+#define MAX_HOLDING_REGS      140   /*!< Số lượng Holding Registers tối đa (40001 - 40140), 100..139 là khối của tối đa 4 van. Kích thước mảng holdingRegs sẽ là MAX_HOLDING_REGS. */
 #define MAX_INPUT_REGS        100   /*!< Số lượng Input Registers tối đa (30001 - 30100). Kích thước mảng inputRegs sẽ là MAX_INPUT_REGS. */
+#define MODBUS_RX_SLOTS       2     /*!< Số bộ đệm frame nhận: 1 cho DMA đang ghi + 1 frame chờ Modbus_Poll xử lý. */
+#define MODBUS_T35_TIM        TIM6  /*!< Timer cơ bản đếm phần t3.5 - t1.5, chạy ở chế độ one-pulse, tick 1 us. */
+#define MODBUS_T35_TIM_IRQn   TIM6_IRQn
+#define MODBUS_T35_TIM_CLK_ENABLE()  __HAL_RCC_TIM6_CLK_ENABLE()
+#define MODBUS_RX_HEAD_SIZE   16    /*!< Đoạn DMA đầu của mỗi frame. Ngắt HT tại byte 8 = đủ một request FC 01..06,
+                                         nên frame được kiểm tra và giao xử lý trước khi chờ IDLE. */
+#define MODBUS_READ_CACHE_SLOTS    4  /*!< Số cửa sổ đọc FC03/FC04 được giữ sẵn khung phản hồi gồm CRC. 0 = tắt. */
+#define MODBUS_READ_CACHE_MAX_REGS 16 /*!< Cửa sổ dài hơn không được cache, chép từ ảnh vào txBuffer. */
 /** @} */ // End of Modbus_Config
 
 /* Modbus Constants --------------------------------------------------------*/
@@ -93,6 +118,72 @@ typedef enum {
  *        hoặc nếu = 1 nhưng bạn muốn tạm thời bỏ qua việc quản lý ngắt bởi thư viện.
  */
 #define MODBUS_IRQN_NONE ((IRQn_Type)-128) // Giá trị âm không dùng cho IRQ hợp lệ
+/**
+ * @brief Bộ đếm chẩn đoán độ trễ và tải ngắt của Modbus.
+ *        Thời gian đo bằng DWT->CYCCNT, quy đổi sang us theo SystemCoreClock.
+ */
+typedef struct {
+    uint32_t frames_rx;            /*!< Số frame đã chụp vào hàng đợi. */
+    uint32_t frames_dropped;       /*!< Số frame bị bỏ vì frame trước chưa được xử lý. */
+    uint32_t isr_cycles_last;      /*!< Thời gian xử lý trong Modbus_UartRxCpltCallback (chu kỳ CPU). */
+    uint32_t isr_cycles_max;
+    uint32_t queue_us_last;        /*!< Từ lúc chụp frame tới lúc bắt đầu xử lý (us). */
+    uint32_t queue_us_max;
+    uint32_t turnaround_us_last;   /*!< Từ lúc chụp frame tới lúc bắt đầu gửi phản hồi (us). */
+    uint32_t turnaround_us_max;
+    uint32_t frames_foreign;       /*!< Số frame của slave khác, bị loại ngay sau byte địa chỉ. */
+    uint32_t frames_crc_err;       /*!< Số frame sai CRC. */
+    uint32_t frames_bad_len;       /*!< Số frame có độ dài không khớp với FC/byte count. */
+    uint32_t frames_early;         /*!< Số frame được giao xử lý trước sự kiện IDLE. */
+    uint32_t t15_gaps;             /*!< Số lần im lặng giữa frame lớn hơn t1.5 nhưng nhỏ hơn t3.5. */
+    uint32_t read_cache_hits;      /*!< Số lần FC03/FC04 phát thẳng khung dựng sẵn. */
+    uint32_t read_cache_misses;    /*!< Số lần phải dựng khung trong lúc xử lý request. */
+} ModbusStats;
+/**
+ * @brief Khung phản hồi FC03/FC04 dựng sẵn cho một cửa sổ đọc hay dùng.
+ *        Hợp lệ khi gen trùng thế hệ ảnh thanh ghi; DMA phát thẳng từ frame, không chép sang txBuffer.
+ */
+typedef struct {
+    uint8_t  fc;        /*!< READ_HOLDING/READ_INPUT, 0 = slot trống. */
+    uint8_t  len;       /*!< Độ dài frame gồm CRC. */
+    uint16_t start;
+    uint16_t quantity;
+    uint32_t gen;       /*!< Thế hệ ảnh lúc dựng khung. */
+    uint8_t  frame[3 + MODBUS_READ_CACHE_MAX_REGS * 2 + 2];
+} ModbusReadCache;
+/**
+ * @brief Ngưỡng thời gian RTU của một tốc độ baud (us).
+ */
+typedef struct {
+    uint32_t baud;
+    uint16_t t15_us;               /*!< Khoảng lặng tối đa giữa 2 ký tự trong frame. */
+    uint16_t t35_us;               /*!< Khoảng lặng đánh dấu kết thúc frame. */
+} ModbusRtuTiming;
+/**
+ * @brief Kết luận của bộ phân tích frame RTU theo luồng byte.
+ */
+typedef enum {
+    MODBUS_RX_PENDING = 0,      /*!< Đang nhận, chưa đủ dữ liệu để kết luận. */
+    MODBUS_RX_FOREIGN,          /*!< Địa chỉ của slave khác: bỏ qua phần còn lại, không tính CRC. */
+    MODBUS_RX_COMPLETE,         /*!< Đủ độ dài và CRC đúng. */
+    MODBUS_RX_BAD_CRC,          /*!< Đủ độ dài nhưng sai CRC. */
+    MODBUS_RX_BAD_LENGTH,       /*!< Ngắn hơn độ dài suy ra từ FC/byte count, hoặc vượt bộ đệm. */
+    MODBUS_RX_BAD_TIMING        /*!< Im lặng giữa frame lớn hơn t1.5 (MODBUS_T15_STRICT = 1). */
+} ModbusRxVerdict;
+/**
+ * @brief Trạng thái phân tích frame đang nhận, được cập nhật ở mỗi sự kiện DMA HT/TC/IDLE.
+ *        Địa chỉ được kiểm tra ở byte 0, độ dài frame suy ra từ FC (và byte count của FC 0F/10),
+ *        CRC được tính dần nên khi frame đủ độ dài là biết ngay frame có hợp lệ không.
+ */
+typedef struct {
+    uint16_t            pos;        /*!< Số byte đã qua bộ phân tích (tính từ đầu frame). */
+    uint16_t            expected;   /*!< Độ dài frame dự kiến, 0 = chưa biết (FC không hỗ trợ). */
+    uint16_t            crc;        /*!< CRC tính dần, bằng 0 khi đã gồm cả 2 byte CRC của một frame đúng. */
+    uint16_t            dma_base;   /*!< Vị trí trong frame của đoạn DMA đang nhận. */
+    uint8_t             verdict;    /*!< ModbusRxVerdict. */
+    uint8_t             delivered;  /*!< Frame đã được giao xử lý (có thể trước IDLE). */
+    uint8_t             queued;     /*!< Frame đã được đưa vào slot chờ Modbus_Poll. */
+} ModbusRxParser;
 /**
  * @brief Cấu trúc chính quản lý toàn bộ trạng thái và dữ liệu của Modbus Slave.
  *        Mỗi instance UART Modbus sẽ cần một biến thuộc kiểu này.
@@ -103,23 +194,35 @@ typedef struct {
 
     IRQn_Type           uart_irqn; /*!< Số hiệu ngắt UART */
 
-#if MODBUS_PROCESS_IN_MAIN_LOOP == 1
-    /**
-     * @brief Cờ báo hiệu có frame Modbus chờ xử lý bởi Modbus_Poll().
-     *        Chỉ được sử dụng khi MODBUS_PROCESS_IN_MAIN_LOOP = 1.
-     *        volatile vì được ghi trong callback và đọc trong main loop.
-     */
-    volatile bool       frame_ready_for_processing;
-#endif
-
     volatile ModbusState state;     /*!< Trạng thái hoạt động hiện tại (volatile vì có thể thay đổi bởi interrupt/DMA). */
 
     /* --- Bộ đệm Nhận (Receive) --- */
-    uint8_t             rxBuffer[MODBUS_RX_BUFFER_SIZE]; /*!< Bộ đệm lưu trữ frame Modbus nhận được từ Master. */
-    volatile uint16_t   rxCount;    /*!< Số byte đã nhận được trong `rxBuffer` (volatile vì được cập nhật bởi DMA/Interrupt). */
+    /**
+     * @brief Bộ đệm đôi: DMA luôn ghi vào rxFrames[rx_dma_slot], slot còn lại giữ frame
+     *        đã nhận xong chờ xử lý (rx_slot_len != 0). ISR chỉ chụp frame, không xử lý.
+     */
+    uint8_t             rxFrames[MODBUS_RX_SLOTS][MODBUS_RX_BUFFER_SIZE];
+    volatile uint16_t   rx_slot_len[MODBUS_RX_SLOTS];   /*!< Độ dài frame chờ xử lý trong slot, 0 = slot trống. */
+    uint32_t            rx_slot_stamp[MODBUS_RX_SLOTS]; /*!< DWT->CYCCNT lúc chụp frame. */
+    volatile uint8_t    rx_dma_slot;                    /*!< Slot DMA đang ghi. */
+    uint8_t*            rxBuffer;   /*!< Trỏ tới frame đang được xử lý (một phần tử của rxFrames). */
+    volatile uint16_t   rxCount;    /*!< Số byte của frame đang được xử lý trong `rxBuffer`. */
+    uint32_t            rx_stamp;   /*!< DWT->CYCCNT lúc chụp frame đang được xử lý. */
+    ModbusRxParser      rx_parser;  /*!< Bộ phân tích frame đang nhận (chỉ dùng trong ngắt). */
+    volatile uint8_t    rx_line_busy;   /*!< 1 = frame đã giao sớm nhưng đường truyền chưa IDLE. */
+    volatile uint16_t   tx_pending_len; /*!< Phản hồi đã sẵn sàng, chờ IDLE mới phát (byte, gồm CRC). */
+    ModbusRtuTiming     timing;     /*!< Ngưỡng t1.5/t3.5 đang áp dụng theo huart->Init.BaudRate. */
+    uint16_t            rx_t15_pos; /*!< Vị trí trong frame lúc báo im lặng t1.5. */
+    uint8_t             slave_address;     /*!< Địa chỉ đang dùng, mặc định SLAVE_ADDRESS (đổi lúc chạy qua comm_settings). */
+    uint16_t            response_delay_us; /*!< Trễ thêm sau t3.5 trước khi phát phản hồi, tối đa 65535 us.
+                                                Chỉ có tác dụng khi MODBUS_RTU_TIMING = 1. */
+    volatile uint8_t    tx_delay_armed;    /*!< 1 = MODBUS_T35_TIM đang đếm trễ phản hồi thay vì t3.5. */
+
+    ModbusStats         stats;      /*!< Bộ đếm chẩn đoán độ trễ. */
 
     /* --- Bộ đệm Truyền (Transmit) --- */
     uint8_t             txBuffer[MODBUS_TX_BUFFER_SIZE]; /*!< Bộ đệm dùng để xây dựng frame phản hồi gửi cho Master. */
+    const uint8_t*      tx_ptr;     /*!< Frame DMA đang/sắp phát: txBuffer hoặc một khung trong read_cache. */
     // Không cần txCount vì độ dài được truyền trực tiếp vào hàm HAL_UART_Transmit_DMA.
 
     /* --- Modbus Data Maps (Slave Memory) --- */
@@ -147,6 +250,17 @@ typedef struct {
     uint16_t            holdingRegs[MAX_HOLDING_REGS];    /*!< Mảng lưu giá trị Holding Registers (16-bit/register). */
     uint16_t            inputRegs[MAX_INPUT_REGS];        /*!< Mảng lưu giá trị Input Registers (16-bit/register). */
 
+    /* --- Ảnh Big-Endian của các thanh ghi --- */
+    // Cập nhật cùng lúc với holdingRegs/inputRegs và chỉ khi giá trị đổi,
+    // FC03/FC04 chép thẳng ra khung phản hồi mà không phải đảo byte từng register.
+    uint8_t             holdingImage[MAX_HOLDING_REGS * 2];
+    uint8_t             inputImage[MAX_INPUT_REGS * 2];
+    volatile uint32_t   image_gen[2];  /*!< Thế hệ ảnh [0] holding, [1] input, tăng mỗi lần ảnh đổi (khác 0). */
+#if MODBUS_READ_CACHE_SLOTS > 0
+    ModbusReadCache     read_cache[MODBUS_READ_CACHE_SLOTS];
+    uint8_t             read_cache_next; /*!< Slot bị thay kế tiếp khi gặp cửa sổ mới. */
+#endif
+
 /*-----Trường hợp đặc biệt(có lệnh ghi khẩn cấp từ master)-----*/
     volatile uint8_t emergency_write_from_master;
     uint16_t holdingRegs_emergency_cpy[MAX_HOLDING_REGS];
@@ -179,13 +293,13 @@ HAL_StatusTypeDef Modbus_ReInit(ModbusHandle* modbus, UART_HandleTypeDef* huart,
 /**
  * @brief Hàm xử lý chính cho gói tin Modbus đã nhận được.
  * @param modbus Con trỏ tới cấu trúc ModbusHandle chứa dữ liệu trong `rxBuffer` và `rxCount`.
- * @note Hàm này **CHỈ** nên được gọi từ `Modbus_UartRxCpltCallback` sau khi nhận xong frame
- *       và nếu trạng thái Modbus đang là IDLE.
+ * @note Hàm này **CHỈ** nên được gọi với frame đã qua bộ phân tích trong `Modbus_UartRxCpltCallback`
+ *       (địa chỉ, độ dài và CRC16 đã được kiểm tra khi nhận).
  *       Nó thực hiện các bước:
  *       1. Kiểm tra độ dài tối thiểu.
- *       2. Kiểm tra địa chỉ Slave.
- *       3. Kiểm tra CRC16.
- *       4. Nếu hợp lệ, chuyển trạng thái sang PROCESSING.
+ *       2. Kiểm tra địa chỉ Slave, xác định broadcast.
+ *       3. (CRC16 đã được kiểm tra dần khi nhận.)
+ *       4. Chuyển trạng thái sang PROCESSING.
  *       5. Phân tích Function Code và các tham số.
  *       6. Gọi hàm xử lý (handler) tương ứng cho Function Code đó.
  *       7. Nếu không hợp lệ hoặc có lỗi, có thể không làm gì hoặc chuẩn bị gửi Exception Response.
@@ -209,11 +323,15 @@ void Modbus_ProcessData(ModbusHandle* modbus);
  * @param Size Số lượng byte thực sự đã nhận được trong frame vừa kết thúc.
  * @note Hàm này **PHẢI** được gọi từ bên trong callback `HAL_UARTEx_RxEventCallback` của HAL,
  *       sau khi kiểm tra đúng `huart` instance.
+ *       Được gọi ở cả sự kiện HT, TC và IDLE của DMA (Size tính từ đầu đoạn DMA hiện tại).
  *       Nó thực hiện:
- *       1. Cập nhật `modbus->rxCount` với `Size`.
- *       2. Nếu trạng thái đang là IDLE, gọi `Modbus_ProcessData` để xử lý frame.
- *       3. **QUAN TRỌNG:** Khởi động lại ngay lập tức việc nhận DMA (`HAL_UARTEx_ReceiveToIdle_DMA`)
- *          để sẵn sàng cho frame tiếp theo, bất kể frame hiện tại có hợp lệ hay không.
+ *       1. Đưa các byte mới qua bộ phân tích: loại frame khác địa chỉ ngay ở byte 0,
+ *          suy ra độ dài frame từ FC, tính CRC dần.
+ *       2. Frame đủ độ dài và đúng CRC được giao xử lý ngay, kể cả khi chưa có IDLE;
+ *          phản hồi khi đó được giữ lại và chỉ phát khi đường truyền IDLE.
+ *       3. **QUAN TRỌNG:** Hết frame (IDLE) thì khởi động lại ngay việc nhận DMA
+ *          (`HAL_UARTEx_ReceiveToIdle_DMA`) cho frame tiếp theo; hết đoạn DMA (TC) giữa frame
+ *          thì nhận tiếp vào phần còn lại của bộ đệm.
  */
 void Modbus_UartRxCpltCallback(ModbusHandle* modbus, uint16_t Size);
 
@@ -237,6 +355,52 @@ void Modbus_UartTxCpltCallback(ModbusHandle* modbus);
  */
 void Modbus_HAL_ErrorCallback(ModbusHandle* modbus, UART_HandleTypeDef* huart);
 
+/**
+ * @brief Áp dụng ngưỡng t1.5/t3.5 theo huart->Init.BaudRate (receiver timeout của USART và timer t3.5).
+ * @note  Được gọi trong Modbus_Init/ReInit, gọi lại sau khi đổi baud rate.
+ */
+void Modbus_ApplyTiming(ModbusHandle* modbus);
+
+/**
+ * @brief Xử lý cờ receiver timeout (im lặng t1.5) của USART Modbus.
+ * @note  **PHẢI** được gọi ở đầu USARTx_IRQHandler, TRƯỚC HAL_UART_IRQHandler
+ *        (HAL coi RTOF là lỗi và sẽ dừng DMA nếu còn thấy cờ này).
+ */
+void Modbus_UartIRQHandler(ModbusHandle* modbus);
+
+/**
+ * @brief Xử lý ngắt của MODBUS_T35_TIM (hết t3.5 = kết thúc frame).
+ * @note  Gọi từ TIMx_IRQHandler tương ứng.
+ */
+void Modbus_TimerIRQHandler(ModbusHandle* modbus);
+
+/**
+ * @brief Hàm __weak được gọi (trong ngắt) khi có frame mới chờ xử lý.
+ * @note  Ứng dụng ghi đè để đánh thức tác vụ gọi Modbus_Poll() (vd: Sched_Trigger).
+ */
+void Modbus_FrameReadyCallback(ModbusHandle* modbus);
+
+/**
+ * @brief Ghi một dải Holding Registers từ ứng dụng một cách nguyên tử.
+ * @param modbus Con trỏ tới ModbusHandle.
+ * @param start Địa chỉ register đầu tiên (tính từ 0).
+ * @param values Mảng giá trị nguồn.
+ * @param count Số register cần ghi.
+ * @note  Cả dải được chép trong một critical section ngắn nên Master không bao giờ
+ *        đọc được một bộ giá trị lẫn cũ và mới. Ảnh Big-Endian chỉ được ghi (và khung
+ *        FC03/FC04 dựng sẵn chỉ bị coi là cũ) khi có register đổi giá trị.
+ *        Không ghi thẳng vào holdingRegs: ảnh sẽ lệch với mảng và Master đọc được giá trị cũ.
+ * @return true nếu dải địa chỉ hợp lệ và đã được ghi.
+ */
+bool Modbus_PublishHoldingRegs(ModbusHandle* modbus, uint16_t start, const uint16_t* values, uint16_t count);
+
+/**
+ * @brief Dựng lại các khung FC03/FC04 đã cũ sau khi ảnh thanh ghi đổi.
+ * @note  Gọi từ vòng lặp chính sau Modbus_PublishHoldingRegs để lần đọc kế tiếp
+ *        của Master chỉ còn tra bảng và khởi động DMA.
+ */
+void Modbus_RefreshReadCache(ModbusHandle* modbus);
+
 
 /* Inline Critical Section Functions ---------------------------------------*/
 
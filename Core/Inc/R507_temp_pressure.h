@@ -32,7 +32,6 @@ static const R507_Point R507_TABLE[] = {
 // Kích thước bảng
 #define R507_TABLE_SIZE (sizeof(R507_TABLE) / sizeof(R507_TABLE[0]))
 
-// Hàm tra bảng
-float R507_GetTemperature(float pressure);
+// Tra bảng: xem refrigerant.h (REFRIGERANT_R507A)
 
 #endif /* INC_R507_TEMP_PRESSURE_H_ */
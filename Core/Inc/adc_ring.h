@@ -0,0 +1,70 @@
+/*
+ * adc_ring.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Thu ADC chạy tự do: timer phát TRGO kích một lượt quét 5 kênh theo chu kỳ cố định,
+ *  GPDMA (linked-list vòng) ghi liên tục vào bộ đệm vòng gồm 2 nửa, mỗi nửa nhiều lượt quét.
+ *  Ngắt HT/TC chỉ ghi nhận nửa vừa đầy (kèm dấu thời gian) rồi gọi ADC_Ring_BlockReadyCallback();
+ *  CPU không phải khởi động lại ADC sau mỗi lượt quét.
+ *  Một lượt quét (5 kênh x 247.5 chu kỳ x oversampling 8) mất ~330 us ở 32 MHz,
+ *  nên ADC_RING_SCAN_HZ không được vượt ~2.5 kHz.
+ */
+
+#ifndef INC_ADC_RING_H_
+#define INC_ADC_RING_H_
+#include "main.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define ADC_RING_CHANNELS         5       // Số rank của ADC1: VREFINT, hồi về, đầu đẩy, áp thấp, áp cao
+#define ADC_RING_SCANS_PER_HALF   8       // Số lượt quét trong một nửa bộ đệm (một khối)
+#define ADC_RING_SCAN_HZ          1000U   // Tần số lượt quét -> một khối mỗi 8 ms
+
+#define ADC_RING_TIM              TIM7    // Timer cơ bản chỉ dùng làm nguồn TRGO cho ADC
+#define ADC_RING_TIM_CLK_ENABLE() __HAL_RCC_TIM7_CLK_ENABLE()
+#define ADC_RING_TRIGGER          ADC_EXTERNALTRIG_T7_TRGO
+
+#define ADC_RING_LENGTH           (2U * ADC_RING_SCANS_PER_HALF * ADC_RING_CHANNELS)
+
+// Một nửa bộ đệm vừa được DMA ghi xong.
+typedef struct {
+    const uint16_t (*scans)[ADC_RING_CHANNELS]; // ADC_RING_SCANS_PER_HALF lượt quét, thứ tự kênh theo rank
+    uint32_t seq;         // Số thứ tự khối kể từ ADC_Ring_Start, bắt đầu từ 1
+    uint32_t first_scan;  // Chỉ số lượt quét đầu khối: thời điểm lấy mẫu = first_scan / ADC_RING_SCAN_HZ
+    uint32_t cycles;      // DWT->CYCCNT lúc ngắt HT/TC, dùng đo độ trễ xử lý
+} ADC_Ring_Block;
+
+typedef struct {
+    uint32_t blocks;      // Số khối DMA đã ghi xong
+    uint32_t missed;      // Khối bị ghi đè trước khi ADC_Ring_GetBlock lấy
+    uint32_t torn;        // Khối bị DMA ghi lại trong lúc đang xử lý (ADC_Ring_BlockValid trả về false)
+    uint32_t errors;      // HAL_ADC_ErrorCallback (overrun), chỉ thấy được khi ngắt ADC1 đang bật
+} ADC_Ring_Stats;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Cấu hình trigger timer + DMA vòng và bắt đầu thu. Gọi sau MX_ADC1_Init và hiệu chuẩn ADC.
+HAL_StatusTypeDef ADC_Ring_Start(ADC_HandleTypeDef* hadc);
+void ADC_Ring_Stop(ADC_HandleTypeDef* hadc);
+
+// Lấy khối mới nhất chưa xử lý. Trả về false nếu chưa có khối mới.
+bool ADC_Ring_GetBlock(ADC_Ring_Block* block);
+// Khối vẫn nguyên vẹn nếu DMA chưa quay lại ghi nửa đó. Gọi sau khi đã đọc xong dữ liệu.
+bool ADC_Ring_BlockValid(const ADC_Ring_Block* block);
+// Trung bình các lượt quét trong khối cho từng kênh (LSB, giữ phần lẻ).
+void ADC_Ring_Mean(const ADC_Ring_Block* block, float out[ADC_RING_CHANNELS]);
+const ADC_Ring_Stats* ADC_Ring_GetStats(void);
+
+/**
+ * @brief Hàm __weak được gọi (trong ngắt DMA) mỗi khi một nửa bộ đệm đầy.
+ * @note  Ứng dụng ghi đè để đánh thức tác vụ xử lý (vd: Sched_Trigger).
+ */
+void ADC_Ring_BlockReadyCallback(void);
+
+#endif /* INC_ADC_RING_H_ */
@@ -0,0 +1,65 @@
+/*
+ * adc_trip.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Đường bảo vệ nhanh bằng analog watchdog của ADC1, không chờ lọc Kalman và vòng lặp chính:
+ *  - AWD1 (12 bit, lọc 4 mẫu liên tiếp): áp suất cao.
+ *  - AWD2 (8 bit, bước 16 LSB): nhiệt độ đầu đẩy.
+ *  - AWD3 còn trống.
+ *  Ngưỡng ADC thô tính từ giới hạn kỹ thuật (bar, °C) qua bảng mô tả cảm biến (sensor_config.h).
+ *  Khi một mẫu vượt ngưỡng, ngắt ADC đưa hệ về trạng thái bảo vệ ngay (relay bật làm mát đầu đẩy,
+ *  dừng động cơ van) và khóa; ADC_Trip_Process() ở vòng lặp chính nhả khóa khi giá trị đường nhanh
+ *  xuống dưới giới hạn trừ độ trễ.
+ */
+
+#ifndef INC_ADC_TRIP_H_
+#define INC_ADC_TRIP_H_
+#include "main.h"
+#include "Modbus_Slave_Final.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define ADC_TRIP_HIGH_PRESSURE_BAR    27.0f   // Giới hạn áp suất cao (bar)
+#define ADC_TRIP_HIGH_PRESSURE_HYST   2.0f
+#define ADC_TRIP_DISCHARGE_TEMP_C     115.0f  // Giới hạn nhiệt độ đầu đẩy (°C)
+#define ADC_TRIP_DISCHARGE_TEMP_HYST  10.0f
+
+// Holding register công bố trạng thái (chỉ đọc)
+#define ADC_TRIP_REG                  50
+//   50: bit 0 = áp suất cao đang trip, bit 1 = nhiệt độ đầu đẩy đang trip
+//   51: số lần trip áp suất cao,        52-53: HAL_GetTick() lần trip gần nhất (word cao, word thấp)
+//   54: số lần trip nhiệt độ đầu đẩy,   55-56: HAL_GetTick() lần trip gần nhất (word cao, word thấp)
+//   57: ngưỡng ADC áp suất cao,         58: ngưỡng ADC nhiệt độ đầu đẩy
+#define ADC_TRIP_REG_COUNT            9
+
+typedef enum {
+    ADC_TRIP_HIGH_PRESSURE = 0,
+    ADC_TRIP_DISCHARGE_TEMP,
+    ADC_TRIP_COUNT
+} ADC_Trip_Id;
+
+typedef struct {
+    volatile uint32_t count;       // Số lần trip
+    volatile uint32_t last_tick;   // HAL_GetTick() lúc trip gần nhất
+    volatile uint8_t  active;      // 1 = đang giữ trạng thái bảo vệ
+    uint16_t          threshold;   // Ngưỡng ADC thô đang nạp
+} ADC_Trip_State;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Cấu hình AWD1/AWD2 và bật ngắt ADC1. Gọi sau hiệu chuẩn, trước ADC_Ring_Start.
+HAL_StatusTypeDef ADC_Trip_Init(ADC_HandleTypeDef* hadc);
+// Cập nhật ngưỡng theo vref đo được, nhả khóa khi đã an toàn. Gọi trước EEV_Control_Step.
+void ADC_Trip_Process(void);
+// Công bố trạng thái lên ADC_TRIP_REG..
+void ADC_Trip_Publish(ModbusHandle* modbus);
+bool ADC_Trip_Active(void);
+const ADC_Trip_State* ADC_Trip_GetState(ADC_Trip_Id id);
+
+#endif /* INC_ADC_TRIP_H_ */
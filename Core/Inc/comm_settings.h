@@ -0,0 +1,93 @@
+/*
+ * comm_settings.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Cấu hình truyền thông Modbus (địa chỉ, baud, parity, stop bit, trễ phản hồi) lưu trong EEPROM
+ *  và áp dụng lúc khởi động. Đổi cấu hình theo 2 pha để không mất liên lạc khi Master ghi sai:
+ *   1. Master ghi cấu hình mới vào COMM_REG_ADDRESS..COMM_REG_DELAY rồi ghi COMM_CMD_APPLY vào COMM_REG_CMD.
+ *      Slave phát phản hồi theo cấu hình cũ, sau đó chạy thử cấu hình mới (chưa lưu).
+ *   2. Master ghi COMM_CMD_CONFIRM theo cấu hình mới trong COMM_TRIAL_TIMEOUT_MS: cấu hình được lưu EEPROM.
+ *      Hết thời gian mà không có xác nhận (hoặc mất điện khi đang chạy thử): quay về cấu hình cũ.
+ *  EEPROM giữ 2 bản ghi luân phiên có số thứ tự và CRC, mất điện giữa lúc ghi vẫn còn bản cũ hợp lệ.
+ */
+
+#ifndef INC_COMM_SETTINGS_H_
+#define INC_COMM_SETTINGS_H_
+#include "Modbus_Slave_Final.h"
+#include "eeprom_final.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+// 2 bản ghi, mỗi bản nằm gọn trong 1 trang 32 byte của M24C64 (địa chỉ 0..3 là thông số làm mát).
+#define COMM_EEPROM_ADDR             0x0040
+#define COMM_EEPROM_SLOT_SIZE        32
+// Thời gian chạy thử cấu hình mới trước khi tự quay về cấu hình cũ.
+#define COMM_TRIAL_TIMEOUT_MS        30000U
+// Trễ phản hồi tối đa, giới hạn bởi timer 16 bit tick 1 us của MODBUS_T35_TIM.
+#define COMM_RESPONSE_DELAY_MAX_MS   50U
+
+// Cấu hình mặc định khi EEPROM chưa có bản ghi hợp lệ (trùng MX_USART1_UART_Init).
+#define COMM_DEFAULT_BAUD            9600U
+#define COMM_DEFAULT_PARITY          COMM_PARITY_NONE
+#define COMM_DEFAULT_STOP_BITS       1U
+
+/*=========================================================================
+    HOLDING REGISTERS
+    -----------------------------------------------------------------------*/
+#define COMM_REG_ADDRESS             40  // Địa chỉ Slave 1..247
+#define COMM_REG_BAUD                41  // Baud / 100 (96 = 9600, 1152 = 115200)
+#define COMM_REG_PARITY              42  // COMM_PARITY_x
+#define COMM_REG_STOP_BITS           43  // 1 hoặc 2
+#define COMM_REG_DELAY               44  // Trễ phản hồi (ms)
+#define COMM_REG_CMD                 45  // COMM_CMD_x, tự xóa về 0 sau khi xử lý
+#define COMM_REG_STATUS              46  // COMM_STATUS_x (chỉ đọc)
+#define COMM_REG_COUNT               7
+
+#define COMM_CMD_NONE                0
+#define COMM_CMD_APPLY               1   // Chạy thử cấu hình trong các thanh ghi 40..44
+#define COMM_CMD_CONFIRM             2   // Giữ cấu hình đang chạy thử và lưu EEPROM
+#define COMM_CMD_REVERT              3   // Bỏ cấu hình đang chạy thử ngay
+
+typedef enum {
+    COMM_PARITY_NONE = 0,
+    COMM_PARITY_ODD  = 1,
+    COMM_PARITY_EVEN = 2
+} CommParity;
+
+typedef enum {
+    COMM_STATUS_IDLE         = 0,
+    COMM_STATUS_TRIAL        = 1, // Đang chạy thử, chờ COMM_CMD_CONFIRM
+    COMM_STATUS_COMMITTED    = 2,
+    COMM_STATUS_REVERTED     = 3, // Hết thời gian chạy thử hoặc Master yêu cầu quay về
+    COMM_STATUS_REJECTED     = 4, // Giá trị ngoài phạm vi, không áp dụng
+    COMM_STATUS_EEPROM_ERROR = 5  // Đã xác nhận nhưng ghi EEPROM lỗi (vẫn chạy cấu hình mới tới khi reset)
+} CommStatus;
+
+typedef struct {
+    uint8_t  slave_address;      // 1..247
+    uint8_t  parity;             // CommParity
+    uint8_t  stop_bits;          // 1 hoặc 2
+    uint8_t  reserved;
+    uint32_t baud;               // Một trong các tốc độ của bảng t1.5/t3.5 Modbus
+    uint16_t response_delay_ms;  // 0..COMM_RESPONSE_DELAY_MAX_MS
+} CommSettings;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Đọc cấu hình từ EEPROM và áp dụng cho modbus. Gọi sau Modbus_Init.
+void CommSettings_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus);
+// Ghi baud/parity/stop bit đang dùng vào huart và khởi tạo lại UART.
+// Gọi sau MX_USART1_UART_Init() khi khởi động lại UART (hàm CubeMX luôn đặt 9600 8N1).
+void CommSettings_ConfigureUart(UART_HandleTypeDef* huart);
+// Xử lý lệnh của Master và thời gian chạy thử. Gọi định kỳ từ vòng lặp chính.
+void CommSettings_Process(void);
+// Cấu hình đang áp dụng (có thể là cấu hình đang chạy thử).
+const CommSettings* CommSettings_Current(void);
+
+#endif /* INC_COMM_SETTINGS_H_ */
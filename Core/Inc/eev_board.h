@@ -0,0 +1,42 @@
+/*
+ * eev_board.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Lớp vào/ra mỏng giữa logic điều khiển EEV (eev_control.c) và phần cứng.
+ *  Bản trên MCU nằm ở eev_board.c (gọi HAL). Muốn chạy logic điều khiển trên máy tính
+ *  chỉ cần cung cấp một eev_board.c khác với cùng các hàm dưới đây.
+ */
+
+#ifndef INC_EEV_BOARD_H_
+#define INC_EEV_BOARD_H_
+#include <stdint.h>
+
+typedef enum {
+    EEV_PIN_RESET = 0,
+    EEV_PIN_SET   = 1
+} EEV_PinState;
+
+// Thời gian hệ thống (ms), chạy tự do và tràn sau ~49 ngày.
+uint32_t EEV_Board_GetTick(void);
+// Bộ đếm chu kỳ CPU chạy tự do, dùng đo thời gian ngắt và độ trễ.
+uint32_t EEV_Board_GetCycles(void);
+uint32_t EEV_Board_CyclesToUs(uint32_t cycles);
+// Critical section ngắn (cấm ngắt), lồng nhau được: trả về trạng thái cũ để khôi phục.
+uint32_t EEV_Board_EnterCritical(void);
+void EEV_Board_ExitCritical(uint32_t state);
+
+// Tín hiệu RUN từ bộ điều khiển máy nén.
+EEV_PinState EEV_Board_ReadRun(void);
+// Tín hiệu RUN_Defrost (đang xả đá).
+EEV_PinState EEV_Board_ReadDefrost(void);
+
+// Relay điều khiển làm mát đầu đẩy: RESET = bật làm mát, SET = tắt.
+EEV_PinState EEV_Board_ReadRelay(void);
+void EEV_Board_WriteRelay(EEV_PinState state);
+
+// 1 = analog watchdog đang giữ relay/van ở trạng thái bảo vệ, logic điều khiển không được ghi đè.
+uint8_t EEV_Board_TripActive(void);
+
+#endif /* INC_EEV_BOARD_H_ */
@@ -0,0 +1,138 @@
+/*
+ * eev_control.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Logic điều khiển van tiết lưu điện tử (EEV): tính quá nhiệt, chọn setpoint theo áp suất cao,
+ *  máy trạng thái đóng/mở van và điều khiển relay làm mát đầu đẩy.
+ *
+ *  Mỗi van là một EEV_Axis (động cơ, PID, bộ gộp bước, máy trạng thái, vị trí lưu backup riêng),
+ *  một board điều khiển được EEV_AXIS_COUNT van. Các van dùng chung tín hiệu RUN/RUN_Defrost,
+ *  áp suất cao (chọn setpoint) và relay làm mát đầu đẩy của cùng một máy nén.
+ */
+
+#ifndef INC_EEV_CONTROL_H_
+#define INC_EEV_CONTROL_H_
+#include <stdint.h>
+#include "pid_ctrl.h"
+#include "stepper_v2.h"
+#include "step_aggregator.h"
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define EEV_AXIS_COUNT          1U      // Số van trên board, mỗi van một kênh so sánh của STEPPER_TIM
+#if EEV_AXIS_COUNT < 1U || EEV_AXIS_COUNT > STEPPER_MAX_AXES
+#error "EEV_AXIS_COUNT must be between 1 and STEPPER_MAX_AXES"
+#endif
+#define EEV_OVERDRIVE_STEPS     80      // Đóng quá thêm khi đóng về 0 để chắc chắn chạm đầu hành trình
+
+/*=========================================================================
+    HOLDING REGISTERS
+    -----------------------------------------------------------------------*/
+// Van i dùng khối EEV_AXIS_REG_BASE + i * EEV_AXIS_REG_STRIDE
+#define EEV_AXIS_REG_BASE       100
+#define EEV_AXIS_REG_STRIDE     10
+#define EEV_AXIS_REG_POSITION   0       // Vị trí (nửa bước), đọc
+#define EEV_AXIS_REG_PERCENT    1       // Độ mở x10 (%), đọc
+#define EEV_AXIS_REG_STATE      2       // SystemState, đọc
+#define EEV_AXIS_REG_SUPERHEAT  3       // Quá nhiệt x10 (có dấu), đọc
+#define EEV_AXIS_REG_SETPOINT   4       // Setpoint quá nhiệt x10, đọc
+#define EEV_AXIS_REG_OUTPUT     5       // Ngõ ra PID x100 (có dấu), đọc
+#define EEV_AXIS_REG_STROKE     6       // Hành trình van (nửa bước), ghi được khi van đứng yên
+#define EEV_AXIS_REG_RATE_OPEN  7       // Tốc độ mở lớn nhất (nửa bước/s), ghi được
+#define EEV_AXIS_REG_RATE_CLOSE 8       // Tốc độ đóng lớn nhất (nửa bước/s), ghi được
+#define EEV_AXIS_REG_ACCEL      9       // Gia tốc (nửa bước/s^2), ghi được
+
+// Các trạng thái của máy trạng thái van
+typedef enum {
+    STATE_INIT,         // Trạng thái khởi tạo ban đầu
+    STATE_CLOSING,      // Đóng van (500 bước)
+    STATE_OPENING,      // Mở van (250 bước)
+    STATE_CONTROL_EEV,  // Điều khiển PID sau khi chờ ổn định
+    STATE_IDLE_EEV      // Van đóng, chờ tín hiệu RUN
+} SystemState;
+
+// Ảnh chụp đầu vào của PID, bảo vệ bằng seqlock (xem eev_control.c)
+typedef struct {
+    float superheat;
+    float saturation;
+    float suction_temperature;
+    float low_pressure;
+} EEV_PidInput;
+
+// Nguồn tín hiệu và chân động cơ của một van
+typedef struct {
+    StepperPins pins;
+    const float* low_pressure;          // Áp suất hút (bar)
+    const float* suction_temperature;   // Nhiệt độ hơi về (°C)
+} EEV_AxisConfig;
+
+// Trạng thái của một van
+typedef struct {
+    uint8_t index;
+    Stepper motor;
+    PidCtrl pid;
+    StepAgg step_agg;                   // Gộp các lệnh bước giữa 2 lần động cơ chạy
+    const float* low_pressure;
+    const float* suction_temperature;
+    EEV_PidInput pid_input;
+    volatile uint32_t pid_input_seq;
+    volatile float saturation;
+    volatile float superheat;
+    volatile float output_pid;
+    float step_residual;                // Phần lẻ của số bước chưa ra được (|x| < 1)
+    SystemState state;
+    uint32_t timer;
+    uint8_t init_done;                  // Cờ đánh dấu đã hoàn thành khởi tạo
+    uint8_t check_run_defrost;
+    uint8_t position_known;             // 1 sau khi đóng về 0 hoặc khôi phục từ vùng backup: vị trí đáng lưu
+    // Đổi setpoint theo áp suất cao (convert_setpoint)
+    float last_setpoint;
+    uint8_t setpoint_waiting;
+    uint32_t setpoint_change_time;
+    uint8_t relay_last_state;           // Chờ 16 s sau khi tắt làm mát đầu đẩy mới chọn lại setpoint
+    uint8_t relay_waiting;
+    uint32_t relay_change_time;
+} EEV_Axis;
+
+extern EEV_Axis eev_axes[EEV_AXIS_COUNT];
+
+// Thời gian thực của đường PID: ngắt TIM2 chỉ đánh dấu đến hạn, PID chạy trong tác vụ
+typedef struct {
+    uint32_t isr_cycles_last;   // Thời gian chạy EEV_Control_TimerTick (chu kỳ CPU)
+    uint32_t isr_cycles_max;
+    uint32_t pid_runs;
+    uint32_t pid_missed;        // Tới hạn lần mới khi lần trước chưa chạy
+    uint32_t latency_us_last;   // Từ ngắt đến hạn tới lúc PID bắt đầu chạy
+    uint32_t latency_us_max;
+    uint32_t jitter_us_max;     // |khoảng cách 2 lần chạy PID - khoảng cách 2 lần đến hạn|
+} EEV_Control_Timing;
+
+// Ngưỡng bật/tắt làm mát đầu đẩy (°C), lưu trong EEPROM địa chỉ 0 và 2
+extern int16_t nhiet_do_bat_lam_mat;
+extern int16_t nhiet_do_tat_lam_mat;
+
+void superheat_value(EEV_Axis* ax);
+void control_stepper(EEV_Axis* ax);
+void convert_setpoint(EEV_Axis* ax);
+void control_EEV(EEV_Axis* ax);
+void lam_mat_dau_day(void);
+
+// Gán chân động cơ và nguồn tín hiệu cho van thứ axis, khởi tạo động cơ (trước PidConfig_Init).
+void EEV_Control_InitAxis(uint8_t axis, const EEV_AxisConfig* cfg);
+// Dừng và nhả cuộn dây mọi van (gọi được trong ngắt).
+void EEV_Control_StopAll(void);
+void EEV_Control_Step(void);
+void EEV_Control_TimerTick(void);
+// Một lần tính PID trên ảnh chụp đầu vào, gọi từ tác vụ khi EEV_Control_PidDueCallback báo.
+void EEV_Control_PidStep(void);
+// Gọi trong ngắt TIM2 mỗi khi PID đến hạn. Mặc định rỗng, ứng dụng ghi đè để đánh thức tác vụ.
+void EEV_Control_PidDueCallback(void);
+const EEV_Control_Timing* EEV_Control_GetTiming(void);
+// Cách gộp các lệnh bước của PID trước mỗi lần động cơ chạy.
+void EEV_Control_SetStepPolicy(StepAgg_Policy policy);
+StepAgg_Policy EEV_Control_GetStepPolicy(void);
+
+#endif /* INC_EEV_CONTROL_H_ */
@@ -0,0 +1,94 @@
+/*
+ * filter_bank.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bộ lọc nhiều kênh cập nhật trong một lượt: trạng thái lưu dạng struct-of-arrays (mỗi đại lượng
+ *  là một mảng theo kênh), kênh được gom theo loại lọc nên mỗi vòng lặp chỉ chạy một công thức.
+ *  Mỗi kênh chọn một bộ lọc chính (Kalman, EMA, biquad thông thấp hoặc không lọc) và có thể bật
+ *  thêm tầng trung vị FILTER_MEDIAN_N mẫu phía trước để loại gai nhiễu.
+ *  Đầu ra giữ nguyên độ phân giải (float), không cắt về uint16_t như SimpleKalmanFilter.
+ *
+ *  FILTER_BANK_FIXED_POINT = 1: tính bằng số nguyên (cho lõi không có FPU)
+ *  - Tín hiệu Q16.16 trong int32 (đơn vị = 1 LSB ADC), đủ cho ADC 12 bit.
+ *  - Hệ số EMA/Kalman Q15, hệ số biquad Q2.30, nhân tích lũy 64 bit.
+ */
+
+#ifndef INC_FILTER_BANK_H_
+#define INC_FILTER_BANK_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#ifndef FILTER_BANK_FIXED_POINT
+#define FILTER_BANK_FIXED_POINT   0
+#endif
+
+#define FILTER_BANK_MAX_CHANNELS  8
+#define FILTER_MEDIAN_N           5   // Số mẫu của tầng trung vị (lẻ)
+
+typedef enum {
+    FILTER_NONE = 0,   // Chỉ đi qua (có thể kèm trung vị)
+    FILTER_KALMAN,     // Kalman 1 chiều như SimpleKalmanFilter
+    FILTER_EMA,        // y += alpha * (x - y)
+    FILTER_BIQUAD      // Biquad thông thấp (RBJ), dạng direct form I
+} Filter_Type;
+
+#if FILTER_BANK_FIXED_POINT
+typedef int32_t filter_value_t;   // Q16.16
+#else
+typedef float   filter_value_t;
+#endif
+
+typedef struct {
+    uint8_t count;
+    uint8_t primed;                                   // 0 = mẫu đầu tiên chưa nạp vào trạng thái
+    uint8_t type[FILTER_BANK_MAX_CHANNELS];
+    uint8_t median[FILTER_BANK_MAX_CHANNELS];
+
+    // Danh sách kênh theo loại, dựng lại khi đổi cấu hình
+    uint8_t kalman_ch[FILTER_BANK_MAX_CHANNELS], n_kalman;
+    uint8_t ema_ch[FILTER_BANK_MAX_CHANNELS],    n_ema;
+    uint8_t biquad_ch[FILTER_BANK_MAX_CHANNELS], n_biquad;
+    uint8_t median_ch[FILTER_BANK_MAX_CHANNELS], n_median;
+
+    filter_value_t y[FILTER_BANK_MAX_CHANNELS];       // Đầu ra hiện tại
+
+    // Kalman: sai số đo r, sai số ước lượng p, nhiễu quá trình q
+    filter_value_t k_r[FILTER_BANK_MAX_CHANNELS];
+    filter_value_t k_p[FILTER_BANK_MAX_CHANNELS];
+    filter_value_t k_q[FILTER_BANK_MAX_CHANNELS];
+
+    // EMA
+    filter_value_t alpha[FILTER_BANK_MAX_CHANNELS];
+
+    // Biquad: y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2
+    filter_value_t b0[FILTER_BANK_MAX_CHANNELS], b1[FILTER_BANK_MAX_CHANNELS], b2[FILTER_BANK_MAX_CHANNELS];
+    filter_value_t a1[FILTER_BANK_MAX_CHANNELS], a2[FILTER_BANK_MAX_CHANNELS];
+    filter_value_t x1[FILTER_BANK_MAX_CHANNELS], x2[FILTER_BANK_MAX_CHANNELS], y2[FILTER_BANK_MAX_CHANNELS];
+
+    // Trung vị: lịch sử vòng, cùng vị trí ghi cho mọi kênh
+    filter_value_t hist[FILTER_MEDIAN_N][FILTER_BANK_MAX_CHANNELS];
+    uint8_t hist_pos;
+} FilterBank;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Mọi kênh mặc định FILTER_NONE, không trung vị.
+void FilterBank_Init(FilterBank* bank, uint8_t count);
+void FilterBank_SetNone(FilterBank* bank, uint8_t ch);
+void FilterBank_SetKalman(FilterBank* bank, uint8_t ch, float mea_e, float est_e, float q);
+void FilterBank_SetEMA(FilterBank* bank, uint8_t ch, float alpha);
+// Biquad thông thấp tần số cắt fc (Hz) ở tần số cập nhật fs (Hz), hệ số phẩm chất q (0.707 = Butterworth).
+void FilterBank_SetBiquadLowpass(FilterBank* bank, uint8_t ch, float fc, float fs, float q);
+void FilterBank_SetMedian(FilterBank* bank, uint8_t ch, bool enable);
+
+// Cập nhật mọi kênh với một mẫu mỗi kênh (in[0..count-1], đơn vị LSB ADC).
+void FilterBank_Update(FilterBank* bank, const float* in);
+float FilterBank_Output(const FilterBank* bank, uint8_t ch);
+
+#endif /* INC_FILTER_BANK_H_ */
@@ -0,0 +1,77 @@
+/*
+ * log_dma.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+
+#ifndef INC_LOG_DMA_H_
+#define INC_LOG_DMA_H_
+#include "stm32h5xx_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+// Kích thước vòng đệm log trong RAM (byte). BẮT BUỘC là lũy thừa của 2.
+#define LOG_RING_SIZE        2048
+// Độ dài tối đa của một bản ghi log đã định dạng (byte).
+#define LOG_LINE_MAX         128
+// Số byte tối đa gửi trong một lần DMA (giới hạn thời gian chiếm kênh DMA).
+#define LOG_DMA_CHUNK_MAX    256
+// Ngắt khởi động DMA log (bên ghi chỉ đặt cờ chờ). Phải cùng mức ưu tiên với ngắt DMA TX
+// của log (GPDMA1 Channel 3) và thấp hơn mọi ngắt có ghi log.
+#define LOG_IRQn             USART3_IRQn
+
+// Byte đồng bộ và kích thước phần đầu của bản ghi sự kiện nhị phân (xem Log_Event).
+#define LOG_EVENT_SYNC       0xA5
+#define LOG_EVENT_HDR_SIZE   8
+
+#if (LOG_RING_SIZE & (LOG_RING_SIZE - 1)) != 0
+#error "LOG_RING_SIZE must be a power of 2"
+#endif
+
+/*=========================================================================
+    STRUCTS
+    -----------------------------------------------------------------------*/
+/**
+ * @brief Trạng thái bộ ghi log bất đồng bộ.
+ *        - Bên ghi (producer): printLOGDATA/Log_Write, gọi được từ main loop và ngắt.
+ *          Giữ chỗ [reserve, reserve + len) trong critical section ngắn, chép khi ngắt vẫn bật,
+ *          rồi commit; bên ghi cuối cùng (writers về 0) dời head lên reserve. Không gọi HAL,
+ *          chỉ đặt cờ chờ cho LOG_IRQn.
+ *        - Bên đọc (consumer): DMA UART, chỉ được khởi động trong Log_IRQHandler hoặc callback
+ *          TxCplt/Error, cùng một mức ưu tiên nên không cần khóa.
+ *        head/reserve/tail là chỉ số chạy tự do (free-running), vị trí thực = chỉ số & (LOG_RING_SIZE - 1).
+ */
+typedef struct {
+    UART_HandleTypeDef *huart;           /*!< UART dùng để xuất log (USART3). */
+    uint8_t            ring[LOG_RING_SIZE];
+    volatile uint32_t  head;             /*!< Cuối vùng đã chép xong, DMA được gửi tới đây. */
+    volatile uint32_t  reserve;          /*!< Cuối vùng đã cấp cho bên ghi (>= head). */
+    volatile uint32_t  tail;             /*!< Vị trí byte cũ nhất chưa gửi xong (consumer). */
+    volatile uint8_t   writers;          /*!< Số bên ghi đang chép (lồng nhau khi ngắt chen vào). */
+    volatile uint16_t  tx_len;           /*!< Số byte đang được DMA gửi. */
+    volatile uint8_t   tx_busy;          /*!< 1 khi DMA đang truyền. */
+    /* --- Thống kê --- */
+    volatile uint32_t  dropped_records;  /*!< Số bản ghi bị bỏ do vòng đệm đầy. */
+    volatile uint32_t  dropped_bytes;    /*!< Tổng số byte bị bỏ do vòng đệm đầy. */
+    volatile uint32_t  max_used;         /*!< Mức chiếm dụng vòng đệm lớn nhất (byte). */
+    volatile uint32_t  tx_errors;        /*!< Số lần khởi động DMA lỗi hoặc UART báo lỗi. */
+} Log_HandleTypeDef;
+
+extern Log_HandleTypeDef hlog;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    =========================================================================*/
+void Log_Init(UART_HandleTypeDef *huart);
+bool Log_Write(const uint8_t *data, uint16_t len);
+void Log_Process(void);
+void Log_IRQHandler(void);
+void Log_TxCpltCallback(UART_HandleTypeDef *huart);
+void Log_ErrorCallback(UART_HandleTypeDef *huart);
+uint32_t Log_GetUsed(void);
+
+#endif /* INC_LOG_DMA_H_ */
@@ -0,0 +1,144 @@
+/*
+ * log_events.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bảng sự kiện log duy nhất cho firmware.
+ *  - Thứ tự dòng trong bảng = ID sự kiện trong bản ghi nhị phân.
+ *    CHỈ thêm dòng mới vào cuối mỗi nhóm dự trữ / cuối bảng, KHÔNG chèn hay xóa ở giữa,
+ *    nếu không tools/log_decode.py sẽ giải mã sai log của firmware cũ.
+ *  - tools/log_decode.py đọc trực tiếp file này, nên mỗi mục phải nằm trên MỘT dòng
+ *    dạng X(TEN_SU_KIEN, "chuoi dinh dang").
+ *  - Tham số chỉ được là số nguyên (tối đa LOG_EVENT_MAX_ARGS), không dùng %s / %f.
+ */
+
+#ifndef INC_LOG_EVENTS_H_
+#define INC_LOG_EVENTS_H_
+
+#define LOG_EVENT_TABLE(X) \
+    /* --- EEPROM: lỗi I2C --- */ \
+    X(EVT_EEPROM_I2C_WRITE_FAIL,     "[EEPROM] [WARN] I2C write op failed. Addr=0x%04X, HAL_Status=%d, I2C_Error=0x%lX, ErrCnt=%u\r\n") \
+    X(EVT_EEPROM_I2C_READ_FAIL,      "[EEPROM] [WARN] I2C read op failed. Addr=0x%04X, HAL_Status=%d, I2C_Error=0x%lX, ErrCnt=%u\r\n") \
+    X(EVT_EEPROM_NACK,               "[EEPROM] [ERROR] NACK received. EEPROM busy or not present. Addr=0x%04X\r\n") \
+    X(EVT_EEPROM_BERR,               "[EEPROM] [ERROR] I2C Bus Error (BERR) detected. Addr=0x%04X\r\n") \
+    X(EVT_EEPROM_ARLO,               "[EEPROM] [ERROR] I2C Arbitration Lost (ARLO) detected. Addr=0x%04X\r\n") \
+    X(EVT_EEPROM_OVR,                "[EEPROM] [ERROR] I2C Overrun/Underrun (OVR) detected. Addr=0x%04X\r\n") \
+    X(EVT_EEPROM_RESET_THRESHOLD,    "[EEPROM] [ERROR] I2C error threshold (%u) reached. Attempting I2C bus reset.\r\n") \
+    /* --- EEPROM: chờ chu trình ghi --- */ \
+    X(EVT_EEPROM_WAIT_WRITE,         "[EEPROM] [DEBUG] Waiting for EEPROM write completion...\r\n") \
+    X(EVT_EEPROM_WRITE_DONE,         "[EEPROM] [DEBUG] EEPROM write completed (ACK received).\r\n") \
+    X(EVT_EEPROM_WRITE_TIMEOUT,      "[EEPROM] [WARN] Timeout (%u ms) waiting for write completion. DevAddr=0x%02X\r\n") \
+    X(EVT_EEPROM_NOT_READY_RESET,    "[EEPROM] [CRITICAL] EEPROM not ready threshold reached after write. Attempting I2C bus reset.\r\n") \
+    /* --- EEPROM: khởi tạo --- */ \
+    X(EVT_EEPROM_INIT,               "[EEPROM] [INFO] Init: MaxAddr=0x%X, PageSize=%u, I2C_Addr7=0x%X, HAL_MemAddrSize=%uBIT.\r\n") \
+    X(EVT_EEPROM_INIT_OK,            "[EEPROM] [INFO] Init: Device detected. I2C_Addr8=0x%02X.\r\n") \
+    X(EVT_EEPROM_INIT_FAIL,          "[EEPROM] [ERROR] Init: Device not detected. I2C_Addr8=0x%02X, HAL_Status=%d.\r\n") \
+    X(EVT_EEPROM_READY_CHECK,        "[EEPROM] [INFO] IsDeviceReady: Checking. Addr8=0x%02X, Trials=%lu...\r\n") \
+    X(EVT_EEPROM_READY_OK,           "[EEPROM] [INFO] IsDeviceReady: Device is ready. Addr8=0x%02X.\r\n") \
+    X(EVT_EEPROM_READY_FAIL,         "[EEPROM] [WARN] IsDeviceReady: Device not ready. Addr8=0x%02X, HAL_Status=%d.\r\n") \
+    /* --- EEPROM: truy cập byte --- */ \
+    X(EVT_EEPROM_WRITEBYTE_OOR,      "[EEPROM] [ERROR] WriteByte: Address out of range. Addr=0x%04X, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_WRITEBYTE_START,    "[EEPROM] [DEBUG] WriteByte: Writing Data=0x%02X to Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_WRITEBYTE_FAIL,     "[EEPROM] [ERROR] WriteByte: HAL_I2C_Mem_Write failed. Addr=0x%04X, Data=0x%02X, Status=%d\r\n") \
+    X(EVT_EEPROM_WRITEBYTE_OK,       "[EEPROM] [DEBUG] WriteByte: Success. Addr=0x%04X, Data=0x%02X.\r\n") \
+    X(EVT_EEPROM_WRITEBYTE_NOT_READY,"[EEPROM] [WARN] WriteByte: Not ready after write. Addr=0x%04X, Data=0x%02X.\r\n") \
+    X(EVT_EEPROM_READBYTE_OOR,       "[EEPROM] [ERROR] ReadByte: Address out of range. Addr=0x%04X, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_READBYTE_START,     "[EEPROM] [DEBUG] ReadByte: Reading from Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_READBYTE_OK,        "[EEPROM] [DEBUG] ReadByte: Success. Addr=0x%04X, Data=0x%02X.\r\n") \
+    X(EVT_EEPROM_READBYTE_FAIL,      "[EEPROM] [ERROR] ReadByte: HAL_I2C_Mem_Read failed. Addr=0x%04X, Status=%d\r\n") \
+    /* --- EEPROM: truy cập buffer --- */ \
+    X(EVT_EEPROM_WRITEBUF_OOR,       "[EEPROM] [ERROR] WriteBuffer: Address range out of bounds. Addr=0x%04X, Len=%u, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_WRITEBUF_START,     "[EEPROM] [INFO] WriteBuffer: Writing %u bytes to Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_WRITEBUF_PAGE,      "[EEPROM] [DEBUG] WriteBuffer: Page write. Addr=0x%04X, Len=%u, PageOffset=%u\r\n") \
+    X(EVT_EEPROM_WRITEBUF_PAGE_FAIL, "[EEPROM] [ERROR] WriteBuffer: Page write failed during multi-byte op. Addr=0x%04X, Status=%d\r\n") \
+    X(EVT_EEPROM_WRITEBUF_NOT_READY, "[EEPROM] [ERROR] WriteBuffer: Not ready after page write. Addr=0x%04X.\r\n") \
+    X(EVT_EEPROM_WRITEBUF_OK,        "[EEPROM] [INFO] WriteBuffer: Success. %u bytes written to Addr=0x%04X.\r\n") \
+    X(EVT_EEPROM_READBUF_OOR,        "[EEPROM] [ERROR] ReadBuffer: Address range out of bounds. Addr=0x%04X, Len=%u, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_READBUF_START,      "[EEPROM] [INFO] ReadBuffer: Reading %u bytes from Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_READBUF_OK,         "[EEPROM] [INFO] ReadBuffer: Success. %u bytes read from Addr=0x%04X.\r\n") \
+    X(EVT_EEPROM_READBUF_FAIL,       "[EEPROM] [ERROR] ReadBuffer: Failed. Addr=0x%04X, Len=%u, Status=%d\r\n") \
+    /* --- EEPROM: kiểu 16-bit --- */ \
+    X(EVT_EEPROM_WRITEU16_OOR,       "[EEPROM] [ERROR] WriteUInt16: Address out of range for 2 bytes. Addr=0x%04X, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_WRITEU16_START,     "[EEPROM] [DEBUG] WriteUInt16: Writing Val=%u (0x%02X,0x%02X LSB-first) to Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_READU16_OOR,        "[EEPROM] [ERROR] ReadUInt16: Address out of range for 2 bytes. Addr=0x%04X, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_READU16_START,      "[EEPROM] [DEBUG] ReadUInt16: Reading from Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_READU16_OK,         "[EEPROM] [DEBUG] ReadUInt16: Success. Addr=0x%04X, Val=%u (0x%02X,0x%02X LSB-first).\r\n") \
+    X(EVT_EEPROM_WRITEI16_OOR,       "[EEPROM] [ERROR] WriteInt16: Address out of range for 2 bytes. Addr=0x%04X, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_WRITEI16_START,     "[EEPROM] [DEBUG] WriteInt16: Writing Val=%d (0x%02X,0x%02X LSB-first) to Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_READI16_OOR,        "[EEPROM] [ERROR] ReadInt16: Address out of range for 2 bytes. Addr=0x%04X, MaxAddr=0x%04X.\r\n") \
+    X(EVT_EEPROM_READI16_START,      "[EEPROM] [DEBUG] ReadInt16: Reading from Addr=0x%04X...\r\n") \
+    X(EVT_EEPROM_READI16_OK,         "[EEPROM] [DEBUG] ReadInt16: Success. Addr=0x%04X, Val=%d (0x%02X,0x%02X LSB-first).\r\n") \
+    /* --- EEPROM: xóa chip / reset bus --- */ \
+    X(EVT_EEPROM_ERASE_START,        "[EEPROM] [INFO] EraseChip: Starting chip erase. Value=0x%02X, MaxAddr=0x%04X, PageSize=%u.\r\n") \
+    X(EVT_EEPROM_ERASE_PAGE,         "[EEPROM] [DEBUG] EraseChip: Erasing page. Addr=0x%04lX, Len=%u, Val=0x%02X.\r\n") \
+    X(EVT_EEPROM_ERASE_PAGE_FAIL,    "[EEPROM] [ERROR] EraseChip: Page write failed. Addr=0x%04lX, Status=%d.\r\n") \
+    X(EVT_EEPROM_ERASE_OK,           "[EEPROM] [INFO] EraseChip: Chip erase completed successfully.\r\n") \
+    X(EVT_EEPROM_BUSRESET_NULL,      "[EEPROM] [ERROR] ResetI2CBus: Null pointer argument (dev or i2c_handle).\r\n") \
+    X(EVT_EEPROM_BUSRESET_START,     "[EEPROM] [INFO] ResetI2CBus: Attempting I2C peripheral reset for I2C_Addr8=0x%02X.\r\n") \
+    X(EVT_EEPROM_BUSRESET_DEINIT_FAIL,"[EEPROM] [ERROR] ResetI2CBus: HAL_I2C_DeInit failed.\r\n") \
+    X(EVT_EEPROM_BUSRESET_REINIT,    "[EEPROM] [INFO] ResetI2CBus: I2C peripheral re-initialized. Verifying device...\r\n") \
+    X(EVT_EEPROM_BUSRESET_OK,        "[EEPROM] [INFO] ResetI2CBus: EEPROM re-detected successfully. Addr8=0x%02X.\r\n") \
+    X(EVT_EEPROM_BUSRESET_FAIL,      "[EEPROM] [ERROR] ResetI2CBus: EEPROM still not detected after reset. Addr8=0x%02X, HAL_Status=%d.\r\n") \
+    /* --- Modbus --- */ \
+    X(EVT_MODBUS_CRC_ERROR,          "[MODBUS] [DEBUG] CRC mismatch. Len=%u, Rx=0x%04X, Calc=0x%04X\r\n") \
+    X(EVT_MODBUS_BUSY_DROP,          "[MODBUS] [WARN] Frame dropped, slave busy. State=%u, Len=%u\r\n") \
+    X(EVT_MODBUS_RX_RESTART_FAIL,    "[MODBUS] [ERROR] ReceiveToIdle_DMA restart failed. HAL_Status=%d\r\n") \
+    X(EVT_MODBUS_TX_START_FAIL,      "[MODBUS] [ERROR] Transmit_DMA failed. Len=%u\r\n") \
+    X(EVT_MODBUS_RESP_TOO_LONG,      "[MODBUS] [ERROR] Response too long. Len=%u\r\n") \
+    X(EVT_MODBUS_EXCEPTION,          "[MODBUS] [DEBUG] Exception response. FC=0x%02X, Code=%u\r\n") \
+    X(EVT_MODBUS_UART_ERROR,         "[MODBUS] [WARN] UART error. ErrorCode=0x%lX\r\n") \
+    /* --- Hệ thống --- */ \
+    X(EVT_SYS_UART_TIMEOUT,          "[WARN] [UART] Modbus timeout detected. Attempting UART DMA restart...\r\n") \
+    X(EVT_SYS_ADC_TIMEOUT,           "[WARN] [ADC] ADC timeout detected. Attempting ADC DMA restart...\r\n") \
+    /* --- Bộ lập lịch --- */ \
+    X(EVT_SCHED_OVERRUN,             "[SCHED] [WARN] Task %u overrun: %lu us > %lu us budget\r\n") \
+    X(EVT_MODBUS_CRC_SELFTEST_FAIL,  "[MODBUS] [ERROR] CRC backend %u self-test failed, using fallback\r\n") \
+    X(EVT_MODBUS_BAD_LENGTH,         "[MODBUS] [DEBUG] Frame length mismatch. Len=%u, Expected=%u\r\n") \
+    /* --- Cấu hình truyền thông --- */ \
+    X(EVT_COMM_LOADED,               "[COMM] [INFO] Settings slot %u seq %u: Addr=%u, Baud=%lu, Parity=%u, Stop=%u, Delay=%u ms\r\n") \
+    X(EVT_COMM_DEFAULTS,             "[COMM] [WARN] No valid settings in EEPROM, using defaults\r\n") \
+    X(EVT_COMM_REJECTED,             "[COMM] [WARN] Settings rejected: Addr=%u, Baud=%u00, Parity=%u, Stop=%u, Delay=%u ms\r\n") \
+    X(EVT_COMM_TRIAL,                "[COMM] [INFO] Trial settings: Addr=%u, Baud=%lu, Parity=%u, Stop=%u, Delay=%u ms\r\n") \
+    X(EVT_COMM_COMMIT,               "[COMM] [INFO] Settings committed to slot %u, seq %u\r\n") \
+    X(EVT_COMM_REVERT,               "[COMM] [WARN] Trial not confirmed, reverting to Addr=%u, Baud=%lu\r\n") \
+    X(EVT_COMM_SAVE_FAIL,            "[COMM] [ERROR] Saving settings to slot %u failed. Status=%d\r\n") \
+    /* --- Cảm biến --- */ \
+    X(EVT_NTC_BENCHMARK,             "[NTC] [INFO] Cycles per conversion: exact=%lu, table=%lu\r\n") \
+    /* --- Môi chất lạnh --- */ \
+    X(EVT_REFRIGERANT_SELECTED,      "[REFRIG] [INFO] Refrigerant %u selected\r\n") \
+    X(EVT_REFRIGERANT_APPROXIMATE,   "[REFRIG] [WARN] Refrigerant %u uses approximate saturation data\r\n") \
+    X(EVT_REFRIGERANT_INVALID,       "[REFRIG] [WARN] Invalid refrigerant %u requested, keeping %u\r\n") \
+    X(EVT_REFRIGERANT_SAVE_FAIL,     "[REFRIG] [ERROR] Saving refrigerant %u failed. Status=%d\r\n") \
+    /* --- Analog watchdog --- */ \
+    X(EVT_ADC_TRIP,                  "[TRIP] [WARN] Trip %u fired, count=%lu\r\n") \
+    X(EVT_ADC_TRIP_CLEAR,            "[TRIP] [INFO] Trip %u cleared\r\n") \
+    /* --- Mô tả cảm biến --- */ \
+    X(EVT_SENSOR_LOADED,             "[SENSOR] [INFO] Sensor descriptors loaded from EEPROM\r\n") \
+    X(EVT_SENSOR_DEFAULTS,           "[SENSOR] [WARN] No valid sensor descriptors, using defaults\r\n") \
+    X(EVT_SENSOR_APPLIED,            "[SENSOR] [INFO] Channel %u set to type %u\r\n") \
+    X(EVT_SENSOR_REJECTED,           "[SENSOR] [WARN] Invalid descriptor for channel %u rejected\r\n") \
+    X(EVT_SENSOR_SAVED,              "[SENSOR] [INFO] Sensor descriptors saved\r\n") \
+    X(EVT_SENSOR_SAVE_FAIL,          "[SENSOR] [ERROR] Saving sensor descriptors failed. Status=%d\r\n") \
+    /* --- Xử lý tín hiệu đa tốc độ --- */ \
+    X(EVT_PIPELINE_STAGE,            "[PIPE] [INFO] Stage %u: rate=%lu (0.01 Hz), latency=%lu (0.1 ms)\r\n") \
+    /* --- Hệ số PID --- */ \
+    X(EVT_PID_LOADED,                "[PID] [INFO] PID gains loaded from EEPROM\r\n") \
+    X(EVT_PID_DEFAULTS,              "[PID] [WARN] No valid PID gains, using defaults\r\n") \
+    X(EVT_PID_APPLIED,               "[PID] [INFO] Gains applied: Kp=%u (1e-4), Ti=%u (0.1 s), Td=%u (0.1 s)\r\n") \
+    X(EVT_PID_REJECTED,              "[PID] [WARN] Invalid PID gains rejected\r\n") \
+    X(EVT_PID_SAVED,                 "[PID] [INFO] PID gains saved\r\n") \
+    X(EVT_PID_SAVE_FAIL,             "[PID] [ERROR] Saving PID gains failed. Status=%d\r\n") \
+    X(EVT_PID_MODE,                  "[PID] [INFO] Mode set to %u (0 = auto, 1 = manual)\r\n") \
+    X(EVT_VALVE_RESUMED,             "[VALVE] [INFO] Axis %u: position %d phase %u restored from backup (resume %u)\r\n") \
+    X(EVT_VALVE_HOMING,              "[VALVE] [INFO] Axis %u: no trusted position in backup, homing\r\n") \
+    X(EVT_REFRIGERANT_NOT_ALLOWED,   "[REFRIG] [WARN] Refrigerant %u has only approximate data and is disabled, keeping %u\r\n")
+
+#define LOG_EVENT_ENUM(name, fmt) name,
+typedef enum {
+    LOG_EVENT_TABLE(LOG_EVENT_ENUM)
+    LOG_EVENT_COUNT
+} Log_EventId;
+#undef LOG_EVENT_ENUM
+
+#endif /* INC_LOG_EVENTS_H_ */
@@ -0,0 +1,94 @@
+/*
+ * log_level.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Lớp macro log có lọc mức tại thời điểm biên dịch.
+ *  - LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG(EVT_xxx, args...) với EVT_xxx lấy từ log_events.h.
+ *  - Mức bị tắt (cao hơn LOG_LEVEL) biên dịch thành ((void)0): không code, không chuỗi, không tính tham số.
+ *  - LOG_BINARY = 0: định dạng thành văn bản bằng printLOGDATA như trước.
+ *    LOG_BINARY = 1: chỉ gửi bản ghi nhị phân (ID + tham số), giải mã trên PC bằng tools/log_decode.py.
+ *  Cả hai macro có thể đặt từ Project Properties (-DLOG_LEVEL=2 -DLOG_BINARY=1).
+ */
+
+#ifndef INC_LOG_LEVEL_H_
+#define INC_LOG_LEVEL_H_
+#include <stdint.h>
+#include "log_events.h"
+
+/*=========================================================================
+    LOG LEVELS
+    -----------------------------------------------------------------------*/
+#define LOG_LEVEL_NONE   0
+#define LOG_LEVEL_ERROR  1
+#define LOG_LEVEL_WARN   2
+#define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+// Bản Debug giữ toàn bộ log, bản Release chỉ giữ WARN và ERROR.
+#ifndef LOG_LEVEL
+#ifdef DEBUG
+#define LOG_LEVEL        LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL        LOG_LEVEL_WARN
+#endif
+#endif
+
+#ifndef LOG_BINARY
+#define LOG_BINARY       0
+#endif
+
+// Số tham số tối đa của một sự kiện (mỗi tham số 4 byte trong bản ghi nhị phân).
+#define LOG_EVENT_MAX_ARGS  8
+
+/*=========================================================================
+    BACKEND
+    -----------------------------------------------------------------------*/
+#if LOG_BINARY
+void Log_Event(uint8_t level, uint16_t id, uint8_t argc, const uint32_t *argv);
+
+// Tham số được ép về uint32_t trong mảng tạm; phần tử 0 chỉ để cho phép gọi không tham số.
+#define LOG_ARGS_(...)    ((const uint32_t[]){0, ##__VA_ARGS__})
+#define LOG_NARGS_(...)   ((uint8_t)(sizeof(LOG_ARGS_(__VA_ARGS__)) / sizeof(uint32_t) - 1U))
+#define LOG_EMIT_(level, id, ...) \
+    Log_Event((level), (uint16_t)(id), LOG_NARGS_(__VA_ARGS__), LOG_ARGS_(__VA_ARGS__) + 1)
+#else
+extern void printLOGDATA(const char *format, ...);
+extern const char *const log_event_fmt[LOG_EVENT_COUNT];
+
+#define LOG_EMIT_(level, id, ...) \
+    printLOGDATA(log_event_fmt[(id)], ##__VA_ARGS__)
+#endif
+
+/*=========================================================================
+    MACROS
+    -----------------------------------------------------------------------*/
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(id, ...)  LOG_EMIT_(LOG_LEVEL_ERROR, id, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(id, ...)  ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(id, ...)   LOG_EMIT_(LOG_LEVEL_WARN, id, ##__VA_ARGS__)
+#else
+#define LOG_WARN(id, ...)   ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(id, ...)   LOG_EMIT_(LOG_LEVEL_INFO, id, ##__VA_ARGS__)
+#else
+#define LOG_INFO(id, ...)   ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(id, ...)  LOG_EMIT_(LOG_LEVEL_DEBUG, id, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(id, ...)  ((void)0)
+#endif
+
+#endif /* INC_LOG_LEVEL_H_ */
@@ -0,0 +1,72 @@
+/*
+ * modbus_crc.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bộ tính CRC16 Modbus RTU (đa thức 0x8005 đảo bit, khởi tạo 0xFFFF) với nhiều backend chọn lúc biên dịch:
+ *  - TABLE : bảng 256 phần tử, 1 byte/vòng (512 byte Flash).
+ *  - SLICE4: slicing-by-4, 4 byte/vòng (2 KB Flash).
+ *  - SLICE8: slicing-by-8, 8 byte/vòng (4 KB Flash).
+ *  - HW    : khối CRC phần cứng của STM32H5 (không cần bảng).
+ *  Mọi backend cho cùng kết quả, Modbus_CRC_SelfTest() kiểm tra điều này trên chip; nếu sai,
+ *  Modbus_CRC_UseFallback() chuyển sang bảng T0 (slicing) hoặc tính từng bit (TABLE/HW).
+ *  Có thể đặt từ Project Properties (-DMODBUS_CRC_BACKEND=2).
+ */
+
+#ifndef INC_MODBUS_CRC_H_
+#define INC_MODBUS_CRC_H_
+#include "stm32h5xx_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    BACKENDS
+    -----------------------------------------------------------------------*/
+#define MODBUS_CRC_BACKEND_TABLE   0
+#define MODBUS_CRC_BACKEND_SLICE4  1
+#define MODBUS_CRC_BACKEND_SLICE8  2
+#define MODBUS_CRC_BACKEND_HW      3
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+// Khung Modbus tối đa 256 byte: slicing-by-4 là điểm cân bằng giữa tốc độ và Flash.
+#ifndef MODBUS_CRC_BACKEND
+#define MODBUS_CRC_BACKEND         MODBUS_CRC_BACKEND_SLICE4
+#endif
+
+// Giá trị khởi tạo CRC16 Modbus, dùng làm tham số crc cho lần gọi Modbus_CRC16_Update đầu tiên.
+#define MODBUS_CRC_INIT            0xFFFFU
+
+// Số bảng tra cứu cần cho backend đã chọn.
+#if MODBUS_CRC_BACKEND == MODBUS_CRC_BACKEND_SLICE8
+#define MODBUS_CRC_TABLES          8
+#elif MODBUS_CRC_BACKEND == MODBUS_CRC_BACKEND_SLICE4
+#define MODBUS_CRC_TABLES          4
+#else
+#define MODBUS_CRC_TABLES          1
+#endif
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    =========================================================================*/
+void Modbus_CRC_Init(void);
+bool Modbus_CRC_SelfTest(void);
+void Modbus_CRC_UseFallback(void);
+
+/**
+ * @brief Tính tiếp CRC16 Modbus trên một đoạn dữ liệu (cho phép tính dần từng phần của frame).
+ * @param crc Giá trị CRC hiện tại (MODBUS_CRC_INIT cho đoạn đầu tiên).
+ * @return CRC sau khi xử lý thêm length byte. Byte thấp được gửi trước trên đường truyền.
+ */
+uint16_t Modbus_CRC16_Update(uint16_t crc, const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Tính CRC16 Modbus của cả một khung dữ liệu.
+ */
+static inline uint16_t Modbus_CRC16(const uint8_t* data, uint16_t length) {
+    return Modbus_CRC16_Update(MODBUS_CRC_INIT, data, length);
+}
+
+#endif /* INC_MODBUS_CRC_H_ */
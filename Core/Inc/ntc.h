@@ -0,0 +1,51 @@
+/*
+ * ntc.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Đổi mã ADC của cảm biến NTC sang nhiệt độ bằng bảng tra + nội suy tuyến tính,
+ *  thay cho Steinhart-Hart với log()/pow() double (chạy soft-float trên Cortex-M33).
+ *  Bảng nằm trong Core/Src/ntc_tables.c, sinh bởi tools/ntc_table_gen.py từ hệ số A/B/C
+ *  (hoặc R25/Beta) và điện trở phân áp. Script kiểm tra sai số nội suy <= 0.1 °C trong -40..125 °C.
+ */
+
+#ifndef INC_NTC_H_
+#define INC_NTC_H_
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+// 1 = NTC_Benchmark() đo số chu kỳ CPU của công thức chính xác và của bảng tra rồi log ra.
+#ifndef NTC_BENCHMARK
+#define NTC_BENCHMARK      0
+#endif
+
+#define NTC_ADC_BITS       12
+#define NTC_TABLE_SHIFT    4   // Khoảng cách điểm bảng = 16 mã ADC, phải trùng TABLE_SHIFT của script
+#define NTC_TABLE_SIZE     ((1 << (NTC_ADC_BITS - NTC_TABLE_SHIFT)) + 1)
+
+typedef struct {
+    const int16_t* table;     // Nhiệt độ (0.01 °C) tại mã ADC i << NTC_TABLE_SHIFT, bão hòa -100..300 °C
+    float a, b, c;            // Hệ số Steinhart-Hart tương đương, chỉ dùng cho NTC_TemperatureExact
+    float series_resistor;    // Điện trở phân áp (ohm)
+} NTC_Curve;
+
+// Các đường cong có sẵn (ntc_tables.c)
+extern const NTC_Curve ntc_curve_10k_sh;
+extern const NTC_Curve ntc_curve_10k_b3435;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Nhiệt độ (°C) bằng bảng tra, vài chục chu kỳ CPU. adc là mã ADC đã lọc, có thể có phần lẻ.
+float NTC_Temperature(const NTC_Curve* curve, float adc);
+// Nhiệt độ (°C) theo công thức Steinhart-Hart, dùng để đối chiếu.
+float NTC_TemperatureExact(const NTC_Curve* curve, uint16_t adc);
+#if NTC_BENCHMARK
+// Đo trung bình chu kỳ/lần đổi của 2 cách trên dải ADC và log EVT_NTC_BENCHMARK.
+void NTC_Benchmark(const NTC_Curve* curve);
+#endif
+
+#endif /* INC_NTC_H_ */
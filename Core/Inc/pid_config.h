@@ -0,0 +1,65 @@
+/*
+ * pid_config.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Hệ số PID quá nhiệt chỉnh được qua Modbus lúc đang chạy và lưu trong EEPROM.
+ *  Ghi các thanh ghi PID_REG_KP..PID_REG_TT rồi ghi PID_CMD_APPLY: hệ số đổi ngay, không giật ngõ ra.
+ *  PID_CMD_SAVE lưu hệ số đang dùng. Chế độ tay/tự động và ngõ ra tay áp dụng ngay khi ghi, không lưu.
+ *  Board nhiều van: một bộ hệ số, chế độ và ngõ ra tay dùng chung cho PID của mọi van.
+ */
+
+#ifndef INC_PID_CONFIG_H_
+#define INC_PID_CONFIG_H_
+#include "pid_ctrl.h"
+#include "Modbus_Slave_Final.h"
+#include "eeprom_final.h"
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define PID_EEPROM_ADDR         0x0200  // Một bản ghi có CRC
+#define PID_SAMPLE_TIME         0.12f   // 3 tick TIM2 x 40 ms (EEV_PID_TICKS)
+#define PID_OUTPUT_LIMIT        60.0f   // |ngõ ra| lớn nhất, x5 = số bước mỗi chu kỳ
+#define PID_DEFAULT_SETPOINT    11.0f   // Quá nhiệt đặt lúc khởi động, convert_setpoint() đổi sau đó
+
+/*=========================================================================
+    HOLDING REGISTERS
+    -----------------------------------------------------------------------*/
+#define PID_REG_KP              80  // x10000
+#define PID_REG_TI              81  // x10 (s), 0 = tắt tích phân
+#define PID_REG_TD              82  // x10 (s), 0 = tắt vi phân
+#define PID_REG_N               83  // Hệ số lọc vi phân
+#define PID_REG_B               84  // x100
+#define PID_REG_TT              85  // x10 (s), 0 = tự chọn
+#define PID_REG_MODE            86  // PidCtrl_Mode
+#define PID_REG_MANUAL          87  // Ngõ ra tay x100, có dấu
+#define PID_REG_CMD             88  // PID_CMD_x, tự xóa về 0 sau khi xử lý
+#define PID_REG_STATUS          89  // PID_STATUS_x (chỉ đọc)
+#define PID_REG_COUNT           10
+
+#define PID_CMD_NONE            0
+#define PID_CMD_APPLY           1   // Áp dụng hệ số 80..85
+#define PID_CMD_SAVE            2   // Lưu hệ số đang dùng vào EEPROM
+#define PID_CMD_DEFAULTS        3   // Về hệ số mặc định (chưa lưu)
+
+typedef enum {
+    PID_STATUS_IDLE         = 0,
+    PID_STATUS_APPLIED      = 1,
+    PID_STATUS_SAVED        = 2,
+    PID_STATUS_REJECTED     = 3,
+    PID_STATUS_EEPROM_ERROR = 4
+} Pid_Status;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Đọc hệ số từ EEPROM (mặc định nếu chưa có hoặc hỏng) và khởi tạo count bộ PID trong pids.
+// Mảng pids phải tồn tại suốt chương trình.
+void PidConfig_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus, PidCtrl* const* pids, uint8_t count);
+// Xử lý lệnh và chế độ tay/tự động của Master. Gọi định kỳ từ vòng lặp chính.
+void PidConfig_Process(void);
+
+#endif /* INC_PID_CONFIG_H_ */
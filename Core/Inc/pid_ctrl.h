@@ -0,0 +1,69 @@
+/*
+ * pid_ctrl.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bộ PID dạng ISA rời rạc, không phụ thuộc HAL (biên dịch được trên máy tính):
+ *    u = Kp * (b * r - y) + I + D
+ *  - P có trọng số setpoint b (b < 1 giảm vọt lố khi setpoint đổi bậc).
+ *  - D lấy vi phân của giá trị đo (không của sai số) qua bộ lọc bậc 1 Tf = Td / N:
+ *    setpoint đổi bậc không tạo xung vi phân, nhiễu cao tần bị chặn ở N lần Kp.
+ *  - I chống bão hòa bằng tính ngược (back-calculation): phần bị cắt (u_sat - u) kéo tích phân
+ *    về với hằng số thời gian Tt. Giới hạn truyền vào mỗi lần tính nên gắn được với giới hạn thật
+ *    của cơ cấu chấp hành (van đã đóng/mở hết).
+ *  - Chuyển tay/tự động, đổi hệ số, bám theo ngõ ra bên ngoài đều không giật (bumpless):
+ *    tích phân được đặt lại sao cho ngõ ra liên tục.
+ */
+
+#ifndef INC_PID_CTRL_H_
+#define INC_PID_CTRL_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    float kp;        // Hệ số tỷ lệ
+    float ti;        // Thời gian tích phân (s), 0 = không tích phân
+    float td;        // Thời gian vi phân (s), 0 = không vi phân
+    float n;         // Hệ số lọc vi phân: Tf = Td / N (thường 5..20)
+    float b;         // Trọng số setpoint của P (0..1)
+    float tt;        // Hằng số thời gian chống bão hòa (s), 0 = tự chọn sqrt(Ti * Td) hoặc Ti
+} PidCtrl_Gains;
+
+typedef enum {
+    PID_MODE_AUTO = 0,
+    PID_MODE_MANUAL
+} PidCtrl_Mode;
+
+typedef struct {
+    PidCtrl_Gains gains;
+    float setpoint;     // Giá trị đặt
+    float T;            // Chu kỳ lấy mẫu (s)
+    float out_min;      // Giới hạn ngõ ra cố định
+    float out_max;
+    PidCtrl_Mode mode;
+    float manual_output;
+
+    /* --- Trạng thái --- */
+    float integral;     // Thành phần I (đã nhân hệ số)
+    float derivative;   // Thành phần D sau lọc
+    float prev_measurement;
+    float output;       // Ngõ ra lần gần nhất (đã giới hạn)
+    uint8_t primed;     // 0 = chưa có giá trị đo trước, bỏ qua D ở lần đầu
+} PidCtrl;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+void PidCtrl_Init(PidCtrl* pid, const PidCtrl_Gains* gains, float T, float setpoint, float out_min, float out_max);
+// Đổi hệ số không giật: tích phân bù phần P thay đổi.
+void PidCtrl_SetGains(PidCtrl* pid, const PidCtrl_Gains* gains);
+// Đổi chế độ không giật: sang tay giữ ngõ ra hiện tại nếu chưa đặt, về tự động bắt đầu từ ngõ ra tay.
+void PidCtrl_SetMode(PidCtrl* pid, PidCtrl_Mode mode);
+void PidCtrl_SetManualOutput(PidCtrl* pid, float output);
+// Ngõ ra đang do bên ngoài quyết định (value): trạng thái bám theo để lúc nhả không giật.
+float PidCtrl_Track(PidCtrl* pid, float measurement, float value);
+// Một lần tính. lo/hi: giới hạn hiệu lực của lần này (giao với out_min/out_max).
+float PidCtrl_Update(PidCtrl* pid, float measurement, float lo, float hi);
+
+#endif /* INC_PID_CTRL_H_ */
@@ -0,0 +1,95 @@
+/*
+ * refrigerant.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Tra áp suất - nhiệt độ bão hòa cho nhiều môi chất lạnh, chọn lúc chạy qua Modbus.
+ *  - R507A dùng bảng gốc trong R507_temp_pressure.h.
+ *  - Các môi chất khác nằm trong Core/Src/refrigerant_tables.c, sinh bởi tools/refrigerant_table_gen.py.
+ *  Hỗn hợp zeotropic (R404A, R448A, R449A) có 2 đường: sôi (bubble) và sương (dew).
+ *  Quá nhiệt tính theo đường sương; với đơn chất/đẳng phí 2 đường là một.
+ *  Mọi bảng dùng chung một bộ tra: lưới chỉ mục đều dựng lúc chọn môi chất, mỗi lần tra
+ *  chỉ còn 1 phép nhân + 1-2 phép so sánh rồi nội suy tuyến tính.
+ */
+
+#ifndef INC_REFRIGERANT_H_
+#define INC_REFRIGERANT_H_
+#include "Modbus_Slave_Final.h"
+#include "eeprom_final.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define REFRIGERANT_REG             47      // Holding register chọn môi chất (Refrigerant_Id)
+#define REFRIGERANT_EEPROM_ADDR     0x0080  // id (2 byte) + bù 1 của id (2 byte)
+#define REFRIGERANT_DEFAULT         REFRIGERANT_R507A
+
+// 1 = cho phép chọn môi chất có dữ liệu gần đúng (approximate = 1, chỉ dùng thử nghiệm).
+// 0 = Refrigerant_Select từ chối các môi chất đó, ô EEPROM trỏ tới chúng quay về REFRIGERANT_DEFAULT.
+#ifndef REFRIGERANT_ALLOW_APPROXIMATE
+#define REFRIGERANT_ALLOW_APPROXIMATE   0
+#endif
+
+// Số ô lưới chỉ mục cho mỗi chiều tra (RAM: 2 đường x (P + T) byte)
+#define REFRIGERANT_P_INDEX_SIZE    384
+#define REFRIGERANT_T_INDEX_SIZE    160
+
+typedef enum {
+    REFRIGERANT_R507A = 0,
+    REFRIGERANT_R404A = 1,
+    REFRIGERANT_R134A = 2,
+    REFRIGERANT_R448A = 3,
+    REFRIGERANT_R449A = 4,
+    REFRIGERANT_R290  = 5,
+    REFRIGERANT_COUNT
+} Refrigerant_Id;
+
+// Một đường bão hòa: 2 cột float tăng dần trong cùng một mảng điểm (tối đa 256 điểm).
+typedef struct {
+    const float* pressure;     // bar tương đối
+    const float* temperature;  // °C
+    uint16_t     stride;       // Số float giữa 2 điểm liên tiếp
+    uint16_t     count;
+} Refrigerant_Curve;
+
+// Đường từ mảng float[][2] dạng {áp suất, nhiệt độ}
+#define REFRIGERANT_CURVE(points) \
+    { &(points)[0][0], &(points)[0][1], 2, (uint16_t)(sizeof(points) / sizeof((points)[0])) }
+
+typedef struct {
+    const char*       name;
+    Refrigerant_Curve bubble;
+    Refrigerant_Curve dew;
+    uint8_t           approximate;  // 1 = dữ liệu gần đúng, chưa đối chiếu dữ liệu chuẩn
+} Refrigerant_Info;
+
+// Bảng sinh tự động (refrigerant_tables.c)
+extern const Refrigerant_Info refrigerant_r404a;
+extern const Refrigerant_Info refrigerant_r134a;
+extern const Refrigerant_Info refrigerant_r448a;
+extern const Refrigerant_Info refrigerant_r449a;
+extern const Refrigerant_Info refrigerant_r290;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Đọc môi chất đã lưu trong EEPROM (mặc định R507A) và công bố lên REFRIGERANT_REG.
+void Refrigerant_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus);
+// Chọn môi chất và dựng lưới chỉ mục. Không lưu EEPROM.
+// Trả về false nếu id không hợp lệ hoặc là dữ liệu gần đúng khi REFRIGERANT_ALLOW_APPROXIMATE = 0.
+bool Refrigerant_Select(Refrigerant_Id id);
+// Xử lý Master ghi REFRIGERANT_REG: chọn, lưu EEPROM, hoặc trả lại giá trị cũ nếu không hợp lệ.
+void Refrigerant_Process(void);
+Refrigerant_Id Refrigerant_Active(void);
+
+// Nhiệt độ bão hòa (°C) theo áp suất (bar), ngoài bảng thì trả về điểm đầu/cuối.
+float Refrigerant_DewTemperature(float pressure);
+float Refrigerant_BubbleTemperature(float pressure);
+// Áp suất bão hòa (bar) theo nhiệt độ (°C), ngoài bảng thì trả về điểm đầu/cuối.
+float Refrigerant_DewPressure(float temperature);
+float Refrigerant_BubblePressure(float temperature);
+
+#endif /* INC_REFRIGERANT_H_ */
@@ -0,0 +1,68 @@
+/*
+ * scheduler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bộ lập lịch hợp tác (cooperative) dựa trên tick 1 ms của HAL.
+ *  - Mỗi tác vụ có chu kỳ (period_ms) hoặc chỉ chạy khi được kích hoạt (period_ms = 0, Sched_Trigger).
+ *  - Thời gian thực thi được đo bằng bộ đếm chu kỳ DWT, so với ngân sách deadline_us.
+ *  - Khi không còn tác vụ nào đến hạn, CPU ngủ bằng WFI cho tới ngắt kế tiếp (SysTick, UART, DMA, TIM2...).
+ *  Tác vụ KHÔNG được chặn lâu: mọi vòng chờ phải dựa trên HAL_GetTick và trả quyền điều khiển ngay.
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+#include "stm32h5xx_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+// 1: ngủ WFI giữa các tick. Đặt 0 nếu cần debug bằng probe không hỗ trợ sleep.
+#define SCHED_USE_WFI        1
+// Số tác vụ tối đa (giới hạn bởi kiểu uint8_t của chỉ số tác vụ).
+#define SCHED_MAX_TASKS      16
+
+/*=========================================================================
+    STRUCTS
+    -----------------------------------------------------------------------*/
+typedef void (*Sched_TaskFn)(void);
+
+/**
+ * @brief Mô tả và thống kê của một tác vụ.
+ *        Người dùng chỉ khai báo func/period_ms/deadline_us, phần còn lại do bộ lập lịch quản lý.
+ */
+typedef struct {
+    Sched_TaskFn      func;          /*!< Hàm tác vụ, phải chạy xong và trả về nhanh. */
+    uint32_t          period_ms;     /*!< Chu kỳ chạy (ms). 0 = chỉ chạy khi được Sched_Trigger. */
+    uint32_t          deadline_us;   /*!< Ngân sách thời gian thực thi (us). 0 = không kiểm tra. */
+    /* --- Trạng thái nội bộ --- */
+    uint32_t          next_run;      /*!< Tick (ms) đến hạn tiếp theo. */
+    volatile uint8_t  pending;       /*!< Cờ kích hoạt, được set từ ngắt bằng Sched_Trigger. */
+    /* --- Thống kê --- */
+    uint32_t          runs;          /*!< Số lần đã chạy. */
+    uint32_t          last_cycles;   /*!< Thời gian chạy lần gần nhất (chu kỳ CPU). */
+    uint32_t          wcet_cycles;   /*!< Thời gian chạy lớn nhất đo được (chu kỳ CPU). */
+    uint32_t          overruns;      /*!< Số lần vượt deadline_us. */
+    uint32_t          late_count;    /*!< Số lần bắt đầu trễ hơn một chu kỳ (bị tác vụ khác chiếm). */
+    uint32_t          max_late_ms;   /*!< Độ trễ bắt đầu lớn nhất (ms). */
+} Sched_Task;
+
+typedef struct {
+    Sched_Task       *tasks;
+    uint8_t           count;
+    uint32_t          cycles_per_us; /*!< Tính từ SystemCoreClock khi khởi tạo. */
+    uint32_t          sleep_count;   /*!< Số lần vào WFI. */
+} Sched_HandleTypeDef;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    =========================================================================*/
+void Sched_Init(Sched_HandleTypeDef *sched, Sched_Task *tasks, uint8_t count);
+void Sched_Run(Sched_HandleTypeDef *sched);
+void Sched_Trigger(Sched_HandleTypeDef *sched, uint8_t task_id);
+uint32_t Sched_CyclesToUs(const Sched_HandleTypeDef *sched, uint32_t cycles);
+
+#endif /* INC_SCHEDULER_H_ */
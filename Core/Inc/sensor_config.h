@@ -0,0 +1,115 @@
+/*
+ * sensor_config.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bảng mô tả đầu vào cảm biến theo kênh ADC (loại, dải đo, shunt/phân áp, hiệu chuẩn, bộ lọc),
+ *  lưu trong EEPROM và đọc lúc khởi động. Thay cảm biến ngoài hiện trường chỉ cần đổi cấu hình.
+ *  Cảm biến tuyến tính (4-20 mA, điện áp 0.5-4.5 V) được gộp sẵn thành một biến đổi
+ *      giá trị = adc * k + c       (k đã nhân vref, cập nhật một lần mỗi khối ADC)
+ *  nên đường nóng chỉ còn một phép nhân-cộng mỗi kênh. NTC tra bảng rồi mới hiệu chuẩn.
+ *
+ *  Đổi cấu hình qua Modbus (SENSOR_REG_CHANNEL..SENSOR_REG_STATUS):
+ *   1. Ghi số kênh vào SENSOR_REG_CHANNEL, ghi SENSOR_CMD_LOAD: mô tả hiện tại của kênh hiện lên các thanh ghi.
+ *   2. Sửa các thanh ghi, ghi SENSOR_CMD_APPLY: kiểm tra và áp dụng ngay (chưa lưu).
+ *   3. Ghi SENSOR_CMD_SAVE: lưu cả bảng vào EEPROM.
+ */
+
+#ifndef INC_SENSOR_CONFIG_H_
+#define INC_SENSOR_CONFIG_H_
+#include "Input_parameters.h"
+#include "Modbus_Slave_Final.h"
+#include "eeprom_final.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define SENSOR_EEPROM_ADDR          0x0100  // Một bản ghi có CRC, 0x0100..0x01FF
+#define SENSOR_VREF_NOMINAL         3.3f    // Dùng khi chưa đo được vref
+
+typedef enum {
+    SENSOR_TYPE_NONE = 0,      // Giữ nguyên mã ADC (LSB)
+    SENSOR_TYPE_VREFINT,       // Kênh VREFINT, dùng để tính vref
+    SENSOR_TYPE_CURRENT,       // Vòng dòng (4-20 mA) qua điện trở shunt
+    SENSOR_TYPE_VOLTAGE,       // Ngõ ra áp (0.5-4.5 V) qua cầu phân áp
+    SENSOR_TYPE_NTC,           // NTC với điện trở phân áp, tra bảng ntc.h
+    SENSOR_TYPE_COUNT
+} Sensor_Type;
+
+typedef enum {
+    SENSOR_NTC_10K_SH = 0,     // ntc_curve_10k_sh
+    SENSOR_NTC_10K_B3435,      // ntc_curve_10k_b3435
+    SENSOR_NTC_COUNT
+} Sensor_NtcCurve;
+
+typedef struct {
+    uint8_t type;              // Sensor_Type
+    uint8_t filter;            // Filter_Type
+    uint8_t median;            // 1 = thêm tầng trung vị trước bộ lọc
+    uint8_t ntc_curve;         // Sensor_NtcCurve (chỉ SENSOR_TYPE_NTC)
+    float   signal_lo;         // mA hoặc V tại range_lo
+    float   signal_hi;         // mA hoặc V tại range_hi
+    float   range_lo;          // Đơn vị kỹ thuật (bar)
+    float   range_hi;
+    float   front_end;         // CURRENT: điện trở shunt (ohm); VOLTAGE: hệ số phân áp (V cảm biến / V chân ADC)
+    float   cal_gain;          // Hiệu chuẩn sau chuyển đổi: y = y * cal_gain + cal_offset
+    float   cal_offset;
+    float   clamp_min;         // Giá trị nhỏ nhất trả về (CURRENT/VOLTAGE)
+    float   filter_param;      // KALMAN: sai số đo; EMA: alpha; BIQUAD: tần số cắt (Hz)
+} Sensor_Descriptor;
+
+/*=========================================================================
+    HOLDING REGISTERS
+    -----------------------------------------------------------------------*/
+#define SENSOR_REG_CHANNEL          60  // Kênh đang xem/sửa (Sensor_Channel)
+#define SENSOR_REG_TYPE             61
+#define SENSOR_REG_FILTER           62  // Filter_Type, bit 8 = trung vị
+#define SENSOR_REG_NTC_CURVE        63
+#define SENSOR_REG_SIGNAL_LO        64  // x100, có dấu
+#define SENSOR_REG_SIGNAL_HI        65  // x100, có dấu
+#define SENSOR_REG_RANGE_LO         66  // x100, có dấu
+#define SENSOR_REG_RANGE_HI         67  // x100, có dấu
+#define SENSOR_REG_FRONT_END        68  // x100
+#define SENSOR_REG_CAL_GAIN         69  // x10000
+#define SENSOR_REG_CAL_OFFSET       70  // x100, có dấu
+#define SENSOR_REG_CLAMP_MIN        71  // x100, có dấu
+#define SENSOR_REG_FILTER_PARAM     72  // x1000
+#define SENSOR_REG_CMD              73  // SENSOR_CMD_x, tự xóa về 0 sau khi xử lý
+#define SENSOR_REG_STATUS           74  // SENSOR_STATUS_x (chỉ đọc)
+#define SENSOR_REG_COUNT            15
+
+#define SENSOR_CMD_NONE             0
+#define SENSOR_CMD_LOAD             1   // Hiện mô tả của kênh SENSOR_REG_CHANNEL
+#define SENSOR_CMD_APPLY            2   // Áp dụng các thanh ghi cho kênh SENSOR_REG_CHANNEL
+#define SENSOR_CMD_SAVE             3   // Lưu cả bảng vào EEPROM
+#define SENSOR_CMD_DEFAULTS         4   // Về bảng mặc định (chưa lưu)
+
+typedef enum {
+    SENSOR_STATUS_IDLE         = 0,
+    SENSOR_STATUS_APPLIED      = 1,
+    SENSOR_STATUS_SAVED        = 2,
+    SENSOR_STATUS_REJECTED     = 3,
+    SENSOR_STATUS_EEPROM_ERROR = 4
+} Sensor_Status;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Đọc bảng từ EEPROM (mặc định nếu chưa có hoặc hỏng). Gọi trước Filter_Input_Init.
+void SensorConfig_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus);
+// Xử lý lệnh của Master. Gọi định kỳ từ vòng lặp chính.
+void SensorConfig_Process(void);
+const Sensor_Descriptor* SensorConfig_Get(uint8_t ch);
+// Cấu hình bộ lọc của một kênh trong bank theo mô tả.
+void SensorConfig_ApplyFilter(FilterBank* bank, uint8_t ch);
+
+// Đường nóng: gọi SensorConfig_SetVref một lần mỗi khối, sau đó SensorConfig_Convert cho từng kênh.
+void SensorConfig_SetVref(float vref);
+float SensorConfig_Convert(uint8_t ch, float adc);
+// Nghịch đảo SensorConfig_Convert: giá trị kỹ thuật -> mã ADC thô 0..4095.
+uint16_t SensorConfig_ToAdc(uint8_t ch, float value);
+
+#endif /* INC_SENSOR_CONFIG_H_ */
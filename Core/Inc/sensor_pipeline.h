@@ -0,0 +1,65 @@
+/*
+ * sensor_pipeline.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Xử lý tín hiệu đa tốc độ trên luồng lượt quét của adc_ring:
+ *
+ *    ADC 1 kHz ─┬─ Đường nhanh (bảo vệ): EMA nhẹ ở 1 kHz trên từng lượt quét
+ *               │    -> fast_sensors (lam_mat_dau_day, nhả trip analog watchdog)
+ *               └─ Đường điều khiển: CIC bậc SENSOR_PIPELINE_CIC_ORDER, hạ tốc SENSOR_PIPELINE_CIC_DECIMATION lần
+ *                    -> bộ lọc theo mô tả cảm biến -> temperature_sensors/pressure_sensors (quá nhiệt, PID)
+ *
+ *  Độ trễ mỗi tầng (tính lúc khởi tạo, xem SensorPipeline_GetStage, công bố lên SENSOR_PIPELINE_REG):
+ *  - RAW:     khối SCANS_PER_HALF lượt quét chỉ xử lý khi đầy -> mẫu cũ nhất chờ SCANS_PER_HALF / SCAN_HZ.
+ *  - FAST:    RAW + trễ nhóm của EMA (1 - alpha) / alpha mẫu.
+ *  - CONTROL: RAW + trễ nhóm của CIC N * (R - 1) / 2 mẫu vào. Chưa tính bộ lọc theo mô tả cảm biến
+ *             (Kalman thích nghi nên không có trễ cố định).
+ *  Mặc định: RAW 8 ms, FAST 11 ms ở 1 kHz; CONTROL 54.5 ms ở 31.25 Hz.
+ */
+
+#ifndef INC_SENSOR_PIPELINE_H_
+#define INC_SENSOR_PIPELINE_H_
+#include "adc_ring.h"
+#include "Modbus_Slave_Final.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define SENSOR_PIPELINE_FAST_ALPHA       0.25f   // EMA đường nhanh, trễ nhóm 3 mẫu = 3 ms
+#define SENSOR_PIPELINE_CIC_ORDER        3
+#define SENSOR_PIPELINE_CIC_DECIMATION   32U     // 1 kHz -> 31.25 Hz; tăng bit = ORDER * log2(R) = 15, cộng 12 bit ADC < 32
+#define SENSOR_PIPELINE_CONTROL_HZ       ((float)ADC_RING_SCAN_HZ / SENSOR_PIPELINE_CIC_DECIMATION)
+
+// Holding register công bố tốc độ và độ trễ (chỉ đọc)
+#define SENSOR_PIPELINE_REG              75
+//   75: tốc độ đường nhanh (0.1 Hz),      76: độ trễ đường nhanh (0.1 ms)
+//   77: tốc độ đường điều khiển (0.1 Hz), 78: độ trễ đường điều khiển (0.1 ms)
+#define SENSOR_PIPELINE_REG_COUNT        4
+
+typedef enum {
+    SENSOR_STAGE_RAW = 0,   // Lượt quét ADC thô
+    SENSOR_STAGE_FAST,      // Đường bảo vệ
+    SENSOR_STAGE_CONTROL,   // Đường điều khiển sau CIC
+    SENSOR_STAGE_COUNT
+} Sensor_StageId;
+
+typedef struct {
+    float rate_hz;          // Tốc độ mẫu ra
+    float latency_ms;       // Độ trễ xấu nhất từ lúc lấy mẫu tới lúc có giá trị
+} Sensor_Stage;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+void SensorPipeline_Init(ModbusHandle* modbus);
+// Đưa count lượt quét vào cả 2 đường. Trả về true nếu CIC vừa ra một mẫu điều khiển (ghi vào control).
+bool SensorPipeline_Process(const uint16_t (*scans)[ADC_RING_CHANNELS], uint8_t count, float control[ADC_RING_CHANNELS]);
+// Giá trị đường nhanh của kênh (LSB, sau EMA).
+float SensorPipeline_Fast(uint8_t ch);
+const Sensor_Stage* SensorPipeline_GetStage(Sensor_StageId id);
+
+#endif /* INC_SENSOR_PIPELINE_H_ */
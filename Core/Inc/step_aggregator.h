@@ -0,0 +1,61 @@
+/*
+ * step_aggregator.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Gộp các lệnh bước của PID giữa 2 lần động cơ chạy, thay cho mảng stepp_buffer + find_max_value().
+ *  Cửa sổ là STEP_AGG_WINDOW lệnh gần nhất kể từ lần lấy trước (như mảng vòng 64 phần tử cũ).
+ *  Mọi đại lượng được cập nhật dần khi thêm lệnh nên lúc lấy không phải quét lại cửa sổ:
+ *  - MAX_ABS: hàng đợi hai đầu đơn điệu (monotonic deque) giữ các ứng viên theo |x| giảm dần,
+ *             bằng nhau thì giá trị dương (đóng van) thắng như find_max_value() cũ.
+ *  - SUM/MEAN: tổng chạy, trừ phần tử rơi khỏi cửa sổ.
+ *  - LAST:   lệnh mới nhất.
+ *  StepAgg_Push là O(1) (trừ dần), StepAgg_Take là O(1). Không gọi HAL: một bên ghi, một bên đọc;
+ *  nếu bên ghi nằm trong ngắt thì bên đọc phải gọi StepAgg_Take trong critical section.
+ */
+
+#ifndef INC_STEP_AGGREGATOR_H_
+#define INC_STEP_AGGREGATOR_H_
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define STEP_AGG_WINDOW     64U     // Lũy thừa của 2, tối đa 128
+#if (STEP_AGG_WINDOW & (STEP_AGG_WINDOW - 1U)) != 0U || STEP_AGG_WINDOW > 128U
+#error "STEP_AGG_WINDOW must be a power of 2 and at most 128"
+#endif
+
+typedef enum {
+    STEP_AGG_MAX_ABS = 0,   // Lệnh có |x| lớn nhất (mặc định, như trước)
+    STEP_AGG_MEAN,          // Trung bình, làm tròn về gần nhất
+    STEP_AGG_SUM,           // Tổng, bão hòa int16
+    STEP_AGG_LAST,          // Lệnh mới nhất
+    STEP_AGG_POLICY_COUNT
+} StepAgg_Policy;
+
+typedef struct {
+    int16_t  value[STEP_AGG_WINDOW];    // Vòng giá trị, chỉ số = số thứ tự % STEP_AGG_WINDOW
+    uint32_t deque[STEP_AGG_WINDOW];    // Số thứ tự các ứng viên MAX_ABS, hạng giảm dần từ đầu
+    uint32_t seq;                       // Số thứ tự của lệnh kế tiếp
+    uint32_t first;                     // Số thứ tự lệnh cũ nhất còn trong cửa sổ
+    uint8_t  dq_head, dq_count;
+    int32_t  sum;
+    int16_t  last;
+    uint8_t  policy;                    // StepAgg_Policy
+} StepAgg;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+void StepAgg_Init(StepAgg* agg, StepAgg_Policy policy);
+void StepAgg_SetPolicy(StepAgg* agg, StepAgg_Policy policy);
+void StepAgg_Reset(StepAgg* agg);
+void StepAgg_Push(StepAgg* agg, int16_t steps);
+// Giá trị gộp theo chính sách hiện tại (0 nếu chưa có lệnh nào).
+int16_t StepAgg_Peek(const StepAgg* agg);
+// Đọc giá trị gộp rồi xóa cửa sổ.
+int16_t StepAgg_Take(StepAgg* agg);
+
+#endif /* INC_STEP_AGGREGATOR_H_ */
@@ -3,6 +3,29 @@
  *
  *  Created on: Nov 14, 2024
  *      Author: PC
+ *
+ *  Động cơ bước của van chạy trên timer riêng (STEPPER_TIM) ở chế độ so sánh:
+ *  bộ đếm 1 MHz chạy tự do, mỗi ngắt so sánh ra một nửa bước rồi đặt thời điểm so sánh kế tiếp
+ *  = thời điểm hiện tại + khoảng cách tính theo profile tốc độ. Không phụ thuộc nhịp TIM2 40 ms nữa.
+ *
+ *  Profile theo quãng đường (tính lại mỗi bước, không cần bảng):
+ *    tăng tốc từ start_rate, giảm tốc về stop_rate ở bước cuối, giới hạn bởi max_rate theo chiều.
+ *  - TRAPEZOID: v = sqrt(v0^2 + 2 * accel * d), d = số bước tính từ đầu (hoặc tới cuối) hành trình.
+ *  - SCURVE:    v = v0 + (vmax - v0) * smoothstep(d / D), D = 1.5 lần quãng tăng tốc của hình thang,
+ *               gia tốc tăng/giảm dần (giới hạn jerk), đỉnh gia tốc xấp xỉ accel.
+ *  Hành trình ngắn tự thành tam giác (không đạt max_rate).
+ *
+ *  Nhiều động cơ (nhiều van trên một board) dùng chung STEPPER_TIM: động cơ thứ i dùng kênh so sánh
+ *  CC(i+1), một ngắt timer phục vụ mọi kênh đến hạn và gộp các bước cùng lúc thành một lần ghi BSRR
+ *  cho mỗi port. Vị trí, giới hạn hành trình và profile nằm trong từng đối tượng Stepper.
+ *
+ *  Chế độ DMA (mặc định khi 4 chân cùng port): lúc bắt đầu hành trình dựng sẵn bảng từ BSRR
+ *  (pha sau mỗi bước) và bảng ARR (khoảng cách từng bước theo profile). Mỗi lần timer tràn, GPDMA
+ *  ghi một từ vào GPIOx->BSRR (4 cuộn dây đổi cùng lúc) và một kênh khác nạp ARR của bước kế tiếp.
+ *  CPU chỉ chạy lúc bắt đầu và lúc kết thúc (ngắt DMA TC); vị trí đọc lại bằng Stepper_Sync.
+ *  Hành trình dài hơn STEPPER_DMA_MAX_STEPS (đóng quá khi về 0) chạy thành nhiều khối nối tiếp,
+ *  ngắt TC của khối trước dựng và chạy khối sau, profile tính trên cả hành trình.
+ *  DMA chiếm cả timer nên chỉ dùng được khi chỉ có một động cơ.
  */
 
 #ifndef STEPPER_V2_H_
@@ -10,6 +33,35 @@
 #include "main.h"
 #include <stdint.h>
 #include <stdlib.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define STEPPER_TIM                 TIM3    // Timer 16 bit có kênh so sánh CC1, không dùng chân ra
+#define STEPPER_TIM_IRQn            TIM3_IRQn
+#define STEPPER_TIM_CLK_ENABLE()    __HAL_RCC_TIM3_CLK_ENABLE()
+#define STEPPER_TIM_IRQ_PRIORITY    1       // Dưới t3.5 của Modbus (0)
+#define STEPPER_MAX_AXES            4U      // Số kênh so sánh CC1..CC4 của STEPPER_TIM
+
+#define STEPPER_POSITION_MAX        500     // Hành trình van mặc định (nửa bước): 0 = đóng, 500 = mở hết
+#define STEPPER_RATE_MIN            16U     // Bước/s: khoảng cách dài nhất phải vừa bộ đếm 16 bit (65.5 ms)
+#define STEPPER_RATE_MAX            1000U   // Bước/s: ngắt không dày hơn 1 ms
+
+// Profile mặc định. start/stop 25 bước/s bằng tốc độ cố định cũ (đã kiểm chứng không mất bước)
+#define STEPPER_DEFAULT_START_RATE  25U
+#define STEPPER_DEFAULT_STOP_RATE   25U
+#define STEPPER_DEFAULT_MAX_OPEN    80U
+#define STEPPER_DEFAULT_MAX_CLOSE   80U
+#define STEPPER_DEFAULT_ACCEL       200U    // Bước/s^2
+
+#define STEPPER_DEFAULT_MODE        STEPPER_MODE_DMA    // Tự lùi về STEPPER_MODE_IRQ nếu 4 chân khác port
+#define STEPPER_DMA_PHASE_CHANNEL   GPDMA1_Channel4     // TIM_UP -> GPIOx->BSRR, ngắt TC kết thúc hành trình
+#define STEPPER_DMA_PHASE_IRQn      GPDMA1_Channel4_IRQn
+#define STEPPER_DMA_PHASE_REQUEST   GPDMA1_REQUEST_TIM3_UP
+#define STEPPER_DMA_RATE_CHANNEL    GPDMA1_Channel5     // TIM_CH1 -> STEPPER_TIM->ARR
+#define STEPPER_DMA_RATE_REQUEST    GPDMA1_REQUEST_TIM3_CH1
+#define STEPPER_DMA_MAX_STEPS       STEPPER_POSITION_MAX    // Độ dài bảng (số bước của một khối DMA)
+
 // Cấu trúc để lưu thông tin chân GPIO
 typedef struct {
     GPIO_TypeDef* PORT_IN1;
@@ -22,29 +74,80 @@ typedef struct {
     uint16_t PIN_IN4;
 } StepperPins;
 
+typedef enum {
+    STEPPER_PROFILE_TRAPEZOID = 0,
+    STEPPER_PROFILE_SCURVE
+} Stepper_ProfileType;
+
+typedef enum {
+    STEPPER_MODE_IRQ = 0,   // Mỗi bước một ngắt so sánh CC1
+    STEPPER_MODE_DMA        // Bảng BSRR/ARR phát bằng GPDMA, CPU chỉ chạy lúc bắt đầu/kết thúc
+} Stepper_Mode;
+
+// Profile chuyển động, mọi tốc độ tính bằng nửa bước/s
+typedef struct {
+    uint8_t  type;            // Stepper_ProfileType
+    uint16_t start_rate;      // Tốc độ bước đầu tiên
+    uint16_t stop_rate;       // Tốc độ bước cuối cùng
+    uint16_t max_rate_open;   // Tốc độ lớn nhất khi mở (direction 0)
+    uint16_t max_rate_close;  // Tốc độ lớn nhất khi đóng (direction 1), đóng ngược áp suất nên có thể thấp hơn
+    uint16_t accel;           // Gia tốc (bước/s^2)
+} Stepper_Profile;
+
 // Cấu trúc để quản lý trạng thái động cơ
 typedef struct {
     StepperPins pins;
-    uint32_t step_delay;     // Độ trễ giữa các bước (microseconds)
+    Stepper_Profile profile;
     int32_t target_steps;    // Số bước cần di chuyển
-    int32_t current_step;    // Vị trí hiện tại
-    uint8_t current_phase;   // Pha hiện tại (0-7 cho full step)
-    uint32_t last_step_time; // Thời điểm bước cuối cùng
-    uint8_t is_moving;       // Trạng thái chuyển động
-    uint8_t direction;       // Hướng quay (0: CW, 1: CCW)
+    int32_t current_step;    // Số bước đã đi của lần di chuyển hiện tại
+    uint8_t current_phase;   // Pha hiện tại (0-7 cho half step)
+    uint16_t interval_us;    // Khoảng cách tới bước kế tiếp (us)
+    volatile uint8_t is_moving;  // Trạng thái chuyển động, ngắt timer xóa khi xong
+    uint8_t direction;       // Hướng quay (0: mở, 1: đóng)
+    uint8_t mode;            // Stepper_Mode
+    GPIO_TypeDef* port;      // Port chung của 4 chân, NULL nếu khác port (không ghi BSRR một lần được)
+    uint32_t phase_bsrr[8];  // Từ BSRR của từng pha
+    uint32_t off_bsrr;       // Từ BSRR nhả cả 4 cuộn dây
+    uint16_t dma_steps;      // Số bước của khối DMA hiện tại, 0 = không chạy
+    uint16_t dma_base;       // Số bước đã ra ở các khối DMA trước của cùng lần di chuyển
+    uint16_t dma_synced;     // Số bước DMA đã cộng vào position
+    uint8_t dma_start_phase; // Pha lúc bắt đầu lần chạy DMA
+    uint8_t axis;            // Kênh so sánh CC(axis+1) của STEPPER_TIM, STEPPER_MAX_AXES = chưa đăng ký được
+    volatile int16_t position;       // Vị trí van: 0 = đóng, position_max = mở hết
+    int16_t position_max;            // Hành trình van (nửa bước)
+    volatile float percent;          // Độ mở (%)
+    volatile uint32_t last_step_tick;    // HAL_GetTick() lúc lần chạy trước kết thúc
 } Stepper;
 
-// Khởi tạo động cơ
+// Khởi tạo động cơ (profile và hành trình mặc định) và đăng ký một kênh so sánh của timer bước
 void Stepper_Init(Stepper* stepper, StepperPins pins);
 
-// Đặt tốc độ (rpm)
-void Stepper_SetSpeed(Stepper* stepper, uint32_t rpm);
+// Đặt hành trình van, chỉ khi đứng yên. Trả về 1 nếu thành công
+uint8_t Stepper_SetLimits(Stepper* stepper, int16_t position_max);
+
+// Đặt vị trí hiện tại (chặn trong [0, position_max]) mà không chạy động cơ
+void Stepper_SetPosition(Stepper* stepper, int32_t position);
+
+// Chọn chế độ phát bước, chỉ khi đứng yên. Trả về 1 nếu thành công
+uint8_t Stepper_SetMode(Stepper* stepper, Stepper_Mode mode);
 
-// Di chuyển số bước nhất định
+// Đổi profile; tốc độ bị chặn trong [STEPPER_RATE_MIN, STEPPER_RATE_MAX], áp dụng từ bước kế tiếp
+void Stepper_SetProfile(Stepper* stepper, const Stepper_Profile* profile);
+
+// Đặt tốc độ lớn nhất (bước/s) cho cả 2 chiều
+void Stepper_SetSpeed(Stepper* stepper, uint32_t rate);
+
+// Di chuyển số bước nhất định (dương = đóng, âm = mở), bắt đầu lại profile từ start_rate
 void Stepper_Move(Stepper* stepper, int32_t steps);
 
-// Xử lý nonblocking trong main loop
-void Stepper_Run(Stepper* stepper);
+// Gọi từ STEPPER_TIM IRQHandler, phục vụ mọi động cơ đã đăng ký
+void Stepper_TimerIRQHandler(void);
+
+// Gọi từ STEPPER_DMA_PHASE_CHANNEL IRQHandler
+void Stepper_DmaIRQHandler(void);
+
+// Chế độ DMA: cập nhật position/percent theo số bước DMA đã phát (gọi trong vòng điều khiển)
+void Stepper_Sync(Stepper* stepper);
 
 // Kiểm tra trạng thái chuyển động
 uint8_t Stepper_IsMoving(Stepper* stepper);
@@ -54,4 +157,7 @@ void Stepper_Stop(Stepper* stepper);
 
 void Stepper_Hold(Stepper* stepper);
 
+// Sau reset: lấy lại pha đã lưu (valve_backup.c) và cấp điện giữ ở pha đó, bước kế tiếp nối tiếp từ đây
+void Stepper_Restore(Stepper* stepper, uint8_t phase);
+
 #endif /* INC_STEPPER_V2_H_ */
@@ -61,7 +61,12 @@ void GPDMA1_Channel2_IRQHandler(void);
 void TIM2_IRQHandler(void);
 void USART1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
-
+void GPDMA1_Channel3_IRQHandler(void);
+void USART3_IRQHandler(void);
+void TIM6_IRQHandler(void);
+void ADC1_IRQHandler(void);
+void TIM3_IRQHandler(void);
+void GPDMA1_Channel4_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
@@ -0,0 +1,52 @@
+/*
+ * valve_backup.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Giữ vị trí van qua reset (watchdog, phần mềm, chân reset, sụt áp ngắn) trong thanh ghi backup
+ *  TAMP->BKPxR, để lúc khởi động không phải đóng 500 bước rồi mở 250 bước (~30 s) mới điều khiển được.
+ *  Vùng backup không mòn như EEPROM nên ghi lại mỗi khi van dừng. Mất nguồn hẳn thì vùng backup
+ *  bị xóa, CRC sai và van về 0 như cũ.
+ *
+ *  Mỗi van (axis) một bản ghi 3 thanh ghi: [magic | vị trí], [pha | cờ | số lần khôi phục], [CRC16 Modbus của 2 từ đầu].
+ *  Vị trí chỉ tin được khi:
+ *  - magic và CRC đúng (reset giữa lúc đang ghi làm CRC sai),
+ *  - cờ VALVE_BACKUP_FLAG_STOPPED còn (cờ bị xóa trước mỗi lần động cơ chạy, đặt lại khi dừng:
+ *    reset giữa hành trình thì không biết đã ra bao nhiêu bước),
+ *  - chưa khôi phục liên tiếp VALVE_BACKUP_MAX_RESUMES lần (giới hạn sai số mất bước tích lũy,
+ *    bộ đếm xóa mỗi khi STATE_CLOSING đóng xong về 0: lúc khởi tạo và mỗi lần mất RUN).
+ */
+
+#ifndef INC_VALVE_BACKUP_H_
+#define INC_VALVE_BACKUP_H_
+#include <stdint.h>
+
+/*=========================================================================
+    USER DEFINES (Cấu hình bởi người dùng)
+    -----------------------------------------------------------------------*/
+#define VALVE_BACKUP_REG_FIRST      0U      // Van i dùng TAMP->BKP(3i)R..BKP(3i+2)R
+#define VALVE_BACKUP_MAX_AXES       4U
+#define VALVE_BACKUP_MAX_RESUMES    8U      // Sau ngần này lần khôi phục liên tiếp thì vẫn đóng về 0
+
+typedef struct {
+    int16_t position;   // 0 = đóng, STEPPER_POSITION_MAX = mở hết
+    uint8_t phase;      // Pha động cơ đang giữ (0-7)
+    uint8_t resumes;    // Số lần khôi phục liên tiếp kể cả lần này
+} ValveBackup_State;
+
+/*=========================================================================
+    FUNCTION PROTOTYPES
+    -----------------------------------------------------------------------*/
+// Bật clock RTCAPB và quyền ghi vùng backup.
+void ValveBackup_Init(void);
+// Đọc bản ghi lúc khởi động. Tin được thì tăng số lần khôi phục, ghi lại và trả về 1.
+uint8_t ValveBackup_Load(uint8_t axis, int16_t position_max, ValveBackup_State* state);
+// Gọi ngay trước khi động cơ chạy: vị trí đã lưu không còn tin được tới lần dừng kế tiếp.
+void ValveBackup_MarkMoving(uint8_t axis);
+// Gọi khi van đứng yên: lưu vị trí và pha (không ghi nếu không đổi).
+void ValveBackup_SaveStopped(uint8_t axis, int16_t position, uint8_t phase);
+// Đã đóng về 0 (cả hành trình hoặc đóng quá EEV_OVERDRIVE_STEPS): xóa bộ đếm khôi phục.
+void ValveBackup_Homed(uint8_t axis);
+
+#endif /* INC_VALVE_BACKUP_H_ */
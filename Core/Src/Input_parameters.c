@@ -5,86 +5,55 @@
  *      Author: PC
  */
 #include "Input_parameters.h"
-#include "math.h"
-#define SERIESRESISTOR 10000
-const float A = 1.129241e-3f;
-const float B = 2.341077e-4f;
-const float C = 8.775468e-8f;
+#include "sensor_config.h"
+#include "ntc.h"
+#include "sensor_pipeline.h"
 
 Temperature_Sensors temperature_sensors;
 Pressure_Sensors pressure_sensors;
+Fast_Sensors fast_sensors;
 
 ADC_Temperature_Sensors adc_temperature_sensors;
 ADC_Pressure_Sensors adc_pressure_sensors;
 
-Filter_Temperature_Sensors filter_temperature_sensors;
-Filter_Pressure_Sensors filter_pressure_sensors;
+FilterBank sensor_filters;
 
-SimpleKalmanFilter filter_vref;
-uint16_t adc_vref;
+float adc_vref;
 float vref;
 
 void Filter_Input_Init()
 {
-	SimpleKalmanFilterInit(&filter_vref, 2.0f, 2.0f, 0.001f);
-	SimpleKalmanFilterInit(&filter_temperature_sensors.filter_temperature_sensor_hoi_ve, 2.0f, 2.0f, 0.001f);
-	SimpleKalmanFilterInit(&filter_temperature_sensors.filter_temperature_sensor_dau_day, 2.0f, 2.0f, 0.001f);
-	SimpleKalmanFilterInit(&filter_pressure_sensors.filter_high_pressure_sensor, 2.0f, 2.0f, 0.001f);
-	SimpleKalmanFilterInit(&filter_pressure_sensors.filter_low_pressure_sensor, 2.0f, 2.0f, 0.001f);
-}
-static float calcular_temperature(uint16_t adc_value)
-{
-    float resistance = (4095*SERIESRESISTOR)/(float)adc_value - SERIESRESISTOR;
-    float steinhart = 1.0f/(A + B*log(resistance) + C*pow(log(resistance),3)) - 273.15f;
-    return steinhart;
-}
-static float calcular_pressure_voltage(uint16_t adc_value,float sample_pressuare_low, float sample_pressure_high, float vref)
-{
-    float voltage = (float)(adc_value)*vref/4095.0f;
-    float pressure = ((voltage - 0.5f)*(sample_pressure_high - sample_pressuare_low))/(3.5f-0.5f) + sample_pressuare_low;
-    return pressure = (pressure < 0.0f)?0.0f:pressure;
-}
-static float calcular_vref(uint16_t adc_value){
-	uint16_t vrefint_cal = *((uint16_t*)0x08FFF810);
-	float vref = 3300*vrefint_cal/(float)adc_value/1000.0f;
-	return vref;
-}
-static float calcular_pressure_voltage_H(uint16_t adc_value, float sample_pressure, float vref)
-{
-    float voltage = (float)(adc_value)*vref/4095.0f;
-    float pressure = ((voltage - 0.5f)*(sample_pressure - 0.0f))/(4.5f-0.5f);
-    return pressure = (pressure < 0.0f)?0.0f:pressure;
-}
-
-static float calcular_pressure_current(uint16_t adc_value, float sample_res, float sample_pressure_low, float sample_pressure_high, float vref)
-{
-    float voltage = (float)(adc_value)*vref/4095.0f;
-    float curent = (voltage/sample_res)*1000.0f;
-    float pressure = ((curent - 4.0f)*(sample_pressure_high - sample_pressure_low))/(20.0f - 4.0f) + sample_pressure_low;
-    return pressure = (pressure < 0.0f)?0.0f:pressure;
-}
-static void read_adc_sensor(ADC_HandleTypeDef* hadc1){
-	adc_vref = SimpleKalmanFilter_updateEstimate(&filter_vref, (float)ADC_ReadChannel(hadc1, ADC_CHANNEL_VREFINT));
-	adc_temperature_sensors.ADC_hoi_ve = SimpleKalmanFilter_updateEstimate(&filter_temperature_sensors.filter_temperature_sensor_hoi_ve, (float)ADC_ReadChannel(hadc1, ADC_CHANNEL_0));
-	adc_temperature_sensors.ADC_dau_day = SimpleKalmanFilter_updateEstimate(&filter_temperature_sensors.filter_temperature_sensor_dau_day, (float)ADC_ReadChannel(hadc1, ADC_CHANNEL_1));
-	adc_pressure_sensors.ADC_low_pressure = SimpleKalmanFilter_updateEstimate(&filter_pressure_sensors.filter_low_pressure_sensor, (float)ADC_ReadChannel(hadc1, ADC_CHANNEL_14));
-	adc_pressure_sensors.ADC_high_pressure = SimpleKalmanFilter_updateEstimate(&filter_pressure_sensors.filter_high_pressure_sensor, (float)ADC_ReadChannel(hadc1, ADC_CHANNEL_15));
-}
-static void read_adc_sensor_dma(){
-	adc_vref = SimpleKalmanFilter_updateEstimate(&filter_vref, (float)adc_buffer[0]);
-	adc_temperature_sensors.ADC_hoi_ve = SimpleKalmanFilter_updateEstimate(&filter_temperature_sensors.filter_temperature_sensor_hoi_ve, (float)adc_buffer[1]);
-	adc_temperature_sensors.ADC_dau_day = SimpleKalmanFilter_updateEstimate(&filter_temperature_sensors.filter_temperature_sensor_dau_day, (float)adc_buffer[2]);
-	adc_pressure_sensors.ADC_low_pressure = SimpleKalmanFilter_updateEstimate(&filter_pressure_sensors.filter_low_pressure_sensor, (float)adc_buffer[3]);
-	adc_pressure_sensors.ADC_high_pressure = SimpleKalmanFilter_updateEstimate(&filter_pressure_sensors.filter_high_pressure_sensor, (float)adc_buffer[4]);
-}
-void Calcular_Input(ADC_HandleTypeDef* hadc1){
-//	read_adc_sensor(hadc1);
-	read_adc_sensor_dma();
-	vref = calcular_vref(adc_vref);
-	temperature_sensors.hoi_ve = calcular_temperature(adc_temperature_sensors.ADC_hoi_ve);
-	temperature_sensors.dau_day = calcular_temperature(adc_temperature_sensors.ADC_dau_day);
-    pressure_sensors.low_pressure_sensor = calcular_pressure_current(adc_pressure_sensors.ADC_low_pressure, 100.0f, -1.0f, 12.0f, vref);
-	pressure_sensors.high_pressure_sensor = calcular_pressure_current(adc_pressure_sensors.ADC_high_pressure, 100.0f, 0.0f, 30.0f, vref);
+	// Loại lọc của từng kênh lấy từ bảng mô tả cảm biến (sensor_config.c), đổi được qua Modbus
+	FilterBank_Init(&sensor_filters, SENSOR_CH_COUNT);
+	for (uint8_t ch = 0; ch < SENSOR_CH_COUNT; ch++) {
+		SensorConfig_ApplyFilter(&sensor_filters, ch);
+	}
+#if NTC_BENCHMARK
+	NTC_Benchmark(&ntc_curve_10k_sh);
+#endif
+}
+static void read_adc_sensor_dma(const float* scan){
+	// Lọc cả 5 kênh trong một lượt
+	FilterBank_Update(&sensor_filters, scan);
+	adc_vref = FilterBank_Output(&sensor_filters, SENSOR_CH_VREF);
+	adc_temperature_sensors.ADC_hoi_ve = FilterBank_Output(&sensor_filters, SENSOR_CH_HOI_VE);
+	adc_temperature_sensors.ADC_dau_day = FilterBank_Output(&sensor_filters, SENSOR_CH_DAU_DAY);
+	adc_pressure_sensors.ADC_low_pressure = FilterBank_Output(&sensor_filters, SENSOR_CH_LOW_PRESSURE);
+	adc_pressure_sensors.ADC_high_pressure = FilterBank_Output(&sensor_filters, SENSOR_CH_HIGH_PRESSURE);
+}
+void Calcular_Input(const float* scan){
+	read_adc_sensor_dma(scan);
+	vref = SensorConfig_Convert(SENSOR_CH_VREF, adc_vref);
+	SensorConfig_SetVref(vref);
+	temperature_sensors.hoi_ve = SensorConfig_Convert(SENSOR_CH_HOI_VE, adc_temperature_sensors.ADC_hoi_ve);
+	temperature_sensors.dau_day = SensorConfig_Convert(SENSOR_CH_DAU_DAY, adc_temperature_sensors.ADC_dau_day);
+	pressure_sensors.low_pressure_sensor = SensorConfig_Convert(SENSOR_CH_LOW_PRESSURE, adc_pressure_sensors.ADC_low_pressure);
+	pressure_sensors.high_pressure_sensor = SensorConfig_Convert(SENSOR_CH_HIGH_PRESSURE, adc_pressure_sensors.ADC_high_pressure);
+}
+void Calcular_Fast_Input(void){
+	// vref lấy từ đường điều khiển, thay đổi chậm
+	fast_sensors.dau_day = SensorConfig_Convert(SENSOR_CH_DAU_DAY, SensorPipeline_Fast(SENSOR_CH_DAU_DAY));
+	fast_sensors.high_pressure_sensor = SensorConfig_Convert(SENSOR_CH_HIGH_PRESSURE, SensorPipeline_Fast(SENSOR_CH_HIGH_PRESSURE));
 }
 
 
@@ -8,12 +8,16 @@
 #include "Modbus_Slave_Final.h" // Bao gồm header của chính thư viện này
 #include <string.h>           // Cần cho memcpy và memset
 #include <stdbool.h>          // Cần cho kiểu bool có giá trị true/false
+#include "log_level.h"        // LOG_ERROR/LOG_WARN/... (lọc mức lúc biên dịch)
+#include "modbus_crc.h"       // Modbus_CRC16 (backend chọn lúc biên dịch)
 /* Private Defines ---------------------------------------------------------*/
 // Định nghĩa các hằng số nội bộ nếu cần (hiện tại không có)
 // Kích thước khung Modbus RTU tối thiểu (Địa chỉ Slave + FC + CRC)
 #define MODBUS_MIN_FRAME_SIZE 4
 // Kích thước khung Modbus RTU tối thiểu cho các chức năng với địa chỉ và số lượng/giá trị (Địa chỉ + FC + Địa chỉ(2) + Số lượng/Giá trị(2) + CRC)
 #define MODBUS_MIN_REQ_RESP_SIZE 8
+// Phần đầu cố định của request FC 0F/10 (Địa chỉ + FC + Địa chỉ(2) + Số lượng(2) + Byte count), chưa gồm dữ liệu và CRC
+#define MODBUS_MULTI_WRITE_HDR_SIZE 7
 /**
  * @brief Đọc giá trị 16-bit từ buffer theo thứ tự byte Big-Endian (MSB first).
  * @param data Con trỏ tới buffer (mảng uint8_t không đổi).
@@ -33,52 +37,51 @@ static inline void Modbus_WriteU16_BE(uint8_t* buffer, uint16_t index, uint16_t
     buffer[index]     = (uint8_t)(value >> 8); // Ghi MSB
     buffer[index + 1] = (uint8_t)(value & 0xFF); // Ghi LSB
 }
+/**
+ * @brief Quy đổi số chu kỳ CPU (DWT->CYCCNT) sang micro giây.
+ */
+static inline uint32_t Modbus_CyclesToUs(uint32_t cycles) {
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    return cycles / (cycles_per_us ? cycles_per_us : 1U);
+}
+
+// Chỉ số của image_gen
+#define MODBUS_MAP_HOLDING 0
+#define MODBUS_MAP_INPUT   1
 
 /* Private Variables -------------------------------------------------------*/
 /**
- * @brief Bảng tra cứu CRC16 Modbus (đa thức 0xA001 - tương đương 0x8005 đảo bit).
- */
-static const uint16_t modbus_crc_table[256] = {
-    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
-    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
-    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
-    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
-    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
-    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
-    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
-    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
-    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
-    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
-    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
-    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
-    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
-    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
-    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
-    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
-    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
-    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
-    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
-    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
-    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
-    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
-    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
-    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
-    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
-    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
-    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
-    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
-    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
-    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
-    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
-    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+ * @brief Ngưỡng t1.5/t3.5 theo baud (1 ký tự = 11 bit: start + 8 data + parity/stop + stop).
+ *        Trên 19200 baud chuẩn Modbus cố định t1.5 = 750 us, t3.5 = 1750 us.
+ *        Có thể nới rộng từng dòng nếu Master thực tế có khoảng lặng giữa ký tự lớn.
+ *        Baud không có trong bảng được tính theo công thức tương tự.
+ */
+static const ModbusRtuTiming modbus_rtu_timing_table[] = {
+    {   1200, 13750, 32083 },
+    {   2400,  6875, 16042 },
+    {   4800,  3438,  8021 },
+    {   9600,  1719,  4010 },
+    {  19200,   859,  2005 },
+    {  38400,   750,  1750 },
+    {  57600,   750,  1750 },
+    { 115200,   750,  1750 },
 };
 
 /* Private Function Prototypes ---------------------------------------------*/
 // Khai báo các hàm nội bộ (static) để cấu trúc code rõ ràng hơn.
 
 // --- Hàm trợ giúp ---
-static uint16_t Modbus_CRC16_Table(const uint8_t* data, uint16_t length);
 static void Modbus_SendResponse(ModbusHandle* modbus, uint16_t length);
+static void Modbus_SendFrame(ModbusHandle* modbus, const uint8_t* frame, uint16_t size);
+static void Modbus_StartTransmit(ModbusHandle* modbus, uint16_t size);
+static void Modbus_StoreRegs(ModbusHandle* modbus, uint8_t map, uint16_t start, const uint16_t* values, uint16_t count);
+static void Modbus_SendRegisters(ModbusHandle* modbus, uint8_t fc, uint16_t address, uint16_t quantity);
+static HAL_StatusTypeDef Modbus_RxArm(ModbusHandle* modbus);
+static void Modbus_RxParse(ModbusRxParser* p, uint8_t address, const uint8_t* frame, uint16_t end);
+static void Modbus_RxFinish(ModbusRxParser* p, uint16_t end);
+static bool Modbus_RxDeliver(ModbusHandle* modbus, uint8_t* frame, uint16_t len, uint32_t stamp);
+static void Modbus_RxUpdate(ModbusHandle* modbus, uint16_t end, uint32_t event);
+static void Modbus_TxRelease(ModbusHandle* modbus);
 static void Modbus_SendExceptionResponse(ModbusHandle* modbus, uint8_t functionCode, uint8_t exceptionCode);
 static inline bool Modbus_GetBit(const uint8_t* data, uint16_t bit_index);
 static inline void Modbus_SetBit(uint8_t* data, uint16_t bit_index, bool value);
@@ -96,28 +99,6 @@ static void Modbus_HandleWriteMultipleRegs(ModbusHandle* modbus, uint16_t addres
 
 /* Private Helper Functions ------------------------------------------------*/
 
-/**
- * @brief Tính toán giá trị CRC16 Modbus sử dụng bảng tra cứu.
- * @param data Con trỏ tới mảng dữ liệu cần tính CRC.
- * @param length Số lượng byte trong mảng dữ liệu.
- * @return Giá trị CRC16 (16-bit), lưu ý thứ tự byte trong giá trị trả về
- *         là Little-Endian (byte thấp trước, byte cao sau trong thanh ghi 16-bit).
- */
-static uint16_t Modbus_CRC16_Table(const uint8_t* data, uint16_t length) {
-    uint16_t crc = 0xFFFF; // Giá trị khởi tạo CRC
-    uint8_t lut_index;
-
-    while (length--) {
-        // XOR byte dữ liệu hiện tại với byte thấp của CRC để lấy index cho bảng tra cứu
-        lut_index = (crc ^ *data++) & 0xFF;
-        // Dịch phải CRC 8 bit và XOR với giá trị từ bảng tra cứu
-        crc = (crc >> 8) ^ modbus_crc_table[lut_index];
-    }
-    // Kết quả crc bây giờ chứa giá trị CRC16 đúng theo chuẩn Modbus RTU.
-    // Khi gửi đi, byte thấp (crc & 0xFF) sẽ được gửi trước, byte cao (crc >> 8) gửi sau.
-    return crc;
-}
-
 /**
  * @brief Gửi gói tin phản hồi Modbus qua UART bằng DMA.
  * @param modbus Con trỏ tới cấu trúc ModbusHandle.
@@ -130,29 +111,42 @@ static void Modbus_SendResponse(ModbusHandle* modbus, uint16_t length) {
     if (length > (MODBUS_TX_BUFFER_SIZE - 2)) {
         // Lỗi nghiêm trọng: Phản hồi quá dài.
         // Không gửi gì cả và quay lại trạng thái sẵn sàng.
-        // Nên log lỗi này để debug.
+        LOG_ERROR(EVT_MODBUS_RESP_TOO_LONG, length);
         modbus->state = MODBUS_STATE_IDLE;
         return;
     }
 
     // Tính toán CRC cho phần dữ liệu (length bytes) trong txBuffer
-    uint16_t crc = Modbus_CRC16_Table(modbus->txBuffer, length);
+    uint16_t crc = Modbus_CRC16(modbus->txBuffer, length);
 
     // Thêm CRC vào cuối buffer (byte thấp trước, byte cao sau)
     modbus->txBuffer[length]     = (uint8_t)(crc & 0xFF);
     modbus->txBuffer[length + 1] = (uint8_t)((crc >> 8) & 0xFF);
 
+    Modbus_SendFrame(modbus, modbus->txBuffer, length + 2);
+}
+
+/**
+ * @brief Phát một frame đã có CRC: txBuffer hoặc khung FC03/FC04 dựng sẵn (không chép).
+ * @param size Độ dài frame gồm CRC.
+ */
+static void Modbus_SendFrame(ModbusHandle* modbus, const uint8_t* frame, uint16_t size) {
     // Chỉ chuyển sang TRANSMITTING nếu chưa phải
     // (để tránh gọi HAL_UART_Transmit_DMA nhiều lần nếu có lỗi logic)
     if (modbus->state == MODBUS_STATE_PROCESSING) {
 		modbus->state = MODBUS_STATE_TRANSMITTING;
-		// Bắt đầu truyền dữ liệu (dữ liệu + 2 byte CRC) bằng DMA
-		if (HAL_UART_Transmit_DMA(modbus->huart, modbus->txBuffer, length + 2) != HAL_OK) {
-			// Lỗi khi bắt đầu truyền DMA!
-			// Đây là lỗi nghiêm trọng, cần xử lý (vd: log lỗi, thử lại?, reset state).
-			// Quan trọng là phải đưa state về IDLE để tránh bị kẹt.
-			modbus->state = MODBUS_STATE_IDLE;
+		modbus->tx_ptr = frame;
+		// Frame được giao trước IDLE: phản hồi đã sẵn sàng nhưng phải chờ Master nhả đường truyền.
+		// Ngắt IDLE sẽ phát phản hồi; kiểm tra và ghi cờ trong vùng cấm ngắt để không lỡ sự kiện.
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		if (modbus->rx_line_busy) {
+			modbus->tx_pending_len = size;
+			__set_PRIMASK(primask);
+			return;
 		}
+		__set_PRIMASK(primask);
+		Modbus_StartTransmit(modbus, size);
 	    // Trạng thái sẽ về IDLE trong TxCpltCallback nếu truyền thành công
     }else{
         // Lỗi logic: Gọi SendResponse khi state không phải là PROCESSING
@@ -162,6 +156,248 @@ static void Modbus_SendResponse(ModbusHandle* modbus, uint16_t length) {
     // khi quá trình truyền DMA hoàn tất thành công.
 }
 
+/**
+ * @brief Bắt đầu phát tx_ptr (đã có CRC) bằng DMA.
+ * @note  Gọi từ Modbus_SendResponse hoặc từ ngắt IDLE khi phản hồi đang chờ đường truyền rảnh.
+ */
+static void Modbus_StartTransmit(ModbusHandle* modbus, uint16_t size) {
+    // Độ trễ từ lúc chụp frame tới lúc bắt đầu gửi phản hồi
+    uint32_t turnaround = Modbus_CyclesToUs(DWT->CYCCNT - modbus->rx_stamp);
+    modbus->stats.turnaround_us_last = turnaround;
+    if (turnaround > modbus->stats.turnaround_us_max) modbus->stats.turnaround_us_max = turnaround;
+    // Bắt đầu truyền dữ liệu (dữ liệu + 2 byte CRC) bằng DMA
+    if (HAL_UART_Transmit_DMA(modbus->huart, modbus->tx_ptr, size) != HAL_OK) {
+        // Lỗi khi bắt đầu truyền DMA!
+        // Quan trọng là phải đưa state về IDLE để tránh bị kẹt.
+        LOG_ERROR(EVT_MODBUS_TX_START_FAIL, size);
+        modbus->state = MODBUS_STATE_IDLE;
+    }
+}
+
+/**
+ * @brief Ghi một dải register cùng ảnh Big-Endian của nó, tăng thế hệ ảnh nếu có giá trị đổi.
+ * @note  Nơi gọi tự lo critical section nếu cần (ngắt xử lý frame và vòng lặp chính).
+ */
+static void Modbus_StoreRegs(ModbusHandle* modbus, uint8_t map, uint16_t start, const uint16_t* values, uint16_t count) {
+    uint16_t* regs = (map == MODBUS_MAP_HOLDING) ? modbus->holdingRegs : modbus->inputRegs;
+    uint8_t* image = (map == MODBUS_MAP_HOLDING) ? modbus->holdingImage : modbus->inputImage;
+    bool changed = false;
+    for (uint16_t i = 0; i < count; i++) {
+        if (regs[start + i] != values[i]) {
+            regs[start + i] = values[i];
+            Modbus_WriteU16_BE(image, (start + i) * 2, values[i]);
+            changed = true;
+        }
+    }
+    if (changed && ++modbus->image_gen[map] == 0) {
+        modbus->image_gen[map] = 1; // 0 dành cho khung chưa dựng
+    }
+}
+
+#if MODBUS_READ_CACHE_SLOTS > 0
+/**
+ * @brief Dựng khung phản hồi FC03/FC04 gồm CRC từ ảnh Big-Endian.
+ */
+static void Modbus_BuildReadFrame(ModbusHandle* modbus, ModbusReadCache* c, uint8_t slave,
+                                  uint8_t fc, uint16_t start, uint16_t quantity) {
+    uint8_t map = (fc == READ_HOLDING) ? MODBUS_MAP_HOLDING : MODBUS_MAP_INPUT;
+    const uint8_t* image = (fc == READ_HOLDING) ? modbus->holdingImage : modbus->inputImage;
+    uint8_t byte_count = (uint8_t)(quantity * 2);
+
+    c->frame[0] = slave;
+    c->frame[1] = fc;
+    c->frame[2] = byte_count;
+    memcpy(&c->frame[3], &image[start * 2], byte_count);
+    uint16_t crc = Modbus_CRC16(c->frame, 3 + byte_count);
+    c->frame[3 + byte_count] = (uint8_t)(crc & 0xFF);
+    c->frame[4 + byte_count] = (uint8_t)(crc >> 8);
+    c->len = 5 + byte_count;
+    c->fc = fc;
+    c->start = start;
+    c->quantity = quantity;
+    c->gen = modbus->image_gen[map];
+}
+#endif
+
+/**
+ * @brief Phát phản hồi FC03/FC04 cho một dải đã kiểm tra hợp lệ.
+ *        Cửa sổ ngắn: phát thẳng khung dựng sẵn nếu ảnh chưa đổi, nếu không thì dựng lại vào slot cache.
+ *        Cửa sổ dài: chép ảnh Big-Endian vào txBuffer (không đảo byte từng register).
+ */
+static void Modbus_SendRegisters(ModbusHandle* modbus, uint8_t fc, uint16_t address, uint16_t quantity) {
+    uint8_t byte_count = (uint8_t)(quantity * 2);
+#if MODBUS_READ_CACHE_SLOTS > 0
+    if (quantity <= MODBUS_READ_CACHE_MAX_REGS) {
+        uint8_t map = (fc == READ_HOLDING) ? MODBUS_MAP_HOLDING : MODBUS_MAP_INPUT;
+        ModbusReadCache* victim = NULL;
+        for (uint8_t i = 0; i < MODBUS_READ_CACHE_SLOTS; i++) {
+            ModbusReadCache* c = &modbus->read_cache[i];
+            if (c->fc == fc && c->start == address && c->quantity == quantity) {
+                if (c->gen == modbus->image_gen[map] && c->frame[0] == modbus->rxBuffer[0]) {
+                    modbus->stats.read_cache_hits++;
+                    Modbus_SendFrame(modbus, c->frame, c->len);
+                    return;
+                }
+                victim = c;
+                break;
+            }
+        }
+        // Cửa sổ mới thay slot theo vòng. Không có phản hồi nào đang phát nên slot nào cũng thay được.
+        if (victim == NULL) {
+            victim = &modbus->read_cache[modbus->read_cache_next];
+            modbus->read_cache_next = (uint8_t)((modbus->read_cache_next + 1) % MODBUS_READ_CACHE_SLOTS);
+        }
+        modbus->stats.read_cache_misses++;
+        Modbus_BuildReadFrame(modbus, victim, modbus->rxBuffer[0], fc, address, quantity);
+        Modbus_SendFrame(modbus, victim->frame, victim->len);
+        return;
+    }
+#endif
+    const uint8_t* image = (fc == READ_HOLDING) ? modbus->holdingImage : modbus->inputImage;
+    modbus->txBuffer[0] = modbus->rxBuffer[0]; // Slave Address
+    modbus->txBuffer[1] = fc;                  // Function Code
+    modbus->txBuffer[2] = byte_count;          // Số byte dữ liệu register theo sau
+    memcpy(&modbus->txBuffer[3], &image[address * 2], byte_count);
+    // Hàm Modbus_SendResponse sẽ tự thêm CRC
+    Modbus_SendResponse(modbus, 3 + byte_count);
+}
+
+/**
+ * @brief Bắt đầu một đoạn nhận DMA. Vẫn dùng ReceiveToIdle để có sự kiện HT/TC,
+ *        nhưng khi MODBUS_RTU_TIMING = 1 ngắt IDLE bị tắt: kết thúc frame do t3.5 quyết định.
+ */
+static HAL_StatusTypeDef Modbus_RxStartDMA(ModbusHandle* modbus, uint8_t* buf, uint16_t len) {
+    HAL_StatusTypeDef status = HAL_UARTEx_ReceiveToIdle_DMA(modbus->huart, buf, len);
+#if MODBUS_RTU_TIMING == 1
+    if (status == HAL_OK) {
+        ATOMIC_CLEAR_BIT(modbus->huart->Instance->CR1, USART_CR1_IDLEIE);
+    }
+#endif
+    return status;
+}
+
+/**
+ * @brief Vị trí (trong frame) của byte kế tiếp DMA sẽ ghi.
+ */
+static uint16_t Modbus_RxPosition(const ModbusHandle* modbus) {
+    const UART_HandleTypeDef* huart = modbus->huart;
+    if (huart->RxState != HAL_UART_STATE_BUSY_RX) return modbus->rx_parser.dma_base;
+    return (uint16_t)(modbus->rx_parser.dma_base + huart->RxXferSize - __HAL_DMA_GET_COUNTER(huart->hdmarx));
+}
+
+/**
+ * @brief Đặt lại bộ phân tích và bắt đầu nhận frame mới từ đầu slot DMA hiện tại.
+ * @note  Chỉ nhận MODBUS_RX_HEAD_SIZE byte đầu: ngắt HT/TC của đoạn này cho phép kiểm tra
+ *        frame trước IDLE, phần còn lại (FC 0F/10 dài) được nhận tiếp khi TC.
+ */
+static HAL_StatusTypeDef Modbus_RxArm(ModbusHandle* modbus) {
+    memset(&modbus->rx_parser, 0, sizeof(modbus->rx_parser));
+    modbus->rx_parser.crc = MODBUS_CRC_INIT;
+    modbus->rx_t15_pos = 0;
+    return Modbus_RxStartDMA(modbus, modbus->rxFrames[modbus->rx_dma_slot], MODBUS_RX_HEAD_SIZE);
+}
+
+/**
+ * @brief Độ dài request suy ra từ FC (và byte count của FC 0F/10).
+ * @return Độ dài frame gồm CRC, 0 nếu chưa đủ byte để biết hoặc FC không được hỗ trợ.
+ */
+static uint16_t Modbus_RxExpectedLength(const uint8_t* frame, uint16_t end) {
+    uint8_t fc = frame[1];
+    if (fc >= READ_COILS && fc <= WRITE_SINGLE_REG) {
+        return MODBUS_MIN_REQ_RESP_SIZE;
+    }
+    if ((fc == WRITE_MULTI_COILS || fc == WRITE_MULTI_REGS) && end >= MODBUS_MULTI_WRITE_HDR_SIZE) {
+        return MODBUS_MULTI_WRITE_HDR_SIZE + frame[MODBUS_MULTI_WRITE_HDR_SIZE - 1] + 2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Đưa các byte frame[pos..end) qua bộ phân tích.
+ * @note  Frame khác địa chỉ bị loại ngay ở byte 0 nên không tốn CRC cho lưu lượng của slave khác.
+ *        CRC chỉ tính tới độ dài dự kiến; CRC gồm cả 2 byte CRC của frame đúng luôn bằng 0.
+ */
+static void Modbus_RxParse(ModbusRxParser* p, uint8_t address, const uint8_t* frame, uint16_t end) {
+    if (p->verdict != MODBUS_RX_PENDING || end <= p->pos) return;
+
+    if (p->pos == 0 && frame[0] != address && frame[0] != 0) { // Địa chỉ 0 là broadcast
+        p->verdict = MODBUS_RX_FOREIGN;
+        return;
+    }
+    if (p->expected == 0 && end >= 2) {
+        p->expected = Modbus_RxExpectedLength(frame, end);
+        if (p->expected > MODBUS_RX_BUFFER_SIZE) {
+            p->verdict = MODBUS_RX_BAD_LENGTH;
+            return;
+        }
+    }
+
+    uint16_t stop = (p->expected != 0 && end > p->expected) ? p->expected : end;
+    if (stop > p->pos) {
+        p->crc = Modbus_CRC16_Update(p->crc, frame + p->pos, stop - p->pos);
+        p->pos = stop;
+    }
+    if (p->expected != 0 && p->pos == p->expected) {
+        p->verdict = (p->crc == 0) ? MODBUS_RX_COMPLETE : MODBUS_RX_BAD_CRC;
+    }
+}
+
+/**
+ * @brief Kết luận frame khi đường truyền IDLE (hoặc hết bộ đệm) mà bộ phân tích vẫn chờ.
+ */
+static void Modbus_RxFinish(ModbusRxParser* p, uint16_t end) {
+    if (p->verdict != MODBUS_RX_PENDING) return;
+    if (p->expected != 0 || end < MODBUS_MIN_FRAME_SIZE) {
+        // Frame kết thúc trước độ dài suy ra từ FC
+        p->verdict = MODBUS_RX_BAD_LENGTH;
+    } else {
+        // FC không hỗ trợ: chỉ biết độ dài khi IDLE, vẫn giao xử lý để trả ILLEGAL_FUNCTION
+        p->verdict = (p->crc == 0) ? MODBUS_RX_COMPLETE : MODBUS_RX_BAD_CRC;
+    }
+}
+
+/**
+ * @brief Giao frame hợp lệ cho xử lý.
+ * @return true nếu frame đã được xếp hàng và cần đánh thức Modbus_Poll.
+ */
+static bool Modbus_RxDeliver(ModbusHandle* modbus, uint8_t* frame, uint16_t len, uint32_t stamp) {
+#if MODBUS_PROCESS_IN_MAIN_LOOP == 1
+    // Chế độ Main Loop: chỉ xếp frame vào slot hiện tại, DMA chuyển sang slot kia khi hết frame.
+    // Việc xử lý và gửi phản hồi được hoãn sang Modbus_Poll().
+    (void)frame;    // Frame đã nằm sẵn trong rxFrames[rx_dma_slot]
+    uint8_t slot = modbus->rx_dma_slot;
+    uint8_t next = (uint8_t)((slot + 1) % MODBUS_RX_SLOTS);
+    if (modbus->rx_slot_len[next] == 0) {
+        modbus->rx_slot_stamp[slot] = stamp;
+        modbus->rx_slot_len[slot] = len;
+        modbus->rx_parser.queued = 1;
+        modbus->stats.frames_rx++;
+        return true;
+    }
+    // Frame trước chưa được xử lý: bỏ frame mới, DMA ghi đè lại slot hiện tại.
+    modbus->stats.frames_dropped++;
+    LOG_WARN(EVT_MODBUS_BUSY_DROP, modbus->state, len);
+    return false;
+#else
+    modbus->rxBuffer = frame;
+    modbus->rxCount = len;
+    modbus->rx_stamp = stamp;
+    // Chỉ xử lý nếu đang ở trạng thái IDLE
+    if (modbus->state == MODBUS_STATE_IDLE) {
+        // Chế độ Callback: Gọi xử lý ngay
+        modbus->stats.frames_rx++;
+        Modbus_ProcessData(modbus);
+    } else {
+        // Đang bận (PROCESSING hoặc TRANSMITTING), bỏ qua frame này.
+        // Việc này là bình thường nếu Master gửi liên tục mà Slave chưa xử lý xong.
+        modbus->stats.frames_dropped++;
+        LOG_WARN(EVT_MODBUS_BUSY_DROP, modbus->state, len);
+        modbus->rxCount = 0; // Reset count để tránh xử lý dữ liệu cũ/không hoàn chỉnh
+    }
+    return false;
+#endif
+}
+
 /**
  * @brief Gửi gói tin phản hồi ngoại lệ (Exception Response) Modbus.
  * @param modbus Con trỏ tới cấu trúc ModbusHandle.
@@ -186,6 +422,8 @@ static void Modbus_SendExceptionResponse(ModbusHandle* modbus, uint8_t functionC
          return;
     }
 
+    LOG_DEBUG(EVT_MODBUS_EXCEPTION, functionCode, exceptionCode);
+
     // Lấy địa chỉ Slave từ gói tin yêu cầu gốc (đã lưu trong rxBuffer)
     modbus->txBuffer[0] = modbus->rxBuffer[0];
     // Set bit cao nhất của Function Code để báo lỗi
@@ -360,23 +598,9 @@ static void Modbus_HandleReadHolding(ModbusHandle* modbus, uint16_t address, uin
         return;
     }
 
-    // 5. Chuẩn bị header phản hồi
-    modbus->txBuffer[0] = modbus->rxBuffer[0]; // Slave Address
-    modbus->txBuffer[1] = READ_HOLDING;        // Function Code
-    modbus->txBuffer[2] = RegN;                // Số byte dữ liệu register theo sau
-
-    // 6. Đọc và đóng gói dữ liệu Holding Registers (Big-Endian) vào txBuffer
-    for (uint16_t i = 0; i < quantity; i++) {
-        // Đọc giá trị từ mảng holdingRegs
-        uint16_t regValue = modbus->holdingRegs[address + i];
-        // Ghi vào buffer (đảm bảo thứ tự Big-Endian)
-        Modbus_WriteU16_BE(modbus->txBuffer, 3 + i * 2, regValue);
-    }
-
-    // 7. Gửi phản hồi ID(1) + FC(1) + ByteCount(1) + Reg1Hi(1) + Reg1Lo(1) + ... + RegNHi(1) + RegNLo(1) + CRCLo(1) + CRCHi(1)
-    // RegN = quantity*2
-    // Hàm Modbus_SendResponse sẽ tự thêm CRC
-    Modbus_SendResponse(modbus, 3 + RegN);
+    // 5. Gửi phản hồi ID(1) + FC(1) + ByteCount(1) + Reg1Hi(1) + Reg1Lo(1) + ... + RegNHi(1) + RegNLo(1) + CRCLo(1) + CRCHi(1)
+    // Dữ liệu lấy từ ảnh Big-Endian, khung dựng sẵn được phát thẳng nếu còn mới
+    Modbus_SendRegisters(modbus, READ_HOLDING, address, quantity);
 }
 
 /**
@@ -401,21 +625,8 @@ static void Modbus_HandleReadInput(ModbusHandle* modbus, uint16_t address, uint1
         Modbus_SendExceptionResponse(modbus, READ_INPUT, MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE);
         return;
     }
-    // 5. Chuẩn bị header phản hồi
-    modbus->txBuffer[0] = modbus->rxBuffer[0];
-    modbus->txBuffer[1] = READ_INPUT;
-    modbus->txBuffer[2] = RegN;
-
-    // 6. Đọc và đóng gói dữ liệu Input Registers (Big-Endian) vào txBuffer
-    for (uint16_t i = 0; i < quantity; i++) {
-        uint16_t regValue = modbus->inputRegs[address + i];
-        Modbus_WriteU16_BE(modbus->txBuffer, 3 + i * 2, regValue);
-    }
-
-    // 7. Gửi phản hồi ID(1) + FC(1) + ByteCount(1) + Reg1Hi(1) + Reg1Lo(1) + ... + RegNHi(1) + RegNLo(1) + CRCLo(1) + CRCHi(1)
-    // RegN = quantity*2
-    // Hàm Modbus_SendResponse sẽ tự thêm CRC
-    Modbus_SendResponse(modbus, 3 + RegN);
+    // 5. Gửi phản hồi ID(1) + FC(1) + ByteCount(1) + Reg1Hi(1) + Reg1Lo(1) + ... + RegNHi(1) + RegNLo(1) + CRCLo(1) + CRCHi(1)
+    Modbus_SendRegisters(modbus, READ_INPUT, address, quantity);
 }
 
 /**
@@ -467,8 +678,8 @@ static void Modbus_HandleWriteSingleReg(ModbusHandle* modbus, uint16_t address,
         return;
     }
 
-    // 2. Thực hiện ghi vào bộ đệm holdingRegs
-    modbus->holdingRegs[address] = value;
+    // 2. Thực hiện ghi vào bộ đệm holdingRegs (và ảnh Big-Endian)
+    Modbus_StoreRegs(modbus, MODBUS_MAP_HOLDING, address, &value, 1);
 
 
     // ** Chỉ gửi phản hồi nếu KHÔNG phải broadcast **
@@ -600,7 +811,7 @@ static void Modbus_HandleWriteMultipleRegs(ModbusHandle* modbus, uint16_t addres
         // Đọc giá trị register 16-bit từ buffer request (Big-Endian)
         uint16_t regValue = Modbus_ReadU16_BE(regData, i * 2);
         // (Tùy chọn) Kiểm tra giá trị `regValue` nếu cần.
-        modbus->holdingRegs[address + i] = regValue; // Ghi vào mảng holdingRegs
+        Modbus_StoreRegs(modbus, MODBUS_MAP_HOLDING, address + i, &regValue, 1); // Ghi vào mảng holdingRegs
     }
 
     // Sao chéo vào 1 buffer khi có lệnh ghi khẩn cấp từ master
@@ -650,12 +861,27 @@ HAL_StatusTypeDef Modbus_Init(ModbusHandle* modbus, UART_HandleTypeDef* huart, I
     modbus->uart_irqn = uart_irqn;
     // Đặt trạng thái ban đầu là sẵn sàng
     modbus->state = MODBUS_STATE_IDLE;
-    // Reset bộ đếm byte nhận
+    // Reset bộ đếm byte nhận và hàng đợi frame
     modbus->rxCount = 0;
-
-#if MODBUS_PROCESS_IN_MAIN_LOOP == 1
-    modbus->frame_ready_for_processing = false; // Khởi tạo cờ báo
-#endif
+    modbus->rx_dma_slot = 0;
+    modbus->rxBuffer = modbus->rxFrames[0];
+    memset((void*)modbus->rx_slot_len, 0, sizeof(modbus->rx_slot_len));
+    memset(&modbus->stats, 0, sizeof(modbus->stats));
+    // Địa chỉ và trễ phản hồi mặc định; comm_settings ghi đè sau khi đọc EEPROM (ReInit giữ nguyên)
+    modbus->slave_address = SLAVE_ADDRESS;
+    modbus->response_delay_us = 0;
+
+    // Bật bộ đếm chu kỳ DWT dùng cho thống kê độ trễ
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Chuẩn bị backend CRC và so sánh với CRC tính từng bit trước khi nhận frame đầu tiên
+    Modbus_CRC_Init();
+    // Backend sai thì vẫn phải giao tiếp được: lùi về đường dự phòng thay vì bỏ Init giữa chừng
+    if (!Modbus_CRC_SelfTest()) {
+        LOG_ERROR(EVT_MODBUS_CRC_SELFTEST_FAIL, MODBUS_CRC_BACKEND);
+        Modbus_CRC_UseFallback();
+    }
 
     // Khởi tạo vùng nhớ dữ liệu (dùng critical section "mini" bằng ngắt toàn cục nếu cần)
     // Hoặc tốt hơn là đảm bảo Init không bị ngắt UART gọi vào
@@ -665,10 +891,19 @@ HAL_StatusTypeDef Modbus_Init(ModbusHandle* modbus, UART_HandleTypeDef* huart, I
     memset(modbus->holdingRegs, 0, sizeof(modbus->holdingRegs));
     memset(modbus->inputRegs, 0, sizeof(modbus->inputRegs));
     memset(modbus->holdingRegs_emergency_cpy, 0, sizeof(modbus->holdingRegs_emergency_cpy));
+    memset(modbus->holdingImage, 0, sizeof(modbus->holdingImage));
+    memset(modbus->inputImage, 0, sizeof(modbus->inputImage));
+    modbus->image_gen[MODBUS_MAP_HOLDING] = 1;
+    modbus->image_gen[MODBUS_MAP_INPUT] = 1;
+#if MODBUS_READ_CACHE_SLOTS > 0
+    memset(modbus->read_cache, 0, sizeof(modbus->read_cache));
+    modbus->read_cache_next = 0;
+#endif
     __enable_irq(); // Kích hoạt lại ngắt
 
-    memset(modbus->rxBuffer, 0, MODBUS_RX_BUFFER_SIZE);
+    memset(modbus->rxFrames, 0, sizeof(modbus->rxFrames));
     memset(modbus->txBuffer, 0, MODBUS_TX_BUFFER_SIZE);
+    modbus->tx_ptr = modbus->txBuffer;
 
     //Reset cờ báo trường hợp đặc biệt(có lệnh ghi khẩn cấp từ master)
     modbus->emergency_write_from_master = 0;
@@ -679,7 +914,11 @@ HAL_StatusTypeDef Modbus_Init(ModbusHandle* modbus, UART_HandleTypeDef* huart, I
     // dữ liệu mới đến trong một khoảng thời gian nhất định (thường là 1 frame time),
     // báo hiệu kết thúc một gói tin Modbus RTU.
     // Bắt đầu nhận DMA với Idle Line detection
-    HAL_StatusTypeDef status = HAL_UARTEx_ReceiveToIdle_DMA(modbus->huart, modbus->rxBuffer, MODBUS_RX_BUFFER_SIZE);
+    modbus->rx_line_busy = 0;
+    modbus->tx_pending_len = 0;
+    modbus->tx_delay_armed = 0;
+    Modbus_ApplyTiming(modbus);
+    HAL_StatusTypeDef status = Modbus_RxArm(modbus);
     // Chỉ kích hoạt ngắt NVIC nếu critical section được BẬT VÀ DMA bắt đầu OK
     // Chỉ kích hoạt ngắt NVIC nếu một IRQ hợp lệ được cung cấp VÀ DMA bắt đầu OK
 #if MODBUS_USE_CRITICAL_SECTION == 1
@@ -711,16 +950,16 @@ HAL_StatusTypeDef Modbus_ReInit(ModbusHandle* modbus, UART_HandleTypeDef* huart,
     modbus->uart_irqn = uart_irqn;
     // Đặt trạng thái ban đầu là sẵn sàng
     modbus->state = MODBUS_STATE_IDLE;
-    // Reset bộ đếm byte nhận
+    // Reset bộ đếm byte nhận và hàng đợi frame (bỏ frame đang chờ, nếu có)
     modbus->rxCount = 0;
-
-#if MODBUS_PROCESS_IN_MAIN_LOOP == 1
-    modbus->frame_ready_for_processing = false; // Khởi tạo cờ báo
-#endif
+    modbus->rx_dma_slot = 0;
+    modbus->rxBuffer = modbus->rxFrames[0];
+    memset((void*)modbus->rx_slot_len, 0, sizeof(modbus->rx_slot_len));
 
     modbus->emergency_write_from_master = 0;
-    memset(modbus->rxBuffer, 0, MODBUS_RX_BUFFER_SIZE);
+    memset(modbus->rxFrames, 0, sizeof(modbus->rxFrames));
     memset(modbus->txBuffer, 0, MODBUS_TX_BUFFER_SIZE);
+    modbus->tx_ptr = modbus->txBuffer;
 
     //Reset cờ báo trường hợp đặc biệt(có lệnh ghi khẩn cấp từ master)
     modbus->emergency_write_from_master = 0;
@@ -730,7 +969,11 @@ HAL_StatusTypeDef Modbus_ReInit(ModbusHandle* modbus, UART_HandleTypeDef* huart,
     // dữ liệu mới đến trong một khoảng thời gian nhất định (thường là 1 frame time),
     // báo hiệu kết thúc một gói tin Modbus RTU.
     // Bắt đầu nhận DMA với Idle Line detection
-    HAL_StatusTypeDef status = HAL_UARTEx_ReceiveToIdle_DMA(modbus->huart, modbus->rxBuffer, MODBUS_RX_BUFFER_SIZE);
+    modbus->rx_line_busy = 0;
+    modbus->tx_pending_len = 0;
+    modbus->tx_delay_armed = 0;
+    Modbus_ApplyTiming(modbus);
+    HAL_StatusTypeDef status = Modbus_RxArm(modbus);
     // Chỉ kích hoạt ngắt NVIC nếu critical section được BẬT VÀ DMA bắt đầu OK
     // Chỉ kích hoạt ngắt NVIC nếu một IRQ hợp lệ được cung cấp VÀ DMA bắt đầu OK
 #if MODBUS_USE_CRITICAL_SECTION == 1
@@ -753,16 +996,33 @@ HAL_StatusTypeDef Modbus_ReInit(ModbusHandle* modbus, UART_HandleTypeDef* huart,
  */
 void Modbus_Poll(ModbusHandle* modbus)
 {
-    // Chỉ thực hiện khi có cờ báo và trạng thái đang là PROCESSING (chờ xử lý)
-    if (modbus->frame_ready_for_processing && modbus->state == MODBUS_STATE_PROCESSING)
-    {
-        // Xóa cờ báo ngay để cho phép nhận frame mới (nếu đến nhanh)
-        // Tránh trường hợp gọi Modbus_ProcessData nhiều lần cho cùng 1 frame
-        modbus->frame_ready_for_processing = false;
+    // Đang gửi phản hồi trước đó: frame mới vẫn nằm an toàn trong slot, xử lý ở lần gọi sau
+    if (modbus->state != MODBUS_STATE_IDLE) return;
+
+    for (uint8_t slot = 0; slot < MODBUS_RX_SLOTS; slot++) {
+        uint16_t len = modbus->rx_slot_len[slot];
+        // Slot DMA đang ghi có thể đã có len != 0: frame được giao sớm (HT/TC) trước khi đường truyền rảnh.
+        // Không cần khóa ngắt vì:
+        // - DMA chỉ ghi tiếp từ vị trí end >= len, các byte [0, len) của frame không bị đổi nữa;
+        // - ISR không ghi lại len/stamp của slot này (delivered = 1), chỉ chuyển rx_dma_slot sang slot kia
+        //   khi kết thúc frame, nên slot chỉ nhận frame mới sau khi đã được trả ở đây.
+        if (len == 0) continue;
+
+        modbus->rxBuffer = modbus->rxFrames[slot];
+        modbus->rxCount = len;
+        modbus->rx_stamp = modbus->rx_slot_stamp[slot];
+
+        uint32_t queued = Modbus_CyclesToUs(DWT->CYCCNT - modbus->rx_stamp);
+        modbus->stats.queue_us_last = queued;
+        if (queued > modbus->stats.queue_us_max) modbus->stats.queue_us_max = queued;
 
         // Gọi hàm xử lý chính
+        modbus->state = MODBUS_STATE_PROCESSING;
         Modbus_ProcessData(modbus);
-        // Modbus_ProcessData sẽ chuyển state sang TRANSMITTING hoặc IDLE sau khi xử lý xong
+        // Modbus_ProcessData sẽ chuyển state sang TRANSMITTING hoặc IDLE sau khi xử lý xong.
+        // txBuffer đã chứa phản hồi nên có thể trả slot cho ngắt ngay.
+        modbus->rx_slot_len[slot] = 0;
+        break;
     }
 }
 #endif
@@ -781,10 +1041,6 @@ void Modbus_ProcessData(ModbusHandle* modbus) {
 #else
     // Chế độ Main Loop: Phải bắt đầu từ PROCESSING
     if (modbus->state != MODBUS_STATE_PROCESSING) {
-         // Nếu state không phải PROCESSING mà cờ lại bật -> Lỗi logic, reset cờ
-        if(modbus->frame_ready_for_processing) {
-            modbus->frame_ready_for_processing = false;
-        }
         return; // Không ở trạng thái chờ xử lý
     }
     // State đã là PROCESSING, không cần set lại
@@ -799,7 +1055,7 @@ void Modbus_ProcessData(ModbusHandle* modbus) {
     }
 
     // 2. Kiểm tra địa chỉ Slave Address (byte đầu tiên)
-    if (modbus->rxBuffer[0] != SLAVE_ADDRESS && modbus->rxBuffer[0] != 0) { // Địa chỉ 0 là broadcast
+    if (modbus->rxBuffer[0] != modbus->slave_address && modbus->rxBuffer[0] != 0) { // Địa chỉ 0 là broadcast
         // Không phải gói tin cho Slave này (và không phải broadcast) -> Bỏ qua.
     	modbus->state = MODBUS_STATE_IDLE;
         return;
@@ -811,20 +1067,8 @@ void Modbus_ProcessData(ModbusHandle* modbus) {
     bool is_broadcast = (modbus->rxBuffer[0] == 0);
 
 
-    // 3. Kiểm tra CRC16
-    // Lấy CRC nhận được từ 2 byte cuối của rxBuffer (Little Endian trên dây)
-    uint16_t receivedCrc = ((uint16_t)modbus->rxBuffer[modbus->rxCount - 1] << 8) |
-                            (uint16_t)modbus->rxBuffer[modbus->rxCount - 2];
-    // Tính CRC cho dữ liệu nhận được (trừ 2 byte CRC cuối)
-    uint16_t calculatedCrc = Modbus_CRC16_Table(modbus->rxBuffer, modbus->rxCount - 2);
-
-    // So sánh CRC (cả hai đều ở dạng Little Endian trong thanh ghi)
-    if (receivedCrc != calculatedCrc) {
-        // Lỗi CRC -> Bỏ qua gói tin.
-        // Có thể đếm số lần lỗi CRC để chẩn đoán.
-    	modbus->state = MODBUS_STATE_IDLE;
-        return;
-    }
+    // 3. CRC16 đã được kiểm tra dần trong lúc nhận (Modbus_RxParse),
+    //    chỉ frame đúng CRC mới được giao tới đây.
 
     // --- Nếu đến đây: Địa chỉ đúng (hoặc broadcast), CRC đúng ---
 
@@ -904,48 +1148,251 @@ void Modbus_ProcessData(ModbusHandle* modbus) {
 }
 
 /**
- * @brief Callback khi UART nhận xong dữ liệu (sử dụng Idle Line + DMA).
+ * @brief Callback khi UART nhận dữ liệu (sự kiện HT/TC của DMA hoặc Idle Line).
  */
 void Modbus_UartRxCpltCallback(ModbusHandle* modbus, uint16_t Size) {
-    // 1. Cập nhật số byte đã nhận
-    modbus->rxCount = Size;
+    // Size tính từ đầu đoạn DMA hiện tại, quy về vị trí trong frame
+    Modbus_RxUpdate(modbus, modbus->rx_parser.dma_base + Size, HAL_UARTEx_GetRxEventType(modbus->huart));
+}
 
-    // 2. Chỉ xử lý nếu đang ở trạng thái IDLE
-    if (modbus->state == MODBUS_STATE_IDLE) {
-        if (Size > 0) { // Chỉ xử lý nếu thực sự có dữ liệu
-#if MODBUS_PROCESS_IN_MAIN_LOOP == 0
-            // Chế độ Callback: Gọi xử lý ngay
-            Modbus_ProcessData(modbus);
+#if MODBUS_RTU_TIMING == 1
+/**
+ * @brief Chạy MODBUS_T35_TIM một lần, ngắt sau us micro giây (1..65536).
+ */
+static void Modbus_TimerStart(uint32_t us) {
+    MODBUS_T35_TIM->CR1 &= ~TIM_CR1_CEN;
+    MODBUS_T35_TIM->CNT = 0;
+    MODBUS_T35_TIM->ARR = us - 1U;
+    MODBUS_T35_TIM->SR = 0;
+    MODBUS_T35_TIM->CR1 |= TIM_CR1_CEN;
+}
+#endif
+
+/**
+ * @brief Nhả đường truyền và phát phản hồi đang chờ (nếu có).
+ */
+static void Modbus_TxRelease(ModbusHandle* modbus) {
+    modbus->rx_line_busy = 0;
+    if (modbus->tx_pending_len != 0) {
+        uint16_t size = modbus->tx_pending_len;
+        modbus->tx_pending_len = 0;
+        Modbus_StartTransmit(modbus, size);
+    }
+}
+
+/**
+ * @brief Cập nhật frame đang nhận tới vị trí end.
+ * @param event HAL_UART_RXEVENT_HT/TC: hết nửa/cả đoạn DMA.
+ *              HAL_UART_RXEVENT_IDLE: đường truyền rảnh (Idle Line hoặc hết t3.5) = kết thúc frame.
+ */
+static void Modbus_RxUpdate(ModbusHandle* modbus, uint16_t end, uint32_t event) {
+    uint32_t isr_start = DWT->CYCCNT;
+    bool notify = false;
+    ModbusRxParser* p = &modbus->rx_parser;
+    uint8_t* frame = modbus->rxFrames[modbus->rx_dma_slot];
+
+    // 1. Đưa các byte mới qua bộ phân tích
+    Modbus_RxParse(p, modbus->slave_address, frame, end);
+
+    bool frame_end = (event == HAL_UART_RXEVENT_IDLE);
+    if (event == HAL_UART_RXEVENT_TC) {
+#if MODBUS_RTU_TIMING == 1
+        // Hết đoạn DMA: t3.5 sẽ kết thúc frame, chỉ dừng ở đây khi bộ đệm đã đầy.
+        frame_end = (end >= MODBUS_RX_BUFFER_SIZE);
 #else
-            // Chế độ Main Loop: Đặt cờ và chuyển state chờ xử lý
-            modbus->state = MODBUS_STATE_PROCESSING; // Giữ buffer, chờ main loop
-            modbus->frame_ready_for_processing = true;   // Báo cho Modbus_Poll
+        // Hết đoạn DMA. IDLE ngay sau TC không sinh callback (đoạn mới chưa có byte nào),
+        // nên frame đã có kết luận thì kết thúc luôn tại đây. FC không hỗ trợ thì coi CRC = 0 là hết frame.
+        frame_end = (p->verdict == MODBUS_RX_COMPLETE) || (p->verdict == MODBUS_RX_BAD_CRC) ||
+                    (p->verdict == MODBUS_RX_BAD_LENGTH) || (end >= MODBUS_RX_BUFFER_SIZE) ||
+                    (p->verdict == MODBUS_RX_PENDING && p->expected == 0 &&
+                     end >= MODBUS_MIN_FRAME_SIZE && p->crc == 0);
 #endif
+    }
+    if (frame_end) {
+        Modbus_RxFinish(p, end);
+    }
 
+    // 2. Frame hợp lệ: giao xử lý ngay, kể cả khi Master chưa nhả đường truyền
+    if (p->verdict == MODBUS_RX_COMPLETE && !p->delivered) {
+        p->delivered = 1;
+        if (!frame_end) {
+            modbus->rx_line_busy = 1;   // Phản hồi sẽ được giữ tới IDLE
+            modbus->stats.frames_early++;
         }
-        // Modbus_ProcessData sẽ thay đổi state thành PROCESSING hoặc TRANSMITTING nếu hợp lệ,
-        // hoặc giữ nguyên IDLE nếu gói tin bị bỏ qua.
-    } else {
-        // Đang bận (PROCESSING hoặc TRANSMITTING), bỏ qua frame này.
-        // Việc này là bình thường nếu Master gửi liên tục mà Slave chưa xử lý xong.
-        // Có thể đếm số lần bỏ qua để theo dõi.
-    	 modbus->rxCount = 0; // Reset count để tránh xử lý dữ liệu cũ/không hoàn chỉnh
+#if MODBUS_RTU_TIMING == 1
+        if (modbus->response_delay_us != 0) {
+            modbus->rx_line_busy = 1;   // Giữ tiếp hết trễ phản hồi sau t3.5
+        }
+#endif
+        notify = Modbus_RxDeliver(modbus, frame, (p->expected != 0) ? p->expected : end, isr_start);
     }
 
-    // 3. **QUAN TRỌNG:** Khởi động lại việc nhận DMA cho frame tiếp theo NGAY LẬP TỨC.
-    // Dù frame vừa nhận có hợp lệ hay không, dù Slave có đang bận hay không,
-    // vẫn phải luôn sẵn sàng để nhận frame kế tiếp.
-    HAL_StatusTypeDef status = HAL_UARTEx_ReceiveToIdle_DMA(modbus->huart, modbus->rxBuffer, MODBUS_RX_BUFFER_SIZE);
+    HAL_StatusTypeDef status = HAL_OK;
+    if (frame_end) {
+        switch (p->verdict) {
+        case MODBUS_RX_FOREIGN:
+            modbus->stats.frames_foreign++;
+            break;
+        case MODBUS_RX_BAD_CRC: {
+            uint16_t len = (p->expected != 0) ? p->expected : end;
+            (void)len;  // Chỉ dùng khi LOG_DEBUG được bật
+            modbus->stats.frames_crc_err++;
+            // CRC tính lại chỉ khi log được bật, frame lỗi hiếm nên không đáng kể
+            LOG_DEBUG(EVT_MODBUS_CRC_ERROR, len,
+                      ((uint16_t)frame[len - 1] << 8) | frame[len - 2],
+                      Modbus_CRC16(frame, len - 2));
+            break;
+        }
+        case MODBUS_RX_BAD_LENGTH:
+            modbus->stats.frames_bad_len++;
+            LOG_DEBUG(EVT_MODBUS_BAD_LENGTH, end, p->expected);
+            break;
+        default:
+            break;
+        }
+
+#if MODBUS_PROCESS_IN_MAIN_LOOP == 1
+        // Frame đã xếp hàng: DMA chuyển sang slot kia (đã kiểm tra trống khi xếp hàng).
+        if (p->queued) {
+            modbus->rx_dma_slot = (uint8_t)((modbus->rx_dma_slot + 1) % MODBUS_RX_SLOTS);
+        }
+#endif
+        // Đường truyền đã rảnh: phát phản hồi đang chờ (nếu có)
+#if MODBUS_RTU_TIMING == 1
+        if (p->delivered && modbus->response_delay_us != 0) {
+            // Master cần thêm thời gian chuyển sang nhận: timer đếm tiếp trễ phản hồi rồi mới phát
+            modbus->tx_delay_armed = 1;
+            Modbus_TimerStart(modbus->response_delay_us);
+        } else
+#endif
+        {
+            Modbus_TxRelease(modbus);
+        }
+
+        // 3. **QUAN TRỌNG:** Khởi động lại việc nhận DMA cho frame tiếp theo NGAY LẬP TỨC.
+        // Dù frame vừa nhận có hợp lệ hay không, dù Slave có đang bận hay không,
+        // vẫn phải luôn sẵn sàng để nhận frame kế tiếp.
+#if MODBUS_RTU_TIMING == 1
+        // Kết thúc bởi t3.5 (không phải IDLE của HAL): DMA vẫn đang chạy, phải dừng trước.
+        HAL_UART_AbortReceive(modbus->huart);
+#endif
+        status = Modbus_RxArm(modbus);
+    } else if (event == HAL_UART_RXEVENT_TC) {
+        // Frame dài hơn đoạn DMA: nhận tiếp vào phần còn lại của cùng bộ đệm
+        p->dma_base = end;
+        status = Modbus_RxStartDMA(modbus, frame + end, MODBUS_RX_BUFFER_SIZE - end);
+    }
     if (status != HAL_OK) {
         // Lỗi nghiêm trọng: Không thể khởi động lại DMA Receive!
-        // Cần có cơ chế phục hồi lỗi ở đây (vd: reset Modbus, báo lỗi hệ thống).
-        // Có thể set state về IDLE để thử lại ở lần sau? Hoặc một trạng thái lỗi riêng.
+        // Frame đã chụp (nếu có) vẫn được giữ cho Modbus_Poll.
         modbus->state = MODBUS_STATE_IDLE; // Tạm thời quay về IDLE
-        // Nên có log hoặc cờ báo lỗi.
-#if MODBUS_PROCESS_IN_MAIN_LOOP == 1
-        modbus->frame_ready_for_processing = false; // Reset cờ
+        LOG_ERROR(EVT_MODBUS_RX_RESTART_FAIL, status);
+    }
+
+    uint32_t isr_cycles = DWT->CYCCNT - isr_start;
+    modbus->stats.isr_cycles_last = isr_cycles;
+    if (isr_cycles > modbus->stats.isr_cycles_max) modbus->stats.isr_cycles_max = isr_cycles;
+
+    if (notify) {
+        Modbus_FrameReadyCallback(modbus);
+    }
+}
+
+/**
+ * @brief Tra ngưỡng t1.5/t3.5 cho một tốc độ baud.
+ */
+static ModbusRtuTiming Modbus_LookupTiming(uint32_t baud) {
+    for (uint8_t i = 0; i < sizeof(modbus_rtu_timing_table) / sizeof(modbus_rtu_timing_table[0]); i++) {
+        if (modbus_rtu_timing_table[i].baud == baud) return modbus_rtu_timing_table[i];
+    }
+    ModbusRtuTiming t = { baud, 750, 1750 };
+    if (baud != 0 && baud <= 19200) {
+        // 1.5 và 3.5 ký tự 11 bit, làm tròn lên
+        t.t15_us = (uint16_t)((16500000UL + baud - 1U) / baud);
+        t.t35_us = (uint16_t)((38500000UL + baud - 1U) / baud);
+    }
+    return t;
+}
+
+#if MODBUS_RTU_TIMING == 1
+/**
+ * @brief Clock của timer trên APB1 (gấp đôi PCLK1 khi bộ chia APB1 khác 1, TIMPRE = 0).
+ */
+static uint32_t Modbus_TimerClock(void) {
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR2 & RCC_CFGR2_PPRE1_2) != 0U) pclk *= 2U;
+    return pclk;
+}
+#endif
+
+void Modbus_ApplyTiming(ModbusHandle* modbus) {
+    modbus->timing = Modbus_LookupTiming(modbus->huart->Init.BaudRate);
+#if MODBUS_RTU_TIMING == 1
+    // Timer one-pulse, tick 1 us, chỉ ngắt khi tràn (URS: ghi UG không sinh ngắt)
+    MODBUS_T35_TIM_CLK_ENABLE();
+    MODBUS_T35_TIM->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+    MODBUS_T35_TIM->PSC = Modbus_TimerClock() / 1000000U - 1U;
+    MODBUS_T35_TIM->EGR = TIM_EGR_UG;
+    MODBUS_T35_TIM->SR = 0;
+    MODBUS_T35_TIM->DIER = TIM_DIER_UIE;
+    // Cùng mức ưu tiên với GPDMA1_Channel0 (sự kiện HT/TC của Modbus RX) để không chen ngang nhau
+    HAL_NVIC_SetPriority(MODBUS_T35_TIM_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(MODBUS_T35_TIM_IRQn);
+
+    // Receiver timeout tính bằng số bit, đếm từ stop bit của ký tự cuối
+    uint32_t rto_bits = ((uint32_t)modbus->timing.t15_us * modbus->huart->Init.BaudRate + 999999U) / 1000000U;
+    HAL_UART_ReceiverTimeout_Config(modbus->huart, rto_bits);
+    HAL_UART_EnableReceiverTimeout(modbus->huart);
+    ATOMIC_SET_BIT(modbus->huart->Instance->CR1, USART_CR1_RTOIE);
+#endif
+}
+
+void Modbus_UartIRQHandler(ModbusHandle* modbus) {
+#if MODBUS_RTU_TIMING == 1
+    USART_TypeDef* uart = modbus->huart->Instance;
+    if ((uart->ISR & USART_ISR_RTOF) != 0U && (uart->CR1 & USART_CR1_RTOIE) != 0U) {
+        // Xóa cờ trước khi HAL_UART_IRQHandler đọc ISR, nếu không HAL sẽ coi là lỗi và dừng DMA
+        __HAL_UART_CLEAR_FLAG(modbus->huart, UART_CLEAR_RTOF);
+        // Im lặng t1.5 kể từ ký tự cuối: ghi lại vị trí và hẹn giờ phần còn lại tới t3.5
+        // Master gửi tiếp khi đang chờ trễ phản hồi: bỏ trễ, phản hồi được phát khi frame mới kết thúc
+        modbus->tx_delay_armed = 0;
+        modbus->rx_t15_pos = Modbus_RxPosition(modbus);
+        Modbus_TimerStart((uint32_t)(modbus->timing.t35_us - modbus->timing.t15_us));
+    }
+#else
+    (void)modbus;
+#endif
+}
+
+void Modbus_TimerIRQHandler(ModbusHandle* modbus) {
+#if MODBUS_RTU_TIMING == 1
+    if ((MODBUS_T35_TIM->SR & TIM_SR_UIF) == 0U) return;
+    MODBUS_T35_TIM->SR = (uint32_t)~TIM_SR_UIF;
+
+    if (modbus->tx_delay_armed) {
+        // Hết trễ phản hồi
+        modbus->tx_delay_armed = 0;
+        Modbus_TxRelease(modbus);
+        return;
+    }
+
+    uint16_t pos = Modbus_RxPosition(modbus);
+    if (pos != modbus->rx_t15_pos) {
+        // Có byte mới sau khoảng lặng > t1.5 nhưng < t3.5: frame bị ngắt quãng.
+        // RTO sẽ hẹn lại t3.5 tính từ ký tự cuối mới.
+        modbus->stats.t15_gaps++;
+#if MODBUS_T15_STRICT == 1
+        if (modbus->rx_parser.verdict == MODBUS_RX_PENDING || modbus->rx_parser.verdict == MODBUS_RX_FOREIGN) {
+            modbus->rx_parser.verdict = MODBUS_RX_BAD_TIMING;
+        }
 #endif
+        return;
     }
+    if (pos == 0) return; // Không có frame đang nhận (frame trước đã kết thúc khi đầy bộ đệm)
+    Modbus_RxUpdate(modbus, pos, HAL_UART_RXEVENT_IDLE);
+#else
+    (void)modbus;
+#endif
 }
 
 /**
@@ -959,6 +1406,15 @@ void Modbus_UartTxCpltCallback(ModbusHandle* modbus) {
 }
 void Modbus_HAL_ErrorCallback(ModbusHandle* modbus, UART_HandleTypeDef* huart) {
 	    if (huart == modbus->huart){
+		LOG_WARN(EVT_MODBUS_UART_ERROR, huart->ErrorCode);
+#if MODBUS_RTU_TIMING == 1
+		// Ngắt timer t3.5 ưu tiên cao hơn USART: dừng timer và xóa cờ trước khi đặt lại,
+		// để nó không chen vào giữa lúc reset, hủy nhận và Modbus_RxArm.
+		// Timer chỉ chạy lại khi RTO của frame kế tiếp gọi Modbus_TimerStart.
+		MODBUS_T35_TIM->CR1 &= ~TIM_CR1_CEN;
+		MODBUS_T35_TIM->SR = 0;
+		NVIC_ClearPendingIRQ(MODBUS_T35_TIM_IRQn);
+#endif
 		// Quan trọng: Phải xóa các cờ lỗi trong thanh ghi trạng thái UART
 		// Để ngăn chặn ngắt lỗi lặp lại hoặc trạng thái treo.
 		__HAL_UART_CLEAR_PEFLAG(huart);   // Parity Error
@@ -967,19 +1423,25 @@ void Modbus_HAL_ErrorCallback(ModbusHandle* modbus, UART_HandleTypeDef* huart) {
 		__HAL_UART_CLEAR_OREFLAG(huart);  // Overrun Error
 		__HAL_UART_CLEAR_IDLEFLAG(huart); // Cân nhắc nếu gặp vấn đề với Idle Line sau lỗi
 
+		// Bỏ phản hồi đang chờ IDLE: frame bị lỗi đường truyền giữa chừng
+		modbus->rx_line_busy = 0;
+		modbus->tx_pending_len = 0;
+		modbus->tx_delay_armed = 0;
 		// Đặt lại trạng thái Modbus về IDLE và reset bộ đếm
-		modbus->state = MODBUS_STATE_IDLE;
-
 #if MODBUS_PROCESS_IN_MAIN_LOOP == 1
-        // Reset cờ báo nếu có lỗi
-        modbus->frame_ready_for_processing = false;
-#endif
-
+		// Main loop đang xử lý frame: để Modbus_ProcessData tự kết thúc, chỉ gỡ kẹt khi đang gửi.
+		if (modbus->state != MODBUS_STATE_PROCESSING) {
+			modbus->state = MODBUS_STATE_IDLE;
+		}
+#else
+		modbus->state = MODBUS_STATE_IDLE;
 		modbus->rxCount = 0;
+#endif
         // Cố gắng hủy bỏ thao tác nhận hiện tại (nếu có) và khởi động lại DMA nhận
-        // HAL_UART_AbortReceive() có thể cần thiết tùy thuộc vào trạng thái lỗi
+        // HAL_UART_AbortReceive() có thể cần thiết tùy thuộc vào trạng thái lỗi.
+        // Frame đã chụp trong slot chờ xử lý không bị ảnh hưởng.
         HAL_UART_AbortReceive(huart); // Thử dừng nhận hiện tại
-        HAL_StatusTypeDef status = HAL_UARTEx_ReceiveToIdle_DMA(modbus->huart, modbus->rxBuffer, MODBUS_RX_BUFFER_SIZE);
+        HAL_StatusTypeDef status = Modbus_RxArm(modbus);
         // Kích hoạt lại ngắt NVIC chỉ khi cần và có thể
 #if MODBUS_USE_CRITICAL_SECTION == 1
         if (status == HAL_OK && modbus->uart_irqn != MODBUS_IRQN_NONE) {
@@ -989,6 +1451,51 @@ void Modbus_HAL_ErrorCallback(ModbusHandle* modbus, UART_HandleTypeDef* huart) {
 	  }
 }
 
+/**
+ * @brief Mặc định không làm gì, ứng dụng ghi đè để đánh thức tác vụ Modbus_Poll.
+ */
+__weak void Modbus_FrameReadyCallback(ModbusHandle* modbus) {
+    (void)modbus;
+}
+
+/**
+ * @brief Ghi nguyên tử một dải Holding Registers từ ứng dụng.
+ */
+bool Modbus_PublishHoldingRegs(ModbusHandle* modbus, uint16_t start, const uint16_t* values, uint16_t count) {
+    if (modbus == NULL || values == NULL || count == 0) return false;
+    if ((uint32_t)start + count > MAX_HOLDING_REGS) return false;
+
+    // Critical section ngắn (vài trăm ns cho 10 register), an toàn cả khi
+    // Modbus được xử lý trong ngắt (MODBUS_PROCESS_IN_MAIN_LOOP = 0).
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    Modbus_StoreRegs(modbus, MODBUS_MAP_HOLDING, start, values, count);
+    __set_PRIMASK(primask);
+    return true;
+}
+
+void Modbus_RefreshReadCache(ModbusHandle* modbus) {
+#if MODBUS_READ_CACHE_SLOTS > 0
+    if (modbus == NULL) return;
+    for (uint8_t i = 0; i < MODBUS_READ_CACHE_SLOTS; i++) {
+        ModbusReadCache* c = &modbus->read_cache[i];
+        if (c->fc == 0) continue;
+        uint8_t map = (c->fc == READ_HOLDING) ? MODBUS_MAP_HOLDING : MODBUS_MAP_INPUT;
+        if (c->gen == modbus->image_gen[map]) continue;
+        // Dựng trong critical section (vài us cho 16 register): ngắt có thể đang xử lý frame (chế độ 0).
+        // Khung đang được DMA phát thì để lần gọi sau.
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        if (!(modbus->state == MODBUS_STATE_TRANSMITTING && modbus->tx_ptr == c->frame)) {
+            Modbus_BuildReadFrame(modbus, c, c->frame[0], c->fc, c->start, c->quantity);
+        }
+        __set_PRIMASK(primask);
+    }
+#else
+    (void)modbus;
+#endif
+}
+
 
 
 /**
@@ -0,0 +1,184 @@
+/*
+ * adc_ring.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "adc_ring.h"
+
+static uint16_t adc_ring[2][ADC_RING_SCANS_PER_HALF][ADC_RING_CHANNELS] __attribute__((aligned(4)));
+
+static DMA_NodeTypeDef adc_ring_node __attribute__((aligned(32)));
+static DMA_QListTypeDef adc_ring_queue;
+static uint8_t adc_ring_queue_ready = 0;
+
+static ADC_HandleTypeDef* ring_hadc;
+static volatile uint32_t ring_seq;       // Số khối đã đầy
+static volatile uint32_t ring_cycles;    // DWT->CYCCNT của khối mới nhất
+static uint32_t ring_taken;              // seq của khối lấy gần nhất
+static ADC_Ring_Stats ring_stats;
+
+static uint32_t ADC_Ring_TimerClock(void) {
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR2 & RCC_CFGR2_PPRE1_2) != 0U) pclk *= 2U;
+    return pclk;
+}
+
+/**
+ * @brief Node linked-list duy nhất trỏ về chính nó: DMA ghi cả bộ đệm rồi quay lại đầu,
+ *        HT/TC của block chính là ranh giới 2 nửa. Địa chỉ và độ dài do HAL_ADC_Start_DMA điền.
+ */
+static HAL_StatusTypeDef ADC_Ring_BuildQueue(ADC_HandleTypeDef* hadc) {
+    DMA_NodeConfTypeDef node = {0};
+
+    node.NodeType = DMA_GPDMA_LINEAR_NODE;
+    node.Init.Request = GPDMA1_REQUEST_ADC1;
+    node.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    node.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    node.Init.SrcInc = DMA_SINC_FIXED;
+    node.Init.DestInc = DMA_DINC_INCREMENTED;
+    node.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_HALFWORD;
+    node.Init.DestDataWidth = DMA_DEST_DATAWIDTH_HALFWORD;
+    node.Init.SrcBurstLength = 1;
+    node.Init.DestBurstLength = 1;
+    node.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT1;
+    node.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    node.DataHandlingConfig.DataExchange = DMA_EXCHANGE_NONE;
+    node.DataHandlingConfig.DataAlignment = DMA_DATA_RIGHTALIGN_ZEROPADDED;
+    node.TriggerConfig.TriggerPolarity = DMA_TRIG_POLARITY_MASKED;
+    node.SrcAddress = (uint32_t)&hadc->Instance->DR;
+    node.DstAddress = (uint32_t)adc_ring;
+    node.DataSize = sizeof(adc_ring);
+
+    if (HAL_DMAEx_List_BuildNode(&node, &adc_ring_node) != HAL_OK) return HAL_ERROR;
+    if (HAL_DMAEx_List_InsertNode_Tail(&adc_ring_queue, &adc_ring_node) != HAL_OK) return HAL_ERROR;
+    return HAL_DMAEx_List_SetCircularMode(&adc_ring_queue);
+}
+
+/**
+ * @brief MX_ADC1_Init/HAL_ADC_MspInit cấu hình DMA ở chế độ normal: chuyển kênh sang linked-list vòng.
+ */
+static HAL_StatusTypeDef ADC_Ring_ConfigDMA(ADC_HandleTypeDef* hadc) {
+    DMA_HandleTypeDef* hdma = hadc->DMA_Handle;
+
+    if (!adc_ring_queue_ready) {
+        if (ADC_Ring_BuildQueue(hadc) != HAL_OK) return HAL_ERROR;
+        adc_ring_queue_ready = 1;
+    }
+    HAL_DMA_DeInit(hdma);
+    hdma->InitLinkedList.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT;
+    hdma->InitLinkedList.LinkStepMode = DMA_LSM_FULL_EXECUTION;
+    hdma->InitLinkedList.LinkAllocatedPort = DMA_LINK_ALLOCATED_PORT1;
+    hdma->InitLinkedList.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    hdma->InitLinkedList.LinkedListMode = DMA_LINKEDLIST_CIRCULAR;
+    if (HAL_DMAEx_List_Init(hdma) != HAL_OK) return HAL_ERROR;
+    if (HAL_DMAEx_List_LinkQ(hdma, &adc_ring_queue) != HAL_OK) return HAL_ERROR;
+    // HAL_DMA_DeInit xóa Parent: liên kết lại để callback DMA tìm được ADC
+    __HAL_LINKDMA(hadc, DMA_Handle, *hdma);
+    return HAL_DMA_ConfigChannelAttributes(hdma, DMA_CHANNEL_NPRIV);
+}
+
+HAL_StatusTypeDef ADC_Ring_Start(ADC_HandleTypeDef* hadc) {
+    ring_hadc = hadc;
+    ring_seq = 0;
+    ring_taken = 0;
+
+    // Trigger timer: tick 1 us, TRGO ở mỗi lần tràn
+    ADC_RING_TIM_CLK_ENABLE();
+    ADC_RING_TIM->CR1 = 0;
+    ADC_RING_TIM->PSC = ADC_Ring_TimerClock() / 1000000U - 1U;
+    ADC_RING_TIM->ARR = 1000000U / ADC_RING_SCAN_HZ - 1U;
+    ADC_RING_TIM->CR2 = TIM_TRGO_UPDATE;
+    ADC_RING_TIM->EGR = TIM_EGR_UG;
+    ADC_RING_TIM->SR = 0;
+
+    // Mỗi TRGO quét đủ 5 rank, DMA được yêu cầu liên tục (DMACFG = circular)
+    hadc->Init.ExternalTrigConv = ADC_RING_TRIGGER;
+    hadc->Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    hadc->Init.ContinuousConvMode = DISABLE;
+    hadc->Init.DMAContinuousRequests = ENABLE;
+    if (HAL_ADC_Init(hadc) != HAL_OK) return HAL_ERROR;
+    if (ADC_Ring_ConfigDMA(hadc) != HAL_OK) return HAL_ERROR;
+    if (HAL_ADC_Start_DMA(hadc, (uint32_t*)adc_ring, ADC_RING_LENGTH) != HAL_OK) return HAL_ERROR;
+
+    ADC_RING_TIM->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+void ADC_Ring_Stop(ADC_HandleTypeDef* hadc) {
+    ADC_RING_TIM->CR1 &= ~TIM_CR1_CEN;
+    HAL_ADC_Stop_DMA(hadc);
+}
+
+static void ADC_Ring_BlockDone(ADC_HandleTypeDef* hadc) {
+    if (hadc != ring_hadc) return;
+    ring_cycles = DWT->CYCCNT;
+    ring_seq++;
+    ring_stats.blocks++;
+    ADC_Ring_BlockReadyCallback();
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc) {
+    ADC_Ring_BlockDone(hadc);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
+    ADC_Ring_BlockDone(hadc);
+}
+
+/**
+ * @brief Ngắt ADC1 bật (adc_trip.c) thì overrun cũng được báo về đây. Dữ liệu vẫn vào vòng;
+ *        nếu DMA dừng hẳn, Reset_ADC_DMA sẽ khởi động lại sau thời gian chờ.
+ */
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* hadc) {
+    if (hadc == ring_hadc) ring_stats.errors++;
+}
+
+bool ADC_Ring_GetBlock(ADC_Ring_Block* block) {
+    uint32_t seq, cycles;
+    // seq và cycles phải cùng một khối: đọc lại nếu ngắt chen vào giữa
+    do {
+        seq = ring_seq;
+        cycles = ring_cycles;
+    } while (seq != ring_seq);
+
+    if (seq == ring_taken) return false;
+    if (seq - ring_taken > 1U) ring_stats.missed += seq - ring_taken - 1U;
+    ring_taken = seq;
+
+    // Khối lẻ là nửa đầu (HT), khối chẵn là nửa sau (TC)
+    block->scans = (const uint16_t (*)[ADC_RING_CHANNELS])adc_ring[(seq - 1U) & 1U];
+    block->seq = seq;
+    block->first_scan = (seq - 1U) * ADC_RING_SCANS_PER_HALF;
+    block->cycles = cycles;
+    return true;
+}
+
+bool ADC_Ring_BlockValid(const ADC_Ring_Block* block) {
+    // Khi khối kế tiếp đầy, DMA đã bắt đầu ghi lại nửa của khối này
+    if (ring_seq != block->seq) {
+        ring_stats.torn++;
+        return false;
+    }
+    return true;
+}
+
+void ADC_Ring_Mean(const ADC_Ring_Block* block, float out[ADC_RING_CHANNELS]) {
+    for (uint8_t ch = 0; ch < ADC_RING_CHANNELS; ch++) {
+        uint32_t sum = 0;
+        for (uint8_t s = 0; s < ADC_RING_SCANS_PER_HALF; s++) {
+            sum += block->scans[s][ch];
+        }
+        out[ch] = (float)sum * (1.0f / ADC_RING_SCANS_PER_HALF);
+    }
+}
+
+const ADC_Ring_Stats* ADC_Ring_GetStats(void) {
+    return &ring_stats;
+}
+
+/**
+ * @brief Mặc định không làm gì, ứng dụng ghi đè để đánh thức tác vụ xử lý ADC.
+ */
+__weak void ADC_Ring_BlockReadyCallback(void) {
+}
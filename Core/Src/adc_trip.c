@@ -0,0 +1,146 @@
+/*
+ * adc_trip.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "adc_trip.h"
+#include "sensor_config.h"
+#include "eev_control.h"
+#include "eev_board.h"
+#include "log_level.h"
+
+// Kênh theo rank của ADC1 (xem MX_ADC1_Init)
+#define ADC_TRIP_CH_HIGH_PRESSURE   ADC_CHANNEL_15
+#define ADC_TRIP_CH_DISCHARGE_TEMP  ADC_CHANNEL_1
+
+static ADC_HandleTypeDef* trip_hadc;
+static ADC_Trip_State trips[ADC_TRIP_COUNT];
+static uint32_t trip_logged[ADC_TRIP_COUNT];   // count đã log
+
+static const struct {
+    uint32_t awd;        // ADC_ANALOGWATCHDOG_x
+    uint32_t ll_awd;     // LL_ADC_AWDx
+    uint32_t it;         // ADC_IT_AWDx (cũng là cờ ADC_FLAG_AWDx)
+    uint32_t channel;
+    uint32_t filtering;
+} trip_hw[ADC_TRIP_COUNT] = {
+    [ADC_TRIP_HIGH_PRESSURE]  = { ADC_ANALOGWATCHDOG_1, LL_ADC_AWD1, ADC_IT_AWD1, ADC_TRIP_CH_HIGH_PRESSURE,  ADC_AWD_FILTERING_4SAMPLES },
+    [ADC_TRIP_DISCHARGE_TEMP] = { ADC_ANALOGWATCHDOG_2, LL_ADC_AWD2, ADC_IT_AWD2, ADC_TRIP_CH_DISCHARGE_TEMP, ADC_AWD_FILTERING_NONE },
+};
+
+static uint16_t ADC_Trip_Threshold(ADC_Trip_Id id) {
+    if (id == ADC_TRIP_HIGH_PRESSURE) {
+        return SensorConfig_ToAdc(SENSOR_CH_HIGH_PRESSURE, ADC_TRIP_HIGH_PRESSURE_BAR);
+    }
+    return SensorConfig_ToAdc(SENSOR_CH_DAU_DAY, ADC_TRIP_DISCHARGE_TEMP_C);
+}
+
+// Cửa sổ [0, threshold]: chỉ vượt trên mới trip
+static void ADC_Trip_LoadThreshold(ADC_Trip_Id id, uint16_t raw) {
+    uint32_t high = (id == ADC_TRIP_HIGH_PRESSURE) ? ADC_AWD1THRESHOLD_SHIFT_RESOLUTION(trip_hadc, raw)
+                                                   : ADC_AWD23THRESHOLD_SHIFT_RESOLUTION(trip_hadc, raw);
+    LL_ADC_ConfigAnalogWDThresholds(trip_hadc->Instance, trip_hw[id].ll_awd, high, 0);
+    trips[id].threshold = raw;
+}
+
+HAL_StatusTypeDef ADC_Trip_Init(ADC_HandleTypeDef* hadc) {
+    ADC_AnalogWDGConfTypeDef awd = {0};
+
+    trip_hadc = hadc;
+    for (uint8_t id = 0; id < ADC_TRIP_COUNT; id++) {
+        awd.WatchdogNumber = trip_hw[id].awd;
+        awd.WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REG;
+        awd.Channel = trip_hw[id].channel;
+        // Đang trip (khởi động lại ADC giữa chừng) thì giữ ngắt tắt đến khi ADC_Trip_Process nhả
+        awd.ITMode = trips[id].active ? DISABLE : ENABLE;
+        awd.HighThreshold = ADC_Trip_Threshold((ADC_Trip_Id)id);
+        awd.LowThreshold = 0;
+        awd.FilteringConfig = trip_hw[id].filtering;
+        if (HAL_ADC_AnalogWDGConfig(hadc, &awd) != HAL_OK) return HAL_ERROR;
+        trips[id].threshold = (uint16_t)awd.HighThreshold;
+    }
+    // Cùng mức ưu tiên cao nhất như các ngắt DMA
+    HAL_NVIC_SetPriority(ADC1_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(ADC1_IRQn);
+    return HAL_OK;
+}
+
+/**
+ * @brief Chạy trong ngắt ADC: AWD là ngắt theo mức nên tắt ngay để không lặp lại mỗi lượt quét.
+ */
+static void ADC_Trip_Fire(ADC_Trip_Id id) {
+    __HAL_ADC_DISABLE_IT(trip_hadc, trip_hw[id].it);
+    trips[id].count++;
+    trips[id].last_tick = HAL_GetTick();
+    trips[id].active = 1;
+    EEV_Board_WriteRelay(EEV_PIN_RESET);   // Bật làm mát đầu đẩy
+    EEV_Control_StopAll();                 // Giữ mọi van tại vị trí hiện tại, ngắt cuộn dây
+}
+
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef* hadc) {
+    if (hadc == trip_hadc) ADC_Trip_Fire(ADC_TRIP_HIGH_PRESSURE);
+}
+
+void HAL_ADCEx_LevelOutOfWindow2Callback(ADC_HandleTypeDef* hadc) {
+    if (hadc == trip_hadc) ADC_Trip_Fire(ADC_TRIP_DISCHARGE_TEMP);
+}
+
+void ADC_Trip_Process(void) {
+    if (trip_hadc == NULL) return;
+    const float value[ADC_TRIP_COUNT] = {
+        [ADC_TRIP_HIGH_PRESSURE]  = fast_sensors.high_pressure_sensor,
+        [ADC_TRIP_DISCHARGE_TEMP] = fast_sensors.dau_day,
+    };
+    const float release[ADC_TRIP_COUNT] = {
+        [ADC_TRIP_HIGH_PRESSURE]  = ADC_TRIP_HIGH_PRESSURE_BAR - ADC_TRIP_HIGH_PRESSURE_HYST,
+        [ADC_TRIP_DISCHARGE_TEMP] = ADC_TRIP_DISCHARGE_TEMP_C - ADC_TRIP_DISCHARGE_TEMP_HYST,
+    };
+
+    for (uint8_t id = 0; id < ADC_TRIP_COUNT; id++) {
+        uint32_t count = trips[id].count;
+        if (count != trip_logged[id]) {
+            trip_logged[id] = count;
+            LOG_WARN(EVT_ADC_TRIP, id, count);
+        }
+
+        // vref hoặc mô tả cảm biến thay đổi làm ngưỡng ADC thô thay đổi theo
+        uint16_t raw = ADC_Trip_Threshold((ADC_Trip_Id)id);
+        if (raw != trips[id].threshold) ADC_Trip_LoadThreshold((ADC_Trip_Id)id, raw);
+
+        if (trips[id].active && value[id] < release[id]) {
+            trips[id].active = 0;
+            __HAL_ADC_CLEAR_FLAG(trip_hadc, trip_hw[id].it);
+            __HAL_ADC_ENABLE_IT(trip_hadc, trip_hw[id].it);
+            LOG_INFO(EVT_ADC_TRIP_CLEAR, id);
+        }
+    }
+}
+
+bool ADC_Trip_Active(void) {
+    for (uint8_t id = 0; id < ADC_TRIP_COUNT; id++) {
+        if (trips[id].active) return true;
+    }
+    return false;
+}
+
+const ADC_Trip_State* ADC_Trip_GetState(ADC_Trip_Id id) {
+    return &trips[id];
+}
+
+void ADC_Trip_Publish(ModbusHandle* modbus) {
+    uint16_t regs[ADC_TRIP_REG_COUNT];
+    const ADC_Trip_State* hp = &trips[ADC_TRIP_HIGH_PRESSURE];
+    const ADC_Trip_State* dt = &trips[ADC_TRIP_DISCHARGE_TEMP];
+
+    regs[0] = (uint16_t)((hp->active ? 1U : 0U) | (dt->active ? 2U : 0U));
+    regs[1] = (uint16_t)hp->count;
+    regs[2] = (uint16_t)(hp->last_tick >> 16);
+    regs[3] = (uint16_t)hp->last_tick;
+    regs[4] = (uint16_t)dt->count;
+    regs[5] = (uint16_t)(dt->last_tick >> 16);
+    regs[6] = (uint16_t)dt->last_tick;
+    regs[7] = hp->threshold;
+    regs[8] = dt->threshold;
+    Modbus_PublishHoldingRegs(modbus, ADC_TRIP_REG, regs, ADC_TRIP_REG_COUNT);
+}
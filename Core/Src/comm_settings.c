@@ -0,0 +1,272 @@
+/*
+ * comm_settings.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "comm_settings.h"
+#include "modbus_crc.h"
+#include "log_level.h"
+#include <stddef.h>
+#include <string.h>
+
+#define COMM_RECORD_MAGIC   0xC0A5U
+
+// Bản ghi trong EEPROM, CRC Modbus tính trên mọi byte trước trường crc.
+typedef struct {
+    uint16_t     magic;
+    uint16_t     seq;       // Tăng mỗi lần lưu, bản ghi mới hơn thắng
+    CommSettings settings;
+    uint16_t     crc;
+} CommSettingsRecord;
+
+typedef enum {
+    COMM_PHASE_IDLE,
+    COMM_PHASE_APPLY_PENDING,  // Chờ phát xong phản hồi lệnh APPLY theo cấu hình cũ
+    COMM_PHASE_TRIAL
+} CommPhase;
+
+static struct {
+    EEPROM_Handle_t* eeprom;
+    ModbusHandle*    modbus;
+    CommSettings     saved;     // Cấu hình đã lưu EEPROM
+    CommSettings     current;   // Cấu hình đang áp dụng
+    CommSettings     trial;
+    CommPhase        phase;
+    uint32_t         trial_start;
+    uint16_t         seq;       // Số thứ tự của bản ghi mới nhất
+    uint8_t          slot;      // Slot chứa bản ghi mới nhất
+    uint16_t         status;
+} comm;
+
+// Các tốc độ có ngưỡng t1.5/t3.5 trong bảng của Modbus_Slave_Final.c
+static const uint32_t comm_baud_rates[] = { 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200 };
+
+static bool CommSettings_Valid(const CommSettings* s) {
+    if (s->slave_address < 1 || s->slave_address > 247) return false;
+    if (s->parity > COMM_PARITY_EVEN) return false;
+    if (s->stop_bits != 1 && s->stop_bits != 2) return false;
+    if (s->response_delay_ms > COMM_RESPONSE_DELAY_MAX_MS) return false;
+    for (uint8_t i = 0; i < sizeof(comm_baud_rates) / sizeof(comm_baud_rates[0]); i++) {
+        if (comm_baud_rates[i] == s->baud) return true;
+    }
+    return false;
+}
+
+static void CommSettings_Defaults(CommSettings* s) {
+    memset(s, 0, sizeof(*s));
+    s->slave_address = SLAVE_ADDRESS;
+    s->parity = COMM_DEFAULT_PARITY;
+    s->stop_bits = COMM_DEFAULT_STOP_BITS;
+    s->baud = COMM_DEFAULT_BAUD;
+}
+
+static uint16_t CommSettings_SlotAddr(uint8_t slot) {
+    return (uint16_t)(COMM_EEPROM_ADDR + slot * COMM_EEPROM_SLOT_SIZE);
+}
+
+static bool CommSettings_ReadSlot(uint8_t slot, CommSettingsRecord* rec) {
+    if (EEPROM_ReadBuffer(comm.eeprom, CommSettings_SlotAddr(slot), (uint8_t*)rec, sizeof(*rec)) != EEPROM_OK) {
+        return false;
+    }
+    return rec->magic == COMM_RECORD_MAGIC &&
+           rec->crc == Modbus_CRC16((const uint8_t*)rec, offsetof(CommSettingsRecord, crc)) &&
+           CommSettings_Valid(&rec->settings);
+}
+
+/**
+ * @brief Ghi cấu hình vào slot cũ hơn rồi đọc lại kiểm tra.
+ *        Bản ghi mới nhất không bị đụng tới cho tới khi bản mới đã hợp lệ.
+ */
+static EEPROM_Status_t CommSettings_Save(const CommSettings* s) {
+    CommSettingsRecord rec, check;
+    uint8_t slot = comm.slot ^ 1U;
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = COMM_RECORD_MAGIC;
+    rec.seq = (uint16_t)(comm.seq + 1U);
+    rec.settings = *s;
+    rec.crc = Modbus_CRC16((const uint8_t*)&rec, offsetof(CommSettingsRecord, crc));
+
+    EEPROM_Status_t status = EEPROM_WriteBuffer(comm.eeprom, CommSettings_SlotAddr(slot), (const uint8_t*)&rec, sizeof(rec));
+    if (status == EEPROM_OK && (!CommSettings_ReadSlot(slot, &check) || check.seq != rec.seq)) {
+        status = EEPROM_ERROR_GENERAL;
+    }
+    if (status == EEPROM_OK) {
+        comm.slot = slot;
+        comm.seq = rec.seq;
+    }
+    return status;
+}
+
+static void CommSettings_Publish(void) {
+    uint16_t regs[COMM_REG_COUNT] = {
+        [COMM_REG_ADDRESS - COMM_REG_ADDRESS]   = comm.current.slave_address,
+        [COMM_REG_BAUD - COMM_REG_ADDRESS]      = (uint16_t)(comm.current.baud / 100U),
+        [COMM_REG_PARITY - COMM_REG_ADDRESS]    = comm.current.parity,
+        [COMM_REG_STOP_BITS - COMM_REG_ADDRESS] = comm.current.stop_bits,
+        [COMM_REG_DELAY - COMM_REG_ADDRESS]     = comm.current.response_delay_ms,
+        [COMM_REG_CMD - COMM_REG_ADDRESS]       = COMM_CMD_NONE,
+        [COMM_REG_STATUS - COMM_REG_ADDRESS]    = comm.status,
+    };
+    Modbus_PublishHoldingRegs(comm.modbus, COMM_REG_ADDRESS, regs, COMM_REG_COUNT);
+}
+
+static void CommSettings_SetStatus(uint16_t status) {
+    comm.status = status;
+    Modbus_PublishHoldingRegs(comm.modbus, COMM_REG_STATUS, &comm.status, 1);
+}
+
+/**
+ * @brief Chuyển UART và Modbus sang cấu hình s. Frame đang nhận (nếu có) bị bỏ.
+ */
+static void CommSettings_Apply(const CommSettings* s) {
+    ModbusHandle* modbus = comm.modbus;
+    comm.current = *s;
+    HAL_UART_Abort(modbus->huart);
+    CommSettings_ConfigureUart(modbus->huart);
+    modbus->slave_address = s->slave_address;
+    modbus->response_delay_us = (uint16_t)(s->response_delay_ms * 1000U);
+    Modbus_ReInit(modbus, modbus->huart, modbus->uart_irqn);
+    CommSettings_Publish();
+}
+
+void CommSettings_ConfigureUart(UART_HandleTypeDef* huart) {
+    const CommSettings* s = &comm.current;
+    if (huart == NULL || s->baud == 0) return;
+    huart->Init.BaudRate = s->baud;
+    // WordLength của STM32 gồm cả bit parity: 8 bit dữ liệu + parity = 9 bit
+    switch (s->parity) {
+    case COMM_PARITY_ODD:
+        huart->Init.Parity = UART_PARITY_ODD;
+        huart->Init.WordLength = UART_WORDLENGTH_9B;
+        break;
+    case COMM_PARITY_EVEN:
+        huart->Init.Parity = UART_PARITY_EVEN;
+        huart->Init.WordLength = UART_WORDLENGTH_9B;
+        break;
+    default:
+        huart->Init.Parity = UART_PARITY_NONE;
+        huart->Init.WordLength = UART_WORDLENGTH_8B;
+        break;
+    }
+    huart->Init.StopBits = (s->stop_bits == 2) ? UART_STOPBITS_2 : UART_STOPBITS_1;
+    HAL_UART_Init(huart);
+}
+
+void CommSettings_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus) {
+    CommSettingsRecord rec[2];
+    bool valid[2];
+
+    memset(&comm, 0, sizeof(comm));
+    comm.eeprom = eeprom;
+    comm.modbus = modbus;
+    for (uint8_t i = 0; i < 2; i++) {
+        valid[i] = CommSettings_ReadSlot(i, &rec[i]);
+    }
+
+    if (valid[0] || valid[1]) {
+        // Cả 2 hợp lệ: chọn bản có seq mới hơn (so sánh có dấu để đúng cả khi seq tràn)
+        uint8_t slot = (valid[0] && valid[1]) ? (((int16_t)(rec[1].seq - rec[0].seq) > 0) ? 1U : 0U)
+                                              : (valid[1] ? 1U : 0U);
+        comm.slot = slot;
+        comm.seq = rec[slot].seq;
+        comm.saved = rec[slot].settings;
+        LOG_INFO(EVT_COMM_LOADED, slot, comm.seq, comm.saved.slave_address, comm.saved.baud,
+                 comm.saved.parity, comm.saved.stop_bits, comm.saved.response_delay_ms);
+    } else {
+        // Lần lưu đầu tiên sẽ vào slot 0
+        comm.slot = 1;
+        CommSettings_Defaults(&comm.saved);
+        LOG_WARN(EVT_COMM_DEFAULTS);
+    }
+    comm.status = COMM_STATUS_IDLE;
+    CommSettings_Apply(&comm.saved);
+}
+
+const CommSettings* CommSettings_Current(void) {
+    return &comm.current;
+}
+
+void CommSettings_Process(void) {
+    ModbusHandle* modbus = comm.modbus;
+    if (modbus == NULL) return;
+
+    // Chụp và xóa lệnh trong một critical section (Master có thể ghi từ ngắt khi MODBUS_PROCESS_IN_MAIN_LOOP = 0)
+    static const uint16_t cmd_none = COMM_CMD_NONE;
+    uint16_t regs[COMM_REG_COUNT];
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memcpy(regs, &modbus->holdingRegs[COMM_REG_ADDRESS], sizeof(regs));
+    Modbus_PublishHoldingRegs(modbus, COMM_REG_CMD, &cmd_none, 1);
+    __set_PRIMASK(primask);
+
+    switch (regs[COMM_REG_CMD - COMM_REG_ADDRESS]) {
+    case COMM_CMD_APPLY: {
+        uint16_t address = regs[COMM_REG_ADDRESS - COMM_REG_ADDRESS];
+        uint16_t baud    = regs[COMM_REG_BAUD - COMM_REG_ADDRESS];
+        uint16_t parity  = regs[COMM_REG_PARITY - COMM_REG_ADDRESS];
+        uint16_t stop    = regs[COMM_REG_STOP_BITS - COMM_REG_ADDRESS];
+        uint16_t delay   = regs[COMM_REG_DELAY - COMM_REG_ADDRESS];
+        CommSettings s;
+        memset(&s, 0, sizeof(s));
+        // Giá trị quá 8 bit bị đổi thành 0 để CommSettings_Valid loại bỏ
+        s.slave_address = (address <= 0xFF) ? (uint8_t)address : 0;
+        s.parity = (parity <= 0xFF) ? (uint8_t)parity : 0xFF;
+        s.stop_bits = (stop <= 0xFF) ? (uint8_t)stop : 0;
+        s.baud = (uint32_t)baud * 100U;
+        s.response_delay_ms = delay;
+        if (!CommSettings_Valid(&s)) {
+            LOG_WARN(EVT_COMM_REJECTED, address, baud, parity, stop, delay);
+            CommSettings_SetStatus(COMM_STATUS_REJECTED);
+            break;
+        }
+        comm.trial = s;
+        comm.phase = COMM_PHASE_APPLY_PENDING;
+        break;
+    }
+    case COMM_CMD_CONFIRM:
+        // Lệnh đến được tới đây nghĩa là Master đã liên lạc được bằng cấu hình mới
+        if (comm.phase == COMM_PHASE_TRIAL) {
+            comm.phase = COMM_PHASE_IDLE;
+            EEPROM_Status_t status = CommSettings_Save(&comm.current);
+            if (status == EEPROM_OK) {
+                comm.saved = comm.current;
+                LOG_INFO(EVT_COMM_COMMIT, comm.slot, comm.seq);
+                CommSettings_SetStatus(COMM_STATUS_COMMITTED);
+            } else {
+                LOG_ERROR(EVT_COMM_SAVE_FAIL, comm.slot ^ 1U, status);
+                CommSettings_SetStatus(COMM_STATUS_EEPROM_ERROR);
+            }
+        }
+        break;
+    case COMM_CMD_REVERT:
+        if (comm.phase == COMM_PHASE_TRIAL) {
+            comm.trial_start = HAL_GetTick() - COMM_TRIAL_TIMEOUT_MS; // Hết hạn ngay bên dưới
+        } else if (comm.phase == COMM_PHASE_APPLY_PENDING) {
+            comm.phase = COMM_PHASE_IDLE;
+            CommSettings_SetStatus(COMM_STATUS_REVERTED);
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (comm.phase == COMM_PHASE_APPLY_PENDING) {
+        // Phản hồi lệnh APPLY phải ra hết theo cấu hình cũ trước khi đổi UART
+        if (modbus->state == MODBUS_STATE_IDLE) {
+            comm.status = COMM_STATUS_TRIAL;
+            CommSettings_Apply(&comm.trial);
+            comm.trial_start = HAL_GetTick();
+            comm.phase = COMM_PHASE_TRIAL;
+            LOG_INFO(EVT_COMM_TRIAL, comm.trial.slave_address, comm.trial.baud,
+                     comm.trial.parity, comm.trial.stop_bits, comm.trial.response_delay_ms);
+        }
+    } else if (comm.phase == COMM_PHASE_TRIAL) {
+        if ((uint32_t)(HAL_GetTick() - comm.trial_start) >= COMM_TRIAL_TIMEOUT_MS) {
+            comm.phase = COMM_PHASE_IDLE;
+            comm.status = COMM_STATUS_REVERTED;
+            CommSettings_Apply(&comm.saved);
+            LOG_WARN(EVT_COMM_REVERT, comm.saved.slave_address, comm.saved.baud);
+        }
+    }
+}
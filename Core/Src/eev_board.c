@@ -0,0 +1,53 @@
+/*
+ * eev_board.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Hiện thực eev_board.h cho STM32H503 bằng HAL.
+ */
+#include "eev_board.h"
+#include "main.h"
+#include "adc_trip.h"
+
+uint32_t EEV_Board_GetTick(void){
+	return HAL_GetTick();
+}
+
+uint32_t EEV_Board_GetCycles(void){
+	return DWT->CYCCNT;
+}
+
+uint32_t EEV_Board_CyclesToUs(uint32_t cycles){
+	return cycles / (SystemCoreClock / 1000000U);
+}
+
+uint32_t EEV_Board_EnterCritical(void){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+void EEV_Board_ExitCritical(uint32_t state){
+	__set_PRIMASK(state);
+}
+
+EEV_PinState EEV_Board_ReadRun(void){
+	return (HAL_GPIO_ReadPin(RUN_GPIO_Port, RUN_Pin) == GPIO_PIN_SET) ? EEV_PIN_SET : EEV_PIN_RESET;
+}
+
+EEV_PinState EEV_Board_ReadDefrost(void){
+	return (HAL_GPIO_ReadPin(RUN_Defrost_GPIO_Port, RUN_Defrost_Pin) == GPIO_PIN_SET) ? EEV_PIN_SET : EEV_PIN_RESET;
+}
+
+EEV_PinState EEV_Board_ReadRelay(void){
+	return (HAL_GPIO_ReadPin(RELAY_GPIO_Port, RELAY_Pin) == GPIO_PIN_SET) ? EEV_PIN_SET : EEV_PIN_RESET;
+}
+
+void EEV_Board_WriteRelay(EEV_PinState state){
+	HAL_GPIO_WritePin(RELAY_GPIO_Port, RELAY_Pin, (state == EEV_PIN_SET) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+uint8_t EEV_Board_TripActive(void){
+	return ADC_Trip_Active() ? 1 : 0;
+}
@@ -0,0 +1,420 @@
+/*
+ * eev_control.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Logic điều khiển van tiết lưu điện tử (EEV), tách khỏi main.c.
+ *  File này không gọi HAL trực tiếp: chân vào/ra và thời gian đi qua eev_board.h,
+ *  nên có thể biên dịch lại trên máy tính với một eev_board.c giả lập.
+ */
+#include "eev_control.h"
+#include "eev_board.h"
+#include "Input_parameters.h"
+#include "refrigerant.h"
+#include "valve_backup.h"
+#include <math.h>
+
+EEV_Axis eev_axes[EEV_AXIS_COUNT];
+
+// Nhịp PID chung cho mọi van
+volatile uint8_t count = 0;
+
+// PID chạy mỗi EEV_PID_TICKS tick TIM2
+#define EEV_PID_TICKS 3
+
+static volatile uint8_t pid_pending;
+static volatile uint32_t pid_due_cycles;
+static uint32_t pid_last_due, pid_last_start;
+static EEV_Control_Timing timing;
+
+// Mọi lần chạy động cơ đi qua đây: bỏ cờ "đứng yên" của bản ghi backup trước khi bước đầu tiên ra
+static void EEV_MoveValve(EEV_Axis* ax, int32_t steps) {
+	if(steps != 0) ValveBackup_MarkMoving(ax->index);
+	Stepper_Move(&ax->motor, steps);
+}
+
+// Ảnh chụp đầu vào của PID, bảo vệ bằng seqlock: bên ghi đưa seq lên lẻ trước khi ghi và
+// về chẵn sau khi ghi; bên đọc chép lại tới khi seq chẵn và không đổi trong lúc chép.
+static void EEV_PidInput_Write(EEV_Axis* ax, const EEV_PidInput* in) {
+	ax->pid_input_seq++;
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	ax->pid_input = *in;
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	ax->pid_input_seq++;
+}
+
+static void EEV_PidInput_Read(EEV_Axis* ax, EEV_PidInput* out) {
+	uint32_t seq;
+	do {
+		seq = ax->pid_input_seq;
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		*out = ax->pid_input;
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	} while ((seq & 1U) != 0U || seq != ax->pid_input_seq);
+}
+
+/*================================================ Hàm tính toán độ quá nhiệt =======================================*/
+void superheat_value(EEV_Axis* ax){
+	EEV_PidInput in;
+	in.low_pressure = *ax->low_pressure;
+	in.suction_temperature = *ax->suction_temperature;
+	in.saturation = Refrigerant_DewTemperature(in.low_pressure);
+	in.superheat = in.suction_temperature - in.saturation;
+	ax->saturation = in.saturation;
+	ax->superheat = in.superheat;
+	EEV_PidInput_Write(ax, &in);
+}
+/*================================================ Hàm tính toán độ quá nhiệt =======================================*/
+
+
+/*================================================ Hàm tính toán để quyết định số bước điều khiển van tiết lưu =======================================*/
+void control_stepper(EEV_Axis* ax){
+	uint32_t current_time = EEV_Board_GetTick();
+	float error = fabsf(ax->pid.setpoint - ax->superheat);
+	static const float k = 0.6f;
+	static const uint32_t time_min = 500, time_max = 10000;
+	uint32_t delay_time = time_min + (uint32_t)((time_max - time_min) / (1.0f + k * error));
+	if(((uint32_t)(current_time - ax->motor.last_step_tick) >= delay_time) && Stepper_IsMoving(&ax->motor) == 0){
+		// Đọc và xóa trong một critical section: không mất lệnh nào được thêm vào giữa 2 bước
+		uint32_t state = EEV_Board_EnterCritical();
+		int16_t output_final = StepAgg_Take(&ax->step_agg);
+		EEV_Board_ExitCritical(state);
+		EEV_MoveValve(ax, output_final);
+	}
+}
+/*================================================ Hàm tính toán để quyết định số bước điều khiển van tiết lưu =======================================*/
+
+
+
+/*================================================ Hàm tính toán để quyết định thay đổi superheat setpoint =======================================*/
+void convert_setpoint(EEV_Axis* ax){
+    static const struct {
+        float pressure_threshold;
+        float target_temp_diff;
+    } lookup_table[] = {
+//        { 23.0f, 5.0f },
+//        { 20.0f, 7.0f },
+//        { 17.0f, 9.0f },
+//        { 15.0f, 11.0f},
+//        { 0.0f,  13.0f}
+        { 23.0f, 3.0f},
+        { 20.0f, 5.0f},
+        { 17.0f, 7.0f},
+        { 15.0f, 9.0f},
+        { 0.0f,  11.0f}
+    };
+    float new_setpoint = ax->pid.setpoint;
+    EEV_PinState state_pin_relay = EEV_Board_ReadRelay();
+    // Lấy giá trị áp suất
+    float high_pressure = pressure_sensors.high_pressure_sensor;
+
+    if(ax->relay_last_state == 0 && state_pin_relay == 1){
+    	ax->relay_change_time = EEV_Board_GetTick();
+    	ax->relay_waiting = 1;
+    }
+    ax->relay_last_state = state_pin_relay;
+
+     // Duyệt bảng để tìm giá trị TARGET_TEMP_DIFF phù hợp
+    if(state_pin_relay == 1){
+    	 uint32_t current_time = EEV_Board_GetTick();
+    	 if(!ax->relay_waiting || ((uint32_t)(current_time - ax->relay_change_time) >= 16000)){
+             ax->relay_waiting = 0;
+			 for (int i = 0; i < sizeof(lookup_table) / sizeof(lookup_table[0]); i++) {
+				 if (high_pressure >= lookup_table[i].pressure_threshold) {
+						 new_setpoint = lookup_table[i].target_temp_diff;
+						 break;  // Thoát kh�?i vòng lặp sau khi tìm thấy ngưỡng phù hợp
+				 }
+			 }
+		}
+    }
+     if(new_setpoint != ax->last_setpoint){
+    	 if(!ax->setpoint_waiting){
+    		 ax->setpoint_change_time = EEV_Board_GetTick();
+    		 ax->setpoint_waiting = 1;
+    	 }
+    	 uint32_t curent_time_2 = EEV_Board_GetTick();
+    	 if((uint32_t)(curent_time_2 - ax->setpoint_change_time) >= 8000){
+    		 ax->pid.setpoint = new_setpoint;
+    		 ax->last_setpoint = new_setpoint;
+    		 ax->setpoint_waiting = 0;
+    	 }
+     }else{
+    	 ax->setpoint_waiting = 0;
+     }
+}
+/*================================================ Hàm tính toán để quyết định thay đổi superheat setpoint =======================================*/
+
+
+/*================================================ Hàm chính điều khiển van tiết lưu =======================================*/
+/**
+ * @brief Lúc khởi động: nếu vùng backup còn vị trí tin được thì cấp lại pha đang giữ và tiếp tục từ đó
+ *        thay cho hành trình đóng hết + mở một nửa. Trả về 1 nếu đã khôi phục.
+ */
+static uint8_t EEV_ResumeFromBackup(EEV_Axis* ax, EEV_PinState pin_state_run){
+	ValveBackup_State saved;
+	if(!ValveBackup_Load(ax->index, ax->motor.position_max, &saved)) return 0;
+
+	Stepper_SetPosition(&ax->motor, saved.position);
+	Stepper_Restore(&ax->motor, saved.phase);
+	ax->position_known = 1;
+	ax->init_done = 1;
+	if(pin_state_run == EEV_PIN_SET){
+		// Van đang ở vị trí làm việc: sang chờ ổn định rồi PID như sau khi mở xong
+		ax->state = STATE_OPENING;
+	}else if(ax->motor.position > 0){
+		// Đóng như khi mất RUN (đóng quá thêm để chắc chắn về 0)
+		Stepper_SetPosition(&ax->motor, ax->motor.position + EEV_OVERDRIVE_STEPS);
+		EEV_MoveValve(ax, ax->motor.position);
+		ax->state = STATE_CLOSING;
+	}else{
+		Stepper_Stop(&ax->motor);
+		ax->state = STATE_IDLE_EEV;
+	}
+	return 1;
+}
+
+void control_EEV(EEV_Axis* ax){
+//	static GPIO_PinState pin_state_run = GPIO_PIN_RESET;
+//	static GPIO_PinState pin_state_run_defrost = GPIO_PIN_RESET;
+	EEV_PinState pin_state_run = EEV_Board_ReadRun();
+	EEV_PinState pin_state_run_defrost = EEV_Board_ReadDefrost();
+//	if(pin_state_run_check == GPIO_PIN_SET || pin_state_run_defrost_check == GPIO_PIN_SET){
+//		if((uint32_t)(HAL_GetTick() - ))
+//	}
+
+
+
+	switch(pin_state_run_defrost){
+	case EEV_PIN_SET:
+		if(ax->check_run_defrost == 0 && !Stepper_IsMoving(&ax->motor)){
+			ax->check_run_defrost = 1;
+//        	step_position = 0;
+//			percent_step = 0.0f;
+//			Stepper_Move(&motor, -500);
+			Stepper_SetPosition(&ax->motor, ax->motor.position - EEV_OVERDRIVE_STEPS);
+            EEV_MoveValve(ax, -(ax->motor.position_max - ax->motor.position));
+            ax->state = STATE_OPENING;
+		}
+		break;
+	case EEV_PIN_RESET:
+		ax->check_run_defrost = 0;
+		   // Xử lý theo trạng thái hiện tại
+		    switch(ax->state) {
+		        case STATE_INIT:
+		            if(!Stepper_IsMoving(&ax->motor) && EEV_ResumeFromBackup(ax, pin_state_run)) {
+		                break;
+		            }
+		            // Không có vị trí tin được: đóng cả hành trình để về 0
+		            if(!Stepper_IsMoving(&ax->motor)) {
+		            	Stepper_SetPosition(&ax->motor, ax->motor.position_max);
+		                EEV_MoveValve(ax, ax->motor.position_max);
+//		            	step_position = 0;
+//		            	percent_step = 0.0f;
+//		                Stepper_Move(&motor, -500);
+		                ax->state = STATE_CLOSING;
+		                ax->init_done = 0;  // �?ánh dấu chưa hoàn thành khởi tạo
+		            }
+		            break;
+
+		        case STATE_CLOSING:
+		            if(!Stepper_IsMoving(&ax->motor)) {
+		                // Mỗi lần đóng về 0 (có đóng quá) đều chỉnh lại sai số mất bước: xóa bộ đếm khôi phục
+		                ax->position_known = 1;
+		                ValveBackup_Homed(ax->index);
+		                if(!ax->init_done) {
+		                    // Nếu đây là lần đóng đầu tiên (khởi tạo)
+		                    ax->init_done = 1;
+		                    // Nếu chân input đang ở mức cao, chuyển sang mở
+		                    if(pin_state_run == EEV_PIN_SET) {
+		                        EEV_MoveValve(ax, -(ax->motor.position_max / 2));
+		                        ax->state = STATE_OPENING;
+		                    } else {
+		                    	ax->state = STATE_IDLE_EEV;  // Ch�? mức cao
+		                    }
+		                } else {
+		                    // Nếu đây là lần đóng trong quá trình hoạt động bình thư�?ng
+		                	ax->state = STATE_IDLE_EEV;
+		                }
+		            }
+		            break;
+
+		        case STATE_IDLE_EEV:
+		        	if(!Stepper_IsMoving(&ax->motor)){
+		        		if(pin_state_run == EEV_PIN_SET){
+		        		    EEV_MoveValve(ax, -(ax->motor.position_max / 2));
+		        		    ax->state = STATE_OPENING;
+		        		}
+		        	}
+		            break;
+
+		        case STATE_OPENING:
+		            if(!Stepper_IsMoving(&ax->motor)) {
+		                // �?ã mở xong, bắt đầu ch�? 15s
+		                ax->timer = EEV_Board_GetTick();
+		                ax->state = STATE_CONTROL_EEV;
+		            }
+		            break;
+
+		        case STATE_CONTROL_EEV:
+		            if(EEV_Board_GetTick() - ax->timer >= 8000) {
+		                control_stepper(ax);
+		            }
+		            // Nếu trong quá trình ch�? mà chân input chuyển thành mức thấp
+		            if(pin_state_run == EEV_PIN_RESET) {
+		            	Stepper_SetPosition(&ax->motor, ax->motor.position + EEV_OVERDRIVE_STEPS);
+		                EEV_MoveValve(ax, ax->motor.position);
+		                ax->state = STATE_CLOSING;
+		            }
+		            break;
+		    }
+	  break;
+	}
+}
+/*================================================ Hàm chính điều khiển van tiết lưu =======================================*/
+
+
+/*================================================ Hàm điều khiển dịch phụ làm mát đầu đẩy =======================================*/
+int16_t nhiet_do_bat_lam_mat = 85;
+int16_t nhiet_do_tat_lam_mat = 75;
+void lam_mat_dau_day(){
+	// Bảo vệ dùng đường nhanh, không chờ bộ hạ tốc của đường điều khiển
+	if(fast_sensors.dau_day >= (float)(nhiet_do_bat_lam_mat)){
+		EEV_Board_WriteRelay(EEV_PIN_RESET);
+	}else if(fast_sensors.dau_day <= (float)(nhiet_do_tat_lam_mat)){
+		EEV_Board_WriteRelay(EEV_PIN_SET);
+	}
+}
+/*================================================ Hàm điều khiển dịch phụ làm mát đầu đẩy =======================================*/
+
+/*================================================ Điểm vào cho main / ngắt =======================================*/
+void EEV_Control_InitAxis(uint8_t axis, const EEV_AxisConfig* cfg){
+	if(axis >= EEV_AXIS_COUNT) return;
+	EEV_Axis* ax = &eev_axes[axis];
+	ax->index = axis;
+	ax->low_pressure = cfg->low_pressure;
+	ax->suction_temperature = cfg->suction_temperature;
+	ax->state = STATE_INIT;
+	ax->last_setpoint = -1;
+	ax->relay_last_state = 1;
+	// Mặc định |x| lớn nhất như trước
+	StepAgg_Init(&ax->step_agg, STEP_AGG_MAX_ABS);
+	Stepper_Init(&ax->motor, cfg->pins);
+}
+
+void EEV_Control_StopAll(void){
+	for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+		Stepper_Stop(&eev_axes[i].motor);
+	}
+}
+
+/**
+ * @brief Một lượt điều khiển, gọi mỗi khi có mẫu ADC mới (tác vụ TASK_CONTROL).
+ */
+void EEV_Control_Step(void){
+	for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+		EEV_Axis* ax = &eev_axes[i];
+		// Chế độ DMA: vị trí van chỉ được cộng khi đọc lại bộ đếm DMA
+		Stepper_Sync(&ax->motor);
+		// Van đứng yên ở vị trí đã biết: lưu vào vùng backup để reset sau không phải đóng về 0
+		if(ax->position_known && !Stepper_IsMoving(&ax->motor)){
+			ValveBackup_SaveStopped(ax->index, ax->motor.position, ax->motor.current_phase);
+		}
+		superheat_value(ax);
+		convert_setpoint(ax);
+	}
+	// Đang trip: relay và van do adc_trip.c giữ, không điều khiển đến khi nhả
+	if(EEV_Board_TripActive()) return;
+	lam_mat_dau_day();
+	for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+		control_EEV(&eev_axes[i]);
+	}
+}
+
+/**
+ * @brief Gọi từ ngắt TIM2: cứ EEV_PID_TICKS tick thì đánh dấu PID đến hạn (kèm dấu thời gian)
+ *        và báo cho tác vụ. Không tính toán gì trong ngắt; động cơ chạy trên STEPPER_TIM riêng.
+ */
+void EEV_Control_TimerTick(void){
+	uint32_t isr_start = EEV_Board_GetCycles();
+	count ++;
+	if(count >= EEV_PID_TICKS){
+	    count = 0;
+	    if(pid_pending) timing.pid_missed++;
+	    pid_due_cycles = isr_start;
+	    pid_pending = 1;
+	    EEV_Control_PidDueCallback();
+	}
+    uint32_t isr_cycles = EEV_Board_GetCycles() - isr_start;
+    timing.isr_cycles_last = isr_cycles;
+    if(isr_cycles > timing.isr_cycles_max) timing.isr_cycles_max = isr_cycles;
+}
+
+/**
+ * @brief PID của một van, đưa số bước vào bộ gộp step_agg của van đó.
+ */
+static void EEV_Control_PidAxis(EEV_Axis* ax){
+	EEV_PidInput in;
+	EEV_PidInput_Read(ax, &in);
+	if(ax->state == STATE_CONTROL_EEV && (uint32_t)(EEV_Board_GetTick() - ax->timer) >= 8000 && !EEV_Board_TripActive()){
+		// Giới hạn theo vị trí van thật: ngõ ra dương = đóng, âm = mở. Van đã chạm đầu hành trình thì
+		// chiều đó không còn tác dụng, phần bị cắt đưa vào chống bão hòa tích phân.
+		float lo = (ax->motor.position >= ax->motor.position_max) ? 0.0f : ax->pid.out_min;
+		float hi = (ax->motor.position <= 0) ? 0.0f : ax->pid.out_max;
+		ax->output_pid = PidCtrl_Update(&ax->pid, in.superheat, lo, hi);
+	}else{
+		// Van do máy trạng thái/trip quyết định: PID bám theo ngõ ra 0 để lúc nhận lại van không giật
+		ax->output_pid = PidCtrl_Track(&ax->pid, in.superheat, 0.0f);
+		ax->step_residual = 0.0f;
+	}
+	// Phần lẻ của bước được cộng dồn sang lần sau thay cho ngõ ra tối thiểu ±0.2 cũ:
+	// ngõ ra nhỏ vẫn ra bước, chỉ thưa hơn, và không tạo dao động quanh setpoint
+	float step_val = ax->output_pid * 5.0f + ax->step_residual;
+	int16_t stepp_count = (int16_t)step_val;
+	ax->step_residual = step_val - (float)stepp_count;
+	StepAgg_Push(&ax->step_agg, stepp_count);
+}
+
+/**
+ * @brief Tính PID cho mọi van, đầu vào lấy từ ảnh chụp nhất quán của superheat_value().
+ */
+void EEV_Control_PidStep(void){
+	uint32_t start = EEV_Board_GetCycles();
+	uint32_t due = pid_due_cycles;
+	if(!pid_pending) return;
+	pid_pending = 0;
+
+	for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+		EEV_Control_PidAxis(&eev_axes[i]);
+	}
+
+	timing.latency_us_last = EEV_Board_CyclesToUs(start - due);
+	if(timing.latency_us_last > timing.latency_us_max) timing.latency_us_max = timing.latency_us_last;
+	if(timing.pid_runs > 0){
+		// Nhịp đến hạn do timer phần cứng tạo nên chính xác: độ lệch so với nó là jitter của tác vụ
+		int32_t diff = (int32_t)((start - pid_last_start) - (due - pid_last_due));
+		uint32_t jitter = EEV_Board_CyclesToUs((uint32_t)(diff < 0 ? -diff : diff));
+		if(jitter > timing.jitter_us_max) timing.jitter_us_max = jitter;
+	}
+	pid_last_start = start;
+	pid_last_due = due;
+	timing.pid_runs++;
+}
+
+const EEV_Control_Timing* EEV_Control_GetTiming(void){
+	return &timing;
+}
+
+void EEV_Control_SetStepPolicy(StepAgg_Policy policy){
+	for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+		StepAgg_SetPolicy(&eev_axes[i].step_agg, policy);
+	}
+}
+
+StepAgg_Policy EEV_Control_GetStepPolicy(void){
+	return (StepAgg_Policy)eev_axes[0].step_agg.policy;
+}
+
+__attribute__((weak)) void EEV_Control_PidDueCallback(void){
+}
+/*================================================ Điểm vào cho main / ngắt =======================================*/
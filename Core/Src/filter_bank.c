@@ -0,0 +1,203 @@
+/*
+ * filter_bank.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "filter_bank.h"
+#include <math.h>
+#include <string.h>
+
+#if FILTER_BANK_FIXED_POINT
+#define FB_SIGNAL(x)      ((int32_t)((x) * 65536.0f))
+#define FB_Q15(x)         ((int32_t)((x) * 32768.0f + 0.5f))
+#define FB_Q30(x)         ((int32_t)((x) * 1073741824.0f))
+#define FB_TO_FLOAT(x)    ((float)(x) * (1.0f / 65536.0f))
+#else
+#define FB_SIGNAL(x)      (x)
+#define FB_TO_FLOAT(x)    (x)
+#endif
+
+static void FilterBank_Rebuild(FilterBank* bank) {
+    bank->n_kalman = bank->n_ema = bank->n_biquad = bank->n_median = 0;
+    for (uint8_t ch = 0; ch < bank->count; ch++) {
+        switch (bank->type[ch]) {
+        case FILTER_KALMAN: bank->kalman_ch[bank->n_kalman++] = ch; break;
+        case FILTER_EMA:    bank->ema_ch[bank->n_ema++] = ch;       break;
+        case FILTER_BIQUAD: bank->biquad_ch[bank->n_biquad++] = ch; break;
+        default: break;
+        }
+        if (bank->median[ch]) bank->median_ch[bank->n_median++] = ch;
+    }
+}
+
+void FilterBank_Init(FilterBank* bank, uint8_t count) {
+    memset(bank, 0, sizeof(*bank));
+    bank->count = (count > FILTER_BANK_MAX_CHANNELS) ? FILTER_BANK_MAX_CHANNELS : count;
+}
+
+static void FilterBank_SetType(FilterBank* bank, uint8_t ch, Filter_Type type) {
+    bank->type[ch] = (uint8_t)type;
+    // Đổi loại lọc lúc đang chạy: nối tiếp từ đầu ra hiện tại, không nhảy bậc
+    bank->x1[ch] = bank->x2[ch] = bank->y2[ch] = bank->y[ch];
+    FilterBank_Rebuild(bank);
+}
+
+void FilterBank_SetNone(FilterBank* bank, uint8_t ch) {
+    if (ch >= bank->count) return;
+    FilterBank_SetType(bank, ch, FILTER_NONE);
+}
+
+void FilterBank_SetKalman(FilterBank* bank, uint8_t ch, float mea_e, float est_e, float q) {
+    if (ch >= bank->count) return;
+    bank->k_r[ch] = FB_SIGNAL(mea_e);
+    bank->k_p[ch] = FB_SIGNAL(est_e);
+    bank->k_q[ch] = FB_SIGNAL(q);
+    FilterBank_SetType(bank, ch, FILTER_KALMAN);
+}
+
+void FilterBank_SetEMA(FilterBank* bank, uint8_t ch, float alpha) {
+    if (ch >= bank->count) return;
+#if FILTER_BANK_FIXED_POINT
+    bank->alpha[ch] = FB_Q15(alpha);
+#else
+    bank->alpha[ch] = alpha;
+#endif
+    FilterBank_SetType(bank, ch, FILTER_EMA);
+}
+
+void FilterBank_SetBiquadLowpass(FilterBank* bank, uint8_t ch, float fc, float fs, float q) {
+    if (ch >= bank->count) return;
+    // Công thức RBJ (Audio EQ Cookbook), chỉ tính một lần lúc cấu hình
+    float w0 = 2.0f * 3.14159265f * fc / fs;
+    float cosw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+    float b0 = (1.0f - cosw) * 0.5f / a0;
+    float b1 = (1.0f - cosw) / a0;
+    float a1 = -2.0f * cosw / a0;
+    float a2 = (1.0f - alpha) / a0;
+#if FILTER_BANK_FIXED_POINT
+    bank->b0[ch] = FB_Q30(b0);
+    bank->b1[ch] = FB_Q30(b1);
+    bank->b2[ch] = FB_Q30(b0);
+    bank->a1[ch] = FB_Q30(a1);
+    bank->a2[ch] = FB_Q30(a2);
+#else
+    bank->b0[ch] = b0;
+    bank->b1[ch] = b1;
+    bank->b2[ch] = b0;
+    bank->a1[ch] = a1;
+    bank->a2[ch] = a2;
+#endif
+    FilterBank_SetType(bank, ch, FILTER_BIQUAD);
+}
+
+void FilterBank_SetMedian(FilterBank* bank, uint8_t ch, bool enable) {
+    if (ch >= bank->count) return;
+    bank->median[ch] = enable ? 1 : 0;
+    for (uint8_t k = 0; k < FILTER_MEDIAN_N; k++) {
+        bank->hist[k][ch] = bank->y[ch];
+    }
+    FilterBank_Rebuild(bank);
+}
+
+static filter_value_t FilterBank_Median(const FilterBank* bank, uint8_t ch) {
+    filter_value_t w[FILTER_MEDIAN_N];
+    // Sắp xếp chèn, N nhỏ nên nhanh hơn mọi thuật toán chọn khác
+    for (uint8_t k = 0; k < FILTER_MEDIAN_N; k++) {
+        filter_value_t v = bank->hist[k][ch];
+        int8_t j = (int8_t)k - 1;
+        while (j >= 0 && w[j] > v) {
+            w[j + 1] = w[j];
+            j--;
+        }
+        w[j + 1] = v;
+    }
+    return w[FILTER_MEDIAN_N / 2];
+}
+
+void FilterBank_Update(FilterBank* bank, const float* in) {
+    filter_value_t x[FILTER_BANK_MAX_CHANNELS];
+
+    for (uint8_t ch = 0; ch < bank->count; ch++) {
+        x[ch] = FB_SIGNAL(in[ch]);
+    }
+
+    // Mẫu đầu tiên nạp thẳng vào trạng thái để bộ lọc không phải leo từ 0
+    if (!bank->primed) {
+        bank->primed = 1;
+        for (uint8_t ch = 0; ch < bank->count; ch++) {
+            bank->y[ch] = bank->x1[ch] = bank->x2[ch] = bank->y2[ch] = x[ch];
+            for (uint8_t k = 0; k < FILTER_MEDIAN_N; k++) bank->hist[k][ch] = x[ch];
+        }
+        return;
+    }
+
+    // Tầng trung vị
+    for (uint8_t k = 0; k < bank->n_median; k++) {
+        bank->hist[bank->hist_pos][bank->median_ch[k]] = x[bank->median_ch[k]];
+    }
+    bank->hist_pos = (uint8_t)((bank->hist_pos + 1U) % FILTER_MEDIAN_N);
+    for (uint8_t k = 0; k < bank->n_median; k++) {
+        uint8_t ch = bank->median_ch[k];
+        x[ch] = FilterBank_Median(bank, ch);
+    }
+
+    // Kênh không lọc
+    for (uint8_t ch = 0; ch < bank->count; ch++) {
+        if (bank->type[ch] == FILTER_NONE) bank->y[ch] = x[ch];
+    }
+
+    // Kalman
+    for (uint8_t k = 0; k < bank->n_kalman; k++) {
+        uint8_t ch = bank->kalman_ch[k];
+        filter_value_t p = bank->k_p[ch];
+#if FILTER_BANK_FIXED_POINT
+        int32_t gain = (int32_t)(((int64_t)p << 15) / (p + bank->k_r[ch]));   // Q15
+        int32_t delta = (int32_t)(((int64_t)gain * (x[ch] - bank->y[ch])) >> 15);
+        bank->y[ch] += delta;
+        p = (int32_t)(((int64_t)(32768 - gain) * p) >> 15)
+          + (int32_t)(((int64_t)(delta < 0 ? -delta : delta) * bank->k_q[ch]) >> 16);
+        // p = 0 sẽ khóa gain = 0 vĩnh viễn
+        bank->k_p[ch] = (p > 0) ? p : 1;
+#else
+        float gain = p / (p + bank->k_r[ch]);
+        float delta = gain * (x[ch] - bank->y[ch]);
+        bank->y[ch] += delta;
+        bank->k_p[ch] = (1.0f - gain) * p + fabsf(delta) * bank->k_q[ch];
+#endif
+    }
+
+    // EMA
+    for (uint8_t k = 0; k < bank->n_ema; k++) {
+        uint8_t ch = bank->ema_ch[k];
+#if FILTER_BANK_FIXED_POINT
+        bank->y[ch] += (int32_t)(((int64_t)bank->alpha[ch] * (x[ch] - bank->y[ch])) >> 15);
+#else
+        bank->y[ch] += bank->alpha[ch] * (x[ch] - bank->y[ch]);
+#endif
+    }
+
+    // Biquad
+    for (uint8_t k = 0; k < bank->n_biquad; k++) {
+        uint8_t ch = bank->biquad_ch[k];
+        filter_value_t y1 = bank->y[ch];
+#if FILTER_BANK_FIXED_POINT
+        int64_t acc = (int64_t)bank->b0[ch] * x[ch] + (int64_t)bank->b1[ch] * bank->x1[ch]
+                    + (int64_t)bank->b2[ch] * bank->x2[ch] - (int64_t)bank->a1[ch] * y1
+                    - (int64_t)bank->a2[ch] * bank->y2[ch];
+        bank->y[ch] = (int32_t)(acc >> 30);
+#else
+        bank->y[ch] = bank->b0[ch] * x[ch] + bank->b1[ch] * bank->x1[ch] + bank->b2[ch] * bank->x2[ch]
+                    - bank->a1[ch] * y1 - bank->a2[ch] * bank->y2[ch];
+#endif
+        bank->x2[ch] = bank->x1[ch];
+        bank->x1[ch] = x[ch];
+        bank->y2[ch] = y1;
+    }
+}
+
+float FilterBank_Output(const FilterBank* bank, uint8_t ch) {
+    return FB_TO_FLOAT(bank->y[ch]);
+}
@@ -0,0 +1,169 @@
+/*
+ * log_dma.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "log_dma.h"
+#include "log_level.h"
+#include <string.h>
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1U)
+
+Log_HandleTypeDef hlog;
+
+#if !LOG_BINARY
+// Chuỗi định dạng chỉ được link vào firmware ở chế độ log văn bản.
+#define LOG_EVENT_FMT(name, fmt) [name] = fmt,
+const char *const log_event_fmt[LOG_EVENT_COUNT] = {
+    LOG_EVENT_TABLE(LOG_EVENT_FMT)
+};
+#undef LOG_EVENT_FMT
+#endif
+
+// Critical section ngắn: lưu PRIMASK để gọi lồng được từ cả ngắt lẫn main loop.
+static inline uint32_t _Log_Lock(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static inline void _Log_Unlock(uint32_t primask) {
+    __set_PRIMASK(primask);
+}
+
+// Khởi động DMA cho đoạn liên tục tiếp theo trong vòng đệm.
+// Chỉ gọi ở mức ưu tiên LOG_IRQn (bên đọc), ngắt vẫn bật.
+static void _Log_StartTx(void) {
+    if (hlog.tx_busy || hlog.huart == NULL) return;
+
+    uint32_t used = hlog.head - hlog.tail;
+    if (used == 0) return;
+
+    uint32_t pos = hlog.tail & LOG_RING_MASK;
+    uint32_t chunk = LOG_RING_SIZE - pos;        // Không vượt qua cuối vòng đệm
+    if (chunk > used) chunk = used;
+    if (chunk > LOG_DMA_CHUNK_MAX) chunk = LOG_DMA_CHUNK_MAX;
+
+    hlog.tx_len = (uint16_t)chunk;
+    hlog.tx_busy = 1;
+    if (HAL_UART_Transmit_DMA(hlog.huart, &hlog.ring[pos], (uint16_t)chunk) != HAL_OK) {
+        // UART đang bận hoặc lỗi: thử lại ở lần Log_Process/Log_Write sau.
+        hlog.tx_busy = 0;
+        hlog.tx_len = 0;
+        hlog.tx_errors++;
+    }
+}
+
+void Log_Init(UART_HandleTypeDef *huart) {
+    hlog.huart = huart;
+    hlog.tx_busy = 0;
+    hlog.tx_len = 0;
+    // Giữ lại các bản ghi đã được đưa vào trước khi UART sẵn sàng.
+    NVIC_SetPendingIRQ(LOG_IRQn);
+}
+
+/**
+ * @brief Đưa một bản ghi vào vòng đệm log, không bao giờ chờ UART.
+ * @note  Bản ghi được chép nguyên vẹn hoặc bị bỏ toàn bộ (đếm vào dropped_*).
+ *        Ngắt chỉ bị cấm trong 2 đoạn giữ chỗ/commit cố định vài lệnh, không phụ thuộc len;
+ *        memcpy chạy khi ngắt bật, DMA được khởi động trong LOG_IRQn.
+ * @return true nếu bản ghi đã vào vòng đệm.
+ */
+bool Log_Write(const uint8_t *data, uint16_t len) {
+    if (data == NULL || len == 0) return false;
+    if (len > LOG_LINE_MAX) len = LOG_LINE_MAX;
+
+    // 1. Giữ chỗ
+    uint32_t primask = _Log_Lock();
+    uint32_t start = hlog.reserve;
+    uint32_t used = start - hlog.tail;
+    if (used + len > LOG_RING_SIZE) {
+        hlog.dropped_records++;
+        hlog.dropped_bytes += len;
+        _Log_Unlock(primask);
+        return false;
+    }
+    hlog.reserve = start + len;
+    hlog.writers++;
+    used += len;
+    if (used > hlog.max_used) hlog.max_used = used;
+    _Log_Unlock(primask);
+
+    // 2. Chép khi ngắt bật: ngắt chen vào chỉ giữ chỗ phía sau vùng này
+    uint32_t pos = start & LOG_RING_MASK;
+    uint32_t first = LOG_RING_SIZE - pos;
+    if (first > len) first = len;
+    memcpy(&hlog.ring[pos], data, first);
+    memcpy(&hlog.ring[0], data + first, len - first);
+
+    // 3. Commit: bên ghi ngoài cùng công bố luôn vùng của các ngắt đã chen vào
+    primask = _Log_Lock();
+    if (--hlog.writers == 0) {
+        hlog.head = hlog.reserve;
+    }
+    _Log_Unlock(primask);
+
+    if (!hlog.tx_busy) {
+        NVIC_SetPendingIRQ(LOG_IRQn);
+    }
+    return true;
+}
+
+#if LOG_BINARY
+/**
+ * @brief Gửi một sự kiện dạng nhị phân, không định dạng chuỗi trên MCU.
+ * @note  Bố cục bản ghi (little-endian):
+ *        [0xA5][level<<4 | argc][id:2][tick ms:4][argv[0]:4]...[argv[argc-1]:4]
+ *        Dùng chung vòng đệm với log văn bản, giải mã bằng tools/log_decode.py.
+ */
+void Log_Event(uint8_t level, uint16_t id, uint8_t argc, const uint32_t *argv) {
+    uint8_t rec[LOG_EVENT_HDR_SIZE + 4U * LOG_EVENT_MAX_ARGS];
+    if (argc > LOG_EVENT_MAX_ARGS) argc = LOG_EVENT_MAX_ARGS;
+
+    uint32_t tick = HAL_GetTick();
+    rec[0] = LOG_EVENT_SYNC;
+    rec[1] = (uint8_t)((level << 4) | argc);
+    rec[2] = (uint8_t)(id & 0xFF);
+    rec[3] = (uint8_t)(id >> 8);
+    memcpy(&rec[4], &tick, 4);                    // Cortex-M33 là little-endian
+    memcpy(&rec[LOG_EVENT_HDR_SIZE], argv, 4U * argc);
+    Log_Write(rec, (uint16_t)(LOG_EVENT_HDR_SIZE + 4U * argc));
+}
+#endif
+
+// Gọi định kỳ từ main loop để khởi động lại DMA nếu lần trước UART bận.
+void Log_Process(void) {
+    if (hlog.tx_busy || hlog.head == hlog.tail) return;
+    NVIC_SetPendingIRQ(LOG_IRQn);
+}
+
+/**
+ * @brief Gọi trong ngắt LOG_IRQn, sau HAL_UART_IRQHandler: khởi động DMA cho dữ liệu đã commit.
+ */
+void Log_IRQHandler(void) {
+    _Log_StartTx();
+}
+
+// Các callback chạy trong ngắt USART3/GPDMA1 Channel 3, cùng mức ưu tiên với LOG_IRQn.
+void Log_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart != hlog.huart) return;
+    hlog.tail += hlog.tx_len;
+    hlog.tx_len = 0;
+    hlog.tx_busy = 0;
+    _Log_StartTx();
+}
+
+void Log_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (huart != hlog.huart) return;
+    // Bỏ đoạn đang gửi dở, tiếp tục với phần còn lại của vòng đệm.
+    hlog.tx_errors++;
+    hlog.tail += hlog.tx_len;
+    hlog.tx_len = 0;
+    hlog.tx_busy = 0;
+    _Log_StartTx();
+}
+
+uint32_t Log_GetUsed(void) {
+    return hlog.head - hlog.tail;
+}
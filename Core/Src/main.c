@@ -23,12 +23,25 @@
 /* USER CODE BEGIN Includes */
 #include "stdio.h"
 #include "stdarg.h"
+#include "string.h"
 #include "eeprom_final.h"
 #include "Modbus_Slave_Final.h"
 #include "Input_parameters.h"
-#include "pid_final.h"
+#include "pid_ctrl.h"
+#include "pid_config.h"
 #include "stepper_v2.h"
-#include "R507_temp_pressure.h"
+#include "refrigerant.h"
+#include "adc_ring.h"
+#include "adc_trip.h"
+#include "sensor_config.h"
+#include "sensor_pipeline.h"
+#include "log_dma.h"
+#include "log_level.h"
+#include "scheduler.h"
+#include "eev_control.h"
+#include "eev_board.h"
+#include "comm_settings.h"
+#include "valve_backup.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -62,10 +75,9 @@ DMA_HandleTypeDef handle_GPDMA1_Channel1;
 DMA_HandleTypeDef handle_GPDMA1_Channel0;
 
 /* USER CODE BEGIN PV */
+DMA_HandleTypeDef handle_GPDMA1_Channel3;
 ModbusHandle modbus_slave;
 EEPROM_Handle_t hEEPROM_final;
-PID_TypeDef pid;
-Stepper motor;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -86,32 +98,23 @@ static void MX_TIM2_Init(void);
 /* USER CODE BEGIN 0 */
 
 // Biến theo dõi tình trạng hoạt động của van tiết lưu
-volatile int16_t step_position = 0;
-volatile float percent_step = 0;
 volatile uint8_t state_motor_step;
-volatile uint32_t last_time_step;
 
 
-// Biến tính toán PID cho số bước điều khiển van tiết lưu
-volatile uint8_t count = 0;
-volatile float output_pid = 0.0f;
-volatile int16_t stepp_count = 0;
-#define BUFFER_SIZE 64
-volatile int16_t stepp_buffer[BUFFER_SIZE];  // Mảng lưu trữ dữ liệu
-volatile uint8_t buffer_index = 0;           // Chỉ mục cho mảng
-
 /*================================================ Hàm Log dữ liệu hoạt động của chương trình =======================================*/
+// Định dạng vào buffer tạm rồi đẩy vào vòng đệm log, DMA USART3 sẽ gửi dần.
+// Không chờ UART nên gọi được từ cả main loop lẫn ngắt.
 void printLOGDATA(const char *fmt, ...) {
-    char temp[128];
+    char temp[LOG_LINE_MAX];
     va_list args;
     va_start(args, fmt);
     int len = vsnprintf(temp, sizeof(temp), fmt, args);
     va_end(args);
 
     if (len > 0) {
-        // Đảm bảo độ dài không vượt quá giới hạn
-        if (len > sizeof(temp)) len = sizeof(temp);
-        HAL_UART_Transmit(&huart3, (uint8_t *)temp, len, 60);
+        // vsnprintf cắt chuỗi khi quá dài, bỏ ký tự kết thúc '\0'
+        if (len >= (int)sizeof(temp)) len = sizeof(temp) - 1;
+        Log_Write((const uint8_t *)temp, (uint16_t)len);
     }
 }
 void I2C1_Reinit(void){
@@ -120,276 +123,101 @@ void I2C1_Reinit(void){
 /*================================================ Hàm Log dữ liệu hoạt động của chương trình =======================================*/
 
 
-/*================================================ Hàm tính toán độ quá nhiệt =======================================*/
-volatile float Saturation_temperature;
-volatile float delta_temperatute;
-void superheat_value(){
-	Saturation_temperature = R507_GetTemperature(pressure_sensors.low_pressure_sensor);
-	delta_temperatute = temperature_sensors.hoi_ve - Saturation_temperature;
+void EWDG_Refresh(){
+	HAL_GPIO_TogglePin(EWDG_GPIO_Port, EWDG_Pin);
+}
+
+
+/*================================================ Hàm xử lý dữ liệu giao tiếp ngoại vi =======================================*/
+// Thời gian thực của đường PID (chỉ đọc), giá trị lớn hơn 65535 bị chặn
+#define CONTROL_TIMING_REG 90
+static uint16_t clamp_u16(uint32_t value){
+	return (value > 0xFFFFU) ? 0xFFFFU : (uint16_t)value;
 }
-/*================================================ Hàm tính toán độ quá nhiệt =======================================*/
-
-
-/*================================================ Hàm tính toán để quyết định số bước điều khiển van tiết lưu =======================================*/
-static int16_t find_max_value() {
-	    if (BUFFER_SIZE <= 0) return 0;
-	    int16_t max_abs_value = stepp_buffer[0];
-	    int16_t abs_max = max_abs_value < 0 ? -max_abs_value : max_abs_value;
-	        uint8_t i = 1;
-	        for (; i + 3 < BUFFER_SIZE; i += 4) {
-	            // Xử lý 4 phần tử mỗi lần
-	            int16_t current0 = stepp_buffer[i];
-	            int16_t abs0 = current0 < 0 ? -current0 : current0;
-	            int update0 = (abs0 > abs_max) || (abs0 == abs_max && current0 > max_abs_value);
-	            max_abs_value = update0 ? current0 : max_abs_value;
-	            abs_max = update0 ? abs0 : abs_max;
-
-	            int16_t current1 = stepp_buffer[i + 1];
-	            int16_t abs1 = current1 < 0 ? -current1 : current1;
-	            int update1 = (abs1 > abs_max) || (abs1 == abs_max && current1 > max_abs_value);
-	            max_abs_value = update1 ? current1 : max_abs_value;
-	            abs_max = update1 ? abs1 : abs_max;
-
-	            int16_t current2 = stepp_buffer[i + 2];
-	            int16_t abs2 = current2 < 0 ? -current2 : current2;
-	            int update2 = (abs2 > abs_max) || (abs2 == abs_max && current2 > max_abs_value);
-	            max_abs_value = update2 ? current2 : max_abs_value;
-	            abs_max = update2 ? abs2 : abs_max;
-
-	            int16_t current3 = stepp_buffer[i + 3];
-	            int16_t abs3 = current3 < 0 ? -current3 : current3;
-	            int update3 = (abs3 > abs_max) || (abs3 == abs_max && current3 > max_abs_value);
-	            max_abs_value = update3 ? current3 : max_abs_value;
-	            abs_max = update3 ? abs3 : abs_max;
-	        }
-	        return max_abs_value;
+static void publish_control_timing(void){
+	const EEV_Control_Timing* t = EEV_Control_GetTiming();
+	uint16_t regs[6];
+	regs[0] = clamp_u16(EEV_Board_CyclesToUs(t->isr_cycles_max));  // 90: WCET ngắt TIM2 (us)
+	regs[1] = clamp_u16(t->latency_us_last);                        // 91: trễ ngắt -> PID gần nhất (us)
+	regs[2] = clamp_u16(t->latency_us_max);                         // 92: trễ ngắt -> PID lớn nhất (us)
+	regs[3] = clamp_u16(t->jitter_us_max);                          // 93: jitter chu kỳ PID lớn nhất (us)
+	regs[4] = clamp_u16(t->pid_missed);                             // 94: số lần PID lỡ nhịp
+	regs[5] = (uint16_t)t->pid_runs;                                // 95: số lần PID đã chạy (16 bit thấp)
+	Modbus_PublishHoldingRegs(&modbus_slave, CONTROL_TIMING_REG, regs, 6);
 }
-void control_stepper(){
-	uint32_t current_time = HAL_GetTick();
-	float error = fabsf(pid.setpoint - delta_temperatute);
-	static const float k = 0.6f;
-	static const uint32_t time_min = 500, time_max = 10000;
-	uint32_t delay_time = time_min + (uint32_t)((time_max - time_min) / (1.0f + k * error));
-	if(((uint32_t)(current_time - last_time_step) >= delay_time) && Stepper_IsMoving(&motor) == 0){
-		int16_t output_final = find_max_value();
-		Stepper_Move(&motor, output_final);
-		volatile int16_t *ptr = stepp_buffer;
-		for (int i = 0; i < BUFFER_SIZE; i += 8) {
-		    *ptr++ = 0; *ptr++ = 0; *ptr++ = 0; *ptr++ = 0;
-		    *ptr++ = 0; *ptr++ = 0; *ptr++ = 0; *ptr++ = 0;
-		}
+// Cách gộp lệnh bước của PID (StepAgg_Policy, 0 = |x| lớn nhất), Master ghi để đổi, giá trị sai bị trả lại
+#define STEP_POLICY_REG 96
+static void process_step_policy(void){
+	uint16_t policy = modbus_slave.holdingRegs[STEP_POLICY_REG];
+	if(policy < STEP_AGG_POLICY_COUNT){
+		EEV_Control_SetStepPolicy((StepAgg_Policy)policy);
+	}else{
+		policy = (uint16_t)EEV_Control_GetStepPolicy();
+		Modbus_PublishHoldingRegs(&modbus_slave, STEP_POLICY_REG, &policy, 1);
 	}
 }
-/*================================================ Hàm tính toán để quyết định số bước điều khiển van tiết lưu =======================================*/
-
-
-
-/*================================================ Hàm tính toán để quyết định thay đổi superheat setpoint =======================================*/
-void convert_setpoint(){
-    static const struct {
-        float pressure_threshold;
-        float target_temp_diff;
-    } lookup_table[] = {
-//        { 23.0f, 5.0f },
-//        { 20.0f, 7.0f },
-//        { 17.0f, 9.0f },
-//        { 15.0f, 11.0f},
-//        { 0.0f,  13.0f}
-        { 23.0f, 3.0f},
-        { 20.0f, 5.0f},
-        { 17.0f, 7.0f},
-        { 15.0f, 9.0f},
-        { 0.0f,  11.0f}
-    };
-    static float last_setpoint = -1;  // Lưu giá trị cũ
-    float new_setpoint = pid.setpoint;
-    static uint8_t waiting = 0;
-    static uint32_t change_time = 0;
-    GPIO_PinState state_pin_relay = HAL_GPIO_ReadPin(RELAY_GPIO_Port, RELAY_Pin);
-    static uint8_t last_state = 1;
-    static uint8_t is_waiting = 0;
-    static uint32_t time_changed = 0;
-    // Lấy giá trị áp suất
-    float high_pressure = pressure_sensors.high_pressure_sensor;
-
-    if(last_state == 0 && state_pin_relay == 1){
-    	time_changed = HAL_GetTick();
-    	is_waiting = 1;
-    }
-    last_state = state_pin_relay;
-
-     // Duyệt bảng để tìm giá trị TARGET_TEMP_DIFF phù hợp
-    if(state_pin_relay == 1){
-    	 uint32_t current_time = HAL_GetTick();
-    	 if(!is_waiting || ((uint32_t)(current_time - time_changed) >= 16000)){
-             is_waiting = 0;
-			 for (int i = 0; i < sizeof(lookup_table) / sizeof(lookup_table[0]); i++) {
-				 if (high_pressure >= lookup_table[i].pressure_threshold) {
-						 new_setpoint = lookup_table[i].target_temp_diff;
-						 break;  // Thoát kh�?i vòng lặp sau khi tìm thấy ngưỡng phù hợp
-				 }
-			 }
-		}
-    }
-     if(new_setpoint != last_setpoint){
-    	 if(!waiting){
-    		 change_time = HAL_GetTick();
-    		 waiting = 1;
-    	 }
-    	 uint32_t curent_time_2 = HAL_GetTick();
-    	 if((uint32_t)(curent_time_2 - change_time) >= 8000){
-    		 pid.setpoint = new_setpoint;
-    		 last_setpoint = new_setpoint;
-    		 waiting = 0;
-    	 }
-     }else{
-    	 waiting = 0;
-     }
+// Khối thanh ghi của từng van (EEV_AXIS_REG_*), van i bắt đầu ở EEV_AXIS_REG_BASE + i * EEV_AXIS_REG_STRIDE
+#if EEV_AXIS_REG_BASE + EEV_AXIS_COUNT * EEV_AXIS_REG_STRIDE > MAX_HOLDING_REGS
+#error "EEV axis register blocks do not fit in MAX_HOLDING_REGS"
+#endif
+static uint16_t eev_axis_reg(const EEV_Axis* ax, uint16_t offset){
+	return (uint16_t)(EEV_AXIS_REG_BASE + ax->index * EEV_AXIS_REG_STRIDE + offset);
 }
-/*================================================ Hàm tính toán để quyết định thay đổi superheat setpoint =======================================*/
-
-
-/*================================================ Hàm chính điều khiển van tiết lưu =======================================*/
-// �?ịnh nghĩa các trạng thái
-typedef enum {
-    STATE_INIT,         // Trạng thái khởi tạo ban đầu
-    STATE_CLOSING,      // �?óng van (500 bước)
-    STATE_OPENING,      // Mở van (200 bước)
-    STATE_CONTROL_EEV,      // Ch�? 15s
-    STATE_IDLE_EEV
-} SystemState;
-// Biến toàn cục
-SystemState current_state_eev = STATE_INIT;
-uint32_t timer = 0;
-uint8_t init_done = 0;      // C�? đánh dấu đã hoàn thành khởi tạo
-void control_EEV(){
-	static uint8_t check_run_defrost = 0;
-//	static GPIO_PinState pin_state_run = GPIO_PIN_RESET;
-//	static GPIO_PinState pin_state_run_defrost = GPIO_PIN_RESET;
-	GPIO_PinState pin_state_run = HAL_GPIO_ReadPin(RUN_GPIO_Port, RUN_Pin);
-	GPIO_PinState pin_state_run_defrost = HAL_GPIO_ReadPin(RUN_Defrost_GPIO_Port, RUN_Defrost_Pin);
-//	if(pin_state_run_check == GPIO_PIN_SET || pin_state_run_defrost_check == GPIO_PIN_SET){
-//		if((uint32_t)(HAL_GetTick() - ))
-//	}
-
-
-
-	switch(pin_state_run_defrost){
-	case GPIO_PIN_SET:
-		if(check_run_defrost == 0 && !Stepper_IsMoving(&motor)){
-			check_run_defrost = 1;
-//        	step_position = 0;
-//			percent_step = 0.0f;
-//			Stepper_Move(&motor, -500);
-			step_position = (step_position - 80 > 0) ? step_position - 80 : 0;
-        	percent_step = (step_position/500.0f)*100.0f;
-            Stepper_Move(&motor, -(500-step_position));
-            current_state_eev = STATE_OPENING;
-		}
-		break;
-	case GPIO_PIN_RESET:
-		check_run_defrost = 0;
-		   // Xử lý theo trạng thái hiện tại
-		    switch(current_state_eev) {
-		        case STATE_INIT:
-		            // Luôn bắt đầu bằng việc đóng 500 bước khi khởi tạo
-		            if(!Stepper_IsMoving(&motor)) {
-		            	step_position = 500;
-		            	percent_step = 100.0f;
-		                Stepper_Move(&motor, 500);
-//		            	step_position = 0;
-//		            	percent_step = 0.0f;
-//		                Stepper_Move(&motor, -500);
-		                current_state_eev = STATE_CLOSING;
-		                init_done = 0;  // �?ánh dấu chưa hoàn thành khởi tạo
-		            }
-		            break;
-
-		        case STATE_CLOSING:
-		            if(!Stepper_IsMoving(&motor)) {
-		                if(!init_done) {
-		                    // Nếu đây là lần đóng đầu tiên (khởi tạo)
-		                    init_done = 1;
-		                    // Nếu chân input đang ở mức cao, chuyển sang mở
-		                    if(pin_state_run == GPIO_PIN_SET) {
-		                        Stepper_Move(&motor, -250);
-		                        current_state_eev = STATE_OPENING;
-		                    } else {
-		                    	current_state_eev = STATE_IDLE_EEV;  // Ch�? mức cao
-		                    }
-		                } else {
-		                    // Nếu đây là lần đóng trong quá trình hoạt động bình thư�?ng
-		                	current_state_eev = STATE_IDLE_EEV;
-		                }
-		            }
-		            break;
-
-		        case STATE_IDLE_EEV:
-		        	if(!Stepper_IsMoving(&motor)){
-		        		if(pin_state_run == GPIO_PIN_SET){
-		        		    Stepper_Move(&motor, -250);
-		        		    current_state_eev = STATE_OPENING;
-		        		}
-		        	}
-		            break;
-
-		        case STATE_OPENING:
-		            if(!Stepper_IsMoving(&motor)) {
-		                // �?ã mở xong, bắt đầu ch�? 15s
-		                timer = HAL_GetTick();
-		                current_state_eev = STATE_CONTROL_EEV;
-		            }
-		            break;
-
-		        case STATE_CONTROL_EEV:
-		            if(HAL_GetTick() - timer >= 8000) {
-		                control_stepper();
-		            }
-		            // Nếu trong quá trình ch�? mà chân input chuyển thành mức thấp
-		            if(pin_state_run == GPIO_PIN_RESET) {
-		            	step_position = (step_position + 80 < 500) ? step_position + 80 : 500;
-		            	percent_step = (step_position/500.0f)*100.0f;
-		                Stepper_Move(&motor, step_position);
-		                current_state_eev = STATE_CLOSING;
-		            }
-		            break;
-		    }
-	  break;
-	}
+// Công bố hành trình và profile đang dùng (sau khởi tạo, sau khi ghi hoặc khi giá trị ghi bị trả lại)
+static void publish_eev_axis_config(const EEV_Axis* ax){
+	uint16_t regs[4];
+	regs[0] = (uint16_t)ax->motor.position_max;
+	regs[1] = ax->motor.profile.max_rate_open;
+	regs[2] = ax->motor.profile.max_rate_close;
+	regs[3] = ax->motor.profile.accel;
+	Modbus_PublishHoldingRegs(&modbus_slave, eev_axis_reg(ax, EEV_AXIS_REG_STROKE), regs, 4);
 }
-/*================================================ Hàm chính điều khiển van tiết lưu =======================================*/
-
-
-/*================================================ Hàm điều khiển dịch phụ làm mát đầu đẩy =======================================*/
-int16_t nhiet_do_bat_lam_mat = 85;
-int16_t nhiet_do_tat_lam_mat = 75;
-void lam_mat_dau_day(){
-	if(temperature_sensors.dau_day >= (float)(nhiet_do_bat_lam_mat)){
-		HAL_GPIO_WritePin(RELAY_GPIO_Port, RELAY_Pin, GPIO_PIN_RESET);
-	}else if(temperature_sensors.dau_day <= (float)(nhiet_do_tat_lam_mat)){
-		HAL_GPIO_WritePin(RELAY_GPIO_Port, RELAY_Pin, GPIO_PIN_SET);
-	}
+static void publish_eev_axis_status(const EEV_Axis* ax){
+	uint16_t regs[6];
+	regs[EEV_AXIS_REG_POSITION]  = (uint16_t)ax->motor.position;
+	regs[EEV_AXIS_REG_PERCENT]   = (uint16_t)(ax->motor.percent*10.0f);
+	regs[EEV_AXIS_REG_STATE]     = (uint16_t)ax->state;
+	regs[EEV_AXIS_REG_SUPERHEAT] = (uint16_t)(int16_t)(ax->superheat*10.0f);
+	regs[EEV_AXIS_REG_SETPOINT]  = (uint16_t)(ax->pid.setpoint*10.0f);
+	regs[EEV_AXIS_REG_OUTPUT]    = (uint16_t)(int16_t)(ax->output_pid*100.0f);
+	Modbus_PublishHoldingRegs(&modbus_slave, eev_axis_reg(ax, EEV_AXIS_REG_POSITION), regs, 6);
 }
-/*================================================ Hàm điều khiển dịch phụ làm mát đầu đẩy =======================================*/
-
-
-void EWDG_Refresh(){
-	HAL_GPIO_TogglePin(EWDG_GPIO_Port, EWDG_Pin);
+// Hành trình chỉ đổi được khi van đứng yên; tốc độ bị Stepper_SetProfile chặn trong [STEPPER_RATE_MIN, STEPPER_RATE_MAX]
+static void process_eev_axis(EEV_Axis* ax){
+	const uint16_t* regs = &modbus_slave.holdingRegs[eev_axis_reg(ax, EEV_AXIS_REG_STROKE)];
+	uint16_t stroke = regs[0];
+	Stepper_Profile profile = ax->motor.profile;
+	uint8_t changed = 0;
+	if(stroke != (uint16_t)ax->motor.position_max){
+		Stepper_SetLimits(&ax->motor, (int16_t)stroke);
+		changed = 1;
+	}
+	if(regs[1] != profile.max_rate_open || regs[2] != profile.max_rate_close || regs[3] != profile.accel){
+		profile.max_rate_open = regs[1];
+		profile.max_rate_close = regs[2];
+		profile.accel = regs[3];
+		Stepper_SetProfile(&ax->motor, &profile);
+		changed = 1;
+	}
+	// Công bố lại giá trị thực dùng: giá trị bị từ chối hoặc bị chặn không nằm lại trên thanh ghi
+	if(changed) publish_eev_axis_config(ax);
+	publish_eev_axis_status(ax);
 }
-
-
-/*================================================ Hàm xử lý dữ liệu giao tiếp ngoại vi =======================================*/
 void modbus_communication(){
-	modbus_slave.holdingRegs[0] = (uint16_t)(pressure_sensors.high_pressure_sensor*100.0f);
-	modbus_slave.holdingRegs[1] = (uint16_t)(pressure_sensors.low_pressure_sensor*100.0f);
-	modbus_slave.holdingRegs[2] = (int16_t)(temperature_sensors.dau_day*10.0f);
-	modbus_slave.holdingRegs[3] = (int16_t)(temperature_sensors.hoi_ve*10.0f);
-	modbus_slave.holdingRegs[4] = (int16_t)(Saturation_temperature*10.0f);
-	modbus_slave.holdingRegs[5] = (int16_t)(delta_temperatute*10.0f);
-	modbus_slave.holdingRegs[6] = (uint16_t)(pid.setpoint*10.0f);
-	modbus_slave.holdingRegs[7] = (uint16_t)(percent_step*10.0f);
-	modbus_slave.holdingRegs[8] = (uint16_t)(current_state_eev);
-	modbus_slave.holdingRegs[9] = (uint16_t)(vref*100.0f);
+	// Tính toàn bộ snapshot trước rồi công bố một lần, Master không đọc được bộ giá trị lẫn cũ/mới
+	uint16_t regs[10];
+	regs[0] = (uint16_t)(pressure_sensors.high_pressure_sensor*100.0f);
+	regs[1] = (uint16_t)(pressure_sensors.low_pressure_sensor*100.0f);
+	regs[2] = (int16_t)(temperature_sensors.dau_day*10.0f);
+	regs[3] = (int16_t)(temperature_sensors.hoi_ve*10.0f);
+	// 4..8 giữ theo van 0 cho Master cũ, các van khác đọc khối EEV_AXIS_REG_BASE
+	regs[4] = (int16_t)(eev_axes[0].saturation*10.0f);
+	regs[5] = (int16_t)(eev_axes[0].superheat*10.0f);
+	regs[6] = (uint16_t)(eev_axes[0].pid.setpoint*10.0f);
+	regs[7] = (uint16_t)(eev_axes[0].motor.percent*10.0f);
+	regs[8] = (uint16_t)(eev_axes[0].state);
+	regs[9] = (uint16_t)(vref*100.0f);
+	Modbus_PublishHoldingRegs(&modbus_slave, 0, regs, 10);
 //	modbus_slave.holdingRegs[8] = (uint16_t)(HAL_GPIO_ReadPin(RUN_GPIO_Port, RUN_Pin));
 //	modbus_slave.holdingRegs[9] = (uint16_t)(HAL_GPIO_ReadPin(RUN_Defrost_GPIO_Port, RUN_Defrost_Pin));
 }
@@ -440,6 +268,8 @@ static void Restart_UART1_DMA_Modbus_Simple(void)
     HAL_Delay(10);
 
     MX_USART1_UART_Init();
+    // MX_USART1_UART_Init luôn đặt 9600 8N1: áp lại cấu hình truyền thông đang dùng
+    CommSettings_ConfigureUart(&huart1);
     __HAL_UART_CLEAR_PEFLAG(&huart1);
     __HAL_UART_CLEAR_FEFLAG(&huart1);
     __HAL_UART_CLEAR_NEFLAG(&huart1);
@@ -450,7 +280,7 @@ static void Restart_UART1_DMA_Modbus_Simple(void)
 volatile uint32_t lastvalidIDTime = 0;
 void reset_UART_DMA(){
 	  if((uint32_t)(HAL_GetTick() - lastvalidIDTime) >= 10000){
-		 printLOGDATA("[WARN] [UART] Modbus timeout detected. Attempting UART DMA restart...\r\n");
+		 LOG_WARN(EVT_SYS_UART_TIMEOUT);
 		 Restart_UART1_DMA_Modbus_Simple();
 		 lastvalidIDTime = HAL_GetTick();
   }
@@ -459,18 +289,12 @@ void reset_UART_DMA(){
 
 
 /*================================================ ADC DMA =================================================*/
-volatile uint16_t adc_buffer[5];
-volatile uint8_t isADCFinish = 0;
 volatile uint32_t time_refresh_adc_dma = 0;
-void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
-	isADCFinish = 1;
-	time_refresh_adc_dma = HAL_GetTick();
-}
 /*==================================================================================================*/
 /* Restart system ADC if error occurs */
 static void Restart_ADC1_DMA_Simple(void)
 {
-    HAL_ADC_Stop_DMA(&hadc1);
+    ADC_Ring_Stop(&hadc1);
     HAL_DMA_Abort(&handle_GPDMA1_Channel2);
 
     HAL_ADC_DeInit(&hadc1);
@@ -480,13 +304,13 @@ static void Restart_ADC1_DMA_Simple(void)
     HAL_ADCEx_Calibration_Start(&hadc1,ADC_SINGLE_ENDED);
     __HAL_ADC_CLEAR_FLAG(&hadc1, ADC_FLAG_EOS | ADC_FLAG_EOC | ADC_FLAG_OVR | ADC_FLAG_AWD1 | ADC_FLAG_AWD2 | ADC_FLAG_AWD3 | ADC_FLAG_JEOS | ADC_FLAG_JEOC);
 
-    isADCFinish = 0;
-    HAL_ADC_Start_DMA(&hadc1, (uint32_t*)adc_buffer, 5);
+    ADC_Trip_Init(&hadc1);
+    ADC_Ring_Start(&hadc1);
 }
 void Reset_ADC_DMA(){
      uint32_t current_time =  HAL_GetTick();
      if((uint32_t)(current_time - time_refresh_adc_dma) >= 6000){
-    	 printLOGDATA("[WARN] [ADC] ADC timeout detected. Attempting ADC DMA restart...\r\n");
+    	 LOG_WARN(EVT_SYS_ADC_TIMEOUT);
     	 Restart_ADC1_DMA_Simple();
    		 time_refresh_adc_dma = HAL_GetTick();
      }
@@ -538,6 +362,104 @@ void GetAndSendResetFlags() {
     // Xóa tất cả các cờ reset để phát hiện reset lần sau
     __HAL_RCC_CLEAR_RESET_FLAGS();
 }
+
+
+/*================================================ Bộ lập lịch tác vụ =======================================*/
+// Thứ tự trong bảng = độ ưu tiên khi nhiều tác vụ cùng đến hạn.
+enum {
+	TASK_PID,        // Tính PID đúng nhịp TIM2 (ngắt chỉ đánh dấu đến hạn)
+	TASK_MODBUS_RX,  // Xử lý frame Modbus đã được ngắt chụp vào hàng đợi
+	TASK_ADC,        // Xử lý khối mẫu ADC mới (một nửa bộ đệm vòng DMA)
+	TASK_CONTROL,    // Tính quá nhiệt, làm mát đầu đẩy, setpoint, máy trạng thái van
+	TASK_MODBUS,     // Cập nhật thanh ghi Modbus, ghi EEPROM khi master yêu cầu
+	TASK_LOG,        // Khởi động lại DMA log nếu lần trước UART bận
+	TASK_RECOVERY,   // Giám sát timeout UART/ADC và khởi động lại ngoại vi
+	TASK_WATCHDOG,   // Nạp IWDG và watchdog ngoài
+	TASK_COUNT
+};
+
+Sched_HandleTypeDef scheduler;
+
+// Ngắt TIM2 báo PID đến hạn
+void EEV_Control_PidDueCallback(void){
+	Sched_Trigger(&scheduler, TASK_PID);
+}
+static void task_pid(void){
+	EEV_Control_PidStep();
+}
+static void task_modbus_rx(void){
+#if MODBUS_PROCESS_IN_MAIN_LOOP == 1
+	Modbus_Poll(&modbus_slave);
+#endif
+}
+// Ngắt UART báo có frame mới: đánh thức tác vụ xử lý ngay ở lượt Sched_Run kế tiếp
+void Modbus_FrameReadyCallback(ModbusHandle* modbus){
+	(void)modbus;
+	Sched_Trigger(&scheduler, TASK_MODBUS_RX);
+}
+// Ngắt DMA báo một nửa bộ đệm vòng ADC đã đầy
+void ADC_Ring_BlockReadyCallback(void){
+	time_refresh_adc_dma = HAL_GetTick();
+	Sched_Trigger(&scheduler, TASK_ADC);
+}
+static void task_adc(void){
+	ADC_Ring_Block block;
+	uint16_t scans[ADC_RING_SCANS_PER_HALF][ADC_RING_CHANNELS];
+	float control[ADC_RING_CHANNELS];
+	if(ADC_Ring_GetBlock(&block)){
+		memcpy(scans, block.scans, sizeof(scans));
+		// Bỏ khối nếu DMA đã quay lại ghi đè trong lúc đang chép (trạng thái CIC không lùi lại được)
+		if(!ADC_Ring_BlockValid(&block)) return;
+		if(SensorPipeline_Process(scans, ADC_RING_SCANS_PER_HALF, control)){
+			Calcular_Input(control);
+		}
+		Calcular_Fast_Input();
+		// Bảo vệ chạy mỗi khối, quá nhiệt/PID dùng giá trị đường điều khiển mới nhất
+		Sched_Trigger(&scheduler, TASK_CONTROL);
+	}
+}
+static void task_control(void){
+	ADC_Trip_Process();
+	EEV_Control_Step();
+}
+static void task_modbus(void){
+	modbus_communication();
+	Data_Write(&modbus_slave);
+	CommSettings_Process();
+	Refrigerant_Process();
+	SensorConfig_Process();
+	PidConfig_Process();
+	ADC_Trip_Publish(&modbus_slave);
+	publish_control_timing();
+	process_step_policy();
+	for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+		process_eev_axis(&eev_axes[i]);
+	}
+	// Dựng sẵn khung FC03/FC04 cho lần đọc kế tiếp của Master
+	Modbus_RefreshReadCache(&modbus_slave);
+}
+static void task_recovery(void){
+	reset_UART_DMA();
+	Reset_ADC_DMA();
+}
+static void task_watchdog(void){
+	HAL_IWDG_Refresh(&hiwdg);
+	EWDG_Refresh();
+}
+
+// deadline_us: ngân sách thời gian chạy, vượt sẽ được đếm vào overruns và log WARN.
+// TASK_MODBUS/TASK_RECOVERY có thể chờ EEPROM hoặc HAL_Delay(10) nên ngân sách lớn hơn.
+Sched_Task sched_tasks[TASK_COUNT] = {
+	[TASK_PID]       = { .func = task_pid,       .period_ms = 0,  .deadline_us = 500  },
+	[TASK_MODBUS_RX] = { .func = task_modbus_rx, .period_ms = 10, .deadline_us = 1000 },
+	[TASK_ADC]      = { .func = task_adc,      .period_ms = 5,   .deadline_us = 1000  },
+	[TASK_CONTROL]  = { .func = task_control,  .period_ms = 50,  .deadline_us = 1000  },
+	[TASK_MODBUS]   = { .func = task_modbus,   .period_ms = 20,  .deadline_us = 20000 },
+	[TASK_LOG]      = { .func = Log_Process,   .period_ms = 10,  .deadline_us = 200   },
+	[TASK_RECOVERY] = { .func = task_recovery, .period_ms = 100, .deadline_us = 30000 },
+	[TASK_WATCHDOG] = { .func = task_watchdog, .period_ms = 10,  .deadline_us = 100   },
+};
+/*================================================ Bộ lập lịch tác vụ =======================================*/
 /* USER CODE END 0 */
 
 /**
@@ -577,6 +499,7 @@ int main(void)
   MX_USART3_UART_Init();
   MX_TIM2_Init();
   /* USER CODE BEGIN 2 */
+  Log_Init(&huart3);
   uint32_t start_time = HAL_GetTick();
   while((uint32_t)(HAL_GetTick() - start_time) <= 600){
 	  EWDG_Refresh();
@@ -586,25 +509,54 @@ int main(void)
   EEPROM_ReadInt16(&hEEPROM_final, 0, &nhiet_do_bat_lam_mat);
   EEPROM_ReadInt16(&hEEPROM_final, 2, &nhiet_do_tat_lam_mat);
 
-  StepperPins pins = {
-  		  .PORT_IN1 = STEPPER_1_GPIO_Port, .PIN_IN1 = STEPPER_1_Pin,
-  		  .PORT_IN2 = STEPPER_2_GPIO_Port, .PIN_IN2 = STEPPER_2_Pin,
-  		  .PORT_IN3 = STEPPER_3_GPIO_Port, .PIN_IN3 = STEPPER_3_Pin,
-  		  .PORT_IN4 = STEPPER_4_GPIO_Port, .PIN_IN4 = STEPPER_4_Pin
+  // Board có một bộ chân động cơ và một cặp cảm biến áp suất hút/nhiệt độ hơi về: van 0
+  EEV_AxisConfig axis_cfg = {
+  		  .pins = {
+  				  .PORT_IN1 = STEPPER_1_GPIO_Port, .PIN_IN1 = STEPPER_1_Pin,
+  				  .PORT_IN2 = STEPPER_2_GPIO_Port, .PIN_IN2 = STEPPER_2_Pin,
+  				  .PORT_IN3 = STEPPER_3_GPIO_Port, .PIN_IN3 = STEPPER_3_Pin,
+  				  .PORT_IN4 = STEPPER_4_GPIO_Port, .PIN_IN4 = STEPPER_4_Pin
+  		  },
+  		  .low_pressure = &pressure_sensors.low_pressure_sensor,
+  		  .suction_temperature = &temperature_sensors.hoi_ve
   };
-  Stepper_Init(&motor, pins);
-  PID_Init(&pid, 0.03f, 0.12f, 11.0f);
+  EEV_Control_InitAxis(0, &axis_cfg);
+  // Vị trí van giữ qua reset trong thanh ghi backup, control_EEV() đọc lại ở STATE_INIT
+  ValveBackup_Init();
 
 //  ADC_Init(&hadc1);
+  // Modbus_Init xóa toàn bộ holding register: phải chạy trước mọi module công bố thanh ghi lúc khởi tạo
+  Modbus_Init(&modbus_slave, &huart1, USART1_IRQn);
+  // Mô tả cảm biến (loại, dải đo, hiệu chuẩn, bộ lọc) lưu trong EEPROM, sửa qua holding register 60..74
+  SensorConfig_Init(&hEEPROM_final, &modbus_slave);
   Filter_Input_Init();
+  // Đường nhanh cho bảo vệ, CIC hạ tốc cho điều khiển; tốc độ/độ trễ công bố lên holding register 75..78
+  SensorPipeline_Init(&modbus_slave);
   HAL_ADCEx_Calibration_Start(&hadc1, ADC_SINGLE_ENDED);
-  HAL_ADC_Start_DMA(&hadc1, (uint32_t*)adc_buffer, 5);
-
-
-  Modbus_Init(&modbus_slave, &huart1, USART1_IRQn);
+  // Analog watchdog cắt relay/van ngay trong ngắt khi áp suất cao hoặc nhiệt độ đầu đẩy vượt giới hạn
+  ADC_Trip_Init(&hadc1);
+  // ADC quét theo TRGO của TIM7, DMA vòng ghi liên tục, không cần khởi động lại sau mỗi lượt
+  ADC_Ring_Start(&hadc1);
+
+
+  // Địa chỉ, baud, parity, stop bit và trễ phản hồi lưu trong EEPROM
+  CommSettings_Init(&hEEPROM_final, &modbus_slave);
+  // Môi chất lạnh lưu trong EEPROM, chọn lại được qua holding register 47
+  Refrigerant_Init(&hEEPROM_final, &modbus_slave);
+  // Hệ số PID lưu trong EEPROM, chỉnh và chuyển tay/tự động qua holding register 80..89
+  static PidCtrl* pids[EEV_AXIS_COUNT];
+  for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+	  pids[i] = &eev_axes[i].pid;
+  }
+  PidConfig_Init(&hEEPROM_final, &modbus_slave, pids, EEV_AXIS_COUNT);
+  // Trạng thái, hành trình và profile từng van ở holding register 100 + 10 * van
+  for(uint8_t i = 0; i < EEV_AXIS_COUNT; i++){
+	  publish_eev_axis_config(&eev_axes[i]);
+  }
   HAL_TIM_Base_Start_IT(&htim2);
 
   GetAndSendResetFlags();
+  Sched_Init(&scheduler, sched_tasks, TASK_COUNT);
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -614,29 +566,13 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-	  if(isADCFinish == 1){
-		isADCFinish = 0;
-		Calcular_Input(&hadc1);
-		HAL_ADC_Start_DMA(&hadc1,(uint32_t*)adc_buffer, 5);
-	  }
+	  Sched_Run(&scheduler);
 //	  Calcular_Input(&hadc1);
 //	  voltage_hoive = adc_temperature_sensors.ADC_hoi_ve*vref/4095.0f;
 //	  voltage_dauday = adc_temperature_sensors.ADC_dau_day*vref/4095.0f;
 //	  voltage_pl = adc_pressure_sensors.ADC_low_pressure*vref/4095.0f;
 //	  voltage_ph = adc_pressure_sensors.ADC_high_pressure*vref/4095.0f;
 
-	  superheat_value();
-	  lam_mat_dau_day();
-	  convert_setpoint();
-	  control_EEV();
-
-	  modbus_communication();
-	  Data_Write(&modbus_slave);
-
-	  reset_UART_DMA();
-	  Reset_ADC_DMA();
-	  HAL_IWDG_Refresh(&hiwdg);
-	  EWDG_Refresh();
   }
   /* USER CODE END 3 */
 }
@@ -1113,25 +1049,24 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
     	lastvalidIDTime = HAL_GetTick();
     	Modbus_UartTxCpltCallback(&modbus_slave);
     }
+    else if (huart == &huart3)
+    {
+    	Log_TxCpltCallback(huart);
+    }
 }
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
+	if (huart == &huart3)
+	{
+		Log_ErrorCallback(huart);
+		return;
+	}
 	Modbus_HAL_ErrorCallback(&modbus_slave, &huart1);
 }
 
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
     if (htim->Instance == TIM2) {
-    	count ++;
-    	if(count >= 3){
-            output_pid = PID_Calculate(&pid, delta_temperatute);
-            float step_val = output_pid * 5.0f;
-            stepp_count = (int16_t)step_val;
-            // Lưu giá trị vào mảng, chỉ mục quay vòng khi đạt BUFFER_SIZE
-            stepp_buffer[buffer_index] = stepp_count;
-            buffer_index = (buffer_index + 1) % BUFFER_SIZE;
-    	    count = 0;
-    	}
-        Stepper_Run(&motor);
+    	EEV_Control_TimerTick();
     }
 }
 
@@ -0,0 +1,62 @@
+/*
+ * ntc.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "ntc.h"
+#include "main.h"
+#include "log_level.h"
+#include "math.h"
+
+#define NTC_ADC_MAX   ((1U << NTC_ADC_BITS) - 1U)
+
+float NTC_Temperature(const NTC_Curve* curve, float adc)
+{
+    if (!(adc > 0.0f)) adc = 0.0f;
+    if (adc > (float)NTC_ADC_MAX) adc = (float)NTC_ADC_MAX;
+    // Vị trí trong bảng, giữ phần lẻ dưới 1 LSB của ADC đã lọc
+    float pos = adc * (1.0f / (1U << NTC_TABLE_SHIFT));
+    uint16_t i = (uint16_t)pos;
+    if (i >= NTC_TABLE_SIZE - 1) i = NTC_TABLE_SIZE - 2;
+    int16_t t0 = curve->table[i];
+    int16_t t1 = curve->table[i + 1];
+    // Phép float đơn chạy trên FPU, không gọi thư viện
+    return ((float)t0 + (float)(t1 - t0) * (pos - (float)i)) * 0.01f;
+}
+
+float NTC_TemperatureExact(const NTC_Curve* curve, uint16_t adc)
+{
+    // Cùng giới hạn bão hòa với bảng (tools/ntc_table_gen.py) để hở/chập cảm biến không chia cho 0
+    if (adc == 0) return -100.0f;
+    if (adc >= NTC_ADC_MAX) return 300.0f;
+    float resistance = (NTC_ADC_MAX * curve->series_resistor) / (float)adc - curve->series_resistor;
+    float steinhart = 1.0f/(curve->a + curve->b*log(resistance) + curve->c*pow(log(resistance),3)) - 273.15f;
+    if (steinhart < -100.0f) return -100.0f;
+    if (steinhart > 300.0f) return 300.0f;
+    return steinhart;
+}
+
+#if NTC_BENCHMARK
+void NTC_Benchmark(const NTC_Curve* curve)
+{
+    volatile float sink;
+    uint32_t exact_cycles = 0, table_cycles = 0, n = 0;
+
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    // ~600 mẫu trải đều dải ADC, tổng vài chục ms nên không chạm watchdog
+    for (uint16_t adc = 1; adc < NTC_ADC_MAX; adc += 7) {
+        uint32_t start = DWT->CYCCNT;
+        sink = NTC_TemperatureExact(curve, adc);
+        uint32_t mid = DWT->CYCCNT;
+        sink = NTC_Temperature(curve, adc);
+        uint32_t end = DWT->CYCCNT;
+        exact_cycles += mid - start;
+        table_cycles += end - mid;
+        n++;
+    }
+    (void)sink;
+    LOG_INFO(EVT_NTC_BENCHMARK, exact_cycles / n, table_cycles / n);
+}
+#endif
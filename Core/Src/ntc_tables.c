@@ -0,0 +1,72 @@
+/*
+ * ntc_tables.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  FILE SINH TỰ ĐỘNG bởi tools/ntc_table_gen.py - không sửa tay.
+ *  Thêm/sửa đường cong trong CURVES của script rồi chạy lại.
+ */
+#include "ntc.h"
+
+// NTC 10K, hệ số Steinhart-Hart hiện dùng cho hồi về và đầu đẩy
+static const int16_t ntc_table_10k_sh[NTC_TABLE_SIZE] = {
+    -10000,  -6757,  -5870,  -5320,  -4915,  -4591,  -4319,  -4085,  -3878,  -3692,  -3523,  -3367,
+     -3223,  -3089,  -2963,  -2845,  -2732,  -2626,  -2524,  -2427,  -2333,  -2244,  -2157,  -2074,
+     -1994,  -1916,  -1840,  -1766,  -1695,  -1625,  -1558,  -1492,  -1427,  -1364,  -1302,  -1241,
+     -1182,  -1124,  -1067,  -1011,   -956,   -901,   -848,   -796,   -744,   -693,   -643,   -593,
+      -545,   -496,   -449,   -402,   -355,   -309,   -264,   -219,   -174,   -130,    -86,    -43,
+         0,     42,     84,    126,    167,    208,    249,    290,    330,    370,    409,    449,
+       488,    527,    565,    604,    642,    680,    718,    756,    793,    831,    868,    905,
+       942,    978,   1015,   1051,   1088,   1124,   1160,   1196,   1232,   1268,   1304,   1339,
+      1375,   1410,   1446,   1481,   1516,   1552,   1587,   1622,   1657,   1692,   1727,   1762,
+      1797,   1833,   1868,   1903,   1938,   1973,   2008,   2043,   2078,   2113,   2148,   2183,
+      2218,   2253,   2289,   2324,   2359,   2395,   2430,   2466,   2501,   2537,   2573,   2608,
+      2644,   2680,   2716,   2753,   2789,   2825,   2862,   2899,   2935,   2972,   3009,   3047,
+      3084,   3122,   3159,   3197,   3235,   3273,   3312,   3350,   3389,   3428,   3467,   3507,
+      3546,   3586,   3626,   3667,   3707,   3748,   3789,   3831,   3873,   3915,   3957,   4000,
+      4043,   4086,   4130,   4174,   4218,   4263,   4308,   4354,   4400,   4446,   4493,   4541,
+      4589,   4637,   4686,   4735,   4785,   4836,   4887,   4938,   4991,   5044,   5097,   5152,
+      5207,   5263,   5319,   5377,   5435,   5494,   5554,   5615,   5677,   5740,   5804,   5869,
+      5935,   6003,   6071,   6141,   6213,   6286,   6360,   6436,   6513,   6593,   6674,   6757,
+      6842,   6929,   7019,   7111,   7206,   7303,   7403,   7506,   7613,   7723,   7837,   7954,
+      8077,   8204,   8336,   8473,   8617,   8767,   8925,   9090,   9264,   9449,   9644,   9851,
+     10073,  10311,  10567,  10845,  11148,  11482,  11852,  12268,  12740,  13288,  13935,  14725,
+     15730,  17095,  19173,  23262,  30000,
+};
+const NTC_Curve ntc_curve_10k_sh = {
+    .table = ntc_table_10k_sh,
+    .a = 1.129241000e-03f, .b = 2.341077000e-04f, .c = 8.775468000e-08f,
+    .series_resistor = 10000.0f,
+};
+
+// NTC 10K B25/85 = 3435 (cảm biến lạnh thông dụng)
+static const int16_t ntc_table_10k_b3435[NTC_TABLE_SIZE] = {
+    -10000,  -7183,  -6325,  -5786,  -5386,  -5063,  -4791,  -4555,  -4346,  -4157,  -3985,  -3826,
+     -3679,  -3542,  -3412,  -3290,  -3174,  -3063,  -2958,  -2857,  -2760,  -2666,  -2576,  -2489,
+     -2405,  -2323,  -2243,  -2166,  -2091,  -2018,  -1946,  -1876,  -1808,  -1741,  -1675,  -1611,
+     -1548,  -1486,  -1425,  -1365,  -1306,  -1248,  -1191,  -1135,  -1080,  -1025,   -971,   -918,
+      -866,   -814,   -762,   -712,   -662,   -612,   -563,   -514,   -466,   -418,   -371,   -324,
+      -277,   -231,   -185,   -140,    -95,    -50,     -6,     39,     82,    126,    169,    213,
+       255,    298,    341,    383,    425,    467,    508,    550,    591,    632,    673,    714,
+       755,    795,    836,    876,    916,    957,    997,   1037,   1076,   1116,   1156,   1196,
+      1235,   1275,   1314,   1354,   1393,   1432,   1472,   1511,   1550,   1590,   1629,   1668,
+      1707,   1747,   1786,   1825,   1865,   1904,   1943,   1983,   2022,   2062,   2101,   2141,
+      2181,   2221,   2260,   2300,   2340,   2380,   2421,   2461,   2501,   2542,   2582,   2623,
+      2664,   2705,   2746,   2787,   2829,   2870,   2912,   2954,   2996,   3038,   3081,   3124,
+      3166,   3209,   3253,   3296,   3340,   3384,   3428,   3472,   3517,   3562,   3607,   3653,
+      3699,   3745,   3791,   3838,   3885,   3933,   3980,   4028,   4077,   4126,   4175,   4225,
+      4275,   4326,   4377,   4428,   4480,   4532,   4585,   4639,   4693,   4747,   4802,   4858,
+      4914,   4971,   5029,   5087,   5146,   5206,   5266,   5327,   5389,   5452,   5516,   5580,
+      5646,   5712,   5780,   5848,   5918,   5988,   6060,   6133,   6207,   6283,   6359,   6438,
+      6517,   6599,   6682,   6766,   6853,   6941,   7031,   7123,   7217,   7314,   7413,   7514,
+      7618,   7725,   7835,   7948,   8064,   8184,   8307,   8435,   8566,   8703,   8844,   8991,
+      9144,   9302,   9468,   9640,   9821,  10011,  10210,  10420,  10642,  10877,  11126,  11393,
+     11679,  11987,  12320,  12682,  13080,  13520,  14011,  14565,  15202,  15944,  16832,  17927,
+     19342,  21303,  24377,  30000,  30000,
+};
+const NTC_Curve ntc_curve_10k_b3435 = {
+    .table = ntc_table_10k_b3435,
+    .a = 6.726946379e-04f, .b = 2.911208151e-04f, .c = 0.000000000e+00f,
+    .series_resistor = 10000.0f,
+};
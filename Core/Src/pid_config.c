@@ -0,0 +1,205 @@
+/*
+ * pid_config.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "pid_config.h"
+#include "modbus_crc.h"
+#include "log_level.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#define PID_RECORD_MAGIC    0x9D1CU
+
+// Bản ghi trong EEPROM, CRC Modbus tính trên mọi byte trước trường crc.
+typedef struct {
+    uint16_t      magic;
+    uint16_t      reserved;
+    PidCtrl_Gains gains;
+    uint16_t      crc;
+} Pid_Record;
+
+// Giữ đáp ứng của bộ PID cũ: nó ghi Ti = 20 s, Td = 4 s nhưng nhân/chia T thêm một lần,
+// hệ số thực chạy ngoài hiện trường là Ti = 20 / T = 166.7 s, Td = 4 / T = 33.3 s
+// (D cũ = Kp * 4 / T * de / T, dạng ISA = Kp * Td * de / T).
+static const PidCtrl_Gains pid_defaults = {
+    .kp = 0.03f, .ti = 166.7f, .td = 33.3f, .n = 10.0f, .b = 1.0f, .tt = 0.0f,
+};
+
+static PidCtrl* const* pid_ctrls;
+static uint8_t pid_count;
+static EEPROM_Handle_t* pid_eeprom;
+static ModbusHandle* pid_modbus;
+static uint16_t pid_status;
+static uint16_t pid_manual_reg;   // Giá trị thanh ghi ngõ ra tay đã công bố lần cuối
+
+static bool PidConfig_Valid(const PidCtrl_Gains* g) {
+    if (!(g->kp > 0.0f && g->kp <= 6.5535f)) return false;
+    if (!(g->ti >= 0.0f && g->ti <= 6553.5f)) return false;
+    if (!(g->td >= 0.0f && g->td <= 6553.5f)) return false;
+    if (!(g->n >= 1.0f && g->n <= 100.0f)) return false;
+    if (!(g->b >= 0.0f && g->b <= 1.0f)) return false;
+    return g->tt >= 0.0f && g->tt <= 6553.5f;
+}
+
+static EEPROM_Status_t PidConfig_Save(void) {
+    static Pid_Record rec, check;
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = PID_RECORD_MAGIC;
+    rec.gains = pid_ctrls[0]->gains;
+    rec.crc = Modbus_CRC16((const uint8_t*)&rec, offsetof(Pid_Record, crc));
+
+    EEPROM_Status_t status = EEPROM_WriteBuffer(pid_eeprom, PID_EEPROM_ADDR, (const uint8_t*)&rec, sizeof(rec));
+    if (status == EEPROM_OK) {
+        status = EEPROM_ReadBuffer(pid_eeprom, PID_EEPROM_ADDR, (uint8_t*)&check, sizeof(check));
+    }
+    if (status == EEPROM_OK && memcmp(&rec, &check, sizeof(rec)) != 0) {
+        status = EEPROM_ERROR_GENERAL;
+    }
+    return status;
+}
+
+static uint16_t PidConfig_ManualToReg(float value) {
+    return (uint16_t)(int16_t)lrintf(value * 100.0f);   // |ngõ ra| <= PID_OUTPUT_LIMIT nên không tràn
+}
+
+static void PidConfig_Publish(void) {
+    const PidCtrl_Gains* g = &pid_ctrls[0]->gains;
+    pid_manual_reg = PidConfig_ManualToReg(pid_ctrls[0]->manual_output);
+    uint16_t regs[PID_REG_COUNT] = {
+        [PID_REG_KP - PID_REG_KP]     = (uint16_t)lrintf(g->kp * 10000.0f),
+        [PID_REG_TI - PID_REG_KP]     = (uint16_t)lrintf(g->ti * 10.0f),
+        [PID_REG_TD - PID_REG_KP]     = (uint16_t)lrintf(g->td * 10.0f),
+        [PID_REG_N - PID_REG_KP]      = (uint16_t)lrintf(g->n),
+        [PID_REG_B - PID_REG_KP]      = (uint16_t)lrintf(g->b * 100.0f),
+        [PID_REG_TT - PID_REG_KP]     = (uint16_t)lrintf(g->tt * 10.0f),
+        [PID_REG_MODE - PID_REG_KP]   = (uint16_t)pid_ctrls[0]->mode,
+        [PID_REG_MANUAL - PID_REG_KP] = pid_manual_reg,
+        [PID_REG_CMD - PID_REG_KP]    = PID_CMD_NONE,
+        [PID_REG_STATUS - PID_REG_KP] = pid_status,
+    };
+    Modbus_PublishHoldingRegs(pid_modbus, PID_REG_KP, regs, PID_REG_COUNT);
+}
+
+static void PidConfig_SetStatus(uint16_t status) {
+    pid_status = status;
+    Modbus_PublishHoldingRegs(pid_modbus, PID_REG_STATUS, &pid_status, 1);
+}
+
+static void PidConfig_SetGains(const PidCtrl_Gains* g) {
+    for (uint8_t i = 0; i < pid_count; i++) PidCtrl_SetGains(pid_ctrls[i], g);
+}
+
+void PidConfig_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus, PidCtrl* const* pids, uint8_t count) {
+    static Pid_Record rec;
+    PidCtrl_Gains gains = pid_defaults;
+
+    pid_ctrls = pids;
+    pid_count = count;
+    pid_eeprom = eeprom;
+    pid_modbus = modbus;
+    if (EEPROM_ReadBuffer(eeprom, PID_EEPROM_ADDR, (uint8_t*)&rec, sizeof(rec)) == EEPROM_OK &&
+        rec.magic == PID_RECORD_MAGIC &&
+        rec.crc == Modbus_CRC16((const uint8_t*)&rec, offsetof(Pid_Record, crc)) &&
+        PidConfig_Valid(&rec.gains)) {
+        gains = rec.gains;
+        LOG_INFO(EVT_PID_LOADED);
+    } else {
+        LOG_WARN(EVT_PID_DEFAULTS);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        PidCtrl_Init(pids[i], &gains, PID_SAMPLE_TIME, PID_DEFAULT_SETPOINT, -PID_OUTPUT_LIMIT, PID_OUTPUT_LIMIT);
+    }
+    pid_status = PID_STATUS_IDLE;
+    PidConfig_Publish();
+}
+
+static void PidConfig_FromRegs(const uint16_t* regs, PidCtrl_Gains* g) {
+    g->kp = regs[PID_REG_KP - PID_REG_KP] / 10000.0f;
+    g->ti = regs[PID_REG_TI - PID_REG_KP] / 10.0f;
+    g->td = regs[PID_REG_TD - PID_REG_KP] / 10.0f;
+    g->n = (float)regs[PID_REG_N - PID_REG_KP];
+    g->b = regs[PID_REG_B - PID_REG_KP] / 100.0f;
+    g->tt = regs[PID_REG_TT - PID_REG_KP] / 10.0f;
+}
+
+/**
+ * @brief Chế độ và ngõ ra tay áp dụng ngay khi Master ghi. Khi chuyển sang tay mà không ghi kèm ngõ ra,
+ *        ngõ ra tay lấy ngõ ra hiện tại (không giật) và được công bố lại lên PID_REG_MANUAL.
+ */
+static void PidConfig_ProcessMode(const uint16_t* regs) {
+    uint16_t mode = regs[PID_REG_MODE - PID_REG_KP];
+    uint16_t manual = regs[PID_REG_MANUAL - PID_REG_KP];
+    bool changed = false;
+
+    if (mode != (uint16_t)pid_ctrls[0]->mode) {
+        if (mode == PID_MODE_AUTO || mode == PID_MODE_MANUAL) {
+            for (uint8_t i = 0; i < pid_count; i++) PidCtrl_SetMode(pid_ctrls[i], (PidCtrl_Mode)mode);
+            LOG_INFO(EVT_PID_MODE, mode);
+        }
+        changed = true;
+    }
+    if (manual != pid_manual_reg) {
+        for (uint8_t i = 0; i < pid_count; i++) PidCtrl_SetManualOutput(pid_ctrls[i], (int16_t)manual / 100.0f);
+        changed = true;
+    }
+    if (changed) {
+        uint16_t state[2] = { (uint16_t)pid_ctrls[0]->mode, PidConfig_ManualToReg(pid_ctrls[0]->manual_output) };
+        pid_manual_reg = state[1];
+        Modbus_PublishHoldingRegs(pid_modbus, PID_REG_MODE, state, 2);
+    }
+}
+
+void PidConfig_Process(void) {
+    ModbusHandle* modbus = pid_modbus;
+    if (modbus == NULL || pid_count == 0) return;
+
+    // Chụp và xóa lệnh trong một critical section (Master có thể ghi từ ngắt)
+    static const uint16_t cmd_none = PID_CMD_NONE;
+    uint16_t regs[PID_REG_COUNT];
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memcpy(regs, &modbus->holdingRegs[PID_REG_KP], sizeof(regs));
+    Modbus_PublishHoldingRegs(modbus, PID_REG_CMD, &cmd_none, 1);
+    __set_PRIMASK(primask);
+
+    PidConfig_ProcessMode(regs);
+
+    switch (regs[PID_REG_CMD - PID_REG_KP]) {
+    case PID_CMD_APPLY: {
+        PidCtrl_Gains g;
+        PidConfig_FromRegs(regs, &g);
+        if (!PidConfig_Valid(&g)) {
+            LOG_WARN(EVT_PID_REJECTED);
+            PidConfig_SetStatus(PID_STATUS_REJECTED);
+            PidConfig_Publish();
+            break;
+        }
+        PidConfig_SetGains(&g);
+        LOG_INFO(EVT_PID_APPLIED, regs[PID_REG_KP - PID_REG_KP], regs[PID_REG_TI - PID_REG_KP], regs[PID_REG_TD - PID_REG_KP]);
+        pid_status = PID_STATUS_APPLIED;
+        PidConfig_Publish();
+        break;
+    }
+    case PID_CMD_SAVE: {
+        EEPROM_Status_t status = PidConfig_Save();
+        if (status == EEPROM_OK) {
+            LOG_INFO(EVT_PID_SAVED);
+            PidConfig_SetStatus(PID_STATUS_SAVED);
+        } else {
+            LOG_ERROR(EVT_PID_SAVE_FAIL, status);
+            PidConfig_SetStatus(PID_STATUS_EEPROM_ERROR);
+        }
+        break;
+    }
+    case PID_CMD_DEFAULTS:
+        PidConfig_SetGains(&pid_defaults);
+        pid_status = PID_STATUS_APPLIED;
+        PidConfig_Publish();
+        break;
+    default:
+        break;
+    }
+}
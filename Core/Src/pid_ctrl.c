@@ -0,0 +1,114 @@
+/*
+ * pid_ctrl.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "pid_ctrl.h"
+#include <math.h>
+
+static float PidCtrl_Clamp(float x, float lo, float hi) {
+    return (x < lo) ? lo : ((x > hi) ? hi : x);
+}
+
+static float PidCtrl_Proportional(const PidCtrl* pid, float measurement) {
+    return pid->gains.kp * (pid->gains.b * pid->setpoint - measurement);
+}
+
+void PidCtrl_Init(PidCtrl* pid, const PidCtrl_Gains* gains, float T, float setpoint, float out_min, float out_max) {
+    pid->gains = *gains;
+    pid->setpoint = setpoint;
+    pid->T = T;
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+    pid->mode = PID_MODE_AUTO;
+    pid->manual_output = 0.0f;
+    pid->integral = 0.0f;
+    pid->derivative = 0.0f;
+    pid->prev_measurement = 0.0f;
+    pid->output = 0.0f;
+    pid->primed = 0;
+}
+
+void PidCtrl_SetGains(PidCtrl* pid, const PidCtrl_Gains* gains) {
+    if (pid->primed) {
+        // Giữ P + I không đổi tại giá trị đo gần nhất
+        float p_old = PidCtrl_Proportional(pid, pid->prev_measurement);
+        pid->gains = *gains;
+        pid->integral += p_old - PidCtrl_Proportional(pid, pid->prev_measurement);
+    } else {
+        pid->gains = *gains;
+    }
+    if (gains->td <= 0.0f) pid->derivative = 0.0f;
+}
+
+void PidCtrl_SetMode(PidCtrl* pid, PidCtrl_Mode mode) {
+    if (mode == pid->mode) return;
+    if (mode == PID_MODE_MANUAL) {
+        // Vào chế độ tay tại ngõ ra hiện tại; lần về tự động PidCtrl_Track đã giữ tích phân đúng
+        pid->manual_output = pid->output;
+    }
+    pid->mode = mode;
+}
+
+void PidCtrl_SetManualOutput(PidCtrl* pid, float output) {
+    pid->manual_output = PidCtrl_Clamp(output, pid->out_min, pid->out_max);
+}
+
+/**
+ * @brief Cập nhật bộ lọc D trên giá trị đo (Euler lùi):
+ *        D_k = Tf / (Tf + T) * D_k-1 - Kp * Td / (Tf + T) * (y_k - y_k-1)
+ */
+static void PidCtrl_UpdateDerivative(PidCtrl* pid, float measurement) {
+    const PidCtrl_Gains* g = &pid->gains;
+    if (g->td <= 0.0f || !pid->primed) {
+        pid->derivative = 0.0f;
+        return;
+    }
+    float tf = (g->n > 0.0f) ? g->td / g->n : 0.0f;
+    float denom = tf + pid->T;
+    pid->derivative = (tf / denom) * pid->derivative
+                    - (g->kp * g->td / denom) * (measurement - pid->prev_measurement);
+}
+
+float PidCtrl_Track(PidCtrl* pid, float measurement, float value) {
+    value = PidCtrl_Clamp(value, pid->out_min, pid->out_max);
+    // Tích phân lấy phần còn lại để P + I = value, D bắt đầu lại từ 0: nếu gộp D lúc chuyển
+    // vào tích phân thì sau đó D tắt dần còn tích phân giữ nguyên, ngõ ra trôi đúng bằng phần đó.
+    pid->derivative = 0.0f;
+    pid->integral = (pid->gains.ti > 0.0f) ? value - PidCtrl_Proportional(pid, measurement) : 0.0f;
+    pid->prev_measurement = measurement;
+    pid->primed = 1;
+    pid->output = value;
+    return value;
+}
+
+float PidCtrl_Update(PidCtrl* pid, float measurement, float lo, float hi) {
+    const PidCtrl_Gains* g = &pid->gains;
+
+    if (pid->mode == PID_MODE_MANUAL) {
+        return PidCtrl_Track(pid, measurement, pid->manual_output);
+    }
+    lo = fmaxf(lo, pid->out_min);
+    hi = fminf(hi, pid->out_max);
+    if (lo > hi) lo = hi;
+
+    PidCtrl_UpdateDerivative(pid, measurement);
+    float p = PidCtrl_Proportional(pid, measurement);
+    float u = p + pid->integral + pid->derivative;
+    float u_sat = PidCtrl_Clamp(u, lo, hi);
+
+    if (g->ti > 0.0f) {
+        float tt = g->tt;
+        if (tt <= 0.0f) tt = (g->td > 0.0f) ? sqrtf(g->ti * g->td) : g->ti;
+        float e = pid->setpoint - measurement;
+        pid->integral += g->kp * pid->T / g->ti * e + pid->T / tt * (u_sat - u);
+    } else {
+        pid->integral = 0.0f;
+    }
+
+    pid->prev_measurement = measurement;
+    pid->primed = 1;
+    pid->output = u_sat;
+    return u_sat;
+}
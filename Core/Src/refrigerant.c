@@ -0,0 +1,185 @@
+/*
+ * refrigerant.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "refrigerant.h"
+#include "R507_temp_pressure.h"
+#include "log_level.h"
+
+// Bảng R507A gốc (không phải dữ liệu gần đúng)
+static const Refrigerant_Info refrigerant_r507a = {
+    .name = "R507A",
+    .bubble = { &R507_TABLE[0].pressure, &R507_TABLE[0].temperature_R507,
+                sizeof(R507_Point) / sizeof(float), R507_TABLE_SIZE },
+    .dew    = { &R507_TABLE[0].pressure, &R507_TABLE[0].temperature_R507,
+                sizeof(R507_Point) / sizeof(float), R507_TABLE_SIZE },
+    .approximate = 0,
+};
+
+static const Refrigerant_Info* const refrigerants[REFRIGERANT_COUNT] = {
+    [REFRIGERANT_R507A] = &refrigerant_r507a,
+    [REFRIGERANT_R404A] = &refrigerant_r404a,
+    [REFRIGERANT_R134A] = &refrigerant_r134a,
+    [REFRIGERANT_R448A] = &refrigerant_r448a,
+    [REFRIGERANT_R449A] = &refrigerant_r449a,
+    [REFRIGERANT_R290]  = &refrigerant_r290,
+};
+
+// Lưới chỉ mục của một đường: ô k chứa điểm cuối cùng có giá trị <= giá trị đầu ô.
+// Chưa dựng (toàn 0) thì tra vẫn đúng, chỉ phải đi bộ từ đầu bảng.
+typedef struct {
+    const Refrigerant_Curve* curve;
+    uint8_t p_index[REFRIGERANT_P_INDEX_SIZE];
+    uint8_t t_index[REFRIGERANT_T_INDEX_SIZE];
+    float   p_inv_step;
+    float   t_inv_step;
+} Refrigerant_Lookup;
+
+static Refrigerant_Lookup lookup_bubble = { .curve = &refrigerant_r507a.bubble };
+static Refrigerant_Lookup lookup_dew    = { .curve = &refrigerant_r507a.dew };
+static Refrigerant_Id active = REFRIGERANT_DEFAULT;
+static EEPROM_Handle_t* refrigerant_eeprom;
+static ModbusHandle* refrigerant_modbus;
+
+static inline float Refrigerant_Key(const float* col, uint16_t stride, uint16_t i) {
+    return col[i * stride];
+}
+
+static void Refrigerant_BuildIndex(uint8_t* index, uint16_t size, float* inv_step,
+                                   const float* key, uint16_t stride, uint16_t count) {
+    float first = Refrigerant_Key(key, stride, 0);
+    float step = (Refrigerant_Key(key, stride, count - 1) - first) / (float)(size - 1);
+    uint16_t i = 0;
+    for (uint16_t k = 0; k < size; k++) {
+        float start = first + step * (float)k;
+        while (i + 2 < count && Refrigerant_Key(key, stride, i + 1) <= start) i++;
+        index[k] = (uint8_t)i;
+    }
+    *inv_step = 1.0f / step;
+}
+
+/**
+ * @brief Tra y theo x trên một đường (x, y là 2 cột của cùng bảng).
+ * @note  Ô lưới cho điểm xuất phát; 2 vòng while chỉ chỉnh 0-2 bước (kể cả khi làm tròn float
+ *        rơi sang ô bên cạnh), nên kết quả không phụ thuộc lưới và trùng với quét tuyến tính.
+ *        Ngoài bảng trả về điểm gần nhất, NaN trả về điểm cuối (như R507_GetTemperature cũ).
+ */
+static float Refrigerant_Lookup1(const uint8_t* index, uint16_t size, float inv_step,
+                                 const float* x_col, const float* y_col, uint16_t stride, uint16_t count, float x) {
+    float x_first = Refrigerant_Key(x_col, stride, 0);
+    if (!(x >= x_first)) {
+        return (x < x_first) ? Refrigerant_Key(y_col, stride, 0) : Refrigerant_Key(y_col, stride, count - 1);
+    }
+    if (x >= Refrigerant_Key(x_col, stride, count - 1)) {
+        return Refrigerant_Key(y_col, stride, count - 1);
+    }
+
+    uint32_t k = (uint32_t)((x - x_first) * inv_step);
+    if (k >= size) k = size - 1U;
+    uint16_t i = index[k];
+    while (x >= Refrigerant_Key(x_col, stride, i + 1)) i++;
+    while (i > 0 && x < Refrigerant_Key(x_col, stride, i)) i--;
+
+    // Trùng điểm bảng: trả về ngay
+    float x1 = Refrigerant_Key(x_col, stride, i);
+    if (x == x1) {
+        return Refrigerant_Key(y_col, stride, i);
+    }
+    // Nội suy tuyến tính
+    float x2 = Refrigerant_Key(x_col, stride, i + 1);
+    float y1 = Refrigerant_Key(y_col, stride, i);
+    float y2 = Refrigerant_Key(y_col, stride, i + 1);
+    return y1 + (x - x1) * (y2 - y1) / (x2 - x1);
+}
+
+static void Refrigerant_Build(Refrigerant_Lookup* l, const Refrigerant_Curve* c) {
+    l->curve = c;
+    Refrigerant_BuildIndex(l->p_index, REFRIGERANT_P_INDEX_SIZE, &l->p_inv_step, c->pressure, c->stride, c->count);
+    Refrigerant_BuildIndex(l->t_index, REFRIGERANT_T_INDEX_SIZE, &l->t_inv_step, c->temperature, c->stride, c->count);
+}
+
+static float Refrigerant_Temperature(const Refrigerant_Lookup* l, float pressure) {
+    const Refrigerant_Curve* c = l->curve;
+    return Refrigerant_Lookup1(l->p_index, REFRIGERANT_P_INDEX_SIZE, l->p_inv_step,
+                               c->pressure, c->temperature, c->stride, c->count, pressure);
+}
+
+static float Refrigerant_Pressure(const Refrigerant_Lookup* l, float temperature) {
+    const Refrigerant_Curve* c = l->curve;
+    return Refrigerant_Lookup1(l->t_index, REFRIGERANT_T_INDEX_SIZE, l->t_inv_step,
+                               c->temperature, c->pressure, c->stride, c->count, temperature);
+}
+
+float Refrigerant_DewTemperature(float pressure)     { return Refrigerant_Temperature(&lookup_dew, pressure); }
+float Refrigerant_BubbleTemperature(float pressure)  { return Refrigerant_Temperature(&lookup_bubble, pressure); }
+float Refrigerant_DewPressure(float temperature)     { return Refrigerant_Pressure(&lookup_dew, temperature); }
+float Refrigerant_BubblePressure(float temperature)  { return Refrigerant_Pressure(&lookup_bubble, temperature); }
+
+bool Refrigerant_Select(Refrigerant_Id id) {
+    if ((uint32_t)id >= REFRIGERANT_COUNT) return false;
+    const Refrigerant_Info* info = refrigerants[id];
+#if REFRIGERANT_ALLOW_APPROXIMATE == 0
+    // Bảng gần đúng lệch vài K so với dữ liệu chuẩn: quá nhiệt sai, van có thể cho lỏng về máy nén
+    if (info->approximate) {
+        LOG_WARN(EVT_REFRIGERANT_NOT_ALLOWED, id, active);
+        return false;
+    }
+#endif
+    Refrigerant_Build(&lookup_bubble, &info->bubble);
+    Refrigerant_Build(&lookup_dew, &info->dew);
+    active = id;
+    LOG_INFO(EVT_REFRIGERANT_SELECTED, id);
+    if (info->approximate) {
+        LOG_WARN(EVT_REFRIGERANT_APPROXIMATE, id);
+    }
+    return true;
+}
+
+Refrigerant_Id Refrigerant_Active(void) {
+    return active;
+}
+
+static void Refrigerant_Publish(void) {
+    uint16_t value = (uint16_t)active;
+    Modbus_PublishHoldingRegs(refrigerant_modbus, REFRIGERANT_REG, &value, 1);
+}
+
+void Refrigerant_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus) {
+    uint16_t stored[2];
+    Refrigerant_Id id = REFRIGERANT_DEFAULT;
+
+    refrigerant_eeprom = eeprom;
+    refrigerant_modbus = modbus;
+    // Ô nhớ mới (0xFF) hoặc hỏng không qua được kiểm tra bù 1
+    if (EEPROM_ReadBuffer(eeprom, REFRIGERANT_EEPROM_ADDR, (uint8_t*)stored, sizeof(stored)) == EEPROM_OK &&
+        (uint16_t)(stored[0] ^ stored[1]) == 0xFFFFU && stored[0] < REFRIGERANT_COUNT) {
+        id = (Refrigerant_Id)stored[0];
+    }
+    if (!Refrigerant_Select(id)) {
+        Refrigerant_Select(REFRIGERANT_DEFAULT);
+    }
+    Refrigerant_Publish();
+}
+
+void Refrigerant_Process(void) {
+    if (refrigerant_modbus == NULL) return;
+    uint16_t requested = refrigerant_modbus->holdingRegs[REFRIGERANT_REG];
+    if (requested == (uint16_t)active) return;
+
+    if (requested >= REFRIGERANT_COUNT) {
+        LOG_WARN(EVT_REFRIGERANT_INVALID, requested, active);
+        Refrigerant_Publish();
+        return;
+    }
+    if (!Refrigerant_Select((Refrigerant_Id)requested)) {
+        Refrigerant_Publish();
+        return;
+    }
+    uint16_t stored[2] = { requested, (uint16_t)~requested };
+    EEPROM_Status_t status = EEPROM_WriteBuffer(refrigerant_eeprom, REFRIGERANT_EEPROM_ADDR, (const uint8_t*)stored, sizeof(stored));
+    if (status != EEPROM_OK) {
+        LOG_ERROR(EVT_REFRIGERANT_SAVE_FAIL, requested, status);
+    }
+}
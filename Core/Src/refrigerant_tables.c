@@ -0,0 +1,179 @@
+/*
+ * refrigerant_tables.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  FILE SINH TỰ ĐỘNG bởi tools/refrigerant_table_gen.py - không sửa tay.
+ *  Mỗi điểm là {áp suất bar tương đối, nhiệt độ °C}, nhiệt độ cách đều 2 K.
+ *  Nguồn: CoolProp 8.0.0 (EOS tham chiếu như REFPROP), xem đầu script.
+ */
+#include "refrigerant.h"
+
+// R404A (R125/R143a/R134a 44/52/4, gần đẳng phí)
+static const float r404a_bubble[][2] = {
+    { -0.171f,  -50.0f}, { -0.084f,  -48.0f}, {  0.011f,  -46.0f}, {  0.113f,  -44.0f},
+    {  0.222f,  -42.0f}, {  0.340f,  -40.0f}, {  0.466f,  -38.0f}, {  0.601f,  -36.0f},
+    {  0.746f,  -34.0f}, {  0.900f,  -32.0f}, {  1.065f,  -30.0f}, {  1.240f,  -28.0f},
+    {  1.426f,  -26.0f}, {  1.625f,  -24.0f}, {  1.835f,  -22.0f}, {  2.058f,  -20.0f},
+    {  2.294f,  -18.0f}, {  2.543f,  -16.0f}, {  2.807f,  -14.0f}, {  3.085f,  -12.0f},
+    {  3.378f,  -10.0f}, {  3.687f,   -8.0f}, {  4.012f,   -6.0f}, {  4.353f,   -4.0f},
+    {  4.712f,   -2.0f}, {  5.089f,    0.0f}, {  5.484f,    2.0f}, {  5.897f,    4.0f},
+    {  6.331f,    6.0f}, {  6.784f,    8.0f}, {  7.258f,   10.0f}, {  7.753f,   12.0f},
+    {  8.270f,   14.0f}, {  8.809f,   16.0f}, {  9.372f,   18.0f}, {  9.958f,   20.0f},
+    { 10.569f,   22.0f}, { 11.205f,   24.0f}, { 11.867f,   26.0f}, { 12.555f,   28.0f},
+    { 13.270f,   30.0f}, { 14.013f,   32.0f}, { 14.785f,   34.0f}, { 15.587f,   36.0f},
+    { 16.418f,   38.0f}, { 17.281f,   40.0f}, { 18.176f,   42.0f}, { 19.103f,   44.0f},
+    { 20.065f,   46.0f}, { 21.061f,   48.0f}, { 22.093f,   50.0f}, { 23.162f,   52.0f},
+    { 24.270f,   54.0f}, { 25.417f,   56.0f}, { 26.605f,   58.0f}, { 27.835f,   60.0f},
+};
+static const float r404a_dew[][2] = {
+    { -0.203f,  -50.0f}, { -0.118f,  -48.0f}, { -0.026f,  -46.0f}, {  0.074f,  -44.0f},
+    {  0.181f,  -42.0f}, {  0.296f,  -40.0f}, {  0.420f,  -38.0f}, {  0.553f,  -36.0f},
+    {  0.695f,  -34.0f}, {  0.847f,  -32.0f}, {  1.009f,  -30.0f}, {  1.182f,  -28.0f},
+    {  1.366f,  -26.0f}, {  1.561f,  -24.0f}, {  1.769f,  -22.0f}, {  1.989f,  -20.0f},
+    {  2.222f,  -18.0f}, {  2.468f,  -16.0f}, {  2.729f,  -14.0f}, {  3.004f,  -12.0f},
+    {  3.294f,  -10.0f}, {  3.600f,   -8.0f}, {  3.922f,   -6.0f}, {  4.261f,   -4.0f},
+    {  4.617f,   -2.0f}, {  4.990f,    0.0f}, {  5.382f,    2.0f}, {  5.793f,    4.0f},
+    {  6.223f,    6.0f}, {  6.673f,    8.0f}, {  7.144f,   10.0f}, {  7.636f,   12.0f},
+    {  8.151f,   14.0f}, {  8.687f,   16.0f}, {  9.247f,   18.0f}, {  9.831f,   20.0f},
+    { 10.439f,   22.0f}, { 11.072f,   24.0f}, { 11.732f,   26.0f}, { 12.417f,   28.0f},
+    { 13.131f,   30.0f}, { 13.872f,   32.0f}, { 14.642f,   34.0f}, { 15.442f,   36.0f},
+    { 16.272f,   38.0f}, { 17.133f,   40.0f}, { 18.027f,   42.0f}, { 18.954f,   44.0f},
+    { 19.915f,   46.0f}, { 20.911f,   48.0f}, { 21.944f,   50.0f}, { 23.014f,   52.0f},
+    { 24.123f,   54.0f}, { 25.272f,   56.0f}, { 26.463f,   58.0f}, { 27.697f,   60.0f},
+};
+const Refrigerant_Info refrigerant_r404a = {
+    .name = "R404A",
+    .bubble = REFRIGERANT_CURVE(r404a_bubble),
+    .dew    = REFRIGERANT_CURVE(r404a_dew),
+    .approximate = 0,
+};
+
+// R134a (đơn chất)
+static const float r134a_bubble[][2] = {
+    { -0.719f,  -50.0f}, { -0.683f,  -48.0f}, { -0.643f,  -46.0f}, { -0.600f,  -44.0f},
+    { -0.553f,  -42.0f}, { -0.501f,  -40.0f}, { -0.445f,  -38.0f}, { -0.384f,  -36.0f},
+    { -0.318f,  -34.0f}, { -0.247f,  -32.0f}, { -0.169f,  -30.0f}, { -0.086f,  -28.0f},
+    {  0.003f,  -26.0f}, {  0.100f,  -24.0f}, {  0.203f,  -22.0f}, {  0.314f,  -20.0f},
+    {  0.433f,  -18.0f}, {  0.560f,  -16.0f}, {  0.695f,  -14.0f}, {  0.839f,  -12.0f},
+    {  0.993f,  -10.0f}, {  1.156f,   -8.0f}, {  1.330f,   -6.0f}, {  1.514f,   -4.0f},
+    {  1.708f,   -2.0f}, {  1.915f,    0.0f}, {  2.133f,    2.0f}, {  2.363f,    4.0f},
+    {  2.607f,    6.0f}, {  2.863f,    8.0f}, {  3.133f,   10.0f}, {  3.417f,   12.0f},
+    {  3.716f,   14.0f}, {  4.029f,   16.0f}, {  4.359f,   18.0f}, {  4.704f,   20.0f},
+    {  5.066f,   22.0f}, {  5.445f,   24.0f}, {  5.841f,   26.0f}, {  6.256f,   28.0f},
+    {  6.689f,   30.0f}, {  7.141f,   32.0f}, {  7.613f,   34.0f}, {  8.105f,   36.0f},
+    {  8.618f,   38.0f}, {  9.153f,   40.0f}, {  9.709f,   42.0f}, { 10.288f,   44.0f},
+    { 10.890f,   46.0f}, { 11.516f,   48.0f}, { 12.166f,   50.0f}, { 12.841f,   52.0f},
+    { 13.542f,   54.0f}, { 14.269f,   56.0f}, { 15.023f,   58.0f}, { 15.805f,   60.0f},
+};
+const Refrigerant_Info refrigerant_r134a = {
+    .name = "R134A",
+    .bubble = REFRIGERANT_CURVE(r134a_bubble),
+    .dew    = REFRIGERANT_CURVE(r134a_bubble),
+    .approximate = 0,
+};
+
+// R448A (R32/R125/R1234yf/R134a/R1234ze(E) 26/26/20/21/7, zeotropic)
+static const float r448a_bubble[][2] = {
+    { -0.174f,  -50.0f}, { -0.086f,  -48.0f}, {  0.009f,  -46.0f}, {  0.112f,  -44.0f},
+    {  0.223f,  -42.0f}, {  0.342f,  -40.0f}, {  0.470f,  -38.0f}, {  0.608f,  -36.0f},
+    {  0.755f,  -34.0f}, {  0.912f,  -32.0f}, {  1.080f,  -30.0f}, {  1.259f,  -28.0f},
+    {  1.450f,  -26.0f}, {  1.653f,  -24.0f}, {  1.868f,  -22.0f}, {  2.097f,  -20.0f},
+    {  2.339f,  -18.0f}, {  2.595f,  -16.0f}, {  2.866f,  -14.0f}, {  3.153f,  -12.0f},
+    {  3.455f,  -10.0f}, {  3.773f,   -8.0f}, {  4.108f,   -6.0f}, {  4.461f,   -4.0f},
+    {  4.831f,   -2.0f}, {  5.220f,    0.0f}, {  5.628f,    2.0f}, {  6.056f,    4.0f},
+    {  6.504f,    6.0f}, {  6.973f,    8.0f}, {  7.464f,   10.0f}, {  7.976f,   12.0f},
+    {  8.511f,   14.0f}, {  9.070f,   16.0f}, {  9.652f,   18.0f}, { 10.259f,   20.0f},
+    { 10.891f,   22.0f}, { 11.549f,   24.0f}, { 12.233f,   26.0f}, { 12.945f,   28.0f},
+    { 13.684f,   30.0f}, { 14.451f,   32.0f}, { 15.247f,   34.0f}, { 16.073f,   36.0f},
+    { 16.930f,   38.0f}, { 17.817f,   40.0f}, { 18.737f,   42.0f}, { 19.689f,   44.0f},
+    { 20.674f,   46.0f}, { 21.692f,   48.0f}, { 22.746f,   50.0f}, { 23.835f,   52.0f},
+    { 24.960f,   54.0f}, { 26.122f,   56.0f}, { 27.321f,   58.0f}, { 28.559f,   60.0f},
+};
+static const float r448a_dew[][2] = {
+    { -0.419f,  -50.0f}, { -0.351f,  -48.0f}, { -0.278f,  -46.0f}, { -0.198f,  -44.0f},
+    { -0.111f,  -42.0f}, { -0.016f,  -40.0f}, {  0.085f,  -38.0f}, {  0.195f,  -36.0f},
+    {  0.313f,  -34.0f}, {  0.441f,  -32.0f}, {  0.577f,  -30.0f}, {  0.724f,  -28.0f},
+    {  0.880f,  -26.0f}, {  1.048f,  -24.0f}, {  1.227f,  -22.0f}, {  1.417f,  -20.0f},
+    {  1.620f,  -18.0f}, {  1.836f,  -16.0f}, {  2.066f,  -14.0f}, {  2.309f,  -12.0f},
+    {  2.567f,  -10.0f}, {  2.839f,   -8.0f}, {  3.128f,   -6.0f}, {  3.432f,   -4.0f},
+    {  3.754f,   -2.0f}, {  4.093f,    0.0f}, {  4.450f,    2.0f}, {  4.826f,    4.0f},
+    {  5.221f,    6.0f}, {  5.636f,    8.0f}, {  6.072f,   10.0f}, {  6.529f,   12.0f},
+    {  7.008f,   14.0f}, {  7.510f,   16.0f}, {  8.035f,   18.0f}, {  8.585f,   20.0f},
+    {  9.160f,   22.0f}, {  9.760f,   24.0f}, { 10.386f,   26.0f}, { 11.040f,   28.0f},
+    { 11.723f,   30.0f}, { 12.434f,   32.0f}, { 13.175f,   34.0f}, { 13.946f,   36.0f},
+    { 14.750f,   38.0f}, { 15.586f,   40.0f}, { 16.456f,   42.0f}, { 17.360f,   44.0f},
+    { 18.300f,   46.0f}, { 19.278f,   48.0f}, { 20.293f,   50.0f}, { 21.348f,   52.0f},
+    { 22.444f,   54.0f}, { 23.582f,   56.0f}, { 24.764f,   58.0f}, { 25.993f,   60.0f},
+};
+const Refrigerant_Info refrigerant_r448a = {
+    .name = "R448A",
+    .bubble = REFRIGERANT_CURVE(r448a_bubble),
+    .dew    = REFRIGERANT_CURVE(r448a_dew),
+    .approximate = 0,
+};
+
+// R449A (R32/R125/R1234yf/R134a 24.3/24.7/25.3/25.7, zeotropic)
+static const float r449a_bubble[][2] = {
+    { -0.187f,  -50.0f}, { -0.100f,  -48.0f}, { -0.006f,  -46.0f}, {  0.095f,  -44.0f},
+    {  0.205f,  -42.0f}, {  0.322f,  -40.0f}, {  0.449f,  -38.0f}, {  0.584f,  -36.0f},
+    {  0.729f,  -34.0f}, {  0.885f,  -32.0f}, {  1.050f,  -30.0f}, {  1.227f,  -28.0f},
+    {  1.415f,  -26.0f}, {  1.615f,  -24.0f}, {  1.828f,  -22.0f}, {  2.053f,  -20.0f},
+    {  2.292f,  -18.0f}, {  2.545f,  -16.0f}, {  2.813f,  -14.0f}, {  3.095f,  -12.0f},
+    {  3.393f,  -10.0f}, {  3.707f,   -8.0f}, {  4.038f,   -6.0f}, {  4.386f,   -4.0f},
+    {  4.752f,   -2.0f}, {  5.136f,    0.0f}, {  5.538f,    2.0f}, {  5.961f,    4.0f},
+    {  6.403f,    6.0f}, {  6.866f,    8.0f}, {  7.350f,   10.0f}, {  7.856f,   12.0f},
+    {  8.384f,   14.0f}, {  8.935f,   16.0f}, {  9.510f,   18.0f}, { 10.109f,   20.0f},
+    { 10.733f,   22.0f}, { 11.382f,   24.0f}, { 12.058f,   26.0f}, { 12.760f,   28.0f},
+    { 13.489f,   30.0f}, { 14.247f,   32.0f}, { 15.033f,   34.0f}, { 15.848f,   36.0f},
+    { 16.694f,   38.0f}, { 17.570f,   40.0f}, { 18.478f,   42.0f}, { 19.417f,   44.0f},
+    { 20.390f,   46.0f}, { 21.396f,   48.0f}, { 22.436f,   50.0f}, { 23.511f,   52.0f},
+    { 24.622f,   54.0f}, { 25.769f,   56.0f}, { 26.953f,   58.0f}, { 28.176f,   60.0f},
+};
+static const float r449a_dew[][2] = {
+    { -0.413f,  -50.0f}, { -0.345f,  -48.0f}, { -0.271f,  -46.0f}, { -0.190f,  -44.0f},
+    { -0.103f,  -42.0f}, { -0.009f,  -40.0f}, {  0.094f,  -38.0f}, {  0.204f,  -36.0f},
+    {  0.322f,  -34.0f}, {  0.450f,  -32.0f}, {  0.586f,  -30.0f}, {  0.733f,  -28.0f},
+    {  0.890f,  -26.0f}, {  1.057f,  -24.0f}, {  1.236f,  -22.0f}, {  1.427f,  -20.0f},
+    {  1.630f,  -18.0f}, {  1.845f,  -16.0f}, {  2.074f,  -14.0f}, {  2.317f,  -12.0f},
+    {  2.574f,  -10.0f}, {  2.846f,   -8.0f}, {  3.134f,   -6.0f}, {  3.438f,   -4.0f},
+    {  3.758f,   -2.0f}, {  4.096f,    0.0f}, {  4.452f,    2.0f}, {  4.826f,    4.0f},
+    {  5.219f,    6.0f}, {  5.632f,    8.0f}, {  6.066f,   10.0f}, {  6.520f,   12.0f},
+    {  6.997f,   14.0f}, {  7.496f,   16.0f}, {  8.018f,   18.0f}, {  8.564f,   20.0f},
+    {  9.134f,   22.0f}, {  9.730f,   24.0f}, { 10.352f,   26.0f}, { 11.001f,   28.0f},
+    { 11.678f,   30.0f}, { 12.384f,   32.0f}, { 13.119f,   34.0f}, { 13.884f,   36.0f},
+    { 14.680f,   38.0f}, { 15.508f,   40.0f}, { 16.370f,   42.0f}, { 17.266f,   44.0f},
+    { 18.197f,   46.0f}, { 19.164f,   48.0f}, { 20.169f,   50.0f}, { 21.213f,   52.0f},
+    { 22.297f,   54.0f}, { 23.423f,   56.0f}, { 24.591f,   58.0f}, { 25.805f,   60.0f},
+};
+const Refrigerant_Info refrigerant_r449a = {
+    .name = "R449A",
+    .bubble = REFRIGERANT_CURVE(r449a_bubble),
+    .dew    = REFRIGERANT_CURVE(r449a_dew),
+    .approximate = 0,
+};
+
+// R290 - propan (đơn chất)
+static const float r290_bubble[][2] = {
+    { -0.308f,  -50.0f}, { -0.238f,  -48.0f}, { -0.162f,  -46.0f}, { -0.082f,  -44.0f},
+    {  0.005f,  -42.0f}, {  0.098f,  -40.0f}, {  0.197f,  -38.0f}, {  0.303f,  -36.0f},
+    {  0.416f,  -34.0f}, {  0.537f,  -32.0f}, {  0.665f,  -30.0f}, {  0.801f,  -28.0f},
+    {  0.946f,  -26.0f}, {  1.099f,  -24.0f}, {  1.261f,  -22.0f}, {  1.432f,  -20.0f},
+    {  1.613f,  -18.0f}, {  1.804f,  -16.0f}, {  2.005f,  -14.0f}, {  2.217f,  -12.0f},
+    {  2.440f,  -10.0f}, {  2.674f,   -8.0f}, {  2.920f,   -6.0f}, {  3.178f,   -4.0f},
+    {  3.448f,   -2.0f}, {  3.731f,    0.0f}, {  4.028f,    2.0f}, {  4.338f,    4.0f},
+    {  4.662f,    6.0f}, {  5.000f,    8.0f}, {  5.353f,   10.0f}, {  5.721f,   12.0f},
+    {  6.104f,   14.0f}, {  6.504f,   16.0f}, {  6.919f,   18.0f}, {  7.351f,   20.0f},
+    {  7.801f,   22.0f}, {  8.267f,   24.0f}, {  8.752f,   26.0f}, {  9.255f,   28.0f},
+    {  9.777f,   30.0f}, { 10.318f,   32.0f}, { 10.878f,   34.0f}, { 11.458f,   36.0f},
+    { 12.059f,   38.0f}, { 12.681f,   40.0f}, { 13.324f,   42.0f}, { 13.989f,   44.0f},
+    { 14.676f,   46.0f}, { 15.386f,   48.0f}, { 16.120f,   50.0f}, { 16.877f,   52.0f},
+    { 17.658f,   54.0f}, { 18.465f,   56.0f}, { 19.297f,   58.0f}, { 20.154f,   60.0f},
+};
+const Refrigerant_Info refrigerant_r290 = {
+    .name = "R290",
+    .bubble = REFRIGERANT_CURVE(r290_bubble),
+    .dew    = REFRIGERANT_CURVE(r290_bubble),
+    .approximate = 0,
+};
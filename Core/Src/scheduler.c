@@ -0,0 +1,126 @@
+/*
+ * scheduler.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "scheduler.h"
+#include "log_level.h"
+
+// Bật bộ đếm chu kỳ DWT->CYCCNT để đo thời gian thực thi tác vụ.
+static void _Sched_CycleCounterInit(void) {
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline bool _Sched_IsDue(const Sched_Task *t, uint32_t now) {
+    if (t->pending) return true;
+    if (t->period_ms == 0) return false;
+    return (int32_t)(now - t->next_run) >= 0;
+}
+
+/**
+ * @brief Khởi tạo bộ lập lịch với bảng tác vụ do người dùng cấp.
+ * @note  Tác vụ có chu kỳ chạy lần đầu ngay ở lần Sched_Run đầu tiên.
+ */
+void Sched_Init(Sched_HandleTypeDef *sched, Sched_Task *tasks, uint8_t count) {
+    if (sched == NULL || tasks == NULL) return;
+    if (count > SCHED_MAX_TASKS) count = SCHED_MAX_TASKS;
+
+    sched->tasks = tasks;
+    sched->count = count;
+    sched->cycles_per_us = SystemCoreClock / 1000000U;
+    if (sched->cycles_per_us == 0) sched->cycles_per_us = 1;
+    sched->sleep_count = 0;
+
+    uint32_t now = HAL_GetTick();
+    for (uint8_t i = 0; i < count; i++) {
+        Sched_Task *t = &tasks[i];
+        t->next_run = now;
+        t->pending = 0;
+        t->runs = 0;
+        t->last_cycles = 0;
+        t->wcet_cycles = 0;
+        t->overruns = 0;
+        t->late_count = 0;
+        t->max_late_ms = 0;
+    }
+    _Sched_CycleCounterInit();
+}
+
+/**
+ * @brief Kích hoạt một tác vụ chạy ở lần Sched_Run kế tiếp. Gọi được từ ngắt.
+ */
+void Sched_Trigger(Sched_HandleTypeDef *sched, uint8_t task_id) {
+    if (task_id < sched->count) {
+        sched->tasks[task_id].pending = 1;
+    }
+}
+
+/**
+ * @brief Chạy một lượt: thực thi mọi tác vụ đến hạn theo thứ tự trong bảng
+ *        (thứ tự = độ ưu tiên), sau đó ngủ WFI nếu không còn việc.
+ * @note  Gọi liên tục trong while(1) của main.
+ */
+void Sched_Run(Sched_HandleTypeDef *sched) {
+    for (uint8_t i = 0; i < sched->count; i++) {
+        Sched_Task *t = &sched->tasks[i];
+        uint32_t now = HAL_GetTick();
+        if (!_Sched_IsDue(t, now)) continue;
+
+        t->pending = 0;
+        if (t->period_ms != 0 && (int32_t)(now - t->next_run) >= 0) {
+            uint32_t late = now - t->next_run;
+            if (late > t->max_late_ms) t->max_late_ms = late;
+            if (late >= t->period_ms) {
+                // Trễ hơn một chu kỳ: bỏ các lần đã lỡ, đồng bộ lại theo thời điểm hiện tại.
+                t->late_count++;
+                t->next_run = now + t->period_ms;
+            } else {
+                t->next_run += t->period_ms;  // Giữ nhịp cố định, không tích lũy sai số
+            }
+        }
+
+        uint32_t start = DWT->CYCCNT;
+        t->func();
+        uint32_t cycles = DWT->CYCCNT - start;
+
+        t->runs++;
+        t->last_cycles = cycles;
+        if (cycles > t->wcet_cycles) {
+            t->wcet_cycles = cycles;
+            if (t->deadline_us != 0 && cycles > t->deadline_us * sched->cycles_per_us) {
+                // Chỉ log khi lập kỷ lục mới để không làm ngập log.
+                LOG_WARN(EVT_SCHED_OVERRUN, i, Sched_CyclesToUs(sched, cycles), t->deadline_us);
+            }
+        }
+        if (t->deadline_us != 0 && cycles > t->deadline_us * sched->cycles_per_us) {
+            t->overruns++;
+        }
+    }
+
+#if SCHED_USE_WFI == 1
+    // Kiểm tra lại trong vùng cấm ngắt: nếu ngắt đến giữa lúc kiểm tra và WFI,
+    // ngắt vẫn ở trạng thái pending nên WFI thoát ngay, không bị mất sự kiện.
+    __disable_irq();
+    uint32_t now = HAL_GetTick();
+    bool any_due = false;
+    for (uint8_t i = 0; i < sched->count; i++) {
+        if (_Sched_IsDue(&sched->tasks[i], now)) {
+            any_due = true;
+            break;
+        }
+    }
+    if (!any_due) {
+        sched->sleep_count++;
+        __DSB();
+        __WFI();
+    }
+    __enable_irq();
+#endif
+}
+
+uint32_t Sched_CyclesToUs(const Sched_HandleTypeDef *sched, uint32_t cycles) {
+    return cycles / sched->cycles_per_us;
+}
@@ -0,0 +1,387 @@
+/*
+ * sensor_config.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "sensor_config.h"
+#include "sensor_pipeline.h"
+#include "ntc.h"
+#include "modbus_crc.h"
+#include "log_level.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#define SENSOR_RECORD_MAGIC     0x5E4CU
+#define SENSOR_ADC_FULL_SCALE   4095.0f
+#define SENSOR_VREFINT_CAL      (*((const uint16_t*)0x08FFF810))   // VREFINT đo ở 3.3 V lúc xuất xưởng
+// Kalman: chỉ sai số đo chỉnh được, 2 thông số còn lại giữ như SimpleKalmanFilter cũ
+#define SENSOR_KALMAN_EST_E     2.0f
+#define SENSOR_KALMAN_Q         0.001f
+// Bộ lọc theo mô tả chạy trên đường điều khiển, sau bộ hạ tốc CIC
+#define SENSOR_FILTER_FS        SENSOR_PIPELINE_CONTROL_HZ
+
+// Bản ghi trong EEPROM, CRC Modbus tính trên mọi byte trước trường crc.
+typedef struct {
+    uint16_t          magic;
+    uint16_t          count;    // SENSOR_CH_COUNT lúc lưu
+    Sensor_Descriptor ch[SENSOR_CH_COUNT];
+    uint16_t          crc;
+} Sensor_Record;
+
+// Bảng mặc định = cấu hình phần cứng gốc
+static const Sensor_Descriptor sensor_defaults[SENSOR_CH_COUNT] = {
+    [SENSOR_CH_VREF] = {
+        .type = SENSOR_TYPE_VREFINT, .filter = FILTER_KALMAN,
+        .cal_gain = 1.0f, .filter_param = 2.0f,
+    },
+    [SENSOR_CH_HOI_VE] = {
+        .type = SENSOR_TYPE_NTC, .filter = FILTER_KALMAN, .ntc_curve = SENSOR_NTC_10K_SH,
+        .cal_gain = 1.0f, .filter_param = 2.0f,
+    },
+    [SENSOR_CH_DAU_DAY] = {
+        .type = SENSOR_TYPE_NTC, .filter = FILTER_KALMAN, .ntc_curve = SENSOR_NTC_10K_SH,
+        .cal_gain = 1.0f, .filter_param = 2.0f,
+    },
+    [SENSOR_CH_LOW_PRESSURE] = {
+        .type = SENSOR_TYPE_CURRENT, .filter = FILTER_KALMAN,
+        .signal_lo = 4.0f, .signal_hi = 20.0f, .range_lo = -1.0f, .range_hi = 12.0f, .front_end = 100.0f,
+        .cal_gain = 1.0f, .clamp_min = 0.0f, .filter_param = 2.0f,
+    },
+    [SENSOR_CH_HIGH_PRESSURE] = {
+        .type = SENSOR_TYPE_CURRENT, .filter = FILTER_KALMAN,
+        .signal_lo = 4.0f, .signal_hi = 20.0f, .range_lo = 0.0f, .range_hi = 30.0f, .front_end = 100.0f,
+        .cal_gain = 1.0f, .clamp_min = 0.0f, .filter_param = 2.0f,
+    },
+};
+
+static const NTC_Curve* const sensor_ntc_curves[SENSOR_NTC_COUNT] = {
+    [SENSOR_NTC_10K_SH]    = &ntc_curve_10k_sh,
+    [SENSOR_NTC_10K_B3435] = &ntc_curve_10k_b3435,
+};
+
+static Sensor_Descriptor sensors[SENSOR_CH_COUNT];
+static EEPROM_Handle_t* sensor_eeprom;
+static ModbusHandle* sensor_modbus;
+static uint16_t sensor_status;
+
+// Biến đổi gộp: value = adc * (gain * vref) + offset
+static float fused_gain[SENSOR_CH_COUNT];    // Chưa nhân vref
+static float fused_k[SENSOR_CH_COUNT];       // Đã nhân vref
+static float fused_offset[SENSOR_CH_COUNT];
+static float fused_vref = SENSOR_VREF_NOMINAL;
+
+static bool SensorConfig_Valid(uint8_t ch, const Sensor_Descriptor* d) {
+    if (d->type >= SENSOR_TYPE_COUNT || d->filter > FILTER_BIQUAD || d->median > 1) return false;
+    // Kênh VREFINT cố định trong phần cứng
+    if ((ch == SENSOR_CH_VREF) != (d->type == SENSOR_TYPE_VREFINT)) return false;
+    if (!isfinite(d->cal_gain) || d->cal_gain == 0.0f || !isfinite(d->cal_offset)) return false;
+
+    switch (d->type) {
+    case SENSOR_TYPE_NTC:
+        if (d->ntc_curve >= SENSOR_NTC_COUNT) return false;
+        break;
+    case SENSOR_TYPE_CURRENT:
+    case SENSOR_TYPE_VOLTAGE:
+        if (!isfinite(d->signal_lo) || !isfinite(d->signal_hi) || d->signal_hi == d->signal_lo) return false;
+        if (!isfinite(d->range_lo) || !isfinite(d->range_hi) || d->range_hi == d->range_lo) return false;
+        if (!isfinite(d->front_end) || d->front_end <= 0.0f || !isfinite(d->clamp_min)) return false;
+        break;
+    default:
+        break;
+    }
+
+    switch (d->filter) {
+    case FILTER_KALMAN:
+        return d->filter_param > 0.0f && isfinite(d->filter_param);
+    case FILTER_EMA:
+        return d->filter_param > 0.0f && d->filter_param <= 1.0f;
+    case FILTER_BIQUAD:
+        return d->filter_param > 0.0f && d->filter_param < SENSOR_FILTER_FS * 0.5f;
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief Gộp chuyển đổi ADC -> tín hiệu -> đơn vị kỹ thuật -> hiệu chuẩn thành adc * k + c.
+ *        CURRENT: I(mA) = adc * vref / 4095 / shunt * 1000
+ *        VOLTAGE: V     = adc * vref / 4095 * phân áp
+ */
+static void SensorConfig_Fuse(uint8_t ch) {
+    const Sensor_Descriptor* d = &sensors[ch];
+    float per_volt;
+
+    switch (d->type) {
+    case SENSOR_TYPE_CURRENT:
+        per_volt = 1000.0f / (SENSOR_ADC_FULL_SCALE * d->front_end);
+        break;
+    case SENSOR_TYPE_VOLTAGE:
+        per_volt = d->front_end / SENSOR_ADC_FULL_SCALE;
+        break;
+    case SENSOR_TYPE_VREFINT:
+        // vref = 3.3 * VREFINT_CAL / adc: lưu tử số, SensorConfig_Convert chia
+        fused_gain[ch] = 3.3f * (float)SENSOR_VREFINT_CAL;
+        fused_k[ch] = fused_gain[ch];
+        fused_offset[ch] = 0.0f;
+        return;
+    default:
+        fused_gain[ch] = fused_k[ch] = d->cal_gain;
+        fused_offset[ch] = d->cal_offset;
+        return;
+    }
+    float span = (d->range_hi - d->range_lo) / (d->signal_hi - d->signal_lo);
+    fused_gain[ch] = per_volt * span * d->cal_gain;
+    fused_offset[ch] = (d->range_lo - d->signal_lo * span) * d->cal_gain + d->cal_offset;
+    fused_k[ch] = fused_gain[ch] * fused_vref;
+}
+
+void SensorConfig_SetVref(float vref) {
+    fused_vref = (vref > 0.0f && isfinite(vref)) ? vref : SENSOR_VREF_NOMINAL;
+    for (uint8_t ch = 0; ch < SENSOR_CH_COUNT; ch++) {
+        uint8_t type = sensors[ch].type;
+        if (type == SENSOR_TYPE_CURRENT || type == SENSOR_TYPE_VOLTAGE) {
+            fused_k[ch] = fused_gain[ch] * fused_vref;
+        }
+    }
+}
+
+float SensorConfig_Convert(uint8_t ch, float adc) {
+    const Sensor_Descriptor* d = &sensors[ch];
+    float value;
+
+    switch (d->type) {
+    case SENSOR_TYPE_CURRENT:
+    case SENSOR_TYPE_VOLTAGE:
+        value = adc * fused_k[ch] + fused_offset[ch];
+        return (value < d->clamp_min) ? d->clamp_min : value;
+    case SENSOR_TYPE_NTC:
+        return NTC_Temperature(sensor_ntc_curves[d->ntc_curve], adc) * fused_k[ch] + fused_offset[ch];
+    case SENSOR_TYPE_VREFINT:
+        return (adc > 0.0f) ? fused_k[ch] / adc : SENSOR_VREF_NOMINAL;
+    default:
+        return adc * fused_k[ch] + fused_offset[ch];
+    }
+}
+
+static uint16_t SensorConfig_ClampAdc(float adc) {
+    if (!(adc > 0.0f)) return 0;
+    if (adc >= SENSOR_ADC_FULL_SCALE) return 4095;
+    return (uint16_t)(adc + 0.5f);
+}
+
+uint16_t SensorConfig_ToAdc(uint8_t ch, float value) {
+    const Sensor_Descriptor* d = &sensors[ch];
+
+    if (d->type == SENSOR_TYPE_NTC) {
+        // Mã ADC đầu tiên mà từ đó nhiệt độ >= value, chiều của đường cong xác định từ bảng
+        const NTC_Curve* curve = sensor_ntc_curves[d->ntc_curve];
+        float temp = (value - fused_offset[ch]) / fused_k[ch];
+        bool rising = NTC_Temperature(curve, 3072.0f) > NTC_Temperature(curve, 1024.0f);
+        uint16_t lo = 0, hi = 4095;
+        while (lo < hi) {
+            uint16_t mid = (uint16_t)((lo + hi) / 2U);
+            bool hot = NTC_Temperature(curve, (float)mid) >= temp;
+            if (hot == rising) hi = mid;
+            else lo = (uint16_t)(mid + 1U);
+        }
+        return lo;
+    }
+    if (d->type == SENSOR_TYPE_VREFINT) {
+        return SensorConfig_ClampAdc((value > 0.0f) ? fused_k[ch] / value : 0.0f);
+    }
+    if (fused_k[ch] == 0.0f) return 0;
+    return SensorConfig_ClampAdc((value - fused_offset[ch]) / fused_k[ch]);
+}
+
+const Sensor_Descriptor* SensorConfig_Get(uint8_t ch) {
+    return &sensors[ch];
+}
+
+void SensorConfig_ApplyFilter(FilterBank* bank, uint8_t ch) {
+    const Sensor_Descriptor* d = &sensors[ch];
+    switch (d->filter) {
+    case FILTER_KALMAN:
+        FilterBank_SetKalman(bank, ch, d->filter_param, SENSOR_KALMAN_EST_E, SENSOR_KALMAN_Q);
+        break;
+    case FILTER_EMA:
+        FilterBank_SetEMA(bank, ch, d->filter_param);
+        break;
+    case FILTER_BIQUAD:
+        FilterBank_SetBiquadLowpass(bank, ch, d->filter_param, SENSOR_FILTER_FS, 0.7071f);
+        break;
+    default:
+        FilterBank_SetNone(bank, ch);
+        break;
+    }
+    FilterBank_SetMedian(bank, ch, d->median != 0);
+}
+
+static void SensorConfig_FuseAll(void) {
+    for (uint8_t ch = 0; ch < SENSOR_CH_COUNT; ch++) {
+        SensorConfig_Fuse(ch);
+    }
+}
+
+static EEPROM_Status_t SensorConfig_Save(void) {
+    static Sensor_Record rec, check;
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = SENSOR_RECORD_MAGIC;
+    rec.count = SENSOR_CH_COUNT;
+    memcpy(rec.ch, sensors, sizeof(rec.ch));
+    rec.crc = Modbus_CRC16((const uint8_t*)&rec, offsetof(Sensor_Record, crc));
+
+    EEPROM_Status_t status = EEPROM_WriteBuffer(sensor_eeprom, SENSOR_EEPROM_ADDR, (const uint8_t*)&rec, sizeof(rec));
+    if (status == EEPROM_OK) {
+        status = EEPROM_ReadBuffer(sensor_eeprom, SENSOR_EEPROM_ADDR, (uint8_t*)&check, sizeof(check));
+    }
+    if (status == EEPROM_OK && memcmp(&rec, &check, sizeof(rec)) != 0) {
+        status = EEPROM_ERROR_GENERAL;
+    }
+    return status;
+}
+
+static int16_t SensorConfig_ToReg(float value, float scale) {
+    float v = value * scale;
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lrintf(v);
+}
+
+static void SensorConfig_Publish(uint8_t ch) {
+    const Sensor_Descriptor* d = &sensors[ch];
+    uint16_t regs[SENSOR_REG_COUNT] = {
+        [SENSOR_REG_CHANNEL - SENSOR_REG_CHANNEL]      = ch,
+        [SENSOR_REG_TYPE - SENSOR_REG_CHANNEL]         = d->type,
+        [SENSOR_REG_FILTER - SENSOR_REG_CHANNEL]       = (uint16_t)(d->filter | (d->median << 8)),
+        [SENSOR_REG_NTC_CURVE - SENSOR_REG_CHANNEL]    = d->ntc_curve,
+        [SENSOR_REG_SIGNAL_LO - SENSOR_REG_CHANNEL]    = (uint16_t)SensorConfig_ToReg(d->signal_lo, 100.0f),
+        [SENSOR_REG_SIGNAL_HI - SENSOR_REG_CHANNEL]    = (uint16_t)SensorConfig_ToReg(d->signal_hi, 100.0f),
+        [SENSOR_REG_RANGE_LO - SENSOR_REG_CHANNEL]     = (uint16_t)SensorConfig_ToReg(d->range_lo, 100.0f),
+        [SENSOR_REG_RANGE_HI - SENSOR_REG_CHANNEL]     = (uint16_t)SensorConfig_ToReg(d->range_hi, 100.0f),
+        [SENSOR_REG_FRONT_END - SENSOR_REG_CHANNEL]    = (uint16_t)lrintf(d->front_end * 100.0f),
+        [SENSOR_REG_CAL_GAIN - SENSOR_REG_CHANNEL]     = (uint16_t)lrintf(d->cal_gain * 10000.0f),
+        [SENSOR_REG_CAL_OFFSET - SENSOR_REG_CHANNEL]   = (uint16_t)SensorConfig_ToReg(d->cal_offset, 100.0f),
+        [SENSOR_REG_CLAMP_MIN - SENSOR_REG_CHANNEL]    = (uint16_t)SensorConfig_ToReg(d->clamp_min, 100.0f),
+        [SENSOR_REG_FILTER_PARAM - SENSOR_REG_CHANNEL] = (uint16_t)lrintf(d->filter_param * 1000.0f),
+        [SENSOR_REG_CMD - SENSOR_REG_CHANNEL]          = SENSOR_CMD_NONE,
+        [SENSOR_REG_STATUS - SENSOR_REG_CHANNEL]       = sensor_status,
+    };
+    Modbus_PublishHoldingRegs(sensor_modbus, SENSOR_REG_CHANNEL, regs, SENSOR_REG_COUNT);
+}
+
+static void SensorConfig_SetStatus(uint16_t status) {
+    sensor_status = status;
+    Modbus_PublishHoldingRegs(sensor_modbus, SENSOR_REG_STATUS, &sensor_status, 1);
+}
+
+void SensorConfig_Init(EEPROM_Handle_t* eeprom, ModbusHandle* modbus) {
+    static Sensor_Record rec;
+    bool valid;
+
+    sensor_eeprom = eeprom;
+    sensor_modbus = modbus;
+    valid = EEPROM_ReadBuffer(eeprom, SENSOR_EEPROM_ADDR, (uint8_t*)&rec, sizeof(rec)) == EEPROM_OK &&
+            rec.magic == SENSOR_RECORD_MAGIC && rec.count == SENSOR_CH_COUNT &&
+            rec.crc == Modbus_CRC16((const uint8_t*)&rec, offsetof(Sensor_Record, crc));
+    for (uint8_t ch = 0; valid && ch < SENSOR_CH_COUNT; ch++) {
+        valid = SensorConfig_Valid(ch, &rec.ch[ch]);
+    }
+
+    if (valid) {
+        memcpy(sensors, rec.ch, sizeof(sensors));
+        LOG_INFO(EVT_SENSOR_LOADED);
+    } else {
+        memcpy(sensors, sensor_defaults, sizeof(sensors));
+        LOG_WARN(EVT_SENSOR_DEFAULTS);
+    }
+    SensorConfig_FuseAll();
+    sensor_status = SENSOR_STATUS_IDLE;
+    SensorConfig_Publish(SENSOR_CH_VREF);
+}
+
+static bool SensorConfig_FromRegs(const uint16_t* regs, Sensor_Descriptor* d) {
+    uint16_t filter = regs[SENSOR_REG_FILTER - SENSOR_REG_CHANNEL];
+    uint16_t type = regs[SENSOR_REG_TYPE - SENSOR_REG_CHANNEL];
+    uint16_t curve = regs[SENSOR_REG_NTC_CURVE - SENSOR_REG_CHANNEL];
+    // Giá trị quá 8 bit bị đổi thành 0xFF để SensorConfig_Valid loại bỏ
+    memset(d, 0, sizeof(*d));
+    d->type = (type <= 0xFF) ? (uint8_t)type : 0xFF;
+    d->filter = (uint8_t)(filter & 0xFFU);
+    d->median = (uint8_t)(filter >> 8);
+    d->ntc_curve = (curve <= 0xFF) ? (uint8_t)curve : 0xFF;
+    d->signal_lo = (int16_t)regs[SENSOR_REG_SIGNAL_LO - SENSOR_REG_CHANNEL] / 100.0f;
+    d->signal_hi = (int16_t)regs[SENSOR_REG_SIGNAL_HI - SENSOR_REG_CHANNEL] / 100.0f;
+    d->range_lo = (int16_t)regs[SENSOR_REG_RANGE_LO - SENSOR_REG_CHANNEL] / 100.0f;
+    d->range_hi = (int16_t)regs[SENSOR_REG_RANGE_HI - SENSOR_REG_CHANNEL] / 100.0f;
+    d->front_end = regs[SENSOR_REG_FRONT_END - SENSOR_REG_CHANNEL] / 100.0f;
+    d->cal_gain = regs[SENSOR_REG_CAL_GAIN - SENSOR_REG_CHANNEL] / 10000.0f;
+    d->cal_offset = (int16_t)regs[SENSOR_REG_CAL_OFFSET - SENSOR_REG_CHANNEL] / 100.0f;
+    d->clamp_min = (int16_t)regs[SENSOR_REG_CLAMP_MIN - SENSOR_REG_CHANNEL] / 100.0f;
+    d->filter_param = regs[SENSOR_REG_FILTER_PARAM - SENSOR_REG_CHANNEL] / 1000.0f;
+    return d->median <= 1;
+}
+
+void SensorConfig_Process(void) {
+    ModbusHandle* modbus = sensor_modbus;
+    if (modbus == NULL) return;
+
+    // Chụp và xóa lệnh trong một critical section (Master có thể ghi từ ngắt)
+    static const uint16_t cmd_none = SENSOR_CMD_NONE;
+    uint16_t regs[SENSOR_REG_COUNT];
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memcpy(regs, &modbus->holdingRegs[SENSOR_REG_CHANNEL], sizeof(regs));
+    Modbus_PublishHoldingRegs(modbus, SENSOR_REG_CMD, &cmd_none, 1);
+    __set_PRIMASK(primask);
+
+    uint16_t ch = regs[SENSOR_REG_CHANNEL - SENSOR_REG_CHANNEL];
+    switch (regs[SENSOR_REG_CMD - SENSOR_REG_CHANNEL]) {
+    case SENSOR_CMD_LOAD:
+        if (ch >= SENSOR_CH_COUNT) {
+            SensorConfig_SetStatus(SENSOR_STATUS_REJECTED);
+            break;
+        }
+        sensor_status = SENSOR_STATUS_IDLE;
+        SensorConfig_Publish((uint8_t)ch);
+        break;
+    case SENSOR_CMD_APPLY: {
+        Sensor_Descriptor d;
+        if (ch >= SENSOR_CH_COUNT || !SensorConfig_FromRegs(regs, &d) || !SensorConfig_Valid((uint8_t)ch, &d)) {
+            LOG_WARN(EVT_SENSOR_REJECTED, ch);
+            SensorConfig_SetStatus(SENSOR_STATUS_REJECTED);
+            break;
+        }
+        sensors[ch] = d;
+        SensorConfig_Fuse((uint8_t)ch);
+        SensorConfig_ApplyFilter(&sensor_filters, (uint8_t)ch);
+        LOG_INFO(EVT_SENSOR_APPLIED, ch, d.type);
+        sensor_status = SENSOR_STATUS_APPLIED;
+        SensorConfig_Publish((uint8_t)ch);
+        break;
+    }
+    case SENSOR_CMD_SAVE: {
+        EEPROM_Status_t status = SensorConfig_Save();
+        if (status == EEPROM_OK) {
+            LOG_INFO(EVT_SENSOR_SAVED);
+            SensorConfig_SetStatus(SENSOR_STATUS_SAVED);
+        } else {
+            LOG_ERROR(EVT_SENSOR_SAVE_FAIL, status);
+            SensorConfig_SetStatus(SENSOR_STATUS_EEPROM_ERROR);
+        }
+        break;
+    }
+    case SENSOR_CMD_DEFAULTS:
+        memcpy(sensors, sensor_defaults, sizeof(sensors));
+        SensorConfig_FuseAll();
+        for (uint8_t i = 0; i < SENSOR_CH_COUNT; i++) {
+            SensorConfig_ApplyFilter(&sensor_filters, i);
+        }
+        sensor_status = SENSOR_STATUS_APPLIED;
+        SensorConfig_Publish((ch < SENSOR_CH_COUNT) ? (uint8_t)ch : SENSOR_CH_VREF);
+        break;
+    default:
+        break;
+    }
+}
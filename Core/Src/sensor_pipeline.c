@@ -0,0 +1,115 @@
+/*
+ * sensor_pipeline.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "sensor_pipeline.h"
+#include "filter_bank.h"
+#include "log_level.h"
+#include <string.h>
+
+static FilterBank fast_filters;
+
+// CIC: tràn số nguyên không dấu là hợp lệ, tầng comb khử lại đúng khi kết quả < 2^32
+static uint32_t cic_integrator[SENSOR_PIPELINE_CIC_ORDER][ADC_RING_CHANNELS];
+static uint32_t cic_comb_delay[SENSOR_PIPELINE_CIC_ORDER][ADC_RING_CHANNELS];
+static uint32_t cic_phase;
+static uint8_t cic_warmup;   // Số mẫu ra còn phải bỏ trước khi trạng thái comb ổn định
+static float cic_inv_gain;   // 1 / R^N
+
+static Sensor_Stage stages[SENSOR_STAGE_COUNT];
+
+static void SensorPipeline_Publish(ModbusHandle* modbus) {
+    uint16_t regs[SENSOR_PIPELINE_REG_COUNT] = {
+        (uint16_t)(stages[SENSOR_STAGE_FAST].rate_hz * 10.0f + 0.5f),
+        (uint16_t)(stages[SENSOR_STAGE_FAST].latency_ms * 10.0f + 0.5f),
+        (uint16_t)(stages[SENSOR_STAGE_CONTROL].rate_hz * 10.0f + 0.5f),
+        (uint16_t)(stages[SENSOR_STAGE_CONTROL].latency_ms * 10.0f + 0.5f),
+    };
+    Modbus_PublishHoldingRegs(modbus, SENSOR_PIPELINE_REG, regs, SENSOR_PIPELINE_REG_COUNT);
+}
+
+void SensorPipeline_Init(ModbusHandle* modbus) {
+    const float scan_ms = 1000.0f / ADC_RING_SCAN_HZ;
+
+    FilterBank_Init(&fast_filters, ADC_RING_CHANNELS);
+    for (uint8_t ch = 0; ch < ADC_RING_CHANNELS; ch++) {
+        FilterBank_SetEMA(&fast_filters, ch, SENSOR_PIPELINE_FAST_ALPHA);
+    }
+    memset(cic_integrator, 0, sizeof(cic_integrator));
+    memset(cic_comb_delay, 0, sizeof(cic_comb_delay));
+    cic_phase = 0;
+    cic_warmup = SENSOR_PIPELINE_CIC_ORDER;
+    cic_inv_gain = 1.0f;
+    for (uint8_t n = 0; n < SENSOR_PIPELINE_CIC_ORDER; n++) {
+        cic_inv_gain /= (float)SENSOR_PIPELINE_CIC_DECIMATION;
+    }
+
+    stages[SENSOR_STAGE_RAW].rate_hz = (float)ADC_RING_SCAN_HZ;
+    stages[SENSOR_STAGE_RAW].latency_ms = ADC_RING_SCANS_PER_HALF * scan_ms;
+    stages[SENSOR_STAGE_FAST].rate_hz = (float)ADC_RING_SCAN_HZ;
+    stages[SENSOR_STAGE_FAST].latency_ms = stages[SENSOR_STAGE_RAW].latency_ms
+        + (1.0f - SENSOR_PIPELINE_FAST_ALPHA) / SENSOR_PIPELINE_FAST_ALPHA * scan_ms;
+    stages[SENSOR_STAGE_CONTROL].rate_hz = SENSOR_PIPELINE_CONTROL_HZ;
+    stages[SENSOR_STAGE_CONTROL].latency_ms = stages[SENSOR_STAGE_RAW].latency_ms
+        + SENSOR_PIPELINE_CIC_ORDER * (SENSOR_PIPELINE_CIC_DECIMATION - 1U) * 0.5f * scan_ms;
+
+    for (uint8_t id = 0; id < SENSOR_STAGE_COUNT; id++) {
+        LOG_INFO(EVT_PIPELINE_STAGE, id, (unsigned long)(stages[id].rate_hz * 100.0f),
+                 (unsigned long)(stages[id].latency_ms * 10.0f));
+    }
+    SensorPipeline_Publish(modbus);
+}
+
+/**
+ * @brief Một lượt quét qua CIC. Tầng tích phân chạy mỗi mẫu, tầng comb chỉ chạy ở mẫu ra.
+ */
+static bool SensorPipeline_Cic(const uint16_t* scan, float control[ADC_RING_CHANNELS]) {
+    for (uint8_t ch = 0; ch < ADC_RING_CHANNELS; ch++) {
+        uint32_t x = scan[ch];
+        for (uint8_t n = 0; n < SENSOR_PIPELINE_CIC_ORDER; n++) {
+            cic_integrator[n][ch] += x;
+            x = cic_integrator[n][ch];
+        }
+    }
+    if (++cic_phase < SENSOR_PIPELINE_CIC_DECIMATION) return false;
+    cic_phase = 0;
+
+    for (uint8_t ch = 0; ch < ADC_RING_CHANNELS; ch++) {
+        uint32_t x = cic_integrator[SENSOR_PIPELINE_CIC_ORDER - 1][ch];
+        for (uint8_t n = 0; n < SENSOR_PIPELINE_CIC_ORDER; n++) {
+            uint32_t y = x - cic_comb_delay[n][ch];
+            cic_comb_delay[n][ch] = x;
+            x = y;
+        }
+        control[ch] = (float)x * cic_inv_gain;
+    }
+    if (cic_warmup > 0) {
+        cic_warmup--;
+        return false;
+    }
+    return true;
+}
+
+bool SensorPipeline_Process(const uint16_t (*scans)[ADC_RING_CHANNELS], uint8_t count, float control[ADC_RING_CHANNELS]) {
+    float fast_in[ADC_RING_CHANNELS];
+    bool ready = false;
+
+    for (uint8_t s = 0; s < count; s++) {
+        for (uint8_t ch = 0; ch < ADC_RING_CHANNELS; ch++) {
+            fast_in[ch] = (float)scans[s][ch];
+        }
+        FilterBank_Update(&fast_filters, fast_in);
+        if (SensorPipeline_Cic(scans[s], control)) ready = true;
+    }
+    return ready;
+}
+
+float SensorPipeline_Fast(uint8_t ch) {
+    return FilterBank_Output(&fast_filters, ch);
+}
+
+const Sensor_Stage* SensorPipeline_GetStage(Sensor_StageId id) {
+    return &stages[id];
+}
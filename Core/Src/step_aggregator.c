@@ -0,0 +1,89 @@
+/*
+ * step_aggregator.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "step_aggregator.h"
+
+#define STEP_AGG_MASK   (STEP_AGG_WINDOW - 1U)
+
+// Hạng để so sánh MAX_ABS: |x| lớn hơn thắng, bằng nhau thì số dương thắng
+static int32_t StepAgg_Rank(int16_t x) {
+    int32_t a = (x < 0) ? -(int32_t)x : (int32_t)x;
+    return 2 * a + (x > 0 ? 1 : 0);
+}
+
+static uint32_t StepAgg_DequeAt(const StepAgg* agg, uint8_t i) {
+    return agg->deque[(agg->dq_head + i) & STEP_AGG_MASK];
+}
+
+void StepAgg_Init(StepAgg* agg, StepAgg_Policy policy) {
+    agg->policy = (policy < STEP_AGG_POLICY_COUNT) ? (uint8_t)policy : STEP_AGG_MAX_ABS;
+    StepAgg_Reset(agg);
+}
+
+void StepAgg_SetPolicy(StepAgg* agg, StepAgg_Policy policy) {
+    if (policy < STEP_AGG_POLICY_COUNT) agg->policy = (uint8_t)policy;
+}
+
+void StepAgg_Reset(StepAgg* agg) {
+    // Không cần xóa value/deque: chỉ phần [first, seq) và dq_count phần tử được đọc
+    agg->first = agg->seq;
+    agg->dq_head = 0;
+    agg->dq_count = 0;
+    agg->sum = 0;
+    agg->last = 0;
+}
+
+void StepAgg_Push(StepAgg* agg, int16_t steps) {
+    // Cửa sổ đầy: lệnh cũ nhất rơi ra khỏi tổng và khỏi đầu deque (nếu nó đang là ứng viên)
+    if (agg->seq - agg->first == STEP_AGG_WINDOW) {
+        agg->sum -= agg->value[agg->first & STEP_AGG_MASK];
+        if (agg->dq_count > 0 && StepAgg_DequeAt(agg, 0) == agg->first) {
+            agg->dq_head = (uint8_t)((agg->dq_head + 1U) & STEP_AGG_MASK);
+            agg->dq_count--;
+        }
+        agg->first++;
+    }
+
+    // Ứng viên cũ không hơn lệnh mới sẽ không bao giờ là lớn nhất nữa
+    int32_t rank = StepAgg_Rank(steps);
+    while (agg->dq_count > 0 &&
+           StepAgg_Rank(agg->value[StepAgg_DequeAt(agg, (uint8_t)(agg->dq_count - 1U)) & STEP_AGG_MASK]) <= rank) {
+        agg->dq_count--;
+    }
+    agg->deque[(agg->dq_head + agg->dq_count) & STEP_AGG_MASK] = agg->seq;
+    agg->dq_count++;
+
+    agg->value[agg->seq & STEP_AGG_MASK] = steps;
+    agg->seq++;
+    agg->sum += steps;
+    agg->last = steps;
+}
+
+int16_t StepAgg_Peek(const StepAgg* agg) {
+    uint32_t n = agg->seq - agg->first;
+    if (n == 0) return 0;
+
+    switch (agg->policy) {
+    case STEP_AGG_MEAN: {
+        int32_t half = (int32_t)(n / 2U);
+        int32_t s = agg->sum;
+        return (int16_t)((s >= 0) ? (s + half) / (int32_t)n : (s - half) / (int32_t)n);
+    }
+    case STEP_AGG_SUM:
+        return (agg->sum > INT16_MAX) ? INT16_MAX : ((agg->sum < INT16_MIN) ? INT16_MIN : (int16_t)agg->sum);
+    case STEP_AGG_LAST:
+        return agg->last;
+    case STEP_AGG_MAX_ABS:
+    default:
+        return agg->value[StepAgg_DequeAt(agg, 0) & STEP_AGG_MASK];
+    }
+}
+
+int16_t StepAgg_Take(StepAgg* agg) {
+    int16_t out = StepAgg_Peek(agg);
+    StepAgg_Reset(agg);
+    return out;
+}
@@ -5,6 +5,7 @@
  *      Author: PC
  */
 #include "stepper_v2.h"
+#include <math.h>
 //// Mảng các bước cho chế độ full step
 /*const uint8_t STEP_SEQUENCE[8][4] = {
     {1, 0, 0, 0},
@@ -27,74 +28,472 @@ const uint8_t STEP_SEQUENCE[8][4] = {
     {0, 1, 1, 0}
 };
 
+// Chế độ DMA: bảng BSRR của cả hành trình và bảng ARR (khoảng cách từng bước), dựng lúc bắt đầu
+static DMA_HandleTypeDef stepper_dma_phase;   // TIM_UP  -> GPIOx->BSRR
+static DMA_HandleTypeDef stepper_dma_rate;    // TIM_CH1 -> STEPPER_TIM->ARR
+static Stepper* stepper_dma_owner;
+static uint32_t stepper_dma_bsrr[STEPPER_DMA_MAX_STEPS];
+static uint16_t stepper_dma_arr[STEPPER_DMA_MAX_STEPS];
+
+// Mọi động cơ dùng chung STEPPER_TIM: động cơ thứ i (stepper->axis) dùng kênh so sánh CC(i+1)
+static Stepper* stepper_axes[STEPPER_MAX_AXES];
+static uint8_t stepper_axis_count;
+#define STEPPER_CCR(s)      ((&STEPPER_TIM->CCR1)[(s)->axis])
+#define STEPPER_CCIE(s)     ((uint32_t)TIM_DIER_CC1IE << (s)->axis)
+#define STEPPER_CCIF(s)     ((uint32_t)TIM_SR_CC1IF << (s)->axis)
+
+// Các bước ra trong cùng một ngắt timer được gộp: mỗi port một lần ghi BSRR
+typedef struct {
+    GPIO_TypeDef* port[STEPPER_MAX_AXES];
+    uint32_t bsrr[STEPPER_MAX_AXES];
+    uint8_t count;
+} Stepper_Batch;
+
 // Hàm nội bộ để điều khiển các chân
 static void Stepper_SetPhase(Stepper* stepper, uint8_t phase) {
+    if (stepper->port != NULL) {
+        // 4 chân cùng port: một lần ghi BSRR, các cuộn dây đổi cùng lúc
+        stepper->port->BSRR = stepper->phase_bsrr[phase];
+        return;
+    }
     HAL_GPIO_WritePin(stepper->pins.PORT_IN1, stepper->pins.PIN_IN1, STEP_SEQUENCE[phase][0]);
     HAL_GPIO_WritePin(stepper->pins.PORT_IN2, stepper->pins.PIN_IN2, STEP_SEQUENCE[phase][1]);
     HAL_GPIO_WritePin(stepper->pins.PORT_IN3, stepper->pins.PIN_IN3, STEP_SEQUENCE[phase][2]);
     HAL_GPIO_WritePin(stepper->pins.PORT_IN4, stepper->pins.PIN_IN4, STEP_SEQUENCE[phase][3]);
 }
 
+static void Stepper_Release(Stepper* stepper) {
+    if (stepper->port != NULL) {
+        stepper->port->BSRR = stepper->off_bsrr;
+        return;
+    }
+    HAL_GPIO_WritePin(stepper->pins.PORT_IN1, stepper->pins.PIN_IN1, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(stepper->pins.PORT_IN2, stepper->pins.PIN_IN2, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(stepper->pins.PORT_IN3, stepper->pins.PIN_IN3, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(stepper->pins.PORT_IN4, stepper->pins.PIN_IN4, GPIO_PIN_SET);
+}
+
+/**
+ * @brief Dựng sẵn từ BSRR cho 8 pha và cho trạng thái nhả cuộn dây nếu 4 chân cùng một port.
+ */
+static void Stepper_BuildBsrr(Stepper* stepper) {
+    const StepperPins* p = &stepper->pins;
+    const uint16_t pin[4] = { p->PIN_IN1, p->PIN_IN2, p->PIN_IN3, p->PIN_IN4 };
+
+    stepper->port = NULL;
+    if (p->PORT_IN2 != p->PORT_IN1 || p->PORT_IN3 != p->PORT_IN1 || p->PORT_IN4 != p->PORT_IN1) return;
+    for (uint8_t phase = 0; phase < 8; phase++) {
+        uint32_t word = 0;
+        for (uint8_t i = 0; i < 4; i++) {
+            word |= STEP_SEQUENCE[phase][i] ? (uint32_t)pin[i] : ((uint32_t)pin[i] << 16);
+        }
+        stepper->phase_bsrr[phase] = word;
+    }
+    stepper->off_bsrr = (uint32_t)pin[0] | pin[1] | pin[2] | pin[3];
+    stepper->port = p->PORT_IN1;
+}
+
+static uint32_t Stepper_TimerClock(void) {
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR2 & RCC_CFGR2_PPRE1_2) != 0U) pclk *= 2U;
+    return pclk;
+}
+
+static uint16_t Stepper_ClampRate(uint32_t rate) {
+    if (rate < STEPPER_RATE_MIN) return STEPPER_RATE_MIN;
+    if (rate > STEPPER_RATE_MAX) return STEPPER_RATE_MAX;
+    return (uint16_t)rate;
+}
+
+/**
+ * @brief Tốc độ cho phép khi cách đầu (hoặc cuối) hành trình d bước, xuất phát từ v0.
+ */
+static float Stepper_RampRate(const Stepper_Profile* p, float v0, float vmax, uint32_t d) {
+    if (v0 >= vmax) return vmax;
+    float accel = (float)p->accel;
+    if (p->type == STEPPER_PROFILE_SCURVE) {
+        float span = 1.5f * (vmax * vmax - v0 * v0) / (2.0f * accel);
+        float x = (float)d / span;
+        if (x >= 1.0f) return vmax;
+        return v0 + (vmax - v0) * x * x * (3.0f - 2.0f * x);
+    }
+    float v = sqrtf(v0 * v0 + 2.0f * accel * (float)d);
+    return (v < vmax) ? v : vmax;
+}
+
+/**
+ * @brief Khoảng cách (us) tới bước kế tiếp: nhỏ nhất giữa đường tăng tốc từ đầu và đường giảm tốc
+ *        về cuối hành trình, nên hành trình ngắn tự thành tam giác.
+ */
+static uint16_t Stepper_NextInterval(const Stepper* stepper) {
+    const Stepper_Profile* p = &stepper->profile;
+    float vmax = (float)(stepper->direction ? p->max_rate_close : p->max_rate_open);
+    uint32_t done = (uint32_t)stepper->current_step;
+    uint32_t total = (uint32_t)abs(stepper->target_steps);
+    uint32_t left = (total > done + 1U) ? total - done - 1U : 0U;
+
+    float v_acc = Stepper_RampRate(p, (float)p->start_rate, vmax, done);
+    float v_dec = Stepper_RampRate(p, (float)p->stop_rate, vmax, left);
+    float v = (v_acc < v_dec) ? v_acc : v_dec;
+    if (v < (float)STEPPER_RATE_MIN) v = (float)STEPPER_RATE_MIN;
+    return (uint16_t)(1000000.0f / v);
+}
+
+static uint8_t Stepper_PhaseAfter(const Stepper* stepper, uint8_t phase, uint32_t steps) {
+    // Mở: pha tăng, đóng: pha giảm (cộng 7 = trừ 1 theo mod 8)
+    return (uint8_t)((phase + (stepper->direction ? 7U : 1U) * (steps & 7U)) & 7U);
+}
+
+static void Stepper_BatchAdd(Stepper_Batch* batch, GPIO_TypeDef* port, uint32_t bsrr) {
+    for (uint8_t i = 0; i < batch->count; i++) {
+        if (batch->port[i] == port) {
+            // Mỗi động cơ có chân riêng: OR các từ BSRR không đè lên nhau
+            batch->bsrr[i] |= bsrr;
+            return;
+        }
+    }
+    batch->port[batch->count] = port;
+    batch->bsrr[batch->count] = bsrr;
+    batch->count++;
+}
+
+void Stepper_SetPosition(Stepper* stepper, int32_t position) {
+    if (position < 0) position = 0;
+    if (position > stepper->position_max) position = stepper->position_max;
+    stepper->position = (int16_t)position;
+    stepper->percent = (stepper->position / (float)stepper->position_max) * 100.0f;
+}
+
+uint8_t Stepper_SetLimits(Stepper* stepper, int16_t position_max) {
+    if (stepper->is_moving || position_max < 1) return 0;
+    stepper->position_max = position_max;
+    Stepper_SetPosition(stepper, stepper->position);
+    return 1;
+}
+
+/**
+ * @brief Một kênh GPDMA bộ nhớ -> thanh ghi ngoại vi, mỗi yêu cầu phần cứng một phần tử.
+ */
+static HAL_StatusTypeDef Stepper_DmaInitChannel(DMA_HandleTypeDef* hdma, DMA_Channel_TypeDef* channel,
+                                                uint32_t request, uint32_t src_width, uint32_t dst_width) {
+    hdma->Instance = channel;
+    hdma->Init.Request = request;
+    hdma->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    hdma->Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma->Init.SrcInc = DMA_SINC_INCREMENTED;
+    hdma->Init.DestInc = DMA_DINC_FIXED;
+    hdma->Init.SrcDataWidth = src_width;
+    hdma->Init.DestDataWidth = dst_width;
+    hdma->Init.Priority = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+    hdma->Init.SrcBurstLength = 1;
+    hdma->Init.DestBurstLength = 1;
+    hdma->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT1 | DMA_DEST_ALLOCATED_PORT0;
+    hdma->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    hdma->Init.Mode = DMA_NORMAL;
+    if (HAL_DMA_Init(hdma) != HAL_OK) return HAL_ERROR;
+    return HAL_DMA_ConfigChannelAttributes(hdma, DMA_CHANNEL_NPRIV);
+}
+
+static void Stepper_DmaDone(DMA_HandleTypeDef* hdma);
+static void Stepper_DmaStart(Stepper* stepper);
+
+static HAL_StatusTypeDef Stepper_DmaInit(void) {
+    if (Stepper_DmaInitChannel(&stepper_dma_phase, STEPPER_DMA_PHASE_CHANNEL, STEPPER_DMA_PHASE_REQUEST,
+                               DMA_SRC_DATAWIDTH_WORD, DMA_DEST_DATAWIDTH_WORD) != HAL_OK) return HAL_ERROR;
+    if (Stepper_DmaInitChannel(&stepper_dma_rate, STEPPER_DMA_RATE_CHANNEL, STEPPER_DMA_RATE_REQUEST,
+                               DMA_SRC_DATAWIDTH_HALFWORD, DMA_DEST_DATAWIDTH_HALFWORD) != HAL_OK) return HAL_ERROR;
+    stepper_dma_phase.XferCpltCallback = Stepper_DmaDone;
+    stepper_dma_phase.XferErrorCallback = Stepper_DmaDone;
+    HAL_NVIC_SetPriority(STEPPER_DMA_PHASE_IRQn, STEPPER_TIM_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(STEPPER_DMA_PHASE_IRQn);
+    return HAL_OK;
+}
+
 void Stepper_Init(Stepper* stepper, StepperPins pins) {
+    static const Stepper_Profile defaults = {
+        .type = STEPPER_PROFILE_TRAPEZOID,
+        .start_rate = STEPPER_DEFAULT_START_RATE, .stop_rate = STEPPER_DEFAULT_STOP_RATE,
+        .max_rate_open = STEPPER_DEFAULT_MAX_OPEN, .max_rate_close = STEPPER_DEFAULT_MAX_CLOSE,
+        .accel = STEPPER_DEFAULT_ACCEL,
+    };
     stepper->pins = pins;
-    stepper->step_delay = 10;  // Mặc định 2ms/bước
     stepper->target_steps = 0;
     stepper->current_step = 0;
     stepper->current_phase = 0;
-    stepper->last_step_time = 0;
+    stepper->interval_us = 0;
     stepper->is_moving = 0;
     stepper->direction = 0;
+    stepper->dma_steps = 0;
+    stepper->dma_synced = 0;
+    stepper->position_max = STEPPER_POSITION_MAX;
+    stepper->last_step_tick = 0;
+    Stepper_SetPosition(stepper, 0);
+    Stepper_SetProfile(stepper, &defaults);
+    Stepper_BuildBsrr(stepper);
+
+    // Nhả cuộn dây: chưa biết rotor đang ở pha nào (Stepper_Restore hoặc lần chạy đầu tiên sẽ cấp pha)
+    Stepper_Release(stepper);
+
+    stepper->mode = STEPPER_MODE_IRQ;
+    if (stepper_axis_count >= STEPPER_MAX_AXES) {
+        // Hết kênh so sánh: động cơ không được đăng ký, Stepper_Move sẽ không chạy nó
+        stepper->axis = STEPPER_MAX_AXES;
+        return;
+    }
+    stepper->axis = stepper_axis_count;
+    stepper_axes[stepper_axis_count++] = stepper;
+
+    if (stepper->axis == 0U) {
+        // Bộ đếm 1 MHz, CC1..CC4 so sánh không ra chân. Chế độ ngắt: chạy tự do 16 bit, mỗi động cơ một kênh.
+        // Chế độ DMA (chỉ khi có một động cơ): cấu hình lại mỗi lần chạy (xem Stepper_DmaStart).
+        STEPPER_TIM_CLK_ENABLE();
+        STEPPER_TIM->CR1 = 0;
+        STEPPER_TIM->PSC = Stepper_TimerClock() / 1000000U - 1U;
+        STEPPER_TIM->ARR = 0xFFFFU;
+        STEPPER_TIM->CCMR1 = 0;
+        STEPPER_TIM->CCMR2 = 0;
+        STEPPER_TIM->DIER = 0;
+        STEPPER_TIM->EGR = TIM_EGR_UG;
+        STEPPER_TIM->SR = 0;
+        STEPPER_TIM->CR1 = TIM_CR1_CEN;
+        HAL_NVIC_SetPriority(STEPPER_TIM_IRQn, STEPPER_TIM_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(STEPPER_TIM_IRQn);
+        if (STEPPER_DEFAULT_MODE == STEPPER_MODE_DMA) Stepper_SetMode(stepper, STEPPER_MODE_DMA);
+    } else if (stepper_dma_owner != NULL) {
+        // DMA chiếm cả timer (ARR, UP, CH1): có động cơ thứ 2 thì động cơ đầu về chế độ ngắt
+        stepper_dma_owner->mode = STEPPER_MODE_IRQ;
+    }
+}
 
-    // Đặt tất cả các chân về 0
-    Stepper_SetPhase(stepper, 0);
+uint8_t Stepper_SetMode(Stepper* stepper, Stepper_Mode mode) {
+    if (stepper->is_moving) return 0;
+    if (mode == STEPPER_MODE_DMA) {
+        // Chỉ khi timer có đúng một động cơ, và 4 chân phải cùng port để ghi BSRR một lần
+        if (stepper->port == NULL || stepper_axis_count != 1U || stepper->axis != 0U) return 0;
+        if (stepper_dma_owner != NULL && stepper_dma_owner != stepper) return 0;
+        if (stepper_dma_owner == NULL && Stepper_DmaInit() != HAL_OK) return 0;
+        stepper_dma_owner = stepper;
+    }
+    stepper->mode = (uint8_t)mode;
+    return 1;
 }
-void Stepper_SetSpeed(Stepper* stepper, uint32_t rpm) {
-    // Chuyển đổi rpm thành microseconds/step
-    // 1 vòng = 4096 bước (với full step gồm 8 pha)
-    stepper->step_delay = rpm;
+
+void Stepper_SetProfile(Stepper* stepper, const Stepper_Profile* profile) {
+    Stepper_Profile p = *profile;
+    p.type = (p.type == STEPPER_PROFILE_SCURVE) ? STEPPER_PROFILE_SCURVE : STEPPER_PROFILE_TRAPEZOID;
+    p.start_rate = Stepper_ClampRate(p.start_rate);
+    p.stop_rate = Stepper_ClampRate(p.stop_rate);
+    p.max_rate_open = Stepper_ClampRate(p.max_rate_open);
+    p.max_rate_close = Stepper_ClampRate(p.max_rate_close);
+    if (p.accel == 0U) p.accel = 1U;
+    stepper->profile = p;
 }
 
-void Stepper_Move(Stepper* stepper, int32_t steps) {
-    stepper->target_steps = steps;
-    stepper->current_step = 0;
-    stepper->direction = (steps >= 0) ? 1 : 0;
-    if(stepper->target_steps != 0){
-        stepper->is_moving = 1;
+void Stepper_SetSpeed(Stepper* stepper, uint32_t rate) {
+    stepper->profile.max_rate_open = Stepper_ClampRate(rate);
+    stepper->profile.max_rate_close = Stepper_ClampRate(rate);
+}
+
+void Stepper_Sync(Stepper* stepper) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (stepper->mode == STEPPER_MODE_DMA && stepper->dma_steps > 0U) {
+        // BNDT = số byte còn lại của khối: số bước đã ra = tổng - còn lại
+        uint32_t left = __HAL_DMA_GET_COUNTER(&stepper_dma_phase) / sizeof(uint32_t);
+        uint16_t done = (uint16_t)(stepper->dma_steps - ((left < stepper->dma_steps) ? left : stepper->dma_steps));
+        int32_t delta = (int32_t)done - (int32_t)stepper->dma_synced;
+        // Cộng dồn phần chênh, không ghi đè: logic điều khiển có thể đã tự chỉnh position
+        Stepper_SetPosition(stepper, stepper->position + (stepper->direction ? -delta : delta));
+        stepper->dma_synced = done;
+        stepper->current_step = (int32_t)stepper->dma_base + done;
+        stepper->current_phase = Stepper_PhaseAfter(stepper, stepper->dma_start_phase, done);
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Dừng timer và 2 kênh DMA, chốt vị trí theo số bước thực sự đã ra.
+ */
+static void Stepper_DmaHalt(Stepper* stepper) {
+    STEPPER_TIM->CR1 &= ~TIM_CR1_CEN;
+    STEPPER_TIM->DIER &= ~(TIM_DIER_UDE | TIM_DIER_CC1DE);
+    if (stepper->dma_steps == 0U) return;
+    // Đọc bộ đếm trước khi abort (abort reset kênh)
+    Stepper_Sync(stepper);
+    stepper->dma_steps = 0;
+    HAL_DMA_Abort(&stepper_dma_phase);
+    HAL_DMA_Abort(&stepper_dma_rate);
+}
+
+static uint8_t Stepper_AtEnd(const Stepper* stepper) {
+    return stepper->position == 0 || stepper->position == stepper->position_max;
+}
+
+static void Stepper_Finish(Stepper* stepper) {
+    stepper->last_step_tick = HAL_GetTick();
+    stepper->is_moving = 0;
+    // Dừng ở đầu hành trình thì nhả cuộn dây, ở giữa thì giữ pha để van không trôi
+    if (Stepper_AtEnd(stepper)) Stepper_Stop(stepper);
+}
+
+static void Stepper_DmaDone(DMA_HandleTypeDef* hdma) {
+    Stepper* stepper = stepper_dma_owner;
+    (void)hdma;
+    if (stepper == NULL) return;
+    STEPPER_TIM->CR1 &= ~TIM_CR1_CEN;
+    STEPPER_TIM->DIER &= ~(TIM_DIER_UDE | TIM_DIER_CC1DE);
+    Stepper_Sync(stepper);
+    stepper->dma_base = (uint16_t)(stepper->dma_base + stepper->dma_steps);
+    stepper->dma_steps = 0;
+    HAL_DMA_Abort(&stepper_dma_rate);
+    // Hành trình dài hơn một bảng: chạy tiếp khối sau, is_moving giữ nguyên tới bước cuối
+    if (stepper->dma_base < abs(stepper->target_steps)) {
+        Stepper_DmaStart(stepper);
+        if (stepper->is_moving) return;
     }
-    stepper->last_step_time = HAL_GetTick();  // Chuyển đổi ms sang us
+    Stepper_Finish(stepper);
 }
 
-void Stepper_Run(Stepper* stepper) {
-	if(stepper->direction == 1 && step_position == 0){
-      	Stepper_Stop(stepper);
+/**
+ * @brief Dựng bảng cho khối kế tiếp của hành trình (từ bước dma_base, tối đa STEPPER_DMA_MAX_STEPS)
+ *        rồi để timer + DMA chạy, CPU không can thiệp tới khi xong khối.
+ *        Chu kỳ k của timer (k = 0 là trước bước đầu) dài stepper_dma_arr[k] + 1 us:
+ *        - TIM_CH1 (CCR1 = 1, ngay sau mỗi lần tràn) ghi ARR của chu kỳ đang bắt đầu (ARPE = 0).
+ *        - TIM_UP (cuối chu kỳ k) ghi từ BSRR của bước k.
+ */
+static void Stepper_DmaStart(Stepper* stepper) {
+    uint32_t n = (uint32_t)abs(stepper->target_steps) - stepper->dma_base;
+    if (n > STEPPER_DMA_MAX_STEPS) n = STEPPER_DMA_MAX_STEPS;
+
+    for (uint32_t k = 0; k < n; k++) {
+        stepper->current_step = (int32_t)(stepper->dma_base + k);
+        stepper_dma_arr[k] = (uint16_t)(Stepper_NextInterval(stepper) - 1U);
+        stepper_dma_bsrr[k] = stepper->phase_bsrr[Stepper_PhaseAfter(stepper, stepper->current_phase, k + 1U)];
+    }
+    stepper->current_step = stepper->dma_base;
+    stepper->dma_start_phase = stepper->current_phase;
+    stepper->dma_synced = 0;
+    stepper->dma_steps = (uint16_t)n;
+    stepper->interval_us = (uint16_t)(stepper_dma_arr[0] + 1U);
+
+    STEPPER_TIM->CR1 = 0;
+    STEPPER_TIM->DIER = 0;
+    STEPPER_TIM->CNT = 0;
+    STEPPER_TIM->ARR = stepper_dma_arr[0];
+    STEPPER_TIM->CCR1 = 1;
+    STEPPER_TIM->SR = 0;
+    if (HAL_DMA_Start_IT(&stepper_dma_phase, (uint32_t)stepper_dma_bsrr, (uint32_t)&stepper->port->BSRR,
+                         n * sizeof(uint32_t)) != HAL_OK ||
+        HAL_DMA_Start(&stepper_dma_rate, (uint32_t)stepper_dma_arr, (uint32_t)&STEPPER_TIM->ARR,
+                      n * sizeof(uint16_t)) != HAL_OK) {
+        HAL_DMA_Abort(&stepper_dma_phase);
+        stepper->dma_steps = 0;
+        stepper->is_moving = 0;
         return;
     }
-    if(stepper->direction == 0 && step_position == 500){
-    	Stepper_Stop(stepper);
+    STEPPER_TIM->DIER = TIM_DIER_UDE | TIM_DIER_CC1DE;
+    STEPPER_TIM->CR1 = TIM_CR1_CEN;
+}
+
+void Stepper_Move(Stepper* stepper, int32_t steps) {
+    if (stepper->axis >= STEPPER_MAX_AXES) return;
+    // Dừng lần chạy đang dở (có thể gọi khi đang chạy) trước khi đổi kế hoạch
+    STEPPER_TIM->DIER &= ~STEPPER_CCIE(stepper);
+    if (stepper->mode == STEPPER_MODE_DMA) Stepper_DmaHalt(stepper);
+
+    stepper->direction = (steps >= 0) ? 1 : 0;
+    // Không lên kế hoạch vượt đầu hành trình: giảm tốc kết thúc đúng ở 0 / position_max
+    int32_t room = stepper->direction ? stepper->position : stepper->position_max - stepper->position;
+    if (room < 0) room = 0;
+    if (steps > room) steps = room;
+    if (steps < -room) steps = -room;
+    stepper->target_steps = steps;
+    stepper->current_step = 0;
+    stepper->dma_base = 0;
+    if (stepper->target_steps == 0) {
+        stepper->is_moving = 0;
+        // Đã ở đầu hành trình theo chiều được yêu cầu: nhả cuộn dây như trước
+        if (room == 0) Stepper_Finish(stepper);
         return;
     }
-    if (!stepper->is_moving) return;
-    if(stepper->target_steps == 0) return;
+    stepper->is_moving = 1;
 
+    if (stepper->mode == STEPPER_MODE_DMA) {
+        Stepper_DmaStart(stepper);
+        return;
+    }
+    stepper->interval_us = Stepper_NextInterval(stepper);
+    STEPPER_TIM->ARR = 0xFFFFU;
+    STEPPER_TIM->CR1 = TIM_CR1_CEN;
+    STEPPER_CCR(stepper) = (uint16_t)(STEPPER_TIM->CNT + stepper->interval_us);
+    STEPPER_TIM->SR = ~STEPPER_CCIF(stepper);
+    STEPPER_TIM->DIER |= STEPPER_CCIE(stepper);
+}
 
-        if (stepper->direction == 0) {
-            stepper->current_phase = (stepper->current_phase + 1) % 8;
-        } else {
-            stepper->current_phase = (stepper->current_phase + 7) % 8;
-        }
-        // Thực hiện bước
-        Stepper_SetPhase(stepper, stepper->current_phase);
+/**
+ * @brief Một nửa bước, từ BSRR đưa vào batch (ghi sau khi xử lý hết các kênh). Trả về 1 nếu còn bước kế tiếp.
+ */
+static uint8_t Stepper_Step(Stepper* stepper, Stepper_Batch* batch) {
+    uint8_t more = 1;
+    uint8_t release = 0;
+
+    if ((stepper->direction == 1 && stepper->position == 0) ||
+        (stepper->direction == 0 && stepper->position == stepper->position_max)) {
+        // Đã chạm đầu hành trình theo chiều đang chạy: ngắt điện cuộn dây như trước
+        release = 1;
+        more = 0;
+    } else {
+        stepper->current_phase = Stepper_PhaseAfter(stepper, stepper->current_phase, 1U);
         stepper->current_step++;
-        int16_t next_step = step_position + (stepper->direction ? -1 : 1);
-        if (next_step >= 0 && next_step <= 500) {
-            step_position = next_step;
-        }
-        percent_step = (step_position/500.0f)*100.0f;
+        Stepper_SetPosition(stepper, stepper->position + (stepper->direction ? -1 : 1));
         // Kiểm tra xem đã hoàn thành chưa
         if (stepper->current_step >= abs(stepper->target_steps)) {
-                 last_time_step = HAL_GetTick();
-            	 stepper->is_moving = 0;
+            release = Stepper_AtEnd(stepper);
+            more = 0;
+        }
+    }
+    if (!more) {
+        stepper->last_step_tick = HAL_GetTick();
+        stepper->is_moving = 0;
+    }
+
+    // Thực hiện bước
+    if (stepper->port == NULL) {
+        if (release) Stepper_Release(stepper);
+        else Stepper_SetPhase(stepper, stepper->current_phase);
+    } else {
+        Stepper_BatchAdd(batch, stepper->port, release ? stepper->off_bsrr : stepper->phase_bsrr[stepper->current_phase]);
+    }
+    return more;
+}
+
+void Stepper_TimerIRQHandler(void) {
+    Stepper_Batch batch;
+    batch.count = 0;
+    // CCxIF và CCxIE cùng vị trí bit: chỉ xử lý kênh đang bật ngắt
+    uint32_t pending = STEPPER_TIM->SR & STEPPER_TIM->DIER;
+
+    for (uint8_t i = 0; i < stepper_axis_count; i++) {
+        Stepper* stepper = stepper_axes[i];
+        if ((pending & STEPPER_CCIF(stepper)) == 0U) continue;
+        STEPPER_TIM->SR = ~STEPPER_CCIF(stepper);
+
+        if (stepper->is_moving && Stepper_Step(stepper, &batch)) {
+            // Mốc so sánh cộng dồn từ mốc trước: trễ ngắt không làm lệch nhịp các bước sau
+            stepper->interval_us = Stepper_NextInterval(stepper);
+            STEPPER_CCR(stepper) = (uint16_t)(STEPPER_CCR(stepper) + stepper->interval_us);
+        } else {
+            STEPPER_TIM->DIER &= ~STEPPER_CCIE(stepper);
         }
+    }
+    // Các động cơ bước cùng lúc trên cùng port đổi pha trong một lần ghi
+    for (uint8_t i = 0; i < batch.count; i++) {
+        batch.port[i]->BSRR = batch.bsrr[i];
+    }
+}
+
+void Stepper_DmaIRQHandler(void) {
+    HAL_DMA_IRQHandler(&stepper_dma_phase);
 }
 
 uint8_t Stepper_IsMoving(Stepper* stepper) {
@@ -107,43 +506,24 @@ uint8_t Stepper_State(Stepper* stepper){
 }
 
 void Stepper_Stop(Stepper* stepper) {
+    if (stepper->axis < STEPPER_MAX_AXES) STEPPER_TIM->DIER &= ~STEPPER_CCIE(stepper);
+    if (stepper->mode == STEPPER_MODE_DMA) Stepper_DmaHalt(stepper);
     stepper->is_moving = 0;
     // Tắt tất cả các cuộn dây
-    HAL_GPIO_WritePin(stepper->pins.PORT_IN1, stepper->pins.PIN_IN1, GPIO_PIN_SET);
-    HAL_GPIO_WritePin(stepper->pins.PORT_IN2, stepper->pins.PIN_IN2, GPIO_PIN_SET);
-    HAL_GPIO_WritePin(stepper->pins.PORT_IN3, stepper->pins.PIN_IN3, GPIO_PIN_SET);
-    HAL_GPIO_WritePin(stepper->pins.PORT_IN4, stepper->pins.PIN_IN4, GPIO_PIN_SET);
+    Stepper_Release(stepper);
+}
+
+void Stepper_Restore(Stepper* stepper, uint8_t phase) {
+    if (stepper->is_moving) return;
+    stepper->current_phase = phase & 7U;
+    Stepper_SetPhase(stepper, stepper->current_phase);
 }
 
 
 void Stepper_Hold(Stepper* stepper) {
+    if (stepper->axis < STEPPER_MAX_AXES) STEPPER_TIM->DIER &= ~STEPPER_CCIE(stepper);
+    if (stepper->mode == STEPPER_MODE_DMA) Stepper_DmaHalt(stepper);
     stepper->is_moving = 0;
     // Tắt tất cả các cuộn dây
     Stepper_SetPhase(stepper, stepper->current_phase);
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
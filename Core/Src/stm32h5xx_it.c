@@ -22,6 +22,9 @@
 #include "stm32h5xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "Modbus_Slave_Final.h"
+#include "log_dma.h"
+#include "stepper_v2.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -61,7 +64,10 @@ extern DMA_HandleTypeDef handle_GPDMA1_Channel1;
 extern DMA_HandleTypeDef handle_GPDMA1_Channel0;
 extern UART_HandleTypeDef huart1;
 /* USER CODE BEGIN EV */
-
+extern DMA_HandleTypeDef handle_GPDMA1_Channel3;
+extern UART_HandleTypeDef huart3;
+extern ModbusHandle modbus_slave;
+extern ADC_HandleTypeDef hadc1;
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -264,7 +270,8 @@ void TIM2_IRQHandler(void)
 void USART1_IRQHandler(void)
 {
   /* USER CODE BEGIN USART1_IRQn 0 */
-
+  // Receiver timeout (t1.5) của Modbus phải được xử lý trước HAL
+  Modbus_UartIRQHandler(&modbus_slave);
   /* USER CODE END USART1_IRQn 0 */
   HAL_UART_IRQHandler(&huart1);
   /* USER CODE BEGIN USART1_IRQn 1 */
@@ -273,5 +280,52 @@ void USART1_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles GPDMA1 Channel 3 global interrupt (USART3 TX - log).
+  */
+void GPDMA1_Channel3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&handle_GPDMA1_Channel3);
+}
+
+/**
+  * @brief This function handles USART3 global interrupt.
+  */
+void USART3_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart3);
+  Log_IRQHandler();
+}
+
+/**
+  * @brief This function handles TIM6 global interrupt (Modbus RTU t3.5).
+  */
+void TIM6_IRQHandler(void)
+{
+  Modbus_TimerIRQHandler(&modbus_slave);
+}
+
+/**
+  * @brief This function handles ADC1 global interrupt (analog watchdog trip).
+  */
+void ADC1_IRQHandler(void)
+{
+  HAL_ADC_IRQHandler(&hadc1);
+}
 
+/**
+  * @brief This function handles TIM3 global interrupt (stepper compare, all axes).
+  */
+void TIM3_IRQHandler(void)
+{
+  Stepper_TimerIRQHandler();
+}
+
+/**
+  * @brief This function handles GPDMA1 Channel 4 global interrupt (stepper phase table done).
+  */
+void GPDMA1_Channel4_IRQHandler(void)
+{
+  Stepper_DmaIRQHandler();
+}
 /* USER CODE END 1 */
@@ -0,0 +1,102 @@
+/*
+ * valve_backup.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ */
+#include "valve_backup.h"
+#include "stm32h5xx_hal.h"
+#include "modbus_crc.h"
+#include "log_level.h"
+
+#define VALVE_BACKUP_MAGIC          0xB7E5U
+#define VALVE_BACKUP_FLAG_STOPPED   0x01U
+#define VALVE_BACKUP_REGS_PER_AXIS  3U
+
+#if VALVE_BACKUP_REG_FIRST + VALVE_BACKUP_MAX_AXES * VALVE_BACKUP_REGS_PER_AXIS > 32U
+#error "Valve backup records do not fit in TAMP->BKP0R..BKP31R"
+#endif
+
+static uint32_t valve_words[VALVE_BACKUP_MAX_AXES][2];     // Bản sao 2 từ dữ liệu đang nằm trong vùng backup
+
+static volatile uint32_t* ValveBackup_Regs(uint8_t axis) {
+    return &TAMP->BKP0R + VALVE_BACKUP_REG_FIRST + axis * VALVE_BACKUP_REGS_PER_AXIS;
+}
+
+static uint16_t ValveBackup_Crc(const uint32_t* words) {
+    return Modbus_CRC16((const uint8_t*)words, 2U * sizeof(uint32_t));
+}
+
+static void ValveBackup_Write(uint8_t axis, int16_t position, uint8_t phase, uint8_t flags, uint8_t resumes) {
+    volatile uint32_t* bkp = ValveBackup_Regs(axis);
+    uint32_t* words = valve_words[axis];
+    words[0] = ((uint32_t)VALVE_BACKUP_MAGIC << 16) | (uint16_t)position;
+    words[1] = (uint32_t)phase | ((uint32_t)flags << 8) | ((uint32_t)resumes << 16);
+    // Reset giữa 3 lần ghi để lại CRC không khớp: lần khởi động sau sẽ đóng về 0
+    bkp[0] = words[0];
+    bkp[1] = words[1];
+    bkp[2] = ValveBackup_Crc(words);
+}
+
+void ValveBackup_Init(void) {
+    __HAL_RCC_RTC_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    for (uint8_t axis = 0; axis < VALVE_BACKUP_MAX_AXES; axis++) {
+        volatile uint32_t* bkp = ValveBackup_Regs(axis);
+        valve_words[axis][0] = bkp[0];
+        valve_words[axis][1] = bkp[1];
+    }
+}
+
+uint8_t ValveBackup_Load(uint8_t axis, int16_t position_max, ValveBackup_State* state) {
+    if (axis >= VALVE_BACKUP_MAX_AXES) return 0;
+    volatile uint32_t* bkp = ValveBackup_Regs(axis);
+    uint32_t words[2] = { bkp[0], bkp[1] };
+    int16_t position = (int16_t)(words[0] & 0xFFFFU);
+    uint8_t phase = (uint8_t)(words[1] & 0xFFU);
+    uint8_t flags = (uint8_t)((words[1] >> 8) & 0xFFU);
+    uint8_t resumes = (uint8_t)((words[1] >> 16) & 0xFFU);
+
+    if ((words[0] >> 16) != VALVE_BACKUP_MAGIC || bkp[2] != ValveBackup_Crc(words) ||
+        (flags & VALVE_BACKUP_FLAG_STOPPED) == 0U ||
+        position < 0 || position > position_max || phase > 7U ||
+        resumes >= VALVE_BACKUP_MAX_RESUMES) {
+        // Không tin được: van sẽ đóng về 0, tới lúc đó không có vị trí nào để lưu
+        ValveBackup_Write(axis, 0, 0, 0, 0);
+        LOG_INFO(EVT_VALVE_HOMING, axis);
+        return 0;
+    }
+    resumes++;
+    ValveBackup_Write(axis, position, phase, flags, resumes);
+    LOG_INFO(EVT_VALVE_RESUMED, axis, position, phase, resumes);
+    state->position = position;
+    state->phase = phase;
+    state->resumes = resumes;
+    return 1;
+}
+
+void ValveBackup_MarkMoving(uint8_t axis) {
+    if (axis >= VALVE_BACKUP_MAX_AXES) return;
+    const uint32_t* words = valve_words[axis];
+    uint8_t flags = (uint8_t)((words[1] >> 8) & 0xFFU);
+    if ((flags & VALVE_BACKUP_FLAG_STOPPED) == 0U) return;
+    ValveBackup_Write(axis, (int16_t)(words[0] & 0xFFFFU), (uint8_t)(words[1] & 0xFFU),
+                      (uint8_t)(flags & ~VALVE_BACKUP_FLAG_STOPPED), (uint8_t)(words[1] >> 16));
+}
+
+void ValveBackup_SaveStopped(uint8_t axis, int16_t position, uint8_t phase) {
+    if (axis >= VALVE_BACKUP_MAX_AXES) return;
+    const uint32_t* words = valve_words[axis];
+    uint8_t resumes = (uint8_t)((words[1] >> 16) & 0xFFU);
+    uint32_t w0 = ((uint32_t)VALVE_BACKUP_MAGIC << 16) | (uint16_t)position;
+    uint32_t w1 = (uint32_t)phase | ((uint32_t)VALVE_BACKUP_FLAG_STOPPED << 8) | ((uint32_t)resumes << 16);
+    if (w0 == words[0] && w1 == words[1]) return;
+    ValveBackup_Write(axis, position, phase, VALVE_BACKUP_FLAG_STOPPED, resumes);
+}
+
+void ValveBackup_Homed(uint8_t axis) {
+    if (axis >= VALVE_BACKUP_MAX_AXES) return;
+    const uint32_t* words = valve_words[axis];
+    ValveBackup_Write(axis, (int16_t)(words[0] & 0xFFFFU), (uint8_t)(words[1] & 0xFFU),
+                      (uint8_t)((words[1] >> 8) & 0xFFU), 0);
+}
@@ -0,0 +1,524 @@
+/*
+ * fake_hal.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Các hàm HAL mà firmware gọi, viết lại trên bộ mô phỏng sim_mcu.c.
+ *  Chỉ giữ hành vi firmware thấy được: trạng thái handle, gọi MspInit như HAL thật
+ *  (NVIC/DMA được cấu hình ở đó), callback DMA/UART/TIM đúng ngữ cảnh ngắt.
+ *  EEPROM I2C (loại chọn trong eeprom_final.h) nằm ngay trong file này, có chu trình ghi 5 ms.
+ */
+#include "sim_mcu.h"
+#include "eeprom_final.h"
+#include <string.h>
+
+/*================================================ Chung =======================================*/
+HAL_StatusTypeDef HAL_Init(void) {
+    HAL_MspInit();
+    return HAL_OK;
+}
+
+void HAL_IncTick(void) {
+}
+
+// Mỗi lần đọc tick tốn 1 us mô phỏng: vòng chờ theo tick luôn tiến được
+uint32_t HAL_GetTick(void) {
+    Sim_Advance(1000U);
+    return Sim_NowMs();
+}
+
+void HAL_Delay(uint32_t Delay) {
+    Sim_Advance((uint64_t)Delay * SIM_NS_PER_MS + 1000U);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+    (void)SubPriority;
+    NVIC_SetPriority(IRQn, PreemptPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+    NVIC_EnableIRQ(IRQn);
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) {
+    NVIC_DisableIRQ(IRQn);
+}
+
+/*================================================ RCC / PWR =======================================*/
+HAL_StatusTypeDef HAL_RCC_OscConfig(const RCC_OscInitTypeDef* pOscInitStruct) {
+    (void)pOscInitStruct;
+    return HAL_OK;
+}
+
+// SYSCLK = HSI 64 MHz / 2 như SystemClock_Config
+HAL_StatusTypeDef HAL_RCC_ClockConfig(const RCC_ClkInitTypeDef* pClkInitStruct, uint32_t FLatency) {
+    (void)pClkInitStruct;
+    (void)FLatency;
+    SystemCoreClock = 32000000U;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(const RCC_PeriphCLKInitTypeDef* pPeriphClkInit) {
+    (void)pPeriphClkInit;
+    return HAL_OK;
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void) {
+    return SystemCoreClock;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return SystemCoreClock;
+}
+
+void HAL_PWR_EnableBkUpAccess(void) {
+}
+
+/*================================================ GPIO =======================================*/
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, const GPIO_InitTypeDef* pGPIO_Init) {
+    if (pGPIO_Init->Mode != GPIO_MODE_INPUT) return;
+    for (uint32_t bit = 0; bit < 16U; bit++) {
+        uint16_t pin = (uint16_t)(1U << bit);
+        if (pGPIO_Init->Pin & pin) Sim_GpioSetInput(GPIOx, pin, 0);
+    }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef* GPIOx, uint32_t GPIO_Pin) {
+    (void)GPIOx;
+    (void)GPIO_Pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(const GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    Sim_GpioSync();
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    // Các lần ghi BSRR trước đó phải vào ODR trước lần ghi này
+    Sim_GpioSync();
+    if (PinState != GPIO_PIN_RESET) GPIOx->ODR |= GPIO_Pin;
+    else GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    Sim_GpioSync();
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    Sim_GpioSync();
+    GPIOx->ODR ^= GPIO_Pin;
+    Sim_GpioSync();
+}
+
+/*================================================ DMA =======================================*/
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* const hdma) {
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+    hdma->State = HAL_DMA_STATE_READY;
+    hdma->Lock = HAL_UNLOCKED;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef* const hdma) {
+    Sim_DmaStop(hdma);
+    hdma->XferCpltCallback = NULL;
+    hdma->XferHalfCpltCallback = NULL;
+    hdma->XferErrorCallback = NULL;
+    hdma->XferAbortCallback = NULL;
+    hdma->Parent = NULL;
+    hdma->State = HAL_DMA_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_ConfigChannelAttributes(DMA_HandleTypeDef* const hdma, uint32_t ChannelAttributes) {
+    (void)hdma;
+    (void)ChannelAttributes;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef* const hdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                uint32_t SrcDataSize) {
+    if (hdma->State != HAL_DMA_STATE_READY) return HAL_BUSY;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    Sim_DmaStart(hdma, SrcAddress, DstAddress, SrcDataSize, 0);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef* const hdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                   uint32_t SrcDataSize) {
+    if (hdma->State != HAL_DMA_STATE_READY) return HAL_BUSY;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    Sim_DmaStart(hdma, SrcAddress, DstAddress, SrcDataSize, 1);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef* const hdma) {
+    Sim_DmaStop(hdma);
+    hdma->Instance->CBR1 = 0;
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* const hdma) {
+    uint32_t flags = hdma->Instance->CSR;
+    if (flags & DMA_CSR_HTF) {
+        hdma->Instance->CSR &= ~DMA_CSR_HTF;
+        if (hdma->XferHalfCpltCallback != NULL) hdma->XferHalfCpltCallback(hdma);
+    }
+    if (flags & DMA_CSR_TCF) {
+        hdma->Instance->CSR &= ~DMA_CSR_TCF;
+        // Linked-list vòng (ADC) chạy tiếp, kênh thường về READY
+        if (hdma->Mode != DMA_LINKEDLIST_CIRCULAR) hdma->State = HAL_DMA_STATE_READY;
+        if (hdma->XferCpltCallback != NULL) hdma->XferCpltCallback(hdma);
+    }
+}
+
+HAL_StatusTypeDef HAL_DMAEx_List_BuildNode(DMA_NodeConfTypeDef const* const pNodeConfig, DMA_NodeTypeDef* const pNode) {
+    (void)pNodeConfig;
+    (void)pNode;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMAEx_List_InsertNode_Tail(DMA_QListTypeDef* const pQList, DMA_NodeTypeDef* const pNewNode) {
+    pQList->Head = pNewNode;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMAEx_List_SetCircularMode(DMA_QListTypeDef* const pQList) {
+    (void)pQList;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMAEx_List_Init(DMA_HandleTypeDef* const hdma) {
+    hdma->Mode = hdma->InitLinkedList.LinkedListMode;
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMAEx_List_LinkQ(DMA_HandleTypeDef* const hdma, DMA_QListTypeDef* const pQList) {
+    hdma->LinkedListQueue = pQList;
+    return HAL_OK;
+}
+
+/*================================================ ADC =======================================*/
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc) {
+    if (hadc->State == HAL_ADC_STATE_RESET) HAL_ADC_MspInit(hadc);
+    hadc->State = HAL_ADC_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef* hadc) {
+    Sim_AdcStop(hadc);
+    HAL_ADC_MspDeInit(hadc);
+    hadc->State = HAL_ADC_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, const ADC_ChannelConfTypeDef* pConfig) {
+    (void)hadc;
+    (void)pConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef* hadc, const ADC_AnalogWDGConfTypeDef* pAnalogWDGConfig) {
+    (void)hadc;
+    (void)pAnalogWDGConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc, uint32_t SingleDiff) {
+    (void)hadc;
+    (void)SingleDiff;
+    return HAL_OK;
+}
+
+// Callback mặc định (weak) như stm32h5xx_hal_adc.c, firmware không dùng nửa bộ đệm thì không cần định nghĩa
+__weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+}
+
+static void Fake_AdcDmaHalf(DMA_HandleTypeDef* hdma) {
+    HAL_ADC_ConvHalfCpltCallback((ADC_HandleTypeDef*)hdma->Parent);
+}
+
+static void Fake_AdcDmaDone(DMA_HandleTypeDef* hdma) {
+    HAL_ADC_ConvCpltCallback((ADC_HandleTypeDef*)hdma->Parent);
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length) {
+    DMA_HandleTypeDef* hdma = hadc->DMA_Handle;
+    if (hdma == NULL) return HAL_ERROR;
+    hdma->XferHalfCpltCallback = Fake_AdcDmaHalf;
+    hdma->XferCpltCallback = Fake_AdcDmaDone;
+    hdma->Parent = hadc;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    Sim_AdcStart(hadc, (uint16_t*)pData, Length);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef* hadc) {
+    Sim_AdcStop(hadc);
+    if (hadc->DMA_Handle != NULL) hadc->DMA_Handle->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef* hadc, uint32_t Timeout) {
+    (void)hadc;
+    (void)Timeout;
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetValue(const ADC_HandleTypeDef* hadc) {
+    return hadc->Instance->DR;
+}
+
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+}
+
+/*================================================ TIM =======================================*/
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim) {
+    if (htim->State == HAL_TIM_STATE_RESET) HAL_TIM_Base_MspInit(htim);
+    htim->Instance->PSC = htim->Init.Prescaler;
+    htim->Instance->ARR = htim->Init.Period;
+    htim->Instance->EGR = TIM_EGR_UG;
+    htim->State = HAL_TIM_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef* htim, const TIM_ClockConfigTypeDef* sClockSourceConfig) {
+    (void)htim;
+    (void)sClockSourceConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef* htim, const TIM_MasterConfigTypeDef* sMasterConfig) {
+    htim->Instance->CR2 = (htim->Instance->CR2 & ~TIM_CR2_MMS) | sMasterConfig->MasterOutputTrigger;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim) {
+    htim->Instance->DIER |= TIM_DIER_UIE;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    htim->State = HAL_TIM_STATE_BUSY;
+    return HAL_OK;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef* htim) {
+    TIM_TypeDef* tim = htim->Instance;
+    if ((tim->SR & TIM_SR_UIF) && (tim->DIER & TIM_DIER_UIE)) {
+        tim->SR = (uint32_t)~TIM_SR_UIF;
+        HAL_TIM_PeriodElapsedCallback(htim);
+    }
+}
+
+/*================================================ UART =======================================*/
+static HAL_StatusTypeDef Fake_UartInit(UART_HandleTypeDef* huart) {
+    if (huart->gState == HAL_UART_STATE_RESET) HAL_UART_MspInit(huart);
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart) {
+    return Fake_UartInit(huart);
+}
+
+HAL_StatusTypeDef HAL_RS485Ex_Init(UART_HandleTypeDef* huart, uint32_t Polarity, uint32_t AssertionTime,
+                                   uint32_t DeassertionTime) {
+    (void)Polarity;
+    (void)AssertionTime;
+    (void)DeassertionTime;
+    return Fake_UartInit(huart);
+}
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef* huart) {
+    Sim_UartAbortTx(huart);
+    HAL_UART_MspDeInit(huart);
+    huart->gState = HAL_UART_STATE_RESET;
+    huart->RxState = HAL_UART_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_SetTxFifoThreshold(UART_HandleTypeDef* huart, uint32_t Threshold) {
+    (void)huart;
+    (void)Threshold;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_SetRxFifoThreshold(UART_HandleTypeDef* huart, uint32_t Threshold) {
+    (void)huart;
+    (void)Threshold;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_DisableFifoMode(UART_HandleTypeDef* huart) {
+    (void)huart;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_EnableReceiverTimeout(UART_HandleTypeDef* huart) {
+    (void)huart;
+    return HAL_OK;
+}
+
+void HAL_UART_ReceiverTimeout_Config(UART_HandleTypeDef* huart, uint32_t TimeoutValue) {
+    (void)huart;
+    (void)TimeoutValue;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    if (huart->gState != HAL_UART_STATE_READY) return HAL_BUSY;
+    if (pData == NULL || Size == 0U) return HAL_ERROR;
+    HAL_StatusTypeDef status = Sim_UartTransmit(huart, pData, Size);
+    if (status == HAL_OK) huart->gState = HAL_UART_STATE_BUSY_TX;
+    return status;
+}
+
+// Không có Master trên bus: nhận chỉ đổi trạng thái, không bao giờ có byte
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size) {
+    (void)pData;
+    (void)Size;
+    if (huart->RxState != HAL_UART_STATE_READY) return HAL_BUSY;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->ReceptionType = HAL_UART_RECEPTION_TOIDLE;
+    return HAL_OK;
+}
+
+HAL_UART_RxEventTypeTypeDef HAL_UARTEx_GetRxEventType(const UART_HandleTypeDef* huart) {
+    return huart->RxEventType;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart) {
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef* huart) {
+    Sim_UartAbortTx(huart);
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef* huart) {
+    return HAL_UART_Abort(huart);
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef* huart) {
+    if (Sim_UartTakeTxDone(huart)) {
+        huart->gState = HAL_UART_STATE_READY;
+        HAL_UART_TxCpltCallback(huart);
+    }
+}
+
+/*================================================ I2C EEPROM =======================================*/
+#define FAKE_EEPROM_SIZE        (CURRENT_EEPROM_MAX_MEM_ADDR + 1U)
+#define FAKE_EEPROM_PAGE        CURRENT_EEPROM_PAGE_SIZE
+#define FAKE_EEPROM_WRITE_NS    (5U * SIM_NS_PER_MS)
+#define FAKE_I2C_BYTE_NS        22500U      // 9 bit ở 400 kHz
+
+static uint8_t eeprom_mem[FAKE_EEPROM_SIZE];
+static uint8_t eeprom_ready;
+static uint64_t eeprom_busy_until;
+
+static void Fake_EepromPowerOn(void) {
+    if (eeprom_ready) return;
+    memset(eeprom_mem, 0xFF, sizeof(eeprom_mem));
+    eeprom_ready = 1;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef* hi2c) {
+    if (hi2c->State == HAL_I2C_STATE_RESET) HAL_I2C_MspInit(hi2c);
+    Fake_EepromPowerOn();
+    hi2c->State = HAL_I2C_STATE_READY;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef* hi2c) {
+    HAL_I2C_MspDeInit(hi2c);
+    hi2c->State = HAL_I2C_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigAnalogFilter(I2C_HandleTypeDef* hi2c, uint32_t AnalogFilter) {
+    (void)hi2c;
+    (void)AnalogFilter;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigDigitalFilter(I2C_HandleTypeDef* hi2c, uint32_t DigitalFilter) {
+    (void)hi2c;
+    (void)DigitalFilter;
+    return HAL_OK;
+}
+
+uint32_t HAL_I2C_GetError(const I2C_HandleTypeDef* hi2c) {
+    return hi2c->ErrorCode;
+}
+
+// Đang ghi nội bộ thì EEPROM không ACK địa chỉ
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout) {
+    (void)hi2c;
+    (void)DevAddress;
+    (void)Trials;
+    (void)Timeout;
+    Sim_Advance(FAKE_I2C_BYTE_NS);
+    return (Sim_NowNs() >= eeprom_busy_until) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    (void)DevAddress;
+    (void)MemAddSize;
+    (void)Timeout;
+    if (Sim_NowNs() < eeprom_busy_until) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    Sim_Advance((uint64_t)(Size + 4U) * FAKE_I2C_BYTE_NS);
+    for (uint16_t i = 0; i < Size; i++) pData[i] = eeprom_mem[(MemAddress + i) % FAKE_EEPROM_SIZE];
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    (void)DevAddress;
+    (void)MemAddSize;
+    (void)Timeout;
+    if (Sim_NowNs() < eeprom_busy_until) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    Sim_Advance((uint64_t)(Size + 3U) * FAKE_I2C_BYTE_NS);
+    // Ghi trong một trang: địa chỉ quay vòng trong trang như chip thật
+    uint32_t page = (MemAddress % FAKE_EEPROM_SIZE) & ~(FAKE_EEPROM_PAGE - 1U);
+    for (uint16_t i = 0; i < Size; i++) {
+        eeprom_mem[page + ((MemAddress + i) & (FAKE_EEPROM_PAGE - 1U))] = pData[i];
+    }
+    eeprom_busy_until = Sim_NowNs() + FAKE_EEPROM_WRITE_NS;
+    return HAL_OK;
+}
+
+/*================================================ IWDG =======================================*/
+// LSI 32 kHz, bộ chia 4 << Prescaler
+HAL_StatusTypeDef HAL_IWDG_Init(IWDG_HandleTypeDef* hiwdg) {
+    uint64_t divider = 4ULL << (hiwdg->Init.Prescaler >> IWDG_PR_PR_Pos);
+    Sim_IwdgStart(((uint64_t)hiwdg->Init.Reload + 1U) * divider * 1000000000ULL / 32000U);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_IWDG_Refresh(IWDG_HandleTypeDef* hiwdg) {
+    (void)hiwdg;
+    Sim_IwdgRefresh();
+    return HAL_OK;
+}
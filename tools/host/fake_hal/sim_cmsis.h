@@ -0,0 +1,94 @@
+/*
+ * sim_cmsis.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Thay cmsis_gcc.h khi biên dịch firmware trên máy tính (CMake ép include file này trước mọi file).
+ *  cmsis_gcc.h toàn lệnh hợp ngữ ARM; ở đây các macro trình biên dịch giữ nguyên,
+ *  còn PRIMASK/WFI/rào bộ nhớ chuyển sang bộ mô phỏng (sim_mcu.c).
+ */
+
+#ifndef SIM_CMSIS_H_
+#define SIM_CMSIS_H_
+
+#ifndef __ASSEMBLER__
+#include <stdint.h>
+
+#define __CMSIS_GCC_H   // Bỏ qua cmsis_gcc.h thật
+
+// NVIC cũng do bộ mô phỏng giữ (ghi ISER/ISPR trên RAM không có nghĩa "ghi 1 để đặt")
+#define CMSIS_NVIC_VIRTUAL
+#define CMSIS_NVIC_VIRTUAL_HEADER_FILE  "sim_nvic.h"
+
+#define __ASM                   __asm
+#define __INLINE                inline
+#define __STATIC_INLINE         static inline
+#define __STATIC_FORCEINLINE    static inline
+#define __NO_RETURN             __attribute__((__noreturn__))
+#define __USED                  __attribute__((used))
+#define __WEAK                  __attribute__((weak))
+#define __PACKED                __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT         struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION          union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+#define __RESTRICT              __restrict
+#define __COMPILER_BARRIER()    __asm volatile("" ::: "memory")
+
+#define __UNALIGNED_UINT16_READ(addr)        (*((const __PACKED uint16_t *)(addr)))
+#define __UNALIGNED_UINT16_WRITE(addr, val)  ((void)(*((__PACKED uint16_t *)(addr)) = (val)))
+#define __UNALIGNED_UINT32_READ(addr)        (*((const __PACKED uint32_t *)(addr)))
+#define __UNALIGNED_UINT32_WRITE(addr, val)  ((void)(*((__PACKED uint32_t *)(addr)) = (val)))
+
+// Ngắt: PRIMASK mô phỏng, bỏ mặt nạ thì các ngắt đang chờ chạy ngay
+void     Sim_DisableIrq(void);
+void     Sim_EnableIrq(void);
+uint32_t Sim_GetPrimask(void);
+void     Sim_SetPrimask(uint32_t primask);
+void     Sim_Wfi(void);
+
+#define __disable_irq()         Sim_DisableIrq()
+#define __enable_irq()          Sim_EnableIrq()
+#define __get_PRIMASK()         Sim_GetPrimask()
+#define __set_PRIMASK(x)        Sim_SetPrimask(x)
+#define __WFI()                 Sim_Wfi()
+#define __WFE()                 Sim_Wfi()
+#define __SEV()                 ((void)0)
+#define __NOP()                 ((void)0)
+#define __BKPT(value)           ((void)0)
+#define __DSB()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DMB()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define __REV(x)                __builtin_bswap32(x)
+#define __REV16(x)              ((uint32_t)(((x) & 0xFF00FF00U) >> 8) | (((x) & 0x00FF00FFU) << 8))
+#define __CLZ(x)                ((uint8_t)((x) == 0U ? 32U : (uint32_t)__builtin_clz(x)))
+
+static inline uint32_t __RBIT(uint32_t value) {
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < 32U; i++) {
+        result = (result << 1) | (value & 1U);
+        value >>= 1;
+    }
+    return result;
+}
+
+// LDREX/STREX: ngắt mô phỏng chỉ chạy ở điểm móc, không bao giờ chen giữa cặp lệnh này
+static inline uint32_t __LDREXW(volatile uint32_t* addr) { return *addr; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t* addr) { *addr = value; return 0; }
+static inline uint16_t __LDREXH(volatile uint16_t* addr) { return *addr; }
+static inline uint32_t __STREXH(uint16_t value, volatile uint16_t* addr) { *addr = value; return 0; }
+static inline uint8_t __LDREXB(volatile uint8_t* addr) { return *addr; }
+static inline uint32_t __STREXB(uint8_t value, volatile uint8_t* addr) { *addr = value; return 0; }
+#define __CLREX()               ((void)0)
+
+static inline uint32_t __get_CONTROL(void) { return 0; }
+static inline uint32_t __get_IPSR(void) { return 0; }
+static inline void __set_CONTROL(uint32_t control) { (void)control; }
+static inline uint32_t __get_BASEPRI(void) { return 0; }
+static inline void __set_BASEPRI(uint32_t basepri) { (void)basepri; }
+static inline uint32_t __get_FPSCR(void) { return 0; }
+static inline void __set_FPSCR(uint32_t fpscr) { (void)fpscr; }
+#endif /* __ASSEMBLER__ */
+
+#endif /* SIM_CMSIS_H_ */
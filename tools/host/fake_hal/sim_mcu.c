@@ -0,0 +1,702 @@
+/*
+ * sim_mcu.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bộ mô phỏng STM32H503 (xem sim_mcu.h). Mọi ngoại vi được cập nhật theo sự kiện:
+ *  Sim_Advance đi từng bước tới sự kiện gần nhất (timer tràn/so sánh, ADC, UART gửi xong, mốc 1 ms),
+ *  xử lý nó rồi chạy các ngắt đang chờ nếu PRIMASK cho phép.
+ */
+#define _GNU_SOURCE
+#include "sim_mcu.h"
+#include "stm32h5xx_it.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#define SIM_IRQ_COUNT       (COMP1_IRQn + 1)
+#define SIM_DMA_CHANNELS    8U
+#define SIM_FW_STACK_SIZE   (4U * 1024U * 1024U)
+#define SIM_ADC_SCAN_NS     50000ULL    // Một lượt quét 5 kênh, oversampling x8
+#define SIM_NEVER           UINT64_MAX
+
+static Sim_Hooks hooks;
+static Sim_Stats stats;
+static uint64_t now_ns;
+static uint64_t end_ns;
+static uint64_t cycle_frac;
+static uint32_t primask;
+static uint8_t in_isr;
+static uint8_t slept;
+
+/*================================================ Bộ nhớ =======================================*/
+static void Sim_Map(uintptr_t addr, size_t size) {
+    void* p = mmap((void*)addr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+    if (p != (void*)addr) {
+        fprintf(stderr, "sim: cannot map 0x%08lx (%zu bytes)\n", (unsigned long)addr, size);
+        exit(2);
+    }
+}
+
+// Chạy trước mọi hàm khác: firmware truy cập thanh ghi qua địa chỉ tuyệt đối
+__attribute__((constructor)) static void Sim_MapMemory(void) {
+    Sim_Map(PERIPH_BASE_NS, 0x08000000U);
+    Sim_Map(SCS_BASE & ~0xFFFFFUL, 0x00100000U);
+    Sim_Map((uintptr_t)VREFINT_CAL_ADDR & ~0xFFFUL, 0x1000U);
+    *VREFINT_CAL_ADDR = SIM_VREFINT_CAL;
+    PWR->VOSSR = PWR_VOSSR_VOSRDY | PWR_VOSSR_ACTVOSRDY;
+    RCC->RSR = RCC_RSR_PINRSTF;
+}
+
+/*================================================ NVIC và PRIMASK =======================================*/
+static uint8_t irq_enabled[SIM_IRQ_COUNT];
+static uint8_t irq_pending[SIM_IRQ_COUNT];
+static uint8_t irq_priority[SIM_IRQ_COUNT];
+static uint32_t irq_pending_count;
+
+// Như file startup: ngắt chưa có handler trong firmware trỏ về handler mặc định (weak)
+static void Sim_DefaultHandler(void) {
+}
+#define SIM_WEAK_HANDLER(name)  void name(void) __attribute__((weak, alias("Sim_DefaultHandler")))
+SIM_WEAK_HANDLER(GPDMA1_Channel0_IRQHandler);
+SIM_WEAK_HANDLER(GPDMA1_Channel1_IRQHandler);
+SIM_WEAK_HANDLER(GPDMA1_Channel2_IRQHandler);
+SIM_WEAK_HANDLER(GPDMA1_Channel3_IRQHandler);
+SIM_WEAK_HANDLER(GPDMA1_Channel4_IRQHandler);
+SIM_WEAK_HANDLER(TIM2_IRQHandler);
+SIM_WEAK_HANDLER(TIM3_IRQHandler);
+SIM_WEAK_HANDLER(TIM6_IRQHandler);
+SIM_WEAK_HANDLER(USART1_IRQHandler);
+SIM_WEAK_HANDLER(USART3_IRQHandler);
+SIM_WEAK_HANDLER(ADC1_IRQHandler);
+
+static void (*const irq_handlers[SIM_IRQ_COUNT])(void) = {
+    [GPDMA1_Channel0_IRQn] = GPDMA1_Channel0_IRQHandler,
+    [GPDMA1_Channel1_IRQn] = GPDMA1_Channel1_IRQHandler,
+    [GPDMA1_Channel2_IRQn] = GPDMA1_Channel2_IRQHandler,
+    [GPDMA1_Channel3_IRQn] = GPDMA1_Channel3_IRQHandler,
+    [GPDMA1_Channel4_IRQn] = GPDMA1_Channel4_IRQHandler,
+    [TIM2_IRQn]            = TIM2_IRQHandler,
+    [TIM3_IRQn]            = TIM3_IRQHandler,
+    [TIM6_IRQn]            = TIM6_IRQHandler,
+    [USART1_IRQn]          = USART1_IRQHandler,
+    [USART3_IRQn]          = USART3_IRQHandler,
+    [ADC1_IRQn]            = ADC1_IRQHandler,
+};
+
+static uint8_t Sim_IrqValid(int32_t irqn) {
+    return irqn >= 0 && irqn < (int32_t)SIM_IRQ_COUNT;
+}
+
+void Sim_NvicEnable(int32_t irqn) {
+    if (Sim_IrqValid(irqn)) irq_enabled[irqn] = 1;
+}
+
+void Sim_NvicDisable(int32_t irqn) {
+    if (Sim_IrqValid(irqn)) irq_enabled[irqn] = 0;
+}
+
+uint32_t Sim_NvicIsEnabled(int32_t irqn) {
+    return Sim_IrqValid(irqn) ? irq_enabled[irqn] : 0U;
+}
+
+void Sim_NvicSetPending(int32_t irqn) {
+    if (!Sim_IrqValid(irqn) || irq_pending[irqn]) return;
+    irq_pending[irqn] = 1;
+    irq_pending_count++;
+}
+
+void Sim_NvicClearPending(int32_t irqn) {
+    if (!Sim_IrqValid(irqn) || !irq_pending[irqn]) return;
+    irq_pending[irqn] = 0;
+    irq_pending_count--;
+}
+
+uint32_t Sim_NvicIsPending(int32_t irqn) {
+    return Sim_IrqValid(irqn) ? irq_pending[irqn] : 0U;
+}
+
+void Sim_NvicSetPriority(int32_t irqn, uint32_t priority) {
+    if (Sim_IrqValid(irqn)) irq_priority[irqn] = (uint8_t)priority;
+}
+
+uint32_t Sim_NvicGetPriority(int32_t irqn) {
+    return Sim_IrqValid(irqn) ? irq_priority[irqn] : 0U;
+}
+
+void Sim_SystemReset(void) {
+    hooks.finish("NVIC_SystemReset");
+    exit(3);
+}
+
+void Sim_RaiseIrq(IRQn_Type irqn) {
+    Sim_NvicSetPending(irqn);
+}
+
+uint8_t Sim_InIsr(void) {
+    return in_isr;
+}
+
+static void Sim_SyncRegisters(void);
+
+static int32_t Sim_NextIrq(void) {
+    int32_t best = -1;
+    if (irq_pending_count == 0U) return -1;
+    for (int32_t i = 0; i < (int32_t)SIM_IRQ_COUNT; i++) {
+        if (!irq_pending[i] || !irq_enabled[i]) continue;
+        if (best < 0 || irq_priority[i] < irq_priority[best]) best = i;
+    }
+    return best;
+}
+
+// Ngắt chạy hết rồi mới tới ngắt kế tiếp (ưu tiên cao trước), không lồng nhau
+static void Sim_Dispatch(void) {
+    if (in_isr || primask) return;
+    for (;;) {
+        int32_t irqn = Sim_NextIrq();
+        if (irqn < 0) return;
+        Sim_NvicClearPending(irqn);
+        stats.irqs++;
+        in_isr = 1;
+        Sim_SyncRegisters();
+        if (irq_handlers[irqn] != NULL) irq_handlers[irqn]();
+        Sim_SyncRegisters();
+        in_isr = 0;
+    }
+}
+
+void Sim_DisableIrq(void) {
+    primask = 1;
+}
+
+void Sim_EnableIrq(void) {
+    primask = 0;
+    Sim_SyncRegisters();
+    Sim_Dispatch();
+}
+
+uint32_t Sim_GetPrimask(void) {
+    return primask;
+}
+
+void Sim_SetPrimask(uint32_t value) {
+    if (value & 1U) Sim_DisableIrq();
+    else Sim_EnableIrq();
+}
+
+/*================================================ GPIO =======================================*/
+static GPIO_TypeDef* const gpio_ports[] = { GPIOA, GPIOB, GPIOC, GPIOD, GPIOH };
+#define SIM_GPIO_PORTS  (sizeof(gpio_ports) / sizeof(gpio_ports[0]))
+static uint32_t gpio_odr_seen[SIM_GPIO_PORTS];
+static uint32_t gpio_input_mask[SIM_GPIO_PORTS];
+static uint32_t gpio_input_level[SIM_GPIO_PORTS];
+
+static int Sim_GpioIndex(GPIO_TypeDef* port) {
+    for (uint32_t i = 0; i < SIM_GPIO_PORTS; i++) {
+        if (gpio_ports[i] == port) return (int)i;
+    }
+    return -1;
+}
+
+void Sim_GpioSync(void) {
+    for (uint32_t i = 0; i < SIM_GPIO_PORTS; i++) {
+        GPIO_TypeDef* p = gpio_ports[i];
+        uint32_t bsrr = p->BSRR;
+        uint32_t brr = p->BRR;
+        if (bsrr != 0U || brr != 0U) {
+            // Cùng chân vừa đặt vừa xóa: đặt thắng (như phần cứng)
+            uint32_t set = bsrr & 0xFFFFU;
+            uint32_t reset = ((bsrr >> 16) | brr) & ~set;
+            p->ODR = (p->ODR | set) & ~reset;
+            p->BSRR = 0;
+            p->BRR = 0;
+        }
+        p->IDR = (p->ODR & ~gpio_input_mask[i]) | (gpio_input_level[i] & gpio_input_mask[i]);
+        if (p->ODR != gpio_odr_seen[i]) {
+            gpio_odr_seen[i] = p->ODR;
+            if (hooks.gpio_changed != NULL) hooks.gpio_changed(p, p->ODR);
+        }
+    }
+}
+
+void Sim_GpioSetInput(GPIO_TypeDef* port, uint16_t pin, uint8_t level) {
+    int i = Sim_GpioIndex(port);
+    if (i < 0) return;
+    gpio_input_mask[i] |= pin;
+    if (level) gpio_input_level[i] |= pin;
+    else gpio_input_level[i] &= ~(uint32_t)pin;
+    port->IDR = (port->ODR & ~gpio_input_mask[i]) | (gpio_input_level[i] & gpio_input_mask[i]);
+}
+
+static uint8_t Sim_IsGpioAddress(uint32_t addr) {
+    return addr >= GPIOA_BASE_NS && addr < GPIOH_BASE_NS + 0x400U;
+}
+
+/*================================================ GPDMA =======================================*/
+typedef struct {
+    DMA_HandleTypeDef* hdma;
+    uint8_t active;
+    uint8_t it;
+    uint8_t src_width, dst_width;
+    uint8_t src_inc, dst_inc;
+    uint32_t request;
+    uint32_t src, dst, left;
+} Sim_DmaChannel;
+
+static Sim_DmaChannel dma_channels[SIM_DMA_CHANNELS];
+static DMA_Channel_TypeDef* const dma_instances[SIM_DMA_CHANNELS] = {
+    GPDMA1_Channel0, GPDMA1_Channel1, GPDMA1_Channel2, GPDMA1_Channel3,
+    GPDMA1_Channel4, GPDMA1_Channel5, GPDMA1_Channel6, GPDMA1_Channel7,
+};
+
+static int Sim_DmaIndex(const DMA_HandleTypeDef* hdma) {
+    for (uint32_t i = 0; i < SIM_DMA_CHANNELS; i++) {
+        if (dma_instances[i] == hdma->Instance) return (int)i;
+    }
+    return -1;
+}
+
+static void Sim_DmaFlag(int index, uint32_t flag) {
+    dma_instances[index]->CSR |= flag;
+    Sim_RaiseIrq((IRQn_Type)(GPDMA1_Channel0_IRQn + index));
+}
+
+void Sim_DmaStart(DMA_HandleTypeDef* hdma, uint32_t src, uint32_t dst, uint32_t bytes, uint8_t it) {
+    int i = Sim_DmaIndex(hdma);
+    if (i < 0) return;
+    Sim_DmaChannel* ch = &dma_channels[i];
+    ch->hdma = hdma;
+    ch->it = it;
+    ch->request = hdma->Init.Request;
+    ch->src_width = (uint8_t)(1U << (hdma->Init.SrcDataWidth >> DMA_CTR1_SDW_LOG2_Pos));
+    ch->dst_width = (uint8_t)(1U << (hdma->Init.DestDataWidth >> DMA_CTR1_DDW_LOG2_Pos));
+    ch->src_inc = (hdma->Init.SrcInc == DMA_SINC_INCREMENTED);
+    ch->dst_inc = (hdma->Init.DestInc == DMA_DINC_INCREMENTED);
+    ch->src = src;
+    ch->dst = dst;
+    ch->left = bytes;
+    ch->active = (bytes > 0U);
+    hdma->Instance->CSR = 0;
+    hdma->Instance->CBR1 = bytes & DMA_CBR1_BNDT;
+}
+
+void Sim_DmaStop(DMA_HandleTypeDef* hdma) {
+    int i = Sim_DmaIndex(hdma);
+    if (i >= 0) dma_channels[i].active = 0;
+}
+
+static uint32_t Sim_Read(uint32_t addr, uint8_t width) {
+    const void* p = (const void*)(uintptr_t)addr;
+    if (width == 1U) return *(const uint8_t*)p;
+    if (width == 2U) return *(const uint16_t*)p;
+    return *(const uint32_t*)p;
+}
+
+static void Sim_Write(uint32_t addr, uint8_t width, uint32_t value) {
+    void* p = (void*)(uintptr_t)addr;
+    if (width == 1U) *(uint8_t*)p = (uint8_t)value;
+    else if (width == 2U) *(uint16_t*)p = (uint16_t)value;
+    else *(uint32_t*)p = value;
+}
+
+// Yêu cầu phần cứng (single burst): mỗi kênh đang chờ yêu cầu này chuyển một phần tử
+static void Sim_DmaRequest(uint32_t request) {
+    for (uint32_t i = 0; i < SIM_DMA_CHANNELS; i++) {
+        Sim_DmaChannel* ch = &dma_channels[i];
+        if (!ch->active || ch->request != request) continue;
+        Sim_Write(ch->dst, ch->dst_width, Sim_Read(ch->src, ch->src_width));
+        stats.dma_transfers++;
+        if (Sim_IsGpioAddress(ch->dst)) Sim_GpioSync();
+        if (ch->src_inc) ch->src += ch->src_width;
+        if (ch->dst_inc) ch->dst += ch->dst_width;
+        ch->left = (ch->left > ch->src_width) ? ch->left - ch->src_width : 0U;
+        dma_instances[i]->CBR1 = (dma_instances[i]->CBR1 & ~DMA_CBR1_BNDT) | ch->left;
+        if (ch->left == 0U) {
+            ch->active = 0;
+            if (ch->it) Sim_DmaFlag((int)i, DMA_CSR_TCF);
+            else dma_instances[i]->CSR |= DMA_CSR_TCF;
+        }
+    }
+}
+
+/*================================================ ADC1 =======================================*/
+static struct {
+    ADC_HandleTypeDef* hadc;
+    uint16_t* buffer;
+    uint32_t length;
+    uint32_t pos;
+    uint8_t running;
+    uint64_t soft_at;       // Khởi động bằng phần mềm: thời điểm lượt quét xong (SIM_NEVER = không chờ)
+} adc;
+
+void Sim_AdcStart(ADC_HandleTypeDef* hadc, uint16_t* buffer, uint32_t length) {
+    adc.hadc = hadc;
+    adc.buffer = buffer;
+    adc.length = length;
+    adc.pos = 0;
+    adc.running = (buffer != NULL && length > 0U);
+    adc.soft_at = (adc.running && hadc->Init.ExternalTrigConv == ADC_SOFTWARE_START) ? now_ns + SIM_ADC_SCAN_NS
+                                                                                     : SIM_NEVER;
+}
+
+void Sim_AdcStop(ADC_HandleTypeDef* hadc) {
+    if (adc.hadc == hadc) {
+        adc.running = 0;
+        adc.soft_at = SIM_NEVER;
+    }
+}
+
+// Một lượt quét đủ các rank (TRGO của TIM7 hoặc khởi động bằng phần mềm), DMA ghi vào bộ đệm,
+// HT/TC ở 2 nửa. DMAContinuousRequests tắt: DMA dừng khi đầy bộ đệm như chế độ normal.
+static void Sim_AdcTrigger(void) {
+    uint16_t scan[16] = {0};
+    if (!adc.running) return;
+    uint8_t count = (uint8_t)adc.hadc->Init.NbrOfConversion;
+    if (count > 16U) count = 16U;
+    if (hooks.adc_scan != NULL) hooks.adc_scan(scan, count);
+    stats.adc_scans++;
+    int ch = (adc.hadc->DMA_Handle != NULL) ? Sim_DmaIndex(adc.hadc->DMA_Handle) : -1;
+    for (uint8_t i = 0; i < count; i++) {
+        adc.buffer[adc.pos++] = scan[i];
+        adc.hadc->Instance->DR = scan[i];
+        if (adc.pos == adc.length / 2U && ch >= 0) Sim_DmaFlag(ch, DMA_CSR_HTF);
+        if (adc.pos == adc.length) {
+            adc.pos = 0;
+            if (ch >= 0) Sim_DmaFlag(ch, DMA_CSR_TCF);
+            if (adc.hadc->Init.DMAContinuousRequests == DISABLE) {
+                adc.running = 0;
+                return;
+            }
+        }
+    }
+}
+
+/*================================================ Timer =======================================*/
+typedef struct {
+    TIM_TypeDef* regs;
+    IRQn_Type irqn;
+    uint32_t max;           // Giá trị lớn nhất của bộ đếm (16 hoặc 32 bit)
+    uint32_t req_up;        // Yêu cầu GPDMA của UP, CC1..CC4 (0 = không nối)
+    uint32_t req_cc[4];
+    uint8_t adc_trigger;    // TRGO nối vào ADC1
+    uint64_t frac;          // ns đã trôi trong tick hiện tại
+    uint32_t sr;            // SR theo phần cứng (firmware xóa cờ bằng cách ghi 0)
+} Sim_Timer;
+
+static Sim_Timer timers[] = {
+    { .regs = TIM2, .irqn = TIM2_IRQn, .max = 0xFFFFFFFFU },
+    { .regs = TIM3, .irqn = TIM3_IRQn, .max = 0xFFFFU, .req_up = GPDMA1_REQUEST_TIM3_UP,
+      .req_cc = { GPDMA1_REQUEST_TIM3_CH1, GPDMA1_REQUEST_TIM3_CH2, GPDMA1_REQUEST_TIM3_CH3, GPDMA1_REQUEST_TIM3_CH4 } },
+    { .regs = TIM6, .irqn = TIM6_IRQn, .max = 0xFFFFU },
+    { .regs = TIM7, .irqn = TIM7_IRQn, .max = 0xFFFFU, .adc_trigger = 1 },
+};
+#define SIM_TIMERS  (sizeof(timers) / sizeof(timers[0]))
+
+static uint64_t Sim_TimerTickNs(const Sim_Timer* t) {
+    // Timer APB1 chạy bằng PCLK1 = SYSCLK (PPRE1 = 1)
+    uint64_t clock = SystemCoreClock ? SystemCoreClock : 1U;
+    uint64_t tick = ((uint64_t)t->regs->PSC + 1U) * 1000000000ULL / clock;
+    return tick ? tick : 1U;
+}
+
+static uint32_t Sim_TimerCcMask(const Sim_Timer* t, uint8_t x) {
+    return (TIM_DIER_CC1IE << x) | (TIM_DIER_CC1DE << x);
+}
+
+static uint8_t Sim_TimerUpdateUsed(const Sim_Timer* t) {
+    TIM_TypeDef* r = t->regs;
+    if (r->DIER & (TIM_DIER_UIE | TIM_DIER_UDE)) return 1;
+    if (r->CR1 & TIM_CR1_OPM) return 1;
+    return t->adc_trigger && (r->CR2 & TIM_CR2_MMS) == TIM_TRGO_UPDATE;
+}
+
+// Số tick tới sự kiện kế tiếp có người dùng (tràn hoặc so sánh)
+static uint64_t Sim_TimerTicksToEvent(const Sim_Timer* t) {
+    TIM_TypeDef* r = t->regs;
+    uint64_t best = SIM_NEVER;
+    if ((r->CR1 & TIM_CR1_CEN) == 0U) return SIM_NEVER;
+    uint64_t cnt = r->CNT & t->max, arr = r->ARR & t->max;
+    uint64_t period = arr + 1U;
+    if (Sim_TimerUpdateUsed(t)) best = (cnt <= arr) ? arr - cnt + 1U : (uint64_t)t->max - cnt + 1U;
+    if (cnt > arr) return best;
+    for (uint8_t x = 0; x < 4U; x++) {
+        if ((r->DIER & Sim_TimerCcMask(t, x)) == 0U) continue;
+        uint64_t ccr = (&r->CCR1)[x] & t->max;
+        if (ccr > arr) continue;
+        uint64_t d = (ccr + period - cnt - 1U) % period + 1U;
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+static uint64_t Sim_TimerNextEvent(const Sim_Timer* t) {
+    uint64_t ticks = Sim_TimerTicksToEvent(t);
+    if (ticks == SIM_NEVER) return SIM_NEVER;
+    return now_ns + ticks * Sim_TimerTickNs(t) - t->frac;
+}
+
+static void Sim_TimerFlag(Sim_Timer* t, uint32_t flag) {
+    t->sr |= flag;
+    t->regs->SR = t->sr;
+}
+
+static void Sim_TimerUpdate(Sim_Timer* t) {
+    TIM_TypeDef* r = t->regs;
+    Sim_TimerFlag(t, TIM_SR_UIF);
+    if (r->DIER & TIM_DIER_UIE) Sim_RaiseIrq(t->irqn);
+    if ((r->DIER & TIM_DIER_UDE) && t->req_up) Sim_DmaRequest(t->req_up);
+    if (r->CR1 & TIM_CR1_OPM) r->CR1 &= ~TIM_CR1_CEN;
+    if (t->adc_trigger && (r->CR2 & TIM_CR2_MMS) == TIM_TRGO_UPDATE) Sim_AdcTrigger();
+}
+
+static void Sim_TimerCompare(Sim_Timer* t, uint8_t x) {
+    TIM_TypeDef* r = t->regs;
+    Sim_TimerFlag(t, TIM_SR_CC1IF << x);
+    if (r->DIER & (TIM_DIER_CC1IE << x)) Sim_RaiseIrq(t->irqn);
+    if ((r->DIER & (TIM_DIER_CC1DE << x)) && t->req_cc[x]) Sim_DmaRequest(t->req_cc[x]);
+}
+
+static void Sim_TimerAdvance(Sim_Timer* t, uint64_t dt) {
+    TIM_TypeDef* r = t->regs;
+    if ((r->CR1 & TIM_CR1_CEN) == 0U) return;
+    uint64_t tick = Sim_TimerTickNs(t);
+    t->frac += dt;
+    uint64_t ticks = t->frac / tick;
+    t->frac %= tick;
+    if (ticks == 0U) return;
+
+    uint64_t cnt = r->CNT & t->max, arr = r->ARR & t->max;
+    uint64_t period = arr + 1U;
+    if (cnt <= arr) {
+        for (uint8_t x = 0; x < 4U; x++) {
+            if ((r->DIER & Sim_TimerCcMask(t, x)) == 0U) continue;
+            uint64_t ccr = (&r->CCR1)[x] & t->max;
+            if (ccr > arr) continue;
+            if ((ccr + period - cnt - 1U) % period + 1U <= ticks) Sim_TimerCompare(t, x);
+        }
+        uint64_t lin = cnt + ticks;
+        r->CNT = (uint32_t)(lin % period);
+        if (lin > arr) Sim_TimerUpdate(t);
+    } else {
+        uint64_t lin = cnt + ticks;
+        r->CNT = (uint32_t)(lin > t->max ? (lin - t->max - 1U) % period : lin);
+        if (lin > t->max) Sim_TimerUpdate(t);
+    }
+}
+
+// Firmware ghi SR (xóa cờ bằng 0) và EGR (UG) giữa 2 điểm móc: áp theo ngữ nghĩa phần cứng
+static void Sim_TimerSync(Sim_Timer* t) {
+    TIM_TypeDef* r = t->regs;
+    if (r->SR != t->sr) {
+        t->sr &= r->SR;
+        r->SR = t->sr;
+    }
+    if (r->EGR & TIM_EGR_UG) {
+        r->CNT = 0;
+        t->frac = 0;
+        r->EGR = 0;
+    }
+}
+
+/*================================================ UART =======================================*/
+typedef struct {
+    USART_TypeDef* instance;
+    IRQn_Type irqn;
+    uint8_t busy;
+    uint8_t done;
+    uint64_t done_at;
+} Sim_Uart;
+
+static Sim_Uart uarts[] = {
+    { .instance = USART1, .irqn = USART1_IRQn },
+    { .instance = USART3, .irqn = USART3_IRQn },
+};
+#define SIM_UARTS   (sizeof(uarts) / sizeof(uarts[0]))
+
+static Sim_Uart* Sim_UartFind(const UART_HandleTypeDef* huart) {
+    for (uint32_t i = 0; i < SIM_UARTS; i++) {
+        if (uarts[i].instance == huart->Instance) return &uarts[i];
+    }
+    return NULL;
+}
+
+HAL_StatusTypeDef Sim_UartTransmit(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t len) {
+    Sim_Uart* u = Sim_UartFind(huart);
+    if (u == NULL || len == 0U) return HAL_ERROR;
+    if (u->busy) return HAL_BUSY;
+    uint32_t baud = huart->Init.BaudRate ? huart->Init.BaudRate : 9600U;
+    u->busy = 1;
+    u->done_at = now_ns + (uint64_t)len * 10U * 1000000000ULL / baud;
+    stats.uart_bytes += len;
+    if (hooks.uart_tx != NULL) hooks.uart_tx(huart->Instance, data, len);
+    return HAL_OK;
+}
+
+void Sim_UartAbortTx(UART_HandleTypeDef* huart) {
+    Sim_Uart* u = Sim_UartFind(huart);
+    if (u == NULL) return;
+    u->busy = 0;
+    u->done = 0;
+}
+
+uint8_t Sim_UartTakeTxDone(UART_HandleTypeDef* huart) {
+    Sim_Uart* u = Sim_UartFind(huart);
+    if (u == NULL || !u->done) return 0;
+    u->done = 0;
+    return 1;
+}
+
+/*================================================ IWDG =======================================*/
+static uint8_t iwdg_started;
+static uint64_t iwdg_timeout, iwdg_last;
+
+void Sim_IwdgStart(uint64_t timeout_ns) {
+    iwdg_started = 1;
+    iwdg_timeout = timeout_ns;
+    iwdg_last = now_ns;
+}
+
+void Sim_IwdgRefresh(void) {
+    iwdg_last = now_ns;
+}
+
+/*================================================ Thời gian =======================================*/
+static void Sim_SyncRegisters(void) {
+    for (uint32_t i = 0; i < SIM_TIMERS; i++) Sim_TimerSync(&timers[i]);
+    Sim_GpioSync();
+}
+
+static uint64_t Sim_NextEvent(void) {
+    uint64_t next = (now_ns / SIM_NS_PER_MS + 1U) * SIM_NS_PER_MS;
+    for (uint32_t i = 0; i < SIM_TIMERS; i++) {
+        uint64_t t = Sim_TimerNextEvent(&timers[i]);
+        if (t < next) next = t;
+    }
+    for (uint32_t i = 0; i < SIM_UARTS; i++) {
+        if (uarts[i].busy && uarts[i].done_at < next) next = uarts[i].done_at;
+    }
+    if (adc.soft_at < next) next = adc.soft_at;
+    return next;
+}
+
+// Đi tới target (không vượt sự kiện kế tiếp) và xử lý các sự kiện đến hạn tại đó
+static void Sim_Step(uint64_t target) {
+    uint64_t dt = target - now_ns;
+    uint64_t cycles = dt * SystemCoreClock + cycle_frac;
+    DWT->CYCCNT += (uint32_t)(cycles / 1000000000ULL);
+    cycle_frac = cycles % 1000000000ULL;
+    for (uint32_t i = 0; i < SIM_TIMERS; i++) Sim_TimerAdvance(&timers[i], dt);
+    now_ns = target;
+    if (adc.soft_at <= now_ns) {
+        adc.soft_at = SIM_NEVER;
+        Sim_AdcTrigger();
+    }
+    for (uint32_t i = 0; i < SIM_UARTS; i++) {
+        Sim_Uart* u = &uarts[i];
+        if (u->busy && u->done_at <= now_ns) {
+            u->busy = 0;
+            u->done = 1;
+            Sim_RaiseIrq(u->irqn);
+        }
+    }
+    if (now_ns % SIM_NS_PER_MS == 0U) {
+        if (hooks.tick_1ms != NULL) hooks.tick_1ms(now_ns);
+        if (iwdg_started && now_ns - iwdg_last > iwdg_timeout) {
+            hooks.finish("IWDG reset: watchdog not refreshed");
+            exit(3);
+        }
+        if (now_ns >= end_ns) {
+            hooks.finish(NULL);
+            exit(0);
+        }
+    }
+}
+
+void Sim_Advance(uint64_t ns) {
+    uint64_t target = now_ns + ns;
+    Sim_SyncRegisters();
+    while (now_ns < target) {
+        uint64_t next = Sim_NextEvent();
+        Sim_Step(next < target ? next : target);
+        Sim_SyncRegisters();
+        Sim_Dispatch();
+    }
+}
+
+// WFI: ngủ tới khi có ngắt chờ (kể cả khi PRIMASK đang chặn) hoặc SysTick (mốc 1 ms)
+void Sim_Wfi(void) {
+    if (!slept) {
+        slept = 1;
+        if (hooks.first_sleep != NULL) hooks.first_sleep();
+    }
+    stats.wfi++;
+    Sim_SyncRegisters();
+    while (Sim_NextIrq() < 0) {
+        uint64_t next = Sim_NextEvent();
+        Sim_Step(next);
+        Sim_SyncRegisters();
+        if (now_ns % SIM_NS_PER_MS == 0U) break;
+    }
+    Sim_Dispatch();
+}
+
+uint64_t Sim_NowNs(void) {
+    return now_ns;
+}
+
+uint32_t Sim_NowMs(void) {
+    return (uint32_t)(now_ns / SIM_NS_PER_MS);
+}
+
+const Sim_Stats* Sim_GetStats(void) {
+    return &stats;
+}
+
+/*================================================ Chạy firmware =======================================*/
+// Stack nằm trong .bss (dưới 4 GB khi link -no-pie): firmware ép địa chỉ biến cục bộ về uint32_t được
+static uint8_t fw_stack[SIM_FW_STACK_SIZE] __attribute__((aligned(16)));
+static ucontext_t host_ctx, fw_ctx;
+static void (*fw_main)(void);
+static volatile uint64_t watchdog_seen;
+
+static void Sim_FirmwareEntry(void) {
+    fw_main();
+}
+
+// Thời gian mô phỏng đứng yên vài giây thật: firmware kẹt trong vòng lặp không có điểm móc
+// (Error_Handler, HardFault_Handler...)
+static void Sim_StallCheck(int sig) {
+    (void)sig;
+    if (watchdog_seen == now_ns) {
+        static const char msg[] = "sim: firmware stalled (no time advance for 5 s, Error_Handler?)\n";
+        if (write(STDERR_FILENO, msg, sizeof(msg) - 1U) < 0) {}
+        _exit(4);
+    }
+    watchdog_seen = now_ns;
+}
+
+void Sim_Run(void (*firmware_main)(void), const Sim_Hooks* sim_hooks, uint64_t end) {
+    hooks = *sim_hooks;
+    end_ns = end;
+    fw_main = firmware_main;
+
+    struct itimerval it = { .it_interval = { 5, 0 }, .it_value = { 5, 0 } };
+    watchdog_seen = SIM_NEVER;
+    signal(SIGALRM, Sim_StallCheck);
+    setitimer(ITIMER_REAL, &it, NULL);
+
+    getcontext(&fw_ctx);
+    fw_ctx.uc_stack.ss_sp = fw_stack;
+    fw_ctx.uc_stack.ss_size = sizeof(fw_stack);
+    fw_ctx.uc_link = &host_ctx;
+    makecontext(&fw_ctx, Sim_FirmwareEntry, 0);
+    swapcontext(&host_ctx, &fw_ctx);
+    hooks.finish("firmware main returned");
+}
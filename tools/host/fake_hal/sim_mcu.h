@@ -0,0 +1,82 @@
+/*
+ * sim_mcu.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Bộ mô phỏng STM32H503 đủ cho firmware EEV chạy trên máy tính:
+ *  - Vùng ngoại vi (0x40000000), SCS (0xE0000000) và vùng hệ thống (VREFINT_CAL) là RAM thường
+ *    ở đúng địa chỉ, firmware đọc/ghi thanh ghi như trên chip.
+ *  - Thời gian mô phỏng (ns) chỉ chạy ở các điểm móc: HAL_GetTick (+1 us mỗi lần gọi), HAL_Delay,
+ *    WFI. Giữa 2 điểm móc firmware chạy "tức thời".
+ *  - TIM2/3/6/7 (đếm, so sánh, yêu cầu DMA, TRGO), GPDMA (từng phần tử theo yêu cầu timer),
+ *    ADC1 (quét khi khởi động bằng phần mềm hoặc theo TRGO của TIM7 vào bộ đệm DMA), UART TX, IWDG.
+ *  - Ngắt: PRIMASK và NVIC mô phỏng, ngắt chờ chạy ngay khi bỏ mặt nạ, không lồng nhau.
+ *  Mô hình đối tượng (van, quá nhiệt...) nằm ngoài, nối vào qua Sim_Hooks.
+ */
+
+#ifndef SIM_MCU_H_
+#define SIM_MCU_H_
+#include "stm32h5xx_hal.h"
+#include <stdint.h>
+
+#define SIM_NS_PER_MS       1000000ULL
+#define SIM_VREFINT_CAL     1501U   // 1.21 V ở VREF+ = 3.3 V
+
+typedef struct {
+    // Mỗi 1 ms mô phỏng (cập nhật đối tượng)
+    void (*tick_1ms)(uint64_t now_ns);
+    // Một lượt quét ADC: count mã thô theo thứ tự rank
+    void (*adc_scan)(uint16_t* scan, uint8_t count);
+    // ODR của một port vừa đổi (chân động cơ, relay)
+    void (*gpio_changed)(GPIO_TypeDef* port, uint32_t odr);
+    // Byte ra khỏi chân TX của UART
+    void (*uart_tx)(USART_TypeDef* uart, const uint8_t* data, uint16_t len);
+    // Lần đầu CPU ngủ WFI (firmware đã khởi tạo xong)
+    void (*first_sleep)(void);
+    // Kết thúc mô phỏng: hết thời gian, watchdog, treo. Không trả về.
+    void (*finish)(const char* reason);
+} Sim_Hooks;
+
+// Chạy firmware_main trên stack riêng (địa chỉ thấp, ép kiểu con trỏ -> uint32_t như trên chip)
+void Sim_Run(void (*firmware_main)(void), const Sim_Hooks* hooks, uint64_t end_ns);
+
+uint64_t Sim_NowNs(void);
+uint32_t Sim_NowMs(void);
+// Thời gian trôi trong ngữ cảnh hiện tại; ngắt được phép thì chạy ngay khi đến
+void Sim_Advance(uint64_t ns);
+void Sim_RaiseIrq(IRQn_Type irqn);
+uint8_t Sim_InIsr(void);
+
+// Áp các lần ghi BSRR/BRR đang chờ vào ODR, báo hook nếu ODR đổi
+void Sim_GpioSync(void);
+void Sim_GpioSetInput(GPIO_TypeDef* port, uint16_t pin, uint8_t level);
+
+// GPDMA: một phần tử mỗi yêu cầu ngoại vi (chỉ các yêu cầu TIM3 được nối)
+void Sim_DmaStart(DMA_HandleTypeDef* hdma, uint32_t src, uint32_t dst, uint32_t bytes, uint8_t it);
+void Sim_DmaStop(DMA_HandleTypeDef* hdma);
+
+// ADC1 + kênh DMA: mỗi lần khởi động bằng phần mềm / mỗi TRGO của TIM7 ghi một lượt quét,
+// HT/TC báo qua ngắt kênh
+void Sim_AdcStart(ADC_HandleTypeDef* hadc, uint16_t* buffer, uint32_t length);
+void Sim_AdcStop(ADC_HandleTypeDef* hadc);
+
+// UART TX: xong sau len * 10 bit, ngắt UART báo TxCplt
+HAL_StatusTypeDef Sim_UartTransmit(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t len);
+void Sim_UartAbortTx(UART_HandleTypeDef* huart);
+uint8_t Sim_UartTakeTxDone(UART_HandleTypeDef* huart);
+
+void Sim_IwdgStart(uint64_t timeout_ns);
+void Sim_IwdgRefresh(void);
+
+// Thống kê
+typedef struct {
+    uint64_t irqs;
+    uint64_t wfi;
+    uint64_t dma_transfers;
+    uint64_t adc_scans;
+    uint64_t uart_bytes;
+} Sim_Stats;
+const Sim_Stats* Sim_GetStats(void);
+
+#endif /* SIM_MCU_H_ */
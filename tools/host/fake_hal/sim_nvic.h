@@ -0,0 +1,37 @@
+/*
+ * sim_nvic.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  core_cm33.h include file này khi CMSIS_NVIC_VIRTUAL được định nghĩa (xem sim_cmsis.h):
+ *  mọi hàm NVIC_* chuyển sang bảng ngắt của bộ mô phỏng.
+ */
+
+#ifndef SIM_NVIC_H_
+#define SIM_NVIC_H_
+
+void     Sim_NvicEnable(int32_t irqn);
+void     Sim_NvicDisable(int32_t irqn);
+uint32_t Sim_NvicIsEnabled(int32_t irqn);
+void     Sim_NvicSetPending(int32_t irqn);
+void     Sim_NvicClearPending(int32_t irqn);
+uint32_t Sim_NvicIsPending(int32_t irqn);
+void     Sim_NvicSetPriority(int32_t irqn, uint32_t priority);
+uint32_t Sim_NvicGetPriority(int32_t irqn);
+void     Sim_SystemReset(void);
+
+#define NVIC_SetPriorityGrouping(group)     ((void)(group))
+#define NVIC_GetPriorityGrouping()          (0U)
+#define NVIC_EnableIRQ(irqn)                Sim_NvicEnable((int32_t)(irqn))
+#define NVIC_GetEnableIRQ(irqn)             Sim_NvicIsEnabled((int32_t)(irqn))
+#define NVIC_DisableIRQ(irqn)               Sim_NvicDisable((int32_t)(irqn))
+#define NVIC_GetPendingIRQ(irqn)            Sim_NvicIsPending((int32_t)(irqn))
+#define NVIC_SetPendingIRQ(irqn)            Sim_NvicSetPending((int32_t)(irqn))
+#define NVIC_ClearPendingIRQ(irqn)          Sim_NvicClearPending((int32_t)(irqn))
+#define NVIC_GetActive(irqn)                (0U)
+#define NVIC_SetPriority(irqn, priority)    Sim_NvicSetPriority((int32_t)(irqn), (priority))
+#define NVIC_GetPriority(irqn)              Sim_NvicGetPriority((int32_t)(irqn))
+#define NVIC_SystemReset()                  Sim_SystemReset()
+
+#endif /* SIM_NVIC_H_ */
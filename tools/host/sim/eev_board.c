@@ -0,0 +1,59 @@
+/*
+ * eev_board.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Hiện thực eev_board.h cho bộ mô phỏng trên máy tính (thay Core/Src/eev_board.c).
+ *  RUN/RUN_Defrost lấy từ kịch bản, relay đi thẳng vào mô hình đối tượng,
+ *  thời gian và bộ đếm chu kỳ đọc từ đồng hồ mô phỏng mà không làm thời gian trôi.
+ */
+#include "eev_board.h"
+#include "main.h"
+#include "adc_trip.h"
+#include "sim_mcu.h"
+#include "plant.h"
+
+uint32_t EEV_Board_GetTick(void){
+	return Sim_NowMs();
+}
+
+uint32_t EEV_Board_GetCycles(void){
+	return (uint32_t)(Sim_NowNs() * (SystemCoreClock / 1000000U) / 1000U);
+}
+
+uint32_t EEV_Board_CyclesToUs(uint32_t cycles){
+	return cycles / (SystemCoreClock / 1000000U);
+}
+
+uint32_t EEV_Board_EnterCritical(void){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+void EEV_Board_ExitCritical(uint32_t state){
+	__set_PRIMASK(state);
+}
+
+EEV_PinState EEV_Board_ReadRun(void){
+	return Plant_GetInputs()->run ? EEV_PIN_SET : EEV_PIN_RESET;
+}
+
+EEV_PinState EEV_Board_ReadDefrost(void){
+	return Plant_GetInputs()->defrost ? EEV_PIN_SET : EEV_PIN_RESET;
+}
+
+EEV_PinState EEV_Board_ReadRelay(void){
+	return Plant_Get()->relay ? EEV_PIN_SET : EEV_PIN_RESET;
+}
+
+void EEV_Board_WriteRelay(EEV_PinState state){
+	// Ghi cả chân GPIO để mức chân khớp với bản trên MCU
+	HAL_GPIO_WritePin(RELAY_GPIO_Port, RELAY_Pin, (state == EEV_PIN_SET) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+	Plant_SetRelay(state == EEV_PIN_SET);
+}
+
+uint8_t EEV_Board_TripActive(void){
+	return ADC_Trip_Active() ? 1 : 0;
+}
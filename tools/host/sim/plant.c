@@ -0,0 +1,160 @@
+/*
+ * plant.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Mô hình van + dàn bay hơi cho bộ mô phỏng (xem plant.h).
+ *  - Van: rotor bám pha cuộn dây gần nhất (lệch ±1..3 nửa bước), lệch 4 là mất bước.
+ *    Ở 2 đầu hành trình rotor trượt theo pha nhưng vị trí không đổi (như khi đóng quá để về 0).
+ *  - Máy nén chạy: quá nhiệt xác lập giảm tuyến tính theo độ mở, về 0 (ngập lỏng) ở u_flood ~ tải,
+ *    có trễ vận chuyển DEAD_TIME_S và hằng số thời gian SH_TAU_S.
+ *  - Máy nén dừng: áp suất cân bằng dần, quá nhiệt và nhiệt độ đầu đẩy trôi về giá trị nghỉ.
+ *  Áp suất hút lấy từ bảng môi chất của firmware: mô hình chỉ cần nhất quán với chính firmware.
+ */
+#include "plant.h"
+#include "refrigerant.h"
+#include "sensor_config.h"
+#include "Input_parameters.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DEAD_TIME_S         4.0f
+#define DEAD_SAMPLE_S       0.1f
+#define DEAD_SAMPLES        40          // DEAD_TIME_S / DEAD_SAMPLE_S
+#define SH_TAU_S            25.0f
+#define SH_MAX_K            30.0f       // Quá nhiệt khi van gần đóng
+#define FLOOD_PER_LOAD      0.6f        // Độ mở ngập lỏng ở tải định mức
+#define TE_TAU_S            20.0f
+#define OFF_TAU_S           60.0f
+#define PH_TAU_S            30.0f
+#define TD_TAU_S            40.0f
+#define ADC_NOISE_LSB       2
+
+extern const uint8_t STEP_SEQUENCE[8][4];
+
+static Plant_Inputs inputs = { .run = 0, .defrost = 0, .load = 1.0f, .ambient = 30.0f };
+static Plant_State st;
+static uint16_t pins[4];
+static float dead_line[DEAD_SAMPLES];
+static uint8_t dead_head;
+static float dead_acc;
+static uint32_t noise_state = 0x12345678U;
+
+void Plant_Init(int32_t stroke, int32_t position, const uint16_t coil_pins[4]) {
+    memset(&st, 0, sizeof(st));
+    memcpy(pins, coil_pins, sizeof(pins));
+    st.stroke = stroke;
+    st.position = (position < 0) ? 0 : (position > stroke) ? stroke : position;
+    st.coil_phase = -1;
+    st.rotor_phase = (uint8_t)(st.position & 7);
+    st.te = inputs.ambient - 20.0f;
+    st.sh = 12.0f;
+    st.ph = 9.0f;
+    st.td = inputs.ambient;
+    st.relay = 1;
+    for (uint8_t i = 0; i < DEAD_SAMPLES; i++) dead_line[i] = (float)st.position / (float)stroke;
+}
+
+Plant_Inputs* Plant_GetInputs(void) {
+    return &inputs;
+}
+
+void Plant_SetStroke(int32_t stroke) {
+    st.stroke = (stroke < 1) ? 1 : stroke;
+    if (st.position > st.stroke) st.position = st.stroke;
+}
+
+const Plant_State* Plant_Get(void) {
+    return &st;
+}
+
+static int8_t Plant_DecodePhase(uint32_t odr) {
+    uint8_t level[4];
+    for (uint8_t i = 0; i < 4; i++) level[i] = (odr & pins[i]) ? 1U : 0U;
+    for (int8_t p = 0; p < 8; p++) {
+        if (memcmp(level, STEP_SEQUENCE[p], 4) == 0) return p;
+    }
+    return -1;  // Cả 4 chân mức cao (nhả) hoặc tổ hợp lạ: rotor tự do, giữ nguyên chỗ
+}
+
+void Plant_Coils(uint32_t odr) {
+    int8_t phase = Plant_DecodePhase(odr);
+    if (phase == st.coil_phase) return;
+    st.coil_phase = phase;
+    if (phase < 0) return;
+
+    int8_t delta = (int8_t)(((uint8_t)phase - st.rotor_phase) & 7U);
+    if (delta > 4) delta = (int8_t)(delta - 8);
+    if (delta == 4) {
+        // Đối xứng: rotor không biết quay chiều nào, coi như đứng yên
+        st.missteps++;
+        st.rotor_phase = (uint8_t)phase;
+        return;
+    }
+    st.rotor_phase = (uint8_t)phase;
+    int32_t target = st.position + delta;
+    if (target < 0 || target > st.stroke) {
+        st.end_slips += (uint32_t)abs(delta);
+        target = (target < 0) ? 0 : st.stroke;
+    }
+    st.steps += (uint64_t)abs(target - st.position);
+    st.position = target;
+}
+
+void Plant_SetRelay(uint8_t level) {
+    st.relay = level ? 1U : 0U;
+}
+
+static float Plant_Lag(float x, float target, float tau, float dt) {
+    return x + (target - x) * (dt / (tau + dt));
+}
+
+void Plant_Step(float dt) {
+    // Trễ vận chuyển của độ mở: lấy mẫu mỗi DEAD_SAMPLE_S
+    float u = (float)st.position / (float)st.stroke;
+    dead_acc += dt;
+    if (dead_acc >= DEAD_SAMPLE_S) {
+        dead_acc -= DEAD_SAMPLE_S;
+        dead_line[dead_head] = u;
+        dead_head = (uint8_t)((dead_head + 1U) % DEAD_SAMPLES);
+    }
+    float ud = dead_line[dead_head];
+
+    if (inputs.run) {
+        float u_flood = FLOOD_PER_LOAD * ((inputs.load > 0.1f) ? inputs.load : 0.1f);
+        float sh_ss = SH_MAX_K * (1.0f - ud / u_flood);
+        if (sh_ss < 0.0f) sh_ss = 0.0f;
+        st.sh = Plant_Lag(st.sh, sh_ss, SH_TAU_S, dt);
+        st.te = Plant_Lag(st.te, -12.0f + 6.0f * ud + 2.0f * (inputs.load - 1.0f), TE_TAU_S, dt);
+        st.ph = Plant_Lag(st.ph, 15.0f + 0.2f * (inputs.ambient - 30.0f), PH_TAU_S, dt);
+        float td = 65.0f + 2.0f * st.sh - (st.relay ? 0.0f : 15.0f);
+        st.td = Plant_Lag(st.td, td, TD_TAU_S, dt);
+    } else {
+        st.sh = Plant_Lag(st.sh, 12.0f, OFF_TAU_S, dt);
+        st.te = Plant_Lag(st.te, inputs.ambient - 20.0f, 2.0f * OFF_TAU_S, dt);
+        st.ph = Plant_Lag(st.ph, 9.0f, 2.0f * OFF_TAU_S, dt);
+        st.td = Plant_Lag(st.td, inputs.ambient, 5.0f * OFF_TAU_S, dt);
+    }
+    st.pl = Refrigerant_DewPressure(st.te);
+}
+
+static uint16_t Plant_Noisy(uint16_t raw) {
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    int32_t v = (int32_t)raw + (int32_t)(noise_state % (2U * ADC_NOISE_LSB + 1U)) - ADC_NOISE_LSB;
+    return (uint16_t)((v < 0) ? 0 : (v > 4095) ? 4095 : v);
+}
+
+void Plant_AdcScan(uint16_t* scan, uint8_t count) {
+    float value[SENSOR_CH_COUNT];
+    value[SENSOR_CH_VREF] = SENSOR_VREF_NOMINAL;
+    value[SENSOR_CH_HOI_VE] = st.te + st.sh;
+    value[SENSOR_CH_DAU_DAY] = st.td;
+    value[SENSOR_CH_LOW_PRESSURE] = st.pl;
+    value[SENSOR_CH_HIGH_PRESSURE] = st.ph;
+    for (uint8_t ch = 0; ch < count && ch < SENSOR_CH_COUNT; ch++) {
+        scan[ch] = Plant_Noisy(SensorConfig_ToAdc(ch, value[ch]));
+    }
+}
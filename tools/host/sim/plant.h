@@ -0,0 +1,55 @@
+/*
+ * plant.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Mô hình đối tượng đơn giản cho bộ mô phỏng: van EEV (rotor bước theo pha cuộn dây, chặn ở
+ *  2 đầu hành trình) và dàn bay hơi (quá nhiệt bậc nhất có trễ vận chuyển, áp suất, nhiệt độ đầu đẩy).
+ *  Chỉ đủ để đóng vòng điều khiển, không phải mô hình nhiệt động học.
+ */
+
+#ifndef PLANT_H_
+#define PLANT_H_
+#include <stdint.h>
+
+// Đầu vào do kịch bản đặt
+typedef struct {
+    uint8_t run;            // Tín hiệu RUN từ bộ điều khiển máy nén
+    uint8_t defrost;        // Tín hiệu RUN_Defrost
+    float load;             // Tải dàn lạnh, 1 = định mức
+    float ambient;          // Nhiệt độ môi trường (°C), quyết định áp suất cao
+} Plant_Inputs;
+
+typedef struct {
+    // Van
+    int32_t stroke;         // Hành trình vật lý (nửa bước)
+    int32_t position;       // Vị trí rotor thật (nửa bước)
+    int8_t  coil_phase;     // Pha đang cấp (0-7), -1 = nhả cuộn dây
+    uint8_t rotor_phase;    // Pha rotor đang bám
+    uint64_t steps;         // Số nửa bước rotor đã đi
+    uint32_t missteps;      // Nhảy pha 4 nửa bước (rotor không biết đi chiều nào)
+    uint32_t end_slips;     // Bước bị chặn ở đầu hành trình
+    // Dàn bay hơi
+    float te;               // Nhiệt độ bay hơi (°C)
+    float sh;               // Quá nhiệt thật (K)
+    float pl;               // Áp suất hút (bar)
+    float ph;               // Áp suất cao (bar)
+    float td;               // Nhiệt độ đầu đẩy (°C)
+    uint8_t relay;          // Mức chân relay (0 = bật làm mát đầu đẩy)
+} Plant_State;
+
+void Plant_Init(int32_t stroke, int32_t position, const uint16_t coil_pins[4]);
+Plant_Inputs* Plant_GetInputs(void);
+// Đổi hành trình vật lý của van (vị trí bị chặn lại nếu vượt)
+void Plant_SetStroke(int32_t stroke);
+const Plant_State* Plant_Get(void);
+// ODR của port động cơ vừa đổi
+void Plant_Coils(uint32_t odr);
+void Plant_SetRelay(uint8_t level);
+// Cập nhật dàn bay hơi sau dt giây
+void Plant_Step(float dt);
+// Mã ADC thô của một lượt quét (thứ tự rank = SENSOR_CH_x)
+void Plant_AdcScan(uint16_t* scan, uint8_t count);
+
+#endif /* PLANT_H_ */
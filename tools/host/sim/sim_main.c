@@ -0,0 +1,433 @@
+/*
+ * sim_main.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Chạy firmware EEV (Core/Src) trên máy tính với HAL giả (tools/host/fake_hal) và mô hình
+ *  van + dàn bay hơi (plant.c), theo một kịch bản bật/tắt máy nén, rồi in báo cáo:
+ *  thời gian ổn định và sai số RMS của quá nhiệt mỗi chu kỳ chạy, quá nhiệt nhỏ nhất,
+ *  lệch vị trí van firmware/thật, mất bước, thời gian từng tác vụ, thời gian thực của PID.
+ *
+ *  eev_sim [--scenario file] [--hours h | --minutes m] [--valve pos] [--trace file.csv]
+ *          [--trace-period s] [--log file|-] [--check] [--check-control]
+ *
+ *  Kịch bản: mỗi dòng "<giây> key=value ..." (run, defrost, load, ambient, stroke = hành trình
+ *  vật lý của van, regN = Master ghi Holding Register N), "loop <giây>" lặp lại cả file với
+ *  chu kỳ đó, "#" là chú thích.
+ *  --check: trả mã lỗi 1 nếu watchdog/treo, vị trí van firmware lệch rotor thật hoặc mất bước.
+ *  --check-control: thêm điều kiện mỗi chu kỳ chạy đủ dài phải ổn định và không gần ngập lỏng.
+ */
+#define _GNU_SOURCE
+#include "sim_mcu.h"
+#include "plant.h"
+#include "main.h"
+#include "scheduler.h"
+#include "eev_control.h"
+#include "Modbus_Slave_Final.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_MAX_EVENTS      256
+#define SIM_MAX_PERIODS     256
+#define SETTLE_BAND_K       1.0f        // |SH - setpoint| để coi là đã ổn định
+#define SETTLE_HOLD_S       60.0f       // Phải nằm trong dải liên tục chừng này
+#define CHECK_SETTLE_MAX_S  900.0f
+#define CHECK_MIN_SH_K      0.5f        // Sau khi ổn định không được gần ngập lỏng
+
+int eev_firmware_main(void);
+extern Sched_HandleTypeDef scheduler;
+extern ModbusHandle modbus_slave;
+
+/*================================================ Kịch bản =======================================*/
+typedef struct {
+    uint64_t at_ms;
+    char key[16];
+    float value;
+} Sim_Event;
+
+static Sim_Event events[SIM_MAX_EVENTS];
+static uint32_t event_count;
+static uint64_t loop_ms;
+static uint32_t event_next;
+static uint64_t event_base_ms;
+
+static void Scenario_Add(uint64_t at_ms, const char* key, float value) {
+    if (event_count >= SIM_MAX_EVENTS) {
+        fprintf(stderr, "sim: too many scenario events\n");
+        exit(2);
+    }
+    Sim_Event* e = &events[event_count++];
+    e->at_ms = at_ms;
+    snprintf(e->key, sizeof(e->key), "%s", key);
+    e->value = value;
+}
+
+static void Scenario_Load(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        exit(2);
+    }
+    char line[256];
+    uint32_t lineno = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        lineno++;
+        char* hash = strchr(line, '#');
+        if (hash != NULL) *hash = '\0';
+        char* tok = strtok(line, " \t\r\n");
+        if (tok == NULL) continue;
+        if (strcmp(tok, "loop") == 0) {
+            tok = strtok(NULL, " \t\r\n");
+            loop_ms = (tok != NULL) ? (uint64_t)(atof(tok) * 1000.0) : 0U;
+            continue;
+        }
+        uint64_t at_ms = (uint64_t)(atof(tok) * 1000.0);
+        while ((tok = strtok(NULL, " \t\r\n")) != NULL) {
+            char* eq = strchr(tok, '=');
+            if (eq == NULL) {
+                fprintf(stderr, "%s:%u: expected key=value, got '%s'\n", path, lineno, tok);
+                exit(2);
+            }
+            *eq = '\0';
+            Scenario_Add(at_ms, tok, (float)atof(eq + 1));
+        }
+    }
+    fclose(f);
+    for (uint32_t i = 1; i < event_count; i++) {
+        if (events[i].at_ms < events[i - 1].at_ms) {
+            fprintf(stderr, "%s: events must be in time order\n", path);
+            exit(2);
+        }
+    }
+}
+
+// Trả về 0 nếu chưa áp dụng được lúc này (thử lại ở ms sau)
+static uint8_t Scenario_Apply(const Sim_Event* e) {
+    Plant_Inputs* in = Plant_GetInputs();
+    if (strncmp(e->key, "reg", 3) == 0) {
+        // Như ngắt UART của Master: không chen vào critical section của firmware
+        if (Sim_GetPrimask() != 0U || Sim_InIsr()) return 0;
+        uint16_t value = (uint16_t)e->value;
+        if (!Modbus_PublishHoldingRegs(&modbus_slave, (uint16_t)atoi(e->key + 3), &value, 1)) {
+            fprintf(stderr, "sim: bad holding register '%s'\n", e->key);
+            exit(2);
+        }
+    }
+    else if (strcmp(e->key, "stroke") == 0) Plant_SetStroke((int32_t)e->value);
+    else if (strcmp(e->key, "run") == 0) in->run = (e->value != 0.0f);
+    else if (strcmp(e->key, "defrost") == 0) in->defrost = (e->value != 0.0f);
+    else if (strcmp(e->key, "load") == 0) in->load = e->value;
+    else if (strcmp(e->key, "ambient") == 0) in->ambient = e->value;
+    else {
+        fprintf(stderr, "sim: unknown scenario key '%s'\n", e->key);
+        exit(2);
+    }
+    return 1;
+}
+
+static void Scenario_Tick(uint64_t now_ms) {
+    while (event_count > 0U) {
+        if (event_next >= event_count) {
+            if (loop_ms == 0U) return;
+            event_next = 0;
+            event_base_ms += loop_ms;
+        }
+        const Sim_Event* e = &events[event_next];
+        if (event_base_ms + e->at_ms > now_ms) return;
+        if (!Scenario_Apply(e)) return;
+        event_next++;
+    }
+}
+
+/*================================================ Đánh giá =======================================*/
+typedef struct {
+    float start_s;
+    float duration_s;
+    float settle_s;         // < 0: chưa ổn định
+    float rms_k;            // Sau khi ổn định
+    float min_sh_k;         // Sau khi ổn định
+} Run_Period;
+
+static Run_Period periods[SIM_MAX_PERIODS];
+static uint32_t period_count;
+static struct {
+    uint8_t active;
+    float start_s;
+    float band_since_s;     // < 0: đang ngoài dải
+    float settle_s;
+    double err_sq;
+    uint32_t samples;
+    float min_sh;
+} cur;
+static float min_sh_running = 1e9f;
+static int32_t pos_err_max;
+static uint32_t pos_checks;
+
+static void Period_Close(float now_s) {
+    if (!cur.active) return;
+    cur.active = 0;
+    if (now_s - cur.start_s < 1.0f || period_count >= SIM_MAX_PERIODS) return;
+    Run_Period* p = &periods[period_count++];
+    p->start_s = cur.start_s;
+    p->duration_s = now_s - cur.start_s;
+    p->settle_s = cur.settle_s;
+    p->rms_k = (cur.samples > 0U) ? (float)sqrt(cur.err_sq / cur.samples) : NAN;
+    p->min_sh_k = (cur.samples > 0U) ? cur.min_sh : NAN;
+}
+
+// Mỗi 100 ms
+static void Evaluate(float now_s) {
+    const Plant_Inputs* in = Plant_GetInputs();
+    const Plant_State* ps = Plant_Get();
+    const EEV_Axis* ax = &eev_axes[0];
+    uint8_t running = in->run && !in->defrost;
+
+    if (running && !cur.active) {
+        memset(&cur, 0, sizeof(cur));
+        cur.active = 1;
+        cur.start_s = now_s;
+        cur.band_since_s = -1.0f;
+        cur.settle_s = -1.0f;
+        cur.min_sh = 1e9f;
+    } else if (!running && cur.active) {
+        Period_Close(now_s);
+    }
+    if (cur.active) {
+        float err = ps->sh - ax->pid.setpoint;
+        if (cur.settle_s < 0.0f) {
+            if (ax->state == STATE_CONTROL_EEV && fabsf(err) <= SETTLE_BAND_K) {
+                if (cur.band_since_s < 0.0f) cur.band_since_s = now_s;
+                if (now_s - cur.band_since_s >= SETTLE_HOLD_S) cur.settle_s = cur.band_since_s - cur.start_s;
+            } else {
+                cur.band_since_s = -1.0f;
+            }
+        } else {
+            cur.err_sq += (double)err * err;
+            cur.samples++;
+            if (ps->sh < cur.min_sh) cur.min_sh = ps->sh;
+        }
+        if (ax->state == STATE_CONTROL_EEV && ps->sh < min_sh_running) min_sh_running = ps->sh;
+    }
+    // Vị trí firmware tin là đúng phải khớp rotor thật mỗi khi van đứng yên
+    if (ax->position_known && !ax->motor.is_moving) {
+        int32_t e = abs((int32_t)ax->motor.position - ps->position);
+        if (e > pos_err_max) pos_err_max = e;
+        pos_checks++;
+    }
+}
+
+/*================================================ Thời gian tác vụ (đồng hồ máy tính) =======================================*/
+static const char* const task_names[] = {
+    "pid", "modbus_rx", "adc", "control", "modbus", "log", "recovery", "watchdog"
+};
+
+typedef struct {
+    Sched_TaskFn func;
+    uint64_t runs;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} Task_Timing;
+
+static Task_Timing task_timing[SCHED_MAX_TASKS];
+
+static uint64_t Host_Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void Task_Timed(uint8_t i) {
+    uint64_t t0 = Host_Ns();
+    task_timing[i].func();
+    uint64_t dt = Host_Ns() - t0;
+    task_timing[i].runs++;
+    task_timing[i].total_ns += dt;
+    if (dt > task_timing[i].max_ns) task_timing[i].max_ns = dt;
+}
+
+#define TASK_WRAPPER(n) static void task_wrapper_##n(void) { Task_Timed(n); }
+TASK_WRAPPER(0) TASK_WRAPPER(1) TASK_WRAPPER(2) TASK_WRAPPER(3)
+TASK_WRAPPER(4) TASK_WRAPPER(5) TASK_WRAPPER(6) TASK_WRAPPER(7)
+TASK_WRAPPER(8) TASK_WRAPPER(9) TASK_WRAPPER(10) TASK_WRAPPER(11)
+TASK_WRAPPER(12) TASK_WRAPPER(13) TASK_WRAPPER(14) TASK_WRAPPER(15)
+
+static const Sched_TaskFn task_wrappers[SCHED_MAX_TASKS] = {
+    task_wrapper_0, task_wrapper_1, task_wrapper_2, task_wrapper_3,
+    task_wrapper_4, task_wrapper_5, task_wrapper_6, task_wrapper_7,
+    task_wrapper_8, task_wrapper_9, task_wrapper_10, task_wrapper_11,
+    task_wrapper_12, task_wrapper_13, task_wrapper_14, task_wrapper_15
+};
+
+/*================================================ Móc của bộ mô phỏng =======================================*/
+static struct {
+    float hours;
+    int32_t valve;
+    const char* scenario;
+    const char* trace;
+    float trace_period_s;
+    const char* log;
+    uint8_t check;
+    uint8_t check_control;
+} opt = { .hours = 1.0f, .valve = 250, .trace_period_s = 1.0f };
+
+static FILE* trace_file;
+static FILE* log_file;
+static uint64_t host_start_ns;
+static float init_sim_s = -1.0f;
+
+static void Hook_Tick(uint64_t now_ns) {
+    uint64_t now_ms = now_ns / SIM_NS_PER_MS;
+    Scenario_Tick(now_ms);
+    Plant_Step(0.001f);
+    if (now_ms % 100U == 0U) Evaluate((float)now_ms / 1000.0f);
+
+    uint64_t trace_ms = (uint64_t)(opt.trace_period_s * 1000.0f);
+    if (trace_file != NULL && trace_ms > 0U && now_ms % trace_ms == 0U) {
+        const Plant_Inputs* in = Plant_GetInputs();
+        const Plant_State* ps = Plant_Get();
+        const EEV_Axis* ax = &eev_axes[0];
+        fprintf(trace_file, "%.3f,%u,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.2f,%d,%d,%d,%.2f,%.3f,%.3f,%.2f,%u\n",
+                (double)now_ms / 1000.0, in->run, in->defrost, (double)in->load,
+                (double)ps->sh, (double)ax->superheat, (double)ax->pid.setpoint, (double)ax->output_pid,
+                (double)ax->pid.integral, (double)ax->pid.derivative,
+                (double)ax->motor.percent, ax->state, ax->motor.position, ps->position,
+                (double)ps->te, (double)ps->pl, (double)ps->ph, (double)ps->td, ps->relay);
+    }
+}
+
+static void Hook_Gpio(GPIO_TypeDef* port, uint32_t odr) {
+    if (port == STEPPER_1_GPIO_Port) Plant_Coils(odr);
+}
+
+static void Hook_Uart(USART_TypeDef* uart, const uint8_t* data, uint16_t len) {
+    if (uart == USART3 && log_file != NULL) fwrite(data, 1, len, log_file);
+}
+
+static void Hook_FirstSleep(void) {
+    init_sim_s = (float)Sim_NowNs() / 1e9f;
+    for (uint8_t i = 0; i < scheduler.count && i < SCHED_MAX_TASKS; i++) {
+        task_timing[i].func = scheduler.tasks[i].func;
+        scheduler.tasks[i].func = task_wrappers[i];
+    }
+}
+
+static void Hook_Finish(const char* reason) {
+    float now_s = (float)Sim_NowNs() / 1e9f;
+    double wall_s = (double)(Host_Ns() - host_start_ns) / 1e9;
+    const Plant_State* ps = Plant_Get();
+    const Sim_Stats* ss = Sim_GetStats();
+    const EEV_Control_Timing* ct = EEV_Control_GetTiming();
+    uint8_t fail = (reason != NULL);
+
+    Period_Close(now_s);
+    if (log_file != NULL) fflush(log_file);
+    if (trace_file != NULL) fclose(trace_file);
+
+    printf("\n=== eev_sim: %.1f s simulated in %.2f s (x%.0f) ===\n", (double)now_s, wall_s,
+           (wall_s > 0.0) ? (double)now_s / wall_s : 0.0);
+    printf("end: %s\n", (reason != NULL) ? reason : "time limit");
+    printf("init: %.3f s until first WFI\n", (double)init_sim_s);
+
+    printf("\nrun periods (band +-%.1f K held %.0f s):\n", (double)SETTLE_BAND_K, (double)SETTLE_HOLD_S);
+    printf("  %8s %8s %9s %8s %8s\n", "start_s", "dur_s", "settle_s", "rms_K", "minSH_K");
+    for (uint32_t i = 0; i < period_count; i++) {
+        const Run_Period* p = &periods[i];
+        printf("  %8.0f %8.0f %9.1f %8.2f %8.2f\n", (double)p->start_s, (double)p->duration_s,
+               (double)p->settle_s, (double)p->rms_k, (double)p->min_sh_k);
+        // Chu kỳ bị cắt ngắn hơn thời gian cho phép không đánh giá được
+        if (opt.check_control && p->duration_s >= CHECK_SETTLE_MAX_S + SETTLE_HOLD_S) {
+            if (p->settle_s < 0.0f || p->settle_s > CHECK_SETTLE_MAX_S) fail = 1;
+            else if (p->min_sh_k < CHECK_MIN_SH_K) fail = 1;
+        }
+    }
+    printf("min SH while controlling: %.2f K\n", (double)min_sh_running);
+
+    printf("\nvalve: position fw %d / plant %d, max mismatch %d (%u checks), steps %llu, missteps %u, end-stop slips %u\n",
+           eev_axes[0].motor.position, ps->position, pos_err_max, pos_checks,
+           (unsigned long long)ps->steps, ps->missteps, ps->end_slips);
+    if (opt.check && (pos_err_max != 0 || ps->missteps != 0U)) fail = 1;
+
+    printf("\ntasks (host time):\n  %-10s %10s %10s %10s %10s %9s\n", "task", "runs", "mean_us", "max_us", "overruns", "wcet_us");
+    for (uint8_t i = 0; i < scheduler.count && i < SCHED_MAX_TASKS; i++) {
+        const Task_Timing* t = &task_timing[i];
+        const Sched_Task* st = &scheduler.tasks[i];
+        char name[16];
+        if (i < sizeof(task_names) / sizeof(task_names[0])) snprintf(name, sizeof(name), "%s", task_names[i]);
+        else snprintf(name, sizeof(name), "task%u", i);
+        printf("  %-10s %10llu %10.2f %10.2f %10u %9u\n", name, (unsigned long long)t->runs,
+               (t->runs > 0U) ? (double)t->total_ns / (double)t->runs / 1000.0 : 0.0,
+               (double)t->max_ns / 1000.0, st->overruns, Sched_CyclesToUs(&scheduler, st->wcet_cycles));
+    }
+    // Thời gian mô phỏng: chi phí CPU của firmware không được mô hình hóa, chỉ các lần chờ/chặn
+    printf("\npid: runs %u, missed %u, latency max %u us, jitter max %u us, isr max %u cycles\n",
+           ct->pid_runs, ct->pid_missed, ct->latency_us_max, ct->jitter_us_max, ct->isr_cycles_max);
+    printf("sim: irqs %llu, wfi %llu, dma transfers %llu, adc scans %llu, uart bytes %llu\n",
+           (unsigned long long)ss->irqs, (unsigned long long)ss->wfi, (unsigned long long)ss->dma_transfers,
+           (unsigned long long)ss->adc_scans, (unsigned long long)ss->uart_bytes);
+    printf("%s\n", fail ? "RESULT: FAIL" : "RESULT: OK");
+    fflush(stdout);
+    exit(fail ? 1 : 0);
+}
+
+/*================================================ main =======================================*/
+static void Firmware_Entry(void) {
+    eev_firmware_main();
+}
+
+static void Usage(void) {
+    fprintf(stderr, "usage: eev_sim [--scenario file] [--hours h | --minutes m] [--valve pos]\n"
+                    "               [--trace file.csv] [--trace-period s] [--log file|-] [--check] [--check-control]\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(a, "--check") == 0) { opt.check = 1; continue; }
+        if (strcmp(a, "--check-control") == 0) { opt.check = 1; opt.check_control = 1; continue; }
+        if (v == NULL) Usage();
+        if (strcmp(a, "--scenario") == 0) opt.scenario = v;
+        else if (strcmp(a, "--hours") == 0) opt.hours = (float)atof(v);
+        else if (strcmp(a, "--minutes") == 0) opt.hours = (float)atof(v) / 60.0f;
+        else if (strcmp(a, "--valve") == 0) opt.valve = atoi(v);
+        else if (strcmp(a, "--trace") == 0) opt.trace = v;
+        else if (strcmp(a, "--trace-period") == 0) opt.trace_period_s = (float)atof(v);
+        else if (strcmp(a, "--log") == 0) opt.log = v;
+        else Usage();
+        i++;
+    }
+
+    if (opt.scenario != NULL) Scenario_Load(opt.scenario);
+    else Scenario_Add(0, "run", 1.0f);     // Mặc định: máy nén chạy liên tục
+
+    if (opt.trace != NULL) {
+        trace_file = fopen(opt.trace, "w");
+        if (trace_file == NULL) { perror(opt.trace); return 2; }
+        fprintf(trace_file, "t_s,run,defrost,load,sh,sh_fw,setpoint,pid_out,pid_i,pid_d,percent,state,pos_fw,pos_plant,te,pl,ph,td,relay\n");
+    }
+    if (opt.log != NULL) {
+        log_file = (strcmp(opt.log, "-") == 0) ? stdout : fopen(opt.log, "w");
+        if (log_file == NULL) { perror(opt.log); return 2; }
+    }
+
+    const uint16_t coils[4] = { STEPPER_1_Pin, STEPPER_2_Pin, STEPPER_3_Pin, STEPPER_4_Pin };
+    Plant_Init(500, opt.valve, coils);
+    Scenario_Tick(0);
+
+    static const Sim_Hooks hooks = {
+        .tick_1ms = Hook_Tick,
+        .adc_scan = Plant_AdcScan,
+        .gpio_changed = Hook_Gpio,
+        .uart_tx = Hook_Uart,
+        .first_sleep = Hook_FirstSleep,
+        .finish = Hook_Finish,
+    };
+    host_start_ns = Host_Ns();
+    Sim_Run(Firmware_Entry, &hooks, (uint64_t)((double)opt.hours * 3600.0 * 1e9));
+    return 0;
+}
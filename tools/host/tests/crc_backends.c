@@ -0,0 +1,132 @@
+/*
+ * crc_backends.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Đối chiếu Core/Src/modbus_crc.c với CRC tính từng bit, biên dịch một lần cho mỗi MODBUS_CRC_BACKEND
+ *  (TABLE/SLICE4/SLICE8, backend HW cần khối CRC thật nên chỉ kiểm tra trên chip):
+ *  - Chuỗi chuẩn "123456789" và Modbus_CRC_SelfTest.
+ *  - Frame ngẫu nhiên 0..256 byte, tính một lần và tính dần qua 1..4 lần Modbus_CRC16_Update cắt ngẫu nhiên.
+ *  - Lặp lại sau Modbus_CRC_UseFallback (đường dự phòng khi tự kiểm tra thất bại).
+ *  - In thời gian tính một frame 256 byte của backend, đường dự phòng và bản từng bit, chỉ để tham khảo.
+ */
+#include "modbus_crc.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAMES          20000
+#define FRAME_MAX       256
+#define BENCH_FRAMES    200000
+
+#if MODBUS_CRC_BACKEND == MODBUS_CRC_BACKEND_TABLE
+#define BACKEND_NAME    "TABLE"
+#elif MODBUS_CRC_BACKEND == MODBUS_CRC_BACKEND_SLICE4
+#define BACKEND_NAME    "SLICE4"
+#elif MODBUS_CRC_BACKEND == MODBUS_CRC_BACKEND_SLICE8
+#define BACKEND_NAME    "SLICE8"
+#else
+#error "crc_backends: host build supports TABLE/SLICE4/SLICE8 only"
+#endif
+
+static int failures;
+static uint32_t rng = 0x9E3779B9U;
+
+static uint32_t Random(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void Check(int ok, const char* name, const char* fmt, double value) {
+    printf("%-40s %s  ", name, ok ? "PASS" : "FAIL");
+    printf(fmt, value);
+    printf("\n");
+    if (!ok) failures++;
+}
+
+static uint16_t Reference(const uint8_t* data, uint16_t length) {
+    uint16_t crc = MODBUS_CRC_INIT;
+    while (length--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 1U) ? (uint16_t)((crc >> 1) ^ 0xA001U) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static void Check_Frames(const char* path) {
+    static const uint8_t check[9] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    uint8_t frame[FRAME_MAX];
+    uint32_t whole_bad = 0, split_bad = 0;
+    char label[64];
+
+    snprintf(label, sizeof(label), "%s check string", path);
+    uint16_t check_crc = Modbus_CRC16(check, sizeof(check));
+    Check(check_crc == 0x4B37, label, "%.0f (0x4B37 = 19255)", check_crc);
+    snprintf(label, sizeof(label), "%s Modbus_CRC_SelfTest", path);
+    Check(Modbus_CRC_SelfTest(), label, "%.0f", 1);
+
+    for (uint32_t n = 0; n < FRAMES; n++) {
+        // Mọi độ dài 0..256 lần lượt, sau đó ngẫu nhiên
+        uint16_t len = (n <= FRAME_MAX) ? (uint16_t)n : (uint16_t)(Random() % (FRAME_MAX + 1U));
+        for (uint16_t i = 0; i < len; i++) frame[i] = (uint8_t)Random();
+        uint16_t ref = Reference(frame, len);
+        if (Modbus_CRC16(frame, len) != ref) whole_bad++;
+
+        // Cắt thành 1..4 đoạn tại vị trí ngẫu nhiên (kể cả đoạn rỗng, lệch phần dư slicing)
+        uint16_t pos = 0, crc = MODBUS_CRC_INIT;
+        uint32_t pieces = 1U + Random() % 4U;
+        for (uint32_t k = 1; k < pieces; k++) {
+            uint16_t n_bytes = (uint16_t)(Random() % (uint32_t)(len - pos + 1U));
+            crc = Modbus_CRC16_Update(crc, frame + pos, n_bytes);
+            pos = (uint16_t)(pos + n_bytes);
+        }
+        crc = Modbus_CRC16_Update(crc, frame + pos, (uint16_t)(len - pos));
+        if (crc != ref) split_bad++;
+    }
+    snprintf(label, sizeof(label), "%s frames vs bitwise", path);
+    Check(whole_bad == 0, label, "%.0f mismatches", whole_bad);
+    snprintf(label, sizeof(label), "%s split updates vs bitwise", path);
+    Check(split_bad == 0, label, "%.0f mismatches", split_bad);
+}
+
+static volatile uint16_t sink;
+
+static double Bench(uint16_t (*fn)(const uint8_t*, uint16_t)) {
+    uint8_t frame[FRAME_MAX];
+    struct timespec t0, t1;
+    for (uint16_t i = 0; i < FRAME_MAX; i++) frame[i] = (uint8_t)Random();
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        frame[0] = (uint8_t)i;  // Đổi dữ liệu để trình biên dịch không gộp các lần tính
+        sink = fn(frame, FRAME_MAX);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+    return ns / BENCH_FRAMES;
+}
+
+static uint16_t Backend(const uint8_t* data, uint16_t length) {
+    return Modbus_CRC16(data, length);
+}
+
+int main(void) {
+    printf("backend %s (%d table(s))\n", BACKEND_NAME, MODBUS_CRC_TABLES);
+    Modbus_CRC_Init();
+    Check_Frames(BACKEND_NAME);
+    double backend_ns = Bench(Backend);
+
+    Modbus_CRC_UseFallback();
+    Check_Frames("fallback");
+    double fallback_ns = Bench(Backend);
+    double bitwise_ns = Bench(Reference);
+
+    printf("  256-byte frame: %s %.1f ns, fallback %.1f ns, bitwise %.1f ns\n", BACKEND_NAME, backend_ns,
+           fallback_ns, bitwise_ns);
+    printf("%s\n", failures ? "RESULT: FAIL" : "RESULT: OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,287 @@
+/*
+ * log_producer_bound.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Kiểm tra bên ghi của Core/Src/log_dma.c trên máy tính (PRIMASK/NVIC/UART là bản giả trong file này):
+ *  - Mỗi Log_Write cấm ngắt tối đa 2 đoạn, thời gian mỗi đoạn không tăng theo độ dài bản ghi.
+ *  - Không có byte nào của bản ghi được chép khi ngắt đang cấm.
+ *  - HAL_UART_Transmit_DMA chỉ được gọi từ ngắt LOG_IRQn, ngắt bật.
+ *  - Ngắt ghi log chen vào giữa giữ chỗ và commit: cả 2 bản ghi nguyên vẹn, đúng thứ tự.
+ *  - Vòng đệm đầy: bản ghi bị bỏ trọn vẹn, không rò chỗ đã giữ.
+ *  - Luồng byte ra UART (qua nhiều vòng) trùng với chuỗi bản ghi đã ghi.
+ */
+#include "log_dma.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define REPS        2000
+#define SENTINEL    0xEE
+
+static UART_HandleTypeDef huart_log;
+static int failures;
+
+static uint64_t Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();  // x86intrin.h đụng macro CMSIS, dùng builtin trực tiếp
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static void Check(int ok, const char* name, const char* fmt, double value) {
+    printf("%-40s %s  ", name, ok ? "PASS" : "FAIL");
+    printf(fmt, value);
+    printf("\n");
+    if (!ok) failures++;
+}
+
+/*================================ PRIMASK / NVIC giả ================================*/
+static uint32_t primask;
+static uint64_t mask_start;
+static uint64_t mask_cycles_max;    // Đoạn cấm ngắt dài nhất kể từ lần xóa gần nhất
+static uint32_t mask_sections;
+static uint8_t  log_irq_pending;
+static uint8_t  in_log_irq;
+static uint32_t masked_copy_errors; // Vùng vừa giữ chỗ đã bị chép trong đoạn cấm ngắt
+static uint32_t tx_masked_calls;    // HAL_UART_Transmit_DMA gọi khi cấm ngắt / ngoài LOG_IRQn
+static uint32_t tx_calls;
+
+// Ngắt ghi log giả lập: chạy một lần ở lần bỏ mặt nạ kế tiếp (ngay sau khi bên ghi giữ chỗ)
+static void (*preempt)(void);
+// Giữ chỗ gần nhất (kiểm tra vùng đó còn nguyên SENTINEL ở lần bỏ mặt nạ đầu tiên)
+static uint32_t check_start, check_len;
+
+static void On_Unmask(void) {
+    uint64_t elapsed = Cycles() - mask_start;
+    if (elapsed > mask_cycles_max) mask_cycles_max = elapsed;
+    mask_sections++;
+
+    if (check_len != 0 && hlog.reserve == check_start + check_len) {
+        for (uint32_t i = 0; i < check_len; i++) {
+            if (hlog.ring[(check_start + i) & (LOG_RING_SIZE - 1U)] != SENTINEL) {
+                masked_copy_errors++;
+                break;
+            }
+        }
+        check_len = 0;
+    }
+    if (preempt != NULL) {
+        void (*isr)(void) = preempt;
+        preempt = NULL;
+        isr();
+    }
+}
+
+void Sim_DisableIrq(void) {
+    if (primask == 0) mask_start = Cycles();
+    primask = 1;
+}
+
+void Sim_EnableIrq(void) {
+    if (primask == 0) return;
+    primask = 0;
+    On_Unmask();
+}
+
+uint32_t Sim_GetPrimask(void) {
+    return primask;
+}
+
+void Sim_SetPrimask(uint32_t value) {
+    if (value != 0) {
+        Sim_DisableIrq();
+    } else {
+        Sim_EnableIrq();
+    }
+}
+
+void Sim_Wfi(void) {
+}
+
+void Sim_NvicSetPending(int32_t irqn) {
+    if (irqn == (int32_t)LOG_IRQn) log_irq_pending = 1;
+}
+
+uint32_t HAL_GetTick(void) {
+    return 0;
+}
+
+/*================================ UART giả ================================*/
+static uint8_t  uart_out[1 << 16];
+static uint32_t uart_out_len;
+static const uint8_t* tx_data;
+static uint16_t tx_size;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    (void)huart;
+    tx_calls++;
+    if (primask != 0 || !in_log_irq) tx_masked_calls++;
+    if (tx_data != NULL) return HAL_BUSY;
+    tx_data = pData;
+    tx_size = Size;
+    return HAL_OK;
+}
+
+// Ngắt LOG_IRQn mức thấp: chạy sau khi bên ghi trả về
+static void Run_LogIrq(void) {
+    while (log_irq_pending) {
+        log_irq_pending = 0;
+        in_log_irq = 1;
+        Log_IRQHandler();
+        in_log_irq = 0;
+    }
+}
+
+// DMA + UART gửi xong đoạn đang chạy, TxCplt trong ngắt cùng mức LOG_IRQn
+static void Finish_Tx(void) {
+    if (tx_data == NULL) return;
+    if (uart_out_len + tx_size <= sizeof(uart_out)) {
+        memcpy(&uart_out[uart_out_len], tx_data, tx_size);
+        uart_out_len += tx_size;
+    }
+    tx_data = NULL;
+    in_log_irq = 1;
+    Log_TxCpltCallback(&huart_log);
+    in_log_irq = 0;
+}
+
+static void Drain(void) {
+    Run_LogIrq();
+    while (tx_data != NULL) {
+        Finish_Tx();
+        Run_LogIrq();
+    }
+}
+
+static void Reset(void) {
+    memset(&hlog, 0, sizeof(hlog));
+    memset(hlog.ring, SENTINEL, sizeof(hlog.ring));
+    tx_data = NULL;
+    uart_out_len = 0;
+    log_irq_pending = 0;
+    Log_Init(&huart_log);
+    Run_LogIrq();
+}
+
+// Ghi một bản ghi, ghi nhận đoạn cấm ngắt dài nhất của riêng lần gọi này
+static uint64_t Write_Measured(const uint8_t* data, uint16_t len, uint32_t* sections) {
+    memset(hlog.ring, SENTINEL, sizeof(hlog.ring));
+    check_start = hlog.reserve;
+    check_len = len;
+    mask_cycles_max = 0;
+    mask_sections = 0;
+    Log_Write(data, len);
+    *sections = mask_sections;
+    return mask_cycles_max;
+}
+
+/*================================ Các phép thử ================================*/
+static void Test_MaskedSections(void) {
+    static const uint16_t lengths[] = { 1, 16, 64, LOG_LINE_MAX };
+    uint8_t line[LOG_LINE_MAX];
+    uint64_t best[sizeof(lengths) / sizeof(lengths[0])];
+    uint32_t worst_sections = 0;
+
+    for (uint32_t i = 0; i < sizeof(line); i++) line[i] = (uint8_t)(i * 7U + 1U);
+    Reset();
+    masked_copy_errors = 0;
+    tx_masked_calls = 0;
+    tx_calls = 0;
+    for (uint32_t n = 0; n < sizeof(lengths) / sizeof(lengths[0]); n++) {
+        // Lấy min qua nhiều lần để loại nhiễu lập lịch của máy tính
+        best[n] = UINT64_MAX;
+        for (int r = 0; r < REPS; r++) {
+            uint32_t sections;
+            uint64_t cycles = Write_Measured(line, lengths[n], &sections);
+            if (cycles < best[n]) best[n] = cycles;
+            if (sections > worst_sections) worst_sections = sections;
+            Drain();
+        }
+        printf("  len %3u: masked section %4llu cycles\n", lengths[n], (unsigned long long)best[n]);
+    }
+    uint64_t growth = (best[3] > best[0]) ? best[3] - best[0] : 0;
+    Check(worst_sections <= 2, "masked sections per write", "%.0f", worst_sections);
+    Check(growth <= 32, "masked cycles 128 B vs 1 B", "+%.0f", (double)growth);
+    Check(masked_copy_errors == 0, "no copy while masked", "%.0f", masked_copy_errors);
+    Check(tx_calls > 0 && tx_masked_calls == 0, "DMA started only from LOG_IRQn", "%.0f bad", tx_masked_calls);
+}
+
+static const uint8_t rec_outer[] = "outer record from main loop\r\n";
+static const uint8_t rec_inner[] = "inner record from ISR\r\n";
+static uint32_t head_seen_by_isr;
+
+static void Isr_Writer(void) {
+    Log_Write(rec_inner, sizeof(rec_inner) - 1U);
+    head_seen_by_isr = hlog.head;
+}
+
+static void Test_NestedWriter(void) {
+    Reset();
+    check_len = 0;
+    preempt = Isr_Writer;
+    Log_Write(rec_outer, sizeof(rec_outer) - 1U);
+    // Bản ghi của ngắt chỉ được công bố khi bên ghi ngoài cùng commit
+    Check(head_seen_by_isr == 0, "ISR record held until outer commit", "head %.0f", head_seen_by_isr);
+    Check(hlog.head == hlog.reserve && hlog.writers == 0, "outer commit publishes both", "%.0f",
+          (double)hlog.head);
+    Drain();
+    uint8_t expected[sizeof(rec_outer) + sizeof(rec_inner)];
+    memcpy(expected, rec_outer, sizeof(rec_outer) - 1U);
+    memcpy(expected + sizeof(rec_outer) - 1U, rec_inner, sizeof(rec_inner) - 1U);
+    uint32_t len = sizeof(rec_outer) + sizeof(rec_inner) - 2U;
+    Check(uart_out_len == len && memcmp(uart_out, expected, len) == 0, "nested records intact, in order", "%.0f B",
+          uart_out_len);
+}
+
+static void Test_RingFull(void) {
+    uint8_t line[100];
+    memset(line, 'x', sizeof(line));
+    Reset();
+    // UART không chạy: ghi tới khi đầy
+    uint32_t written = 0;
+    while (Log_Write(line, sizeof(line))) written++;
+    Check(written == LOG_RING_SIZE / sizeof(line), "ring full: records accepted", "%.0f", written);
+    Check(hlog.dropped_records == 1 && hlog.reserve == hlog.head && hlog.writers == 0,
+          "ring full: dropped without leaking", "%.0f", hlog.dropped_records);
+    Drain();
+    Check(uart_out_len == written * sizeof(line) && hlog.tail == hlog.head, "ring full: drained", "%.0f B",
+          uart_out_len);
+}
+
+static void Test_Stream(void) {
+    static uint8_t expected[sizeof(uart_out)];
+    uint32_t expected_len = 0;
+    uint32_t seed = 12345;
+    Reset();
+    // Nhiều vòng quanh vòng đệm, UART chậm hơn bên ghi từng lúc
+    while (expected_len + LOG_LINE_MAX < sizeof(expected)) {
+        uint8_t line[LOG_LINE_MAX];
+        seed = seed * 1103515245U + 12345U;
+        uint16_t len = (uint16_t)(1U + (seed >> 16) % LOG_LINE_MAX);
+        for (uint16_t i = 0; i < len; i++) line[i] = (uint8_t)(expected_len + i);
+        if (Log_Write(line, len)) {
+            memcpy(&expected[expected_len], line, len);
+            expected_len += len;
+        }
+        Run_LogIrq();
+        if ((seed >> 8) % 3U == 0U) Finish_Tx();
+    }
+    Drain();
+    Check(uart_out_len == expected_len && memcmp(uart_out, expected, expected_len) == 0,
+          "stream matches records", "%.0f B", uart_out_len);
+    Check(hlog.dropped_records == 0, "stream: no drops", "%.0f", hlog.dropped_records);
+}
+
+int main(void) {
+    Test_MaskedSections();
+    Test_NestedWriter();
+    Test_RingFull();
+    Test_Stream();
+    printf("%s\n", failures ? "RESULT: FAIL" : "RESULT: OK");
+    return failures ? 1 : 0;
+}
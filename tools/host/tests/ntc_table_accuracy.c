@@ -0,0 +1,101 @@
+/*
+ * ntc_table_accuracy.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Đối chiếu bảng tra NTC (Core/Src/ntc.c + ntc_tables.c) với công thức Steinhart-Hart:
+ *  - Mọi mã ADC có nhiệt độ trong -40..125 °C, cả 2 đường cong: |NTC_Temperature - NTC_TemperatureExact| <= 0.1 °C.
+ *  - Mã ADC 0 và tối đa (hở/chập cảm biến) nằm ngoài dải đo, cùng phía với công thức.
+ *  - Ước lượng số chu kỳ/lần đổi như NTC_Benchmark (rdtsc thay DWT), chỉ để tham khảo.
+ */
+#include "ntc.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define NTC_ADC_MAX     ((1U << NTC_ADC_BITS) - 1U)
+#define T_LOW           -40.0f
+#define T_HIGH          125.0f
+#define MAX_ERROR       0.1f
+#define BENCH_ROUNDS    200
+
+static int failures;
+
+static uint64_t Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();  // x86intrin.h đụng macro CMSIS, dùng builtin trực tiếp
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static void Check(int ok, const char* name, const char* fmt, double value) {
+    printf("%-40s %s  ", name, ok ? "PASS" : "FAIL");
+    printf(fmt, value);
+    printf("\n");
+    if (!ok) failures++;
+}
+
+static void Check_Curve(const char* name, const NTC_Curve* curve) {
+    float worst = 0.0f;
+    uint16_t worst_adc = 0;
+    uint32_t codes = 0;
+    char label[64];
+
+    for (uint16_t adc = 0; adc <= NTC_ADC_MAX; adc++) {
+        float exact = NTC_TemperatureExact(curve, adc);
+        if (exact < T_LOW || exact > T_HIGH) continue;
+        float err = fabsf(NTC_Temperature(curve, (float)adc) - exact);
+        codes++;
+        if (err > worst) {
+            worst = err;
+            worst_adc = adc;
+        }
+    }
+    printf("  %s: %u codes in %.0f..%.0f C, worst at adc %u\n", name, codes, (double)T_LOW, (double)T_HIGH,
+           worst_adc);
+    snprintf(label, sizeof(label), "%s table vs exact", name);
+    Check(codes > 0 && worst <= MAX_ERROR, label, "max %.4f C", worst);
+
+    // Hở/chập cảm biến: bảng chỉ cần rơi ra ngoài dải đo cùng phía với công thức
+    float open = NTC_Temperature(curve, 0.0f);
+    float shorted = NTC_Temperature(curve, (float)NTC_ADC_MAX);
+    snprintf(label, sizeof(label), "%s open sensor below range", name);
+    Check(open < T_LOW && NTC_TemperatureExact(curve, 0) < T_LOW, label, "%.1f C", open);
+    snprintf(label, sizeof(label), "%s shorted sensor above range", name);
+    Check(shorted > T_HIGH && NTC_TemperatureExact(curve, NTC_ADC_MAX) > T_HIGH, label, "%.1f C", shorted);
+}
+
+/*================================ Thời gian ================================*/
+static volatile float sink;
+
+// Cùng các mẫu với NTC_Benchmark (ntc.c), nhưng đo cả lượt cho mỗi cách để chi phí đọc bộ đếm
+// không lấn át; lấy min qua nhiều lượt để loại nhiễu lập lịch
+static void Benchmark(const char* name, const NTC_Curve* curve) {
+    uint64_t exact_best = UINT64_MAX, table_best = UINT64_MAX;
+    uint32_t n = 0;
+    for (uint16_t adc = 1; adc < NTC_ADC_MAX; adc += 7) n++;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint64_t start = Cycles();
+        for (uint16_t adc = 1; adc < NTC_ADC_MAX; adc += 7) sink = NTC_TemperatureExact(curve, adc);
+        uint64_t mid = Cycles();
+        for (uint16_t adc = 1; adc < NTC_ADC_MAX; adc += 7) sink = NTC_Temperature(curve, adc);
+        uint64_t end = Cycles();
+        if (mid - start < exact_best) exact_best = mid - start;
+        if (end - mid < table_best) table_best = end - mid;
+    }
+    printf("  %s: exact %.1f cycles, table %.1f cycles per conversion (host)\n", name,
+           (double)exact_best / n, (double)table_best / n);
+}
+
+int main(void) {
+    Check_Curve("10k S-H", &ntc_curve_10k_sh);
+    Check_Curve("10k B3435", &ntc_curve_10k_b3435);
+    Benchmark("10k S-H", &ntc_curve_10k_sh);
+    Benchmark("10k B3435", &ntc_curve_10k_b3435);
+    printf("%s\n", failures ? "RESULT: FAIL" : "RESULT: OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * pid_step_response.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Kiểm tra PidCtrl (Core/Src/pid_ctrl.c) trên máy tính, cùng cách dùng như EEV_Control_PidAxis:
+ *  ngõ ra x5 = số nửa bước mỗi chu kỳ (dương = đóng), giới hạn lo/hi về 0 khi van chạm đầu hành trình.
+ *  Đối tượng: vị trí van 0..500, quá nhiệt bậc nhất (25 s) có trễ vận chuyển 4 s.
+ *  - Đổi setpoint bậc: ổn định trong dải ±0.5 K, vọt lố nhỏ.
+ *  - Bão hòa đầu hành trình: van mở hết lâu mà vẫn thiếu, khi tải đổi phải đóng lại ngay (không windup).
+ *  - Chuyển bám/tự động, tay/tự động và đổi hệ số không giật, ngõ ra không trôi sau đó.
+ *  In đáp ứng ra CSV nếu có đối số: pid_step_response out.csv
+ */
+#include "pid_ctrl.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define T_S             0.12f       // PID_SAMPLE_TIME
+#define STEPS_PER_OUT   5.0f
+#define STROKE          500.0f
+#define SH_TAU_S        25.0f
+#define DEAD_SAMPLES    33          // ~4 s / T_S
+
+// Hệ số mặc định của pid_config.c
+static const PidCtrl_Gains gains = {
+    .kp = 0.03f, .ti = 166.7f, .td = 33.3f, .n = 10.0f, .b = 1.0f, .tt = 0.0f,
+};
+
+typedef struct {
+    float position;             // Nửa bước
+    float sh;
+    float sh_max;               // Quá nhiệt khi van đóng
+    float u_flood;              // Độ mở (0..1) mà quá nhiệt về 0
+    float dead[DEAD_SAMPLES];
+    int head;
+} Plant;
+
+static FILE* csv;
+static int failures;
+
+static void Check(int ok, const char* name, const char* fmt, double value) {
+    printf("%-34s %s  ", name, ok ? "PASS" : "FAIL");
+    printf(fmt, value);
+    printf("\n");
+    if (!ok) failures++;
+}
+
+static float Plant_Equilibrium(const Plant* p, float sh) {
+    return STROKE * p->u_flood * (1.0f - sh / p->sh_max);
+}
+
+static void Plant_Init(Plant* p, float sh) {
+    p->sh_max = 30.0f;
+    p->u_flood = 0.6f;
+    p->position = Plant_Equilibrium(p, sh);
+    p->sh = sh;
+    for (int i = 0; i < DEAD_SAMPLES; i++) p->dead[i] = p->position;
+    p->head = 0;
+}
+
+static void Plant_Step(Plant* p, float output) {
+    p->position -= output * STEPS_PER_OUT;
+    if (p->position < 0.0f) p->position = 0.0f;
+    if (p->position > STROKE) p->position = STROKE;
+    p->dead[p->head] = p->position;
+    p->head = (p->head + 1) % DEAD_SAMPLES;
+    float u = p->dead[p->head] / STROKE;
+    float sh_ss = p->sh_max * (1.0f - u / p->u_flood);
+    if (sh_ss < 0.0f) sh_ss = 0.0f;
+    p->sh += (sh_ss - p->sh) * (T_S / (SH_TAU_S + T_S));
+}
+
+// Một chu kỳ như EEV_Control_PidAxis
+static float Loop_Step(PidCtrl* pid, Plant* p, float t) {
+    float lo = (p->position >= STROKE) ? 0.0f : pid->out_min;
+    float hi = (p->position <= 0.0f) ? 0.0f : pid->out_max;
+    float out = PidCtrl_Update(pid, p->sh, lo, hi);
+    if (csv != NULL) fprintf(csv, "%.2f,%.3f,%.3f,%.2f,%.4f\n", (double)t, (double)pid->setpoint,
+                             (double)p->sh, (double)p->position, (double)out);
+    Plant_Step(p, out);
+    return out;
+}
+
+static void Test_SetpointStep(void) {
+    PidCtrl pid;
+    Plant p;
+    Plant_Init(&p, 11.0f);
+    PidCtrl_Init(&pid, &gains, T_S, 11.0f, -60.0f, 60.0f);
+    PidCtrl_Track(&pid, p.sh, 0.0f);
+
+    float t = 0.0f, settle = -1.0f, min_sh = 1e9f;
+    pid.setpoint = 8.0f;
+    for (; t < 1500.0f; t += T_S) {
+        Loop_Step(&pid, &p, t);
+        if (p.sh < min_sh) min_sh = p.sh;
+        if (fabsf(p.sh - pid.setpoint) > 0.5f) settle = -1.0f;
+        else if (settle < 0.0f) settle = t;
+    }
+    Check(settle >= 0.0f && settle < 600.0f, "setpoint 11 -> 8 K: settle", "%.1f s", settle);
+    Check(min_sh > 8.0f - 2.0f, "setpoint 11 -> 8 K: undershoot", "%.2f K", 8.0f - min_sh);
+}
+
+static void Test_EndStopWindup(void) {
+    PidCtrl pid;
+    Plant p;
+    Plant_Init(&p, 11.0f);
+    PidCtrl_Init(&pid, &gains, T_S, 11.0f, -60.0f, 60.0f);
+    PidCtrl_Track(&pid, p.sh, 0.0f);
+
+    // Tải lớn: mở hết vẫn còn 20 K, van nằm ở đầu hành trình 10 phút
+    p.sh_max = 60.0f;
+    p.u_flood = 1.5f;
+    float t = 0.0f;
+    for (; t < 600.0f; t += T_S) Loop_Step(&pid, &p, t);
+    float stop_position = p.position;
+    // Ngõ ra trước khi chặn phải nằm sát giới hạn 0: tích phân không tích thêm khi van đã mở hết
+    float unclamped = pid.gains.kp * (pid.gains.b * pid.setpoint - p.sh) + pid.integral + pid.derivative;
+
+    // Tải về bình thường: quá nhiệt xuống dưới setpoint, van phải bắt đầu đóng ngay
+    p.sh_max = 30.0f;
+    p.u_flood = 0.6f;
+    float crossed = -1.0f, closing = -1.0f;
+    for (; t < 1200.0f && closing < 0.0f; t += T_S) {
+        float out = Loop_Step(&pid, &p, t);
+        if (crossed < 0.0f && p.sh < pid.setpoint) crossed = t;
+        if (crossed >= 0.0f && out > 0.0f) closing = t;
+    }
+    Check(stop_position >= STROKE, "end stop: valve saturated open", "%.0f", stop_position);
+    // Back-calculation giữ |u - u_sat| ~ Kp * Tt / Ti * |e| (0.12 ở 9 K), không windup thì tăng mãi
+    Check(fabsf(unclamped) < 0.3f, "end stop: unclamped output", "%.4f", unclamped);
+    Check(crossed >= 0.0f && closing >= 0.0f && closing - crossed < 5.0f,
+          "end stop: close after SH < setpoint", "%.2f s", (closing >= 0.0f) ? closing - crossed : -1.0f);
+}
+
+// Ngõ ra lớn nhất lệch khỏi value trong n chu kỳ khi giá trị đo đứng yên ở setpoint
+static float Drift(PidCtrl* pid, float value, int n) {
+    float worst = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float out = PidCtrl_Update(pid, pid->setpoint, pid->out_min, pid->out_max);
+        if (fabsf(out - value) > worst) worst = fabsf(out - value);
+    }
+    return worst;
+}
+
+static void Test_Bumpless(void) {
+    PidCtrl pid;
+    PidCtrl_Init(&pid, &gains, T_S, 11.0f, -60.0f, 60.0f);
+
+    // Bám ngõ ra 0 trong khi giá trị đo nhảy (như lúc cảm biến vừa có số): bộ lọc D đang nạp
+    for (int i = 0; i < 200; i++) PidCtrl_Track(&pid, 8.0f + 0.01f * (float)i, 0.0f);
+    PidCtrl_Track(&pid, 11.0f, 0.0f);
+    float first = Drift(&pid, 0.0f, 1);
+    Check(first < 0.05f, "track -> auto: first output", "%.4f", first);
+    float drift = Drift(&pid, 0.0f, (int)(120.0f / T_S));
+    Check(drift < 0.05f, "track -> auto: drift over 120 s", "%.4f", drift);
+
+    // Tay -> tự động
+    PidCtrl_SetMode(&pid, PID_MODE_MANUAL);
+    PidCtrl_SetManualOutput(&pid, 5.0f);
+    for (int i = 0; i < 50; i++) PidCtrl_Update(&pid, 11.0f + 0.05f * (float)i, pid.out_min, pid.out_max);
+    PidCtrl_Update(&pid, 11.0f, pid.out_min, pid.out_max);
+    PidCtrl_SetMode(&pid, PID_MODE_AUTO);
+    drift = Drift(&pid, 5.0f, (int)(120.0f / T_S));
+    Check(drift < 0.05f, "manual -> auto: drift over 120 s", "%.4f", drift);
+
+    // Đổi hệ số giữa chừng
+    PidCtrl_Update(&pid, 12.0f, pid.out_min, pid.out_max);
+    float before = PidCtrl_Update(&pid, 12.0f, pid.out_min, pid.out_max);
+    PidCtrl_Gains g = gains;
+    g.kp *= 3.0f;
+    PidCtrl_SetGains(&pid, &g);
+    float after = PidCtrl_Update(&pid, 12.0f, pid.out_min, pid.out_max);
+    Check(fabsf(after - before) < 0.05f, "gain change: output step", "%.4f", fabsf(after - before));
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        csv = fopen(argv[1], "w");
+        if (csv == NULL) {
+            perror(argv[1]);
+            return 2;
+        }
+        fprintf(csv, "t_s,setpoint,sh,position,output\n");
+    }
+    Test_SetpointStep();
+    Test_EndStopWindup();
+    Test_Bumpless();
+    if (csv != NULL) fclose(csv);
+    printf("%s\n", failures ? "RESULT: FAIL" : "RESULT: OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,231 @@
+/*
+ * r507_lookup_bench.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Đối chiếu bộ tra lưới chỉ mục (Core/Src/refrigerant.c) với quét tuyến tính cũ của R507_GetTemperature:
+ *  - Kết quả phải trùng từng bit: quét dày toàn dải, mọi điểm bảng, 2 số float kề điểm bảng, ngoài bảng, NaN.
+ *  - Cả P -> T và T -> P, cả đường sôi/sương, cho R507A và mọi bảng trong refrigerant_tables.c,
+ *    trước khi dựng lưới (toàn 0) và sau Refrigerant_Select.
+ *  - In thời gian mỗi lần tra (ns) của 2 cách ở vài mức áp suất, chỉ để tham khảo.
+ */
+#include "refrigerant.h"
+#include "R507_temp_pressure.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SWEEP_STEPS     140000
+#define BENCH_LOOKUPS   200000
+
+static int failures;
+
+static void Check(int ok, const char* name, const char* fmt, double value) {
+    printf("%-40s %s  ", name, ok ? "PASS" : "FAIL");
+    printf(fmt, value);
+    printf("\n");
+    if (!ok) failures++;
+}
+
+// refrigerant.c gọi các hàm này trong Refrigerant_Init/Process, bài kiểm tra không dùng tới
+bool Modbus_PublishHoldingRegs(ModbusHandle* modbus, uint16_t start, const uint16_t* values, uint16_t count) {
+    (void)modbus;
+    (void)start;
+    (void)values;
+    (void)count;
+    return true;
+}
+
+EEPROM_Status_t EEPROM_ReadBuffer(EEPROM_Handle_t* dev, uint16_t mem_addr, uint8_t* p_data, size_t len) {
+    (void)dev;
+    (void)mem_addr;
+    (void)p_data;
+    (void)len;
+    return EEPROM_ERROR_GENERAL;
+}
+
+EEPROM_Status_t EEPROM_WriteBuffer(EEPROM_Handle_t* dev, uint16_t mem_addr, const uint8_t* p_data, size_t len) {
+    (void)dev;
+    (void)mem_addr;
+    (void)p_data;
+    (void)len;
+    return EEPROM_ERROR_GENERAL;
+}
+
+/*================================ Bản cũ ================================*/
+// R507_GetTemperature trước khi có lưới chỉ mục (Core/Src/R507_temp_pressure.c), giữ nguyên phép tính
+static float R507_GetTemperature_Linear(float pressure) {
+    for (int i = 0; i < (int)R507_TABLE_SIZE - 1; i++) {
+        if (pressure == R507_TABLE[i].pressure) {
+            return R507_TABLE[i].temperature_R507;
+        }
+        if (pressure > R507_TABLE[i].pressure &&
+            pressure < R507_TABLE[i + 1].pressure) {
+            float p1 = R507_TABLE[i].pressure;
+            float p2 = R507_TABLE[i + 1].pressure;
+            float t1 = R507_TABLE[i].temperature_R507;
+            float t2 = R507_TABLE[i + 1].temperature_R507;
+            return t1 + (pressure - p1) * (t2 - t1) / (p2 - p1);
+        }
+    }
+    if (pressure < R507_TABLE[0].pressure)
+        return R507_TABLE[0].temperature_R507;
+    return R507_TABLE[R507_TABLE_SIZE - 1].temperature_R507;
+}
+
+// Cùng phép quét đó trên một đường bất kỳ, x/y là 2 cột (P -> T hoặc T -> P)
+static float Linear(const float* x_col, const float* y_col, uint16_t stride, uint16_t count, float x) {
+    for (int i = 0; i < count - 1; i++) {
+        float xi = x_col[i * stride];
+        float xn = x_col[(i + 1) * stride];
+        if (x == xi) {
+            return y_col[i * stride];
+        }
+        if (x > xi && x < xn) {
+            float y1 = y_col[i * stride];
+            float y2 = y_col[(i + 1) * stride];
+            return y1 + (x - xi) * (y2 - y1) / (xn - xi);
+        }
+    }
+    if (x < x_col[0])
+        return y_col[0];
+    return y_col[(count - 1) * stride];
+}
+
+/*================================ Đối chiếu ================================*/
+typedef float (*Lookup_Fn)(float x);
+
+typedef struct {
+    const float* x;
+    const float* y;
+    uint16_t     stride;
+    uint16_t     count;
+    Lookup_Fn    fast;
+    uint32_t     tested;
+    uint32_t     mismatches;
+} Compare;
+
+static int Same(float a, float b) {
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static void Compare_One(Compare* c, float x) {
+    c->tested++;
+    if (!Same(c->fast(x), Linear(c->x, c->y, c->stride, c->count, x))) {
+        if (c->mismatches == 0) {
+            printf("  first mismatch at x = %.9g: fast %.9g, linear %.9g\n", (double)x, (double)c->fast(x),
+                   (double)Linear(c->x, c->y, c->stride, c->count, x));
+        }
+        c->mismatches++;
+    }
+}
+
+static void Compare_Curve(Compare* c) {
+    float first = c->x[0];
+    float last = c->x[(c->count - 1) * c->stride];
+    float span = last - first + 2.0f;
+    for (int i = 0; i <= SWEEP_STEPS; i++) {
+        Compare_One(c, first - 1.0f + span * (float)i / (float)SWEEP_STEPS);
+    }
+    for (uint16_t i = 0; i < c->count; i++) {
+        float xi = c->x[i * c->stride];
+        Compare_One(c, xi);
+        Compare_One(c, nextafterf(xi, -INFINITY));
+        Compare_One(c, nextafterf(xi, INFINITY));
+    }
+    Compare_One(c, NAN);
+    Compare_One(c, -INFINITY);
+    Compare_One(c, INFINITY);
+}
+
+static void Check_Curve(const char* name, const Refrigerant_Curve* curve, Lookup_Fn to_t, Lookup_Fn to_p) {
+    Compare pt = { curve->pressure, curve->temperature, curve->stride, curve->count, to_t, 0, 0 };
+    Compare tp = { curve->temperature, curve->pressure, curve->stride, curve->count, to_p, 0, 0 };
+    char label[64];
+    Compare_Curve(&pt);
+    Compare_Curve(&tp);
+    snprintf(label, sizeof(label), "%s P->T bit-identical", name);
+    Check(pt.mismatches == 0, label, "%.0f points", pt.tested);
+    snprintf(label, sizeof(label), "%s T->P bit-identical", name);
+    Check(tp.mismatches == 0, label, "%.0f points", tp.tested);
+}
+
+static void Check_R507(const char* when) {
+    uint32_t tested = 0, mismatches = 0;
+    char label[64];
+    for (int i = 0; i <= SWEEP_STEPS; i++) {
+        float p = -1.0f + 14.0f * (float)i / (float)SWEEP_STEPS;
+        tested++;
+        if (!Same(Refrigerant_DewTemperature(p), R507_GetTemperature_Linear(p))) mismatches++;
+    }
+    for (uint16_t i = 0; i < R507_TABLE_SIZE; i++) {
+        float p[3] = { R507_TABLE[i].pressure, nextafterf(R507_TABLE[i].pressure, -INFINITY),
+                       nextafterf(R507_TABLE[i].pressure, INFINITY) };
+        for (int k = 0; k < 3; k++) {
+            tested++;
+            if (!Same(Refrigerant_DewTemperature(p[k]), R507_GetTemperature_Linear(p[k]))) mismatches++;
+        }
+    }
+    tested++;
+    if (!Same(Refrigerant_DewTemperature(NAN), R507_GetTemperature_Linear(NAN))) mismatches++;
+    snprintf(label, sizeof(label), "R507A vs old R507_GetTemperature (%s)", when);
+    Check(mismatches == 0, label, "%.0f points", tested);
+}
+
+/*================================ Thời gian ================================*/
+static volatile float sink;
+
+static double Bench(float (*fn)(float), float p) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < BENCH_LOOKUPS; i++) {
+        // Nhiễu nhỏ để trình biên dịch không gộp các lần tra
+        sink = fn(p + (float)(i & 7) * 1e-4f);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+    return ns / BENCH_LOOKUPS;
+}
+
+static void Benchmark(void) {
+    static const float pressures[] = { 0.0f, 3.0f, 6.0f, 9.0f, 11.5f };
+    printf("  pressure   grid ns   linear ns\n");
+    for (uint32_t i = 0; i < sizeof(pressures) / sizeof(pressures[0]); i++) {
+        double grid = Bench(Refrigerant_DewTemperature, pressures[i]);
+        double linear = Bench(R507_GetTemperature_Linear, pressures[i]);
+        printf("  %6.1f bar  %7.1f   %9.1f\n", (double)pressures[i], grid, linear);
+    }
+}
+
+int main(void) {
+    // Trước Refrigerant_Select: lưới R507A toàn 0, vẫn phải đúng (chỉ chậm hơn)
+    Check_R507("grid not built");
+    Refrigerant_Select(REFRIGERANT_R507A);
+    Check_R507("grid built");
+    Benchmark();
+
+    static const struct {
+        Refrigerant_Id id;
+        const char* name;
+        const Refrigerant_Info* info;
+    } tables[] = {
+        { REFRIGERANT_R404A, "R404A", &refrigerant_r404a },
+        { REFRIGERANT_R134A, "R134a", &refrigerant_r134a },
+        { REFRIGERANT_R448A, "R448A", &refrigerant_r448a },
+        { REFRIGERANT_R449A, "R449A", &refrigerant_r449a },
+        { REFRIGERANT_R290,  "R290",  &refrigerant_r290 },
+    };
+    for (uint32_t i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "%s select", tables[i].name);
+        Check(Refrigerant_Select(tables[i].id), name, "id %.0f", (double)tables[i].id);
+        snprintf(name, sizeof(name), "%s dew", tables[i].name);
+        Check_Curve(name, &tables[i].info->dew, Refrigerant_DewTemperature, Refrigerant_DewPressure);
+        snprintf(name, sizeof(name), "%s bubble", tables[i].name);
+        Check_Curve(name, &tables[i].info->bubble, Refrigerant_BubbleTemperature, Refrigerant_BubblePressure);
+    }
+    printf("%s\n", failures ? "RESULT: FAIL" : "RESULT: OK");
+    return failures ? 1 : 0;
+}
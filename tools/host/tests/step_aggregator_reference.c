@@ -0,0 +1,151 @@
+/*
+ * step_aggregator_reference.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: PC
+ *
+ *  Đối chiếu StepAgg (Core/Src/step_aggregator.c) với bản quét thẳng trên mảng lệnh đã lưu:
+ *  - Cả 4 chính sách, Peek sau mỗi lệnh và Take ngẫu nhiên (cửa sổ trống, chưa đầy, đầy và trượt).
+ *  - Giá trị nhỏ (nhiều lệnh bằng |x|, kiểm tra số dương thắng) và giá trị biên int16 (bão hòa SUM).
+ *  - Đổi chính sách giữa chừng, số thứ tự seq tràn qua 2^32.
+ */
+#include "step_aggregator.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SEQUENCES       400
+#define OPS_PER_SEQ     3000
+
+typedef struct {
+    int16_t  value[STEP_AGG_WINDOW];    // Các lệnh còn trong cửa sổ, cũ nhất ở đầu
+    uint32_t count;
+} Reference;
+
+static int failures;
+static uint32_t rng = 0x2545F491U;
+
+static uint32_t Random(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void Check(int ok, const char* name, const char* fmt, double value) {
+    printf("%-40s %s  ", name, ok ? "PASS" : "FAIL");
+    printf(fmt, value);
+    printf("\n");
+    if (!ok) failures++;
+}
+
+static void Reference_Push(Reference* r, int16_t x) {
+    if (r->count == STEP_AGG_WINDOW) {
+        for (uint32_t i = 1; i < STEP_AGG_WINDOW; i++) r->value[i - 1] = r->value[i];
+        r->count--;
+    }
+    r->value[r->count++] = x;
+}
+
+// Quét thẳng toàn cửa sổ theo định nghĩa của từng chính sách
+static int16_t Reference_Value(const Reference* r, StepAgg_Policy policy) {
+    if (r->count == 0) return 0;
+    int32_t sum = 0;
+    int16_t best = r->value[0];
+    for (uint32_t i = 0; i < r->count; i++) {
+        int16_t x = r->value[i];
+        int32_t ax = abs(x), ab = abs(best);
+        sum += x;
+        if (ax > ab || (ax == ab && x > best)) best = x;
+    }
+    switch (policy) {
+    case STEP_AGG_MEAN: {
+        // Làm tròn về gần nhất, nửa thì ra xa 0
+        double mean = (double)sum / (double)r->count;
+        return (int16_t)((mean >= 0.0) ? (int32_t)(mean + 0.5) : -(int32_t)(-mean + 0.5));
+    }
+    case STEP_AGG_SUM:
+        return (int16_t)((sum > INT16_MAX) ? INT16_MAX : ((sum < INT16_MIN) ? INT16_MIN : sum));
+    case STEP_AGG_LAST:
+        return r->value[r->count - 1];
+    case STEP_AGG_MAX_ABS:
+    default:
+        return best;
+    }
+}
+
+static int16_t Random_Step(uint32_t range) {
+    if (range == 0) {
+        // Giá trị biên int16
+        static const int16_t edge[] = { INT16_MIN, INT16_MIN + 1, -1, 0, 1, INT16_MAX - 1, INT16_MAX };
+        return edge[Random() % (sizeof(edge) / sizeof(edge[0]))];
+    }
+    return (int16_t)((int32_t)(Random() % (2U * range + 1U)) - (int32_t)range);
+}
+
+int main(void) {
+    static const uint32_t ranges[] = { 1, 3, 20, 500, 32767, 0 };
+    uint32_t mismatches[STEP_AGG_POLICY_COUNT] = { 0 };
+    uint32_t checks = 0, takes = 0, evictions = 0;
+
+    for (uint32_t s = 0; s < SEQUENCES; s++) {
+        StepAgg agg;
+        Reference ref = { .count = 0 };
+        StepAgg_Policy policy = (StepAgg_Policy)(s % STEP_AGG_POLICY_COUNT);
+        uint32_t range = ranges[(s / STEP_AGG_POLICY_COUNT) % (sizeof(ranges) / sizeof(ranges[0]))];
+        // Lấy thưa (cửa sổ thường trượt) hoặc lấy dày (cửa sổ hiếm khi đầy)
+        uint32_t take_every = (s & 1U) ? 200U : 20U;
+
+        StepAgg_Init(&agg, policy);
+        if (s % 7U == 0U) {
+            // Số thứ tự sắp tràn 32 bit
+            agg.seq = 0xFFFFFFFFU - (Random() % 200U);
+            StepAgg_Reset(&agg);
+        }
+
+        for (uint32_t op = 0; op < OPS_PER_SEQ; op++) {
+            uint32_t roll = Random() % take_every;
+            if (roll == 0) {
+                int16_t got = StepAgg_Take(&agg);
+                if (got != Reference_Value(&ref, policy)) mismatches[policy]++;
+                ref.count = 0;
+                takes++;
+            } else if (roll == 1 && s % 5U == 0U) {
+                policy = (StepAgg_Policy)(Random() % STEP_AGG_POLICY_COUNT);
+                StepAgg_SetPolicy(&agg, policy);
+            } else {
+                if (ref.count == STEP_AGG_WINDOW) evictions++;
+                int16_t x = Random_Step(range);
+                StepAgg_Push(&agg, x);
+                Reference_Push(&ref, x);
+            }
+            checks++;
+            if (StepAgg_Peek(&agg) != Reference_Value(&ref, policy)) {
+                if (mismatches[policy] == 0) {
+                    printf("  first mismatch: sequence %u op %u policy %u: %d vs %d\n", s, op, policy,
+                           StepAgg_Peek(&agg), Reference_Value(&ref, policy));
+                }
+                mismatches[policy]++;
+            }
+        }
+    }
+
+    static const char* const names[STEP_AGG_POLICY_COUNT] = {
+        "max-abs vs brute force", "mean vs brute force", "sum vs brute force", "last vs brute force",
+    };
+    for (uint32_t p = 0; p < STEP_AGG_POLICY_COUNT; p++) {
+        Check(mismatches[p] == 0, names[p], "%.0f mismatches", mismatches[p]);
+    }
+    Check(evictions > 0 && takes > 0, "window eviction and take covered", "%.0f evictions", evictions);
+    printf("  %u checks, %u takes\n", checks, takes);
+
+    // Chính sách không hợp lệ giữ nguyên chính sách cũ
+    StepAgg agg;
+    StepAgg_Init(&agg, STEP_AGG_POLICY_COUNT);
+    Check(agg.policy == STEP_AGG_MAX_ABS, "invalid policy at init -> max-abs", "%.0f", agg.policy);
+    StepAgg_SetPolicy(&agg, STEP_AGG_SUM);
+    StepAgg_SetPolicy(&agg, (StepAgg_Policy)9);
+    Check(agg.policy == STEP_AGG_SUM, "invalid policy ignored", "%.0f", agg.policy);
+
+    printf("%s\n", failures ? "RESULT: FAIL" : "RESULT: OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+log_decode.py - Giải mã log nhị phân (LOG_BINARY=1) từ USART3 thành văn bản.
+
+Bảng sự kiện được đọc trực tiếp từ Core/Inc/log_events.h, thứ tự dòng X(...) = ID.
+Bản ghi nhị phân (little-endian), xem Log_Event() trong Core/Src/log_dma.c:
+    [0xA5][level<<4 | argc][id:2][tick ms:4][arg0:4]...[arg(argc-1):4]
+Các byte không thuộc bản ghi (printLOGDATA văn bản) được in ra nguyên vẹn.
+
+Cách dùng:
+    python3 tools/log_decode.py capture.bin
+    python3 tools/log_decode.py --port /dev/ttyUSB0 --baud 115200   (cần pyserial)
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HDR_SIZE = 8
+MAX_ARGS = 8
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D"}
+
+DEFAULT_TABLE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             "..", "Core", "Inc", "log_events.h")
+
+_ENTRY_RE = re.compile(r'^\s*X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+_SPEC_RE = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|t)?([diouxXc%])')
+
+
+def load_events(path):
+    events = []
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            m = _ENTRY_RE.match(line)
+            if m:
+                fmt = m.group(2).encode("utf-8").decode("unicode_escape")
+                events.append((m.group(1), fmt))
+    return events
+
+
+def format_event(fmt, args):
+    """printf tối giản: mọi tham số là uint32, %d/%i được hiểu là số có dấu."""
+    it = iter(args)
+
+    def repl(m):
+        flags, conv = m.group(1), m.group(3)
+        if conv == "%":
+            return "%"
+        v = next(it, 0)
+        if conv in "di":
+            v = v - (1 << 32) if v & 0x80000000 else v
+            conv = "d"
+        elif conv == "u":
+            conv = "d"
+        return ("%" + flags + conv) % (chr(v & 0xFF) if conv == "c" else v)
+
+    return _SPEC_RE.sub(repl, fmt)
+
+
+def decode_stream(data, events, out):
+    i = 0
+    text = bytearray()
+    n = len(data)
+    while i < n:
+        b = data[i]
+        if b == SYNC and i + HDR_SIZE <= n:
+            level, argc = data[i + 1] >> 4, data[i + 1] & 0x0F
+            evt_id, tick = struct.unpack_from("<HI", data, i + 2)
+            size = HDR_SIZE + 4 * argc
+            # Kiểm tra phần đầu để phân biệt với byte 0xA5 trong văn bản UTF-8.
+            if level in LEVELS and argc <= MAX_ARGS and evt_id < len(events) and i + size <= n:
+                if text:
+                    out.write(text.decode("utf-8", errors="replace"))
+                    text.clear()
+                args = struct.unpack_from("<%dI" % argc, data, i + HDR_SIZE)
+                name, fmt = events[evt_id]
+                out.write("[%10.3f] %s %s" % (tick / 1000.0, LEVELS[level], format_event(fmt, args)))
+                i += size
+                continue
+        text.append(b)
+        i += 1
+    if text:
+        out.write(text.decode("utf-8", errors="replace"))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("input", nargs="?", help="file log nhị phân (mặc định: stdin)")
+    ap.add_argument("--events", default=DEFAULT_TABLE, help="đường dẫn tới log_events.h")
+    ap.add_argument("--port", help="đọc trực tiếp từ cổng COM")
+    ap.add_argument("--baud", type=int, default=115200)
+    a = ap.parse_args()
+
+    events = load_events(a.events)
+    if a.port:
+        import serial  # pyserial
+        with serial.Serial(a.port, a.baud, timeout=0.1) as ser:
+            pending = b""
+            while True:
+                pending += ser.read(4096)
+                # Giữ lại phần cuối có thể là bản ghi chưa nhận đủ.
+                cut = pending.rfind(bytes([SYNC]), max(0, len(pending) - (HDR_SIZE + 4 * MAX_ARGS)))
+                chunk, pending = (pending[:cut], pending[cut:]) if cut >= 0 else (pending, b"")
+                decode_stream(chunk, events, sys.stdout)
+                sys.stdout.flush()
+    else:
+        data = open(a.input, "rb").read() if a.input else sys.stdin.buffer.read()
+        decode_stream(data, events, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""
+ntc_table_gen.py - Sinh bảng tra nhiệt độ NTC theo mã ADC (Core/Src/ntc_tables.c).
+
+Mỗi đường cong là một bảng int16 (0.01 °C) tại các mã ADC cách đều 2^NTC_TABLE_SHIFT,
+firmware nội suy tuyến tính giữa 2 điểm (xem NTC_Temperature() trong Core/Src/ntc.c).
+Mạch phân áp giống calcular_temperature() cũ: R_ntc = 4095 * R_series / adc - R_series.
+
+Sau khi sinh, script so nội suy với công thức chính xác trên mọi mã ADC trong dải
+kiểm tra và thoát với mã lỗi nếu sai số vượt MAX_ERROR_C.
+
+Cách dùng:
+    python3 tools/ntc_table_gen.py            (ghi Core/Src/ntc_tables.c)
+    python3 tools/ntc_table_gen.py --check    (chỉ kiểm tra, không ghi file)
+"""
+import argparse
+import math
+import os
+import sys
+
+ADC_BITS = 12
+ADC_MAX = (1 << ADC_BITS) - 1
+TABLE_SHIFT = 4                              # Phải trùng NTC_TABLE_SHIFT trong Core/Inc/ntc.h
+TABLE_SIZE = (1 << (ADC_BITS - TABLE_SHIFT)) + 1
+CLAMP_C = (-100.0, 300.0)                    # Hở/chập cảm biến: bảng bão hòa thay vì chia cho 0
+CHECK_RANGE_C = (-40.0, 125.0)               # Dải làm việc của cảm biến
+MAX_ERROR_C = 0.1
+
+DEFAULT_OUT = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           "..", "Core", "Src", "ntc_tables.c")
+
+
+def steinhart(a, b, c):
+    return {"a": a, "b": b, "c": c}
+
+
+def beta(r25, b):
+    # Mô hình Beta viết lại dạng Steinhart-Hart với C = 0
+    t0 = 298.15
+    return {"a": 1.0 / t0 - math.log(r25) / b, "b": 1.0 / b, "c": 0.0}
+
+
+# name: tên biến C (ntc_curve_<name>), series: điện trở phân áp (ohm)
+CURVES = [
+    {"name": "10k_sh", "desc": "NTC 10K, hệ số Steinhart-Hart hiện dùng cho hồi về và đầu đẩy",
+     "series": 10000.0, **steinhart(1.129241e-3, 2.341077e-4, 8.775468e-8)},
+    {"name": "10k_b3435", "desc": "NTC 10K B25/85 = 3435 (cảm biến lạnh thông dụng)",
+     "series": 10000.0, **beta(10000.0, 3435.0)},
+]
+
+
+def exact(curve, adc):
+    """Nhiệt độ (°C) theo đúng công thức của calcular_temperature(), đã bão hòa."""
+    if adc <= 0:
+        return CLAMP_C[0]
+    if adc >= ADC_MAX:
+        return CLAMP_C[1]
+    r = ADC_MAX * curve["series"] / adc - curve["series"]
+    ln = math.log(r)
+    t = 1.0 / (curve["a"] + curve["b"] * ln + curve["c"] * ln ** 3) - 273.15
+    return min(max(t, CLAMP_C[0]), CLAMP_C[1])
+
+
+def build(curve):
+    return [int(round(exact(curve, i << TABLE_SHIFT) * 100.0)) for i in range(TABLE_SIZE)]
+
+
+def interpolate(table, adc):
+    # Giống hệt phép tính số nguyên trong NTC_Temperature()
+    i = adc >> TABLE_SHIFT
+    frac = adc & ((1 << TABLE_SHIFT) - 1)
+    return (table[i] * 100.0 + (table[i + 1] - table[i]) * 100.0 * frac / (1 << TABLE_SHIFT)) / 10000.0
+
+
+def max_error(curve, table):
+    worst, worst_adc = 0.0, 0
+    for adc in range(1, ADC_MAX):
+        t = exact(curve, adc)
+        if not CHECK_RANGE_C[0] <= t <= CHECK_RANGE_C[1]:
+            continue
+        e = abs(interpolate(table, adc) - t)
+        if e > worst:
+            worst, worst_adc = e, adc
+    return worst, worst_adc
+
+
+def emit(curves, tables):
+    out = []
+    out.append("/*")
+    out.append(" * ntc_tables.c")
+    out.append(" *")
+    out.append(" *  Created on: Oct 17, 2026")
+    out.append(" *      Author: PC")
+    out.append(" *")
+    out.append(" *  FILE SINH TỰ ĐỘNG bởi tools/ntc_table_gen.py - không sửa tay.")
+    out.append(" *  Thêm/sửa đường cong trong CURVES của script rồi chạy lại.")
+    out.append(" */")
+    out.append('#include "ntc.h"')
+    for curve, table in zip(curves, tables):
+        out.append("")
+        out.append("// %s" % curve["desc"])
+        out.append("static const int16_t ntc_table_%s[NTC_TABLE_SIZE] = {" % curve["name"])
+        for k in range(0, len(table), 12):
+            out.append("    " + " ".join("%6d," % v for v in table[k:k + 12]))
+        out.append("};")
+        out.append("const NTC_Curve ntc_curve_%s = {" % curve["name"])
+        out.append("    .table = ntc_table_%s," % curve["name"])
+        out.append("    .a = %.9ef, .b = %.9ef, .c = %.9ef," % (curve["a"], curve["b"], curve["c"]))
+        out.append("    .series_resistor = %.1ff," % curve["series"])
+        out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--out", default=DEFAULT_OUT)
+    ap.add_argument("--check", action="store_true", help="chỉ kiểm tra sai số")
+    args = ap.parse_args()
+
+    tables = [build(c) for c in CURVES]
+    ok = True
+    for curve, table in zip(CURVES, tables):
+        err, adc = max_error(curve, table)
+        print("ntc_curve_%-10s max |error| = %.4f C at ADC %d (%.2f C)" % (curve["name"], err, adc, exact(curve, adc)))
+        if err > MAX_ERROR_C:
+            ok = False
+    if not ok:
+        print("error: interpolation error above %.2f C, decrease TABLE_SHIFT" % MAX_ERROR_C, file=sys.stderr)
+        return 1
+    if not args.check:
+        with open(args.out, "w", newline="\r\n", encoding="utf-8") as f:
+            f.write(emit(CURVES, tables))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+refrigerant_table_gen.py - Sinh bảng áp suất - nhiệt độ bão hòa (Core/Src/refrigerant_tables.c).
+
+Nguồn dữ liệu: CoolProp (pip install CoolProp==8.0.0), backend HEOS - cùng các phương trình trạng thái
+tham chiếu mà NIST REFPROP dùng:
+  - R134a:  Tillner-Roth & Baehr, JPCRD 23 (1994).
+  - R290:   Lemmon, McLinden & Wagner, JCED 54 (2009).
+  - R404A, R448A, R449A: hỗn hợp theo thành phần ASHRAE 34 (file .mix như REFPROP), từng đơn chất
+    R32/R125/R143a/R134a/R1234yf/R1234ze(E) theo EOS tham chiếu, quy tắc trộn và hệ số cặp của
+    Lemmon & Jacobsen JPCRD 33 (2004), Bell et al. JPCRD (2022, 2023).
+Mỗi đường được tính trực tiếp tại từng điểm (bước T_STEP), không nội suy. Hỗn hợp zeotropic có
+2 đường: sôi (Q = 0) và sương (Q = 1). Áp suất đổi sang bar tương đối (như cảm biến áp suất và bảng
+R507 cũ). --check in thêm độ lệch của cùng cách tính so với bảng R507A gốc (R507_temp_pressure.h).
+
+Cách dùng:
+    python3 tools/refrigerant_table_gen.py            (ghi Core/Src/refrigerant_tables.c)
+    python3 tools/refrigerant_table_gen.py --check    (chỉ kiểm tra, không ghi file)
+"""
+import argparse
+import os
+import re
+import sys
+
+try:
+    import CoolProp
+    from CoolProp.CoolProp import PropsSI
+except ImportError:
+    sys.exit("CoolProp is required: pip install CoolProp==8.0.0")
+
+ATM_BAR = 1.01325
+T_MIN, T_MAX, T_STEP = -50, 60, 2   # Dải bảng (°C), tối đa 256 điểm (chỉ mục uint8_t)
+CONSTANT_GLIDE_K = 0.01             # Trượt nhỏ hơn mức này thì chỉ ghi 1 đường
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+DEFAULT_OUT = os.path.join(ROOT, "Core", "Src", "refrigerant_tables.c")
+R507_HEADER = os.path.join(ROOT, "Core", "Inc", "R507_temp_pressure.h")
+
+# name: hậu tố tên biến C (refrigerant_<name>), phải khớp với refrigerant.c
+# fluid: tên chất/hỗn hợp trong CoolProp
+REFRIGERANTS = [
+    {"name": "r404a", "fluid": "R404A.mix", "desc": "R404A (R125/R143a/R134a 44/52/4, gần đẳng phí)"},
+    {"name": "r134a", "fluid": "R134a",     "desc": "R134a (đơn chất)"},
+    {"name": "r448a", "fluid": "R448A.mix", "desc": "R448A (R32/R125/R1234yf/R134a/R1234ze(E) 26/26/20/21/7, zeotropic)"},
+    {"name": "r449a", "fluid": "R449A.mix", "desc": "R449A (R32/R125/R1234yf/R134a 24.3/24.7/25.3/25.7, zeotropic)"},
+    {"name": "r290",  "fluid": "Propane",   "desc": "R290 - propan (đơn chất)"},
+]
+
+
+def check_monotonic(samples, what):
+    for (p0, t0), (p1, t1) in zip(samples, samples[1:]):
+        if not (t1 > t0 and p1 > p0):
+            raise ValueError("%s: points must increase (%s,%s) -> (%s,%s)" % (what, p0, t0, p1, t1))
+
+
+def sample(fluid, quality):
+    """{áp suất bar tương đối, nhiệt độ °C} trên đường bão hòa Q = quality."""
+    return [(PropsSI("P", "T", t + 273.15, "Q", quality, fluid) / 1e5 - ATM_BAR, float(t))
+            for t in range(T_MIN, T_MAX + 1, T_STEP)]
+
+
+def r507_deviation():
+    """Độ lệch lớn nhất (K) giữa đường sương R507A tính bằng CoolProp và bảng R507 gốc."""
+    with open(R507_HEADER, encoding="utf-8") as f:
+        points = re.findall(r"\{\s*(-?[\d.]+)f,\s*(-?[\d.]+)f\s*\}", f.read())
+    return max(abs(PropsSI("T", "P", (float(p) + ATM_BAR) * 1e5, "Q", 1, "R507A.mix") - 273.15 - float(t))
+               for p, t in points)
+
+
+def emit_curve(out, var, samples):
+    out.append("static const float %s[][2] = {" % var)
+    for k in range(0, len(samples), 4):
+        out.append("    " + " ".join("{%7.3ff, %6.1ff}," % s for s in samples[k:k + 4]))
+    out.append("};")
+
+
+def emit(refrigerants):
+    out = []
+    out.append("/*")
+    out.append(" * refrigerant_tables.c")
+    out.append(" *")
+    out.append(" *  Created on: Oct 17, 2026")
+    out.append(" *      Author: PC")
+    out.append(" *")
+    out.append(" *  FILE SINH TỰ ĐỘNG bởi tools/refrigerant_table_gen.py - không sửa tay.")
+    out.append(" *  Mỗi điểm là {áp suất bar tương đối, nhiệt độ °C}, nhiệt độ cách đều %d K." % T_STEP)
+    out.append(" *  Nguồn: CoolProp %s (EOS tham chiếu như REFPROP), xem đầu script." % CoolProp.__version__)
+    out.append(" */")
+    out.append('#include "refrigerant.h"')
+    for r in refrigerants:
+        out.append("")
+        out.append("// %s" % r["desc"])
+        emit_curve(out, "%s_bubble" % r["name"], r["bubble"])
+        if r["dew"] is not None:
+            emit_curve(out, "%s_dew" % r["name"], r["dew"])
+        dew = "%s_dew" % r["name"] if r["dew"] is not None else "%s_bubble" % r["name"]
+        bubble = "%s_bubble" % r["name"]
+        out.append("const Refrigerant_Info refrigerant_%s = {" % r["name"])
+        out.append('    .name = "%s",' % r["name"].upper())
+        out.append("    .bubble = REFRIGERANT_CURVE(%s)," % bubble)
+        out.append("    .dew    = REFRIGERANT_CURVE(%s)," % dew)
+        out.append("    .approximate = 0,")
+        out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--out", default=DEFAULT_OUT)
+    ap.add_argument("--check", action="store_true", help="chỉ kiểm tra dữ liệu")
+    args = ap.parse_args()
+
+    tables = []
+    for r in REFRIGERANTS:
+        bubble = sample(r["fluid"], 0)
+        dew = sample(r["fluid"], 1)
+        glide = max(abs(PropsSI("T", "P", (p + ATM_BAR) * 1e5, "Q", 1, r["fluid"]) - 273.15 - t) for p, t in bubble)
+        if glide < CONSTANT_GLIDE_K:
+            dew = None
+        for kind, s in (("bubble", bubble), ("dew", dew)):
+            if s is not None:
+                check_monotonic(s, "%s %s" % (r["name"], kind))
+        nbp = [t for p, t in bubble if p >= 0.0][0]
+        print("%-6s points=%d curves=%d glide<=%.2f K bubble crosses 0 barg near %d C"
+              % (r["name"], len(bubble), 1 if dew is None else 2, glide, nbp))
+        tables.append(dict(r, bubble=bubble, dew=dew))
+    print("R507A  CoolProp vs R507_temp_pressure.h: max %.2f K" % r507_deviation())
+    if not args.check:
+        with open(args.out, "w", newline="\r\n", encoding="utf-8") as f:
+            f.write(emit(tables))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())